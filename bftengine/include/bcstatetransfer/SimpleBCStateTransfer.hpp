@@ -140,12 +140,31 @@ class IAppState {
   // return number of blocks that were actually post-processed
   virtual size_t postProcessUntilBlockId(uint64_t maxBlockId) = 0;
 
+  // Make all the blocks added so far durable. Called before a checkpoint of the current state is persisted, for
+  // storages that delay the sync of added blocks (group commit).
+  virtual void flushBlocks() {}
+
   // When the state is updated by the application, getLastReachableBlockNum()
   // and getLastBlockNum() should always return the same block number.
   // When that state transfer module is updating the state, then these methods
   // may return different block numbers.
 };
 
+// Compression of the blocks sent by a source replica in ItemDataMsg chunks
+enum class ChunkCompression : uint8_t { NONE = 0, LZ4 = 1, ZSTD = 2 };
+
+inline std::ostream &operator<<(std::ostream &os, const ChunkCompression &c) {
+  switch (c) {
+    case ChunkCompression::NONE:
+      return os << "none";
+    case ChunkCompression::LZ4:
+      return os << "lz4";
+    case ChunkCompression::ZSTD:
+      return os << "zstd";
+  }
+  return os << static_cast<uint16_t>(c);
+}
+
 struct Config {
   uint16_t myReplicaId;
   uint16_t fVal = 0;
@@ -185,6 +204,23 @@ struct Config {
   bool enableSourceBlocksPreFetch = true;
   bool enableSourceSelectorPrimaryAwareness = true;
   bool enableStoreRvbDataDuringCheckpointing = true;
+
+  // Number of preferred replicas, besides the current source, from which batches of blocks are fetched in parallel.
+  // 0 fetches all blocks from the current source.
+  uint16_t maxNumOfStripeSources = 0;
+
+  // Compression the source replicas are asked to send blocks with. A source sends a block as is if it does not shrink.
+  ChunkCompression chunkCompression = ChunkCompression::NONE;
+
+  // Number of blocks above the last batch requested by a destination which a source reads ahead asynchronously, once
+  // the destination fetches batches sequentially. 0 disables the read ahead.
+  uint32_t sourceReadAheadBlocks = 0;
+  // Maximal size of the blocks read ahead by a source and kept in memory until they are requested, bytes
+  uint32_t sourceBlockCacheSize = 256 * 1024 * 1024;
+
+  // Number of threads reading RVB digests from storage while the RVB data is reconstructed or a checkpoint adds many
+  // blocks. 0 reads them one by one on the calling thread.
+  uint16_t numOfRvbReconstructionThreads = 0;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Config &c) {
@@ -221,6 +257,12 @@ inline std::ostream &operator<<(std::ostream &os, const Config &c) {
               c.enableSourceBlocksPreFetch,
               c.enableSourceSelectorPrimaryAwareness,
               c.enableStoreRvbDataDuringCheckpointing);
+  os << ",";
+  os << KVLOG(c.maxNumOfStripeSources,
+              c.chunkCompression,
+              c.sourceReadAheadBlocks,
+              c.sourceBlockCacheSize,
+              c.numOfRvbReconstructionThreads);
   return os;
 }
 // creates an instance of the state transfer module.
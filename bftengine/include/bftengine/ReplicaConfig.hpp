@@ -280,6 +280,107 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
                "Port to be used to communicate with the diagnostic server using"
                "the concord-ctl script");
   CONFIG_PARAM(kvBlockchainVersion, std::uint32_t, 1u, "Default version of KV blockchain for this replica");
+  CONFIG_PARAM(enableLockFreeIncomingMsgsQueues,
+               bool,
+               false,
+               "whether incoming messages are passed to the dispatcher through lock-free consensus/client/internal lanes");
+  CONFIG_PARAM(numOfMsgValidationThreads,
+               uint16_t,
+               0,
+               "number of threads validating PrePrepare, Commit, Checkpoint and ClientRequest messages ahead of the "
+               "dispatcher; 0 disables the validation stage");
+  CONFIG_PARAM(numOfSigVerificationThreads,
+               uint16_t,
+               0,
+               "number of threads that help the calling thread to verify batches of client signatures; 0 means "
+               "batches are verified by the calling thread only");
+  CONFIG_PARAM(prePrepareProposalPipelineDepth,
+               uint16_t,
+               1,
+               "maximal number of PrePrepare messages the primary proposes back to back while the previous ones are "
+               "finalized asynchronously (requires prePrepareFinalizeAsyncEnabled); bounded by the concurrency level");
+  CONFIG_PARAM(prePrepareProposalBenchmarkReportPeriodSec,
+               uint32_t,
+               0,
+               "if positive, the primary logs PrePrepare proposal latency and request-to-PrePrepare delay percentiles "
+               "with this period (in seconds)");
+  CONFIG_PARAM(v4GroupCommitMaxBlocks,
+               uint32_t,
+               0,
+               "v4 blockchain: sync the WAL once per this number of consecutive blocks, bounding the blocks lost on a "
+               "host crash; blocks are written unsynced otherwise. 0 disables group commit (no WAL syncs)");
+  CONFIG_PARAM(v4GroupCommitMaxBytes,
+               uint64_t,
+               4 * 1024 * 1024,
+               "v4 blockchain: a group commit syncs the WAL once the write batches of its blocks reach this size");
+  CONFIG_PARAM(stLinkDigestPipelineDepth,
+               uint32_t,
+               0,
+               "number of state transfer blocks that are read and hashed ahead, in parallel, while they are linked to "
+               "the blockchain; 0 hashes each block after the previous one was linked");
+  CONFIG_PARAM(merkleNodeCacheMaxBytes,
+               uint64_t,
+               0,
+               "estimated memory of the cache of merkle tree internal nodes of each block merkle category; 0 disables "
+               "the cache");
+  CONFIG_PARAM(merkleNodeCacheMaxVersionAge,
+               uint64_t,
+               10000,
+               "merkle tree internal nodes not used in this many tree versions are evicted from the cache; 0 disables "
+               "eviction by age");
+  CONFIG_PARAM(numOfCategoryAddThreads,
+               uint32_t,
+               0,
+               "number of threads that add the updates of a block to its categories concurrently, each category into "
+               "its own write batch; 0 adds them one category after another");
+  CONFIG_PARAM(numOfMerkleUpdateThreads,
+               uint32_t,
+               0,
+               "number of threads that insert the keys of large updates of a sparse merkle tree into the subtrees of "
+               "its root in parallel; 0 updates the trees on the calling thread");
+  CONFIG_PARAM(stateSnapshotExportEnabled,
+               bool,
+               false,
+               "export the public state of a state snapshot to a compressed, indexed file when the snapshot is "
+               "created, and serve the snapshot from the file");
+  CONFIG_PARAM(stateSnapshotExportBlockSize,
+               uint32_t,
+               64 * 1024,
+               "size of the blocks of key values that are compressed together in an exported state snapshot file");
+  CONFIG_PARAM(numOfStateSnapshotHashThreads,
+               uint32_t,
+               0,
+               "number of threads that hash the ranges of the public state of a state snapshot concurrently when "
+               "stateSnapshotHashRangeSize is not 0; 0 hashes them on the calling thread. The public state hash does "
+               "not depend on it");
+  CONFIG_PARAM(stateSnapshotHashRangeSize,
+               uint64_t,
+               0,
+               "number of public state keys in each range that is hashed on its own, the public state hash being the "
+               "hash of the range hashes; 0 computes the public state hash as a single chain over all keys. Must be "
+               "the same on all replicas");
+  CONFIG_PARAM(v4LatestKeysCacheMaxBytes,
+               uint64_t,
+               0,
+               "estimated memory of the write-through cache of the latest values of keys of the v4 blockchain; 0 "
+               "disables the cache");
+  CONFIG_PARAM(tlsMaxCoalescedWriteMsgs,
+               uint32_t,
+               1,
+               "maximal number of queued messages a TLS connection sends by a single write; 1 disables coalescing");
+  CONFIG_PARAM(tlsMaxCoalescedWriteBytes,
+               uint32_t,
+               64 * 1024,
+               "maximal total size of the messages a TLS connection coalesces into a single write");
+  CONFIG_PARAM(tlsNumOfIoShards,
+               uint16_t,
+               1,
+               "number of io_contexts the TLS connections are spread over, each served by its own thread; 1 serves all "
+               "the connections by a single io_context and a pool of threads");
+  CONFIG_PARAM(tlsPinIoShardsToCores,
+               bool,
+               false,
+               "pin the thread of each TLS io_context shard to a core (only with more than one shard)");
 
   // Parameter to enable/disable waiting for transaction data to be persisted.
   // Not predefined configuration parameters
@@ -406,6 +507,27 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     serialize(outStream, diagnosticsServerPort);
     serialize(outStream, useUnifiedCertificates);
     serialize(outStream, kvBlockchainVersion);
+    serialize(outStream, enableLockFreeIncomingMsgsQueues);
+    serialize(outStream, numOfMsgValidationThreads);
+    serialize(outStream, numOfSigVerificationThreads);
+    serialize(outStream, prePrepareProposalPipelineDepth);
+    serialize(outStream, prePrepareProposalBenchmarkReportPeriodSec);
+    serialize(outStream, v4GroupCommitMaxBlocks);
+    serialize(outStream, v4GroupCommitMaxBytes);
+    serialize(outStream, stLinkDigestPipelineDepth);
+    serialize(outStream, merkleNodeCacheMaxBytes);
+    serialize(outStream, merkleNodeCacheMaxVersionAge);
+    serialize(outStream, numOfCategoryAddThreads);
+    serialize(outStream, numOfMerkleUpdateThreads);
+    serialize(outStream, stateSnapshotExportEnabled);
+    serialize(outStream, stateSnapshotExportBlockSize);
+    serialize(outStream, numOfStateSnapshotHashThreads);
+    serialize(outStream, stateSnapshotHashRangeSize);
+    serialize(outStream, v4LatestKeysCacheMaxBytes);
+    serialize(outStream, tlsMaxCoalescedWriteMsgs);
+    serialize(outStream, tlsMaxCoalescedWriteBytes);
+    serialize(outStream, tlsNumOfIoShards);
+    serialize(outStream, tlsPinIoShardsToCores);
   }
   void deserializeDataMembers(std::istream& inStream) {
     deserialize(inStream, isReadOnly);
@@ -506,6 +628,27 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     deserialize(inStream, diagnosticsServerPort);
     deserialize(inStream, useUnifiedCertificates);
     deserialize(inStream, kvBlockchainVersion);
+    deserialize(inStream, enableLockFreeIncomingMsgsQueues);
+    deserialize(inStream, numOfMsgValidationThreads);
+    deserialize(inStream, numOfSigVerificationThreads);
+    deserialize(inStream, prePrepareProposalPipelineDepth);
+    deserialize(inStream, prePrepareProposalBenchmarkReportPeriodSec);
+    deserialize(inStream, v4GroupCommitMaxBlocks);
+    deserialize(inStream, v4GroupCommitMaxBytes);
+    deserialize(inStream, stLinkDigestPipelineDepth);
+    deserialize(inStream, merkleNodeCacheMaxBytes);
+    deserialize(inStream, merkleNodeCacheMaxVersionAge);
+    deserialize(inStream, numOfCategoryAddThreads);
+    deserialize(inStream, numOfMerkleUpdateThreads);
+    deserialize(inStream, stateSnapshotExportEnabled);
+    deserialize(inStream, stateSnapshotExportBlockSize);
+    deserialize(inStream, numOfStateSnapshotHashThreads);
+    deserialize(inStream, stateSnapshotHashRangeSize);
+    deserialize(inStream, v4LatestKeysCacheMaxBytes);
+    deserialize(inStream, tlsMaxCoalescedWriteMsgs);
+    deserialize(inStream, tlsMaxCoalescedWriteBytes);
+    deserialize(inStream, tlsNumOfIoShards);
+    deserialize(inStream, tlsPinIoShardsToCores);
   }
 
  private:
@@ -599,7 +742,29 @@ inline std::ostream& operator<<(std::ostream& os, const ReplicaConfig& rc) {
               rc.enablePreProcessorMemoryPool,
               rc.diagnosticsServerPort,
               rc.useUnifiedCertificates,
-              rc.kvBlockchainVersion);
+              rc.kvBlockchainVersion,
+              rc.enableLockFreeIncomingMsgsQueues,
+              rc.numOfMsgValidationThreads,
+              rc.numOfSigVerificationThreads,
+              rc.prePrepareProposalPipelineDepth,
+              rc.prePrepareProposalBenchmarkReportPeriodSec,
+              rc.v4GroupCommitMaxBlocks,
+              rc.v4GroupCommitMaxBytes);
+  os << ",";
+  os << KVLOG(rc.stLinkDigestPipelineDepth,
+              rc.merkleNodeCacheMaxBytes,
+              rc.merkleNodeCacheMaxVersionAge,
+              rc.numOfCategoryAddThreads,
+              rc.numOfMerkleUpdateThreads,
+              rc.stateSnapshotExportEnabled,
+              rc.stateSnapshotExportBlockSize,
+              rc.numOfStateSnapshotHashThreads,
+              rc.stateSnapshotHashRangeSize,
+              rc.v4LatestKeysCacheMaxBytes,
+              rc.tlsMaxCoalescedWriteMsgs,
+              rc.tlsMaxCoalescedWriteBytes,
+              rc.tlsNumOfIoShards,
+              rc.tlsPinIoShardsToCores);
   os << ", ";
   for (auto& [param, value] : rc.config_params_) os << param << ": " << value << "\n";
   return os;
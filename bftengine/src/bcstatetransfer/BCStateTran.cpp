@@ -34,6 +34,7 @@
 #include "client/reconfiguration/client_reconfiguration_engine.hpp"
 #include "client/reconfiguration/poll_based_state_client.hpp"
 #include "RVBManager.hpp"
+#include "BlockCompression.hpp"
 
 using std::tie;
 using namespace std::placeholders;
@@ -214,7 +215,30 @@ BCStateTran::Metrics BCStateTran::createRegisterMetrics() {
 
       metrics_component_.RegisterGauge("src_num_io_contexts_dropped", 0),
       metrics_component_.RegisterGauge("src_num_io_contexts_invoked", 0),
-      metrics_component_.RegisterCounter("src_num_io_contexts_consumed")};
+      metrics_component_.RegisterCounter("src_num_io_contexts_consumed"),
+
+      metrics_component_.RegisterGauge("num_stripes", 0),
+      metrics_component_.RegisterGauge("total_size_of_stripe_item_data_msgs", 0),
+      metrics_component_.RegisterCounter("sent_stripe_fetch_blocks_msg"),
+      metrics_component_.RegisterCounter("received_stripe_item_data_msg"),
+      metrics_component_.RegisterCounter("stripes_taken_over"),
+      metrics_component_.RegisterCounter("stripes_expired"),
+      metrics_component_.RegisterCounter("bad_data_from_stripe_source"),
+      metrics_component_.RegisterCounter("src_compressed_blocks"),
+      metrics_component_.RegisterCounter("src_bytes_before_compression"),
+      metrics_component_.RegisterCounter("src_bytes_after_compression"),
+      metrics_component_.RegisterGauge("src_compressed_size_percent", 0),
+      metrics_component_.RegisterCounter("dst_decompressed_blocks"),
+      metrics_component_.RegisterCounter("dst_bytes_before_decompression"),
+      metrics_component_.RegisterCounter("dst_bytes_after_decompression"),
+      metrics_component_.RegisterGauge("dst_compressed_size_percent", 0),
+      metrics_component_.RegisterCounter("dst_decompression_failures"),
+      metrics_component_.RegisterCounter("src_read_ahead_blocks"),
+      metrics_component_.RegisterCounter("src_block_cache_hits"),
+      metrics_component_.RegisterCounter("src_block_cache_misses"),
+      metrics_component_.RegisterCounter("src_block_cache_evictions"),
+      metrics_component_.RegisterGauge("src_block_cache_num_blocks", 0),
+      metrics_component_.RegisterGauge("src_block_cache_size_bytes", 0)};
 }
 
 void BCStateTran::rvbm_deleter::operator()(RVBManager *ptr) const { delete ptr; }  // used for pimpl
@@ -251,12 +275,15 @@ BCStateTran::BCStateTran(const Config &config, IAppState *const stateApi, DataSt
                       config_.sourceReplicaReplacementTimeoutMs,
                       config_.maxFetchRetransmissions,
                       config_.minPrePrepareMsgsForPrimaryAwareness,
-                      ST_SRC_LOG},
+                      ST_SRC_LOG,
+                      config_.maxNumOfStripeSources,
+                      config_.fetchRangeSize,
+                      config_.maxNumberOfChunksInBatch},
       fetchState_{0},
       commitState_{0},
       postponedSendFetchBlocksMsg_(false),
       ioPool_(
-          config_.maxNumberOfChunksInBatch,
+          config_.maxNumberOfChunksInBatch + numSrcReadAheadContexts(),
           nullptr,                                     // alloc callback
           [&](std::shared_ptr<BlockIOContext> &ctx) {  // free callback
             if (ctx->future.valid()) {
@@ -274,6 +301,11 @@ BCStateTran::BCStateTran(const Config &config, IAppState *const stateApi, DataSt
             BCStateTran::BlockIOContext::sizeOfBlockData = config_.maxBlockSize;
           }),
       oneShotTimerFlag_{true},
+      srcBlockCache_{config_.sourceBlockCacheSize},
+      srcReadAheadDestReplicaId_{UINT16_MAX},
+      srcLastRequestedMaxBlockId_{0},
+      srcReadAheadNextBlockId_{1},
+      srcReadAheadMaxBlockId_{0},
       rvbm_{new RVBManager(config_, as_, psd_)},
       metrics_component_{
           concordMetrics::Component("bc_state_transfer", std::make_shared<concordMetrics::Aggregator>())},
@@ -584,6 +616,8 @@ void BCStateTran::createCheckpointOfCurrentStateImpl(uint64_t checkpointNumber)
   ConcordAssertGT(checkpointNumber, lastStoredCheckpointNumber);
 
   metrics_.create_checkpoint_++;
+  // The checkpoint must not refer to blocks that are not durable yet
+  as_->flushBlocks();
 
   {  // txn scope
     DataStoreTransaction::Guard g(psd_->beginTransaction());
@@ -960,8 +994,17 @@ void BCStateTran::onTimerImpl() {
     LOG_DEBUG(logger_, "--RVT metrics dump--" + rvbm_->getRvtMetricComponent().ToJson());
   }
 
-  // Retransmit AskForCheckpointSummariesMsg if needed
+  // Keep reading ahead blocks while a source session is open, and drop them once it is closed
   FetchingState fs = getFetchingState();
+  if ((config_.sourceReadAheadBlocks > 0) && (fs == FetchingState::NotFetching)) {
+    if (sourceSession_.isOpen()) {
+      srcContinueReadAhead();
+    } else if (!srcReadAheadContexts_.empty() || (srcBlockCache_.size() > 0)) {
+      clearSrcReadAhead();
+    }
+  }
+
+  // Retransmit AskForCheckpointSummariesMsg if needed
   if (fs == FetchingState::SendingBatch) {
     continueSendBatch();
   } else if (fs == FetchingState::GettingCheckpointSummaries) {
@@ -976,6 +1019,9 @@ void BCStateTran::onTimerImpl() {
     }
     // process data if fetching
   } else if (fs == FetchingState::GettingMissingBlocks || fs == FetchingState::GettingMissingResPages) {
+    if (fs == FetchingState::GettingMissingBlocks) {
+      cancelExpiredStripes(currentTimeMilli);
+    }
     processData();
   } else if (fs == FetchingState::FinalizingCycle) {
     ConcordAssert(on_transferring_complete_ongoing_);
@@ -1133,6 +1179,7 @@ void BCStateTran::handleStateTransferMessageImpl(char *msg,
       }
       break;
     case MsgType::ItemData:
+    case MsgType::CompressedItemData:
       if (fs == FetchingState::GettingMissingBlocks || fs == FetchingState::GettingMissingResPages) {
         TimeRecorder scoped_timer(*histograms_.dst_handle_ItemData_msg);
         metrics_.handle_ItemData_msg_++;
@@ -1510,7 +1557,7 @@ void BCStateTran::trySendFetchBlocksMsg(int16_t lastKnownChunkInLastRequiredBloc
     return;
   }
 
-  FetchBlocksMsg msg;
+  CompressedFetchBlocksMsg msg;
   lastMsgSeqNum_ = uniqueMsgSeqNum();
   metrics_.last_msg_seq_num_.Get().Set(lastMsgSeqNum_);
 
@@ -1520,6 +1567,7 @@ void BCStateTran::trySendFetchBlocksMsg(int16_t lastKnownChunkInLastRequiredBloc
   msg.maxBlockIdInCycle = psd_->getLastRequiredBlock();
   msg.lastKnownChunkInLastRequiredBlock = lastKnownChunkInLastRequiredBlock;
   msg.rvbGroupId = rvbm_->getFetchBlocksRvbGroupId(msg.minBlockId, msg.maxBlockId);
+  msg.compression = static_cast<uint8_t>(config_.chunkCompression);
   auto totalBlocksRequested = (msg.maxBlockId - msg.minBlockId) + 1;
 
   LOG_INFO(logger_,
@@ -1534,12 +1582,13 @@ void BCStateTran::trySendFetchBlocksMsg(int16_t lastKnownChunkInLastRequiredBloc
                                               msg.rvbGroupId));
 
   replicaForStateTransfer_->sendStateTransferMessage(
-      reinterpret_cast<char *>(&msg), sizeof(FetchBlocksMsg), sourceSelector_.currentReplica());
+      reinterpret_cast<char *>(&msg), msg.size(), sourceSelector_.currentReplica());
   sourceSelector_.setFetchingTimeStamp(getMonotonicTimeMilli(), true);
   metrics_.sent_fetch_blocks_msg_++;
   dst_time_between_sendFetchBlocksMsg_rec_.end();  // if it was never started, this operation does nothing
   dst_time_between_sendFetchBlocksMsg_rec_.start();
   postponedSendFetchBlocksMsg_ = false;
+  trySendStripeFetchBlocksMsgs();
 }
 
 void BCStateTran::sendFetchResPagesMsg(int16_t lastKnownChunkInLastRequiredBlock) {
@@ -1799,6 +1848,32 @@ uint16_t BCStateTran::getBlocksConcurrentAsync(uint64_t maxBlockId, uint64_t min
 
   LOG_DEBUG(logger_, KVLOG(maxBlockId, minBlockId, numBlocks, ioPool_.numFreeElements()));
   for (uint64_t i{maxBlockId}; (i >= minBlockId) && (j < numBlocks) && !ioPool_.empty(); --i, ++j) {
+    if (config_.sourceReadAheadBlocks > 0) {
+      // The block might be read ahead already, or being read ahead
+      auto it = std::find_if(srcReadAheadContexts_.begin(), srcReadAheadContexts_.end(), [i](const auto &ctx) {
+        return ctx->blockId == i;
+      });
+      if (it != srcReadAheadContexts_.end()) {
+        ioContexts_.push_back(std::move(*it));
+        srcReadAheadContexts_.erase(it);
+        metrics_.src_block_cache_hits_++;
+        continue;
+      }
+      if (const auto *block = srcBlockCache_.get(i)) {
+        auto ctx = ioPool_.alloc();
+        ctx->blockId = i;
+        ctx->actualBlockSize = static_cast<uint32_t>(block->size());
+        memcpy(ctx->blockData.get(), block->data(), block->size());
+        std::promise<bool> blockRead;
+        blockRead.set_value(true);
+        ctx->future = blockRead.get_future();
+        ioContexts_.push_back(std::move(ctx));
+        srcBlockCache_.erase(i);
+        metrics_.src_block_cache_hits_++;
+        continue;
+      }
+      metrics_.src_block_cache_misses_++;
+    }
     auto ctx = ioPool_.alloc();
     ctx->blockId = i;
     ctx->future = as_->getBlockAsync(ctx->blockId, ctx->blockData.get(), config_.maxBlockSize, &ctx->actualBlockSize);
@@ -1821,6 +1896,104 @@ void BCStateTran::clearIoContexts() {
   ioContexts_.clear();
 }
 
+uint16_t BCStateTran::numSrcReadAheadContexts() const {
+  return static_cast<uint16_t>(std::min<uint32_t>(config_.sourceReadAheadBlocks, config_.maxNumberOfChunksInBatch));
+}
+
+void BCStateTran::srcUpdateReadAhead(const FetchBlocksMsg *m, uint16_t replicaId) {
+  if (config_.sourceReadAheadBlocks == 0) {
+    return;
+  }
+  bool sequential = (replicaId == srcReadAheadDestReplicaId_) && (m->minBlockId == srcLastRequestedMaxBlockId_ + 1);
+  srcReadAheadDestReplicaId_ = replicaId;
+  srcLastRequestedMaxBlockId_ = m->maxBlockId;
+  if (sequential) {
+    // Blocks below the requested batch were already sent
+    srcBlockCache_.eraseBelow(m->minBlockId);
+    srcReadAheadNextBlockId_ = std::max(srcReadAheadNextBlockId_, m->maxBlockId + 1);
+    srcReadAheadMaxBlockId_ = std::min({m->maxBlockIdInCycle,
+                                        m->maxBlockId + config_.sourceReadAheadBlocks,
+                                        as_->getLastReachableBlockNum()});
+  } else {
+    // Stop reading ahead. Blocks already read ahead are kept, as long as there is room for them.
+    srcReadAheadNextBlockId_ = 1;
+    srcReadAheadMaxBlockId_ = 0;
+  }
+  LOG_DEBUG(logger_,
+            std::boolalpha << KVLOG(sequential,
+                                    replicaId,
+                                    m->minBlockId,
+                                    m->maxBlockId,
+                                    srcReadAheadNextBlockId_,
+                                    srcReadAheadMaxBlockId_,
+                                    srcReadAheadContexts_.size(),
+                                    srcBlockCache_.size()));
+}
+
+void BCStateTran::srcContinueReadAhead() {
+  if (config_.sourceReadAheadBlocks == 0) {
+    return;
+  }
+  for (auto it = srcReadAheadContexts_.begin(); it != srcReadAheadContexts_.end();) {
+    if (srcCacheBlockOfContext(*it, false)) {
+      ioPool_.free(*it);
+      it = srcReadAheadContexts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto isPrefetched = [&](uint64_t blockId) {
+    return std::any_of(
+        ioContexts_.begin(), ioContexts_.end(), [blockId](const auto &ctx) { return ctx->blockId == blockId; });
+  };
+  while ((srcReadAheadNextBlockId_ <= srcReadAheadMaxBlockId_) &&
+         (srcReadAheadContexts_.size() < numSrcReadAheadContexts())) {
+    auto blockId = srcReadAheadNextBlockId_++;
+    if (srcBlockCache_.contains(blockId) || isPrefetched(blockId)) {
+      continue;
+    }
+    auto ctx = ioPool_.alloc();
+    ctx->blockId = blockId;
+    ctx->future = as_->getBlockAsync(ctx->blockId, ctx->blockData.get(), config_.maxBlockSize, &ctx->actualBlockSize);
+    srcReadAheadContexts_.push_back(std::move(ctx));
+    metrics_.src_read_ahead_blocks_++;
+  }
+  metrics_.src_block_cache_num_blocks_.Get().Set(srcBlockCache_.size());
+  metrics_.src_block_cache_size_bytes_.Get().Set(srcBlockCache_.bytes());
+}
+
+bool BCStateTran::srcCacheBlockOfContext(BlockIOContextPtr &ctx, bool wait) {
+  if (!ctx->future.valid()) {
+    return true;
+  }
+  if (!wait && (ctx->future.wait_for(std::chrono::nanoseconds(0)) != std::future_status::ready)) {
+    return false;
+  }
+  if (ctx->future.get()) {
+    metrics_.src_block_cache_evictions_ +=
+        srcBlockCache_.put(ctx->blockId, ctx->blockData.get(), ctx->actualBlockSize);
+  } else {
+    LOG_WARN(logger_, "Failed to read ahead block:" << KVLOG(ctx->blockId));
+  }
+  return true;
+}
+
+void BCStateTran::clearSrcReadAhead() {
+  LOG_DEBUG(logger_, KVLOG(srcReadAheadContexts_.size(), srcBlockCache_.size(), srcBlockCache_.bytes()));
+  for (auto &ctx : srcReadAheadContexts_) {
+    ioPool_.free(ctx);
+  }
+  srcReadAheadContexts_.clear();
+  srcBlockCache_.clear();
+  srcReadAheadDestReplicaId_ = UINT16_MAX;
+  srcLastRequestedMaxBlockId_ = 0;
+  srcReadAheadNextBlockId_ = 1;
+  srcReadAheadMaxBlockId_ = 0;
+  metrics_.src_block_cache_num_blocks_.Get().Set(0);
+  metrics_.src_block_cache_size_bytes_.Get().Set(0);
+}
+
 void BCStateTran::sendRejectFetchingMsg(const uint16_t rejectionCode,
                                         uint64_t msgSeqNum,
                                         uint16_t destReplicaId,
@@ -1886,7 +2059,13 @@ void BCStateTran::sourcePrepareBatch(uint64_t numBlocksRequested) {
 
   if (invokeGetBlocks) {
     // Contexts have to be cleared
-    if (sizeIoContexts > 0) {
+    if ((sizeIoContexts > 0) && (config_.sourceReadAheadBlocks > 0)) {
+      // Keep the blocks read so far, this batch or the next ones might need them
+      for (auto &ctx : ioContexts_) {
+        srcCacheBlockOfContext(ctx, true);
+      }
+      clearIoContexts();
+    } else if (sizeIoContexts > 0) {
       metrics_.src_num_io_contexts_dropped_.Get().Set(metrics_.src_num_io_contexts_dropped_.Get().Get() +
                                                       sizeIoContexts);
       clearIoContexts();
@@ -1914,8 +2093,9 @@ bool BCStateTran::onMessage(const FetchBlocksMsg *m, uint32_t msgLen, uint16_t r
   metrics_.received_fetch_blocks_msg_++;
 
   // if msg is invalid
+  const auto compression = CompressedFetchBlocksMsg::compressionOf(m, msgLen);
   if (msgLen < sizeof(FetchBlocksMsg) || m->msgSeqNum == 0 || m->minBlockId == 0 || m->maxBlockId < m->minBlockId ||
-      m->maxBlockId > m->maxBlockIdInCycle) {
+      m->maxBlockId > m->maxBlockIdInCycle || !isValidChunkCompression(compression)) {
     LOG_WARN(logger_,
              "Msg is invalid: " << KVLOG(msgLen,
                                          sizeof(FetchBlocksMsg),
@@ -1923,7 +2103,8 @@ bool BCStateTran::onMessage(const FetchBlocksMsg *m, uint32_t msgLen, uint16_t r
                                          m->msgSeqNum,
                                          m->minBlockId,
                                          m->maxBlockId,
-                                         m->maxBlockIdInCycle));
+                                         m->maxBlockIdInCycle,
+                                         compression));
     metrics_.invalid_fetch_blocks_msg_++;
     return true;
   }
@@ -1990,10 +2171,13 @@ bool BCStateTran::onMessage(const FetchBlocksMsg *m, uint32_t msgLen, uint16_t r
                     config_,
                     rvbGroupDigestsExpectedSize,
                     m,
+                    static_cast<ChunkCompression>(compression),
                     replicaId);
   ConcordAssertEQ(sourceBatch_.destReplicaId, sourceSession_.ownerDestReplicaId());
 
+  srcUpdateReadAhead(m, replicaId);
   sourcePrepareBatch(numBlocksRequested);
+  srcContinueReadAhead();
 
   LOG_INFO(logger_,
            "Start sending batch:" + sourceBatch_.toString() << KVLOG(numBlocksRequested,
@@ -2054,12 +2238,15 @@ void BCStateTran::continueSendBatch() {
       histograms_.src_get_block_size_bytes->record(ctx->actualBlockSize);
       sb.getNextBlock = false;
     }
-    buffer = ctx->blockData.get();
+    if (sb.preparedBlockId != sb.nextBlockId) {
+      prepareBlockToSend(*ctx);
+    }
+    buffer = (sb.blockCompression != ChunkCompression::NONE) ? srcCompressedBlock_.get() : ctx->blockData.get();
 
     uint32_t sizeOfLastChunk = config_.maxChunkSize;
-    uint32_t numOfChunksInNextBlock = ctx->actualBlockSize / config_.maxChunkSize;
-    if ((ctx->actualBlockSize % config_.maxChunkSize) != 0) {
-      sizeOfLastChunk = ctx->actualBlockSize % config_.maxChunkSize;
+    uint32_t numOfChunksInNextBlock = sb.blockSize / config_.maxChunkSize;
+    if ((sb.blockSize % config_.maxChunkSize) != 0) {
+      sizeOfLastChunk = sb.blockSize % config_.maxChunkSize;
       numOfChunksInNextBlock++;
     }
 
@@ -2081,7 +2268,8 @@ void BCStateTran::continueSendBatch() {
     ConcordAssertGT(chunkSize, 0);
 
     char *pRawChunk = buffer + (sb.nextChunk - 1) * config_.maxChunkSize;
-    ItemDataMsg *outMsg = ItemDataMsg::alloc(chunkSize + sb.rvbGroupDigestsExpectedSize);  // TODO(GG): improve
+    ItemDataMsg *outMsg = ItemDataMsg::alloc(chunkSize + sb.rvbGroupDigestsExpectedSize,
+                                             static_cast<uint8_t>(sb.blockCompression));  // TODO(GG): improve
 
     outMsg->requestMsgSeqNum = m->msgSeqNum;
     outMsg->blockNumber = sb.nextBlockId;
@@ -2130,6 +2318,7 @@ void BCStateTran::continueSendBatch() {
                                                outMsg->chunkNumber,
                                                outMsg->dataSize,
                                                outMsg->rvbDigestsSize,
+                                               sb.blockCompression,
                                                (bool)outMsg->lastInBatch));
 
     metrics_.sent_item_data_msg_++;
@@ -2148,6 +2337,7 @@ void BCStateTran::continueSendBatch() {
         getBlocksConcurrentAsync(sb.preFetchBlockId, m->maxBlockId + 1, 1);
         --sb.preFetchBlockId;
       }
+      srcContinueReadAhead();
     };
 
     // if we've already sent enough chunks
@@ -2206,6 +2396,43 @@ void BCStateTran::continueSendBatch() {
   return;
 }
 
+void BCStateTran::prepareBlockToSend(const BlockIOContext &ctx) {
+  auto &sb = sourceBatch_;
+  sb.preparedBlockId = ctx.blockId;
+  sb.blockCompression = ChunkCompression::NONE;
+  sb.blockSize = ctx.actualBlockSize;
+  if (sb.compression == ChunkCompression::NONE) {
+    return;
+  }
+
+  if (!srcCompressedBlock_) {
+    srcCompressedBlock_.reset(new char[config_.maxBlockSize]);
+  }
+  uint32_t compressedSize = 0;
+  {
+    TimeRecorder scoped_timer(*histograms_.src_compress_block_duration);
+    compressedSize = compressBlock(sb.compression,
+                                   ctx.blockData.get(),
+                                   ctx.actualBlockSize,
+                                   srcCompressedBlock_.get(),
+                                   std::min(ctx.actualBlockSize, config_.maxBlockSize));
+  }
+  metrics_.src_bytes_before_compression_ += ctx.actualBlockSize;
+  if (compressedSize > 0) {
+    // Send the compressed block
+    sb.blockCompression = sb.compression;
+    sb.blockSize = compressedSize;
+    metrics_.src_compressed_blocks_++;
+  }
+  metrics_.src_bytes_after_compression_ += sb.blockSize;
+  const auto bytesBeforeCompression = metrics_.src_bytes_before_compression_.Get().Get();
+  if (bytesBeforeCompression > 0) {
+    metrics_.src_compressed_size_percent_.Get().Set((100 * metrics_.src_bytes_after_compression_.Get().Get()) /
+                                                    bytesBeforeCompression);
+  }
+  LOG_DEBUG(logger_, KVLOG(ctx.blockId, ctx.actualBlockSize, sb.compression, sb.blockCompression, sb.blockSize));
+}
+
 bool BCStateTran::onMessage(const FetchResPagesMsg *m, uint32_t msgLen, uint16_t replicaId) {
   SCOPED_MDC_SEQ_NUM(getScopedMdcStr(replicaId, m->msgSeqNum));
   LOG_INFO(
@@ -2367,6 +2594,19 @@ bool BCStateTran::onMessage(const RejectFetchingMsg *m, uint32_t msgLen, uint16_
     return true;
   }
 
+  // A stripe source rejected its stripe: stop using it, the blocks of the stripe are fetched from other sources
+  if ((fs == FetchingState::GettingMissingBlocks) && (sourceSelector_.currentReplica() != replicaId)) {
+    auto it = stripes_.find(replicaId);
+    if ((it != stripes_.end()) && (it->second.msgSeqNum == m->requestMsgSeqNum)) {
+      LOG_INFO(logger_,
+               "Stripe source rejected stripe" << KVLOG(m->rejectionCode, itr->second, replicaId, it->second.batch));
+      eraseStripe(it);
+      sourceSelector_.removeStripeSource(replicaId);
+      trySendStripeFetchBlocksMsgs();
+      return true;
+    }
+  }
+
   // if msg is not relevant
   if ((sourceSelector_.currentReplica() != replicaId) || (lastMsgSeqNum_ != m->requestMsgSeqNum) ||
       ((fs == FetchingState::GettingMissingBlocks) &&
@@ -2441,7 +2681,8 @@ bool BCStateTran::onMessage(const ItemDataMsg *m,
   // if msg is invalid
   if ((msgLen != m->size()) || (m->requestMsgSeqNum == 0) || (m->blockNumber == 0) ||
       (m->totalNumberOfChunksInBlock == 0) || (m->totalNumberOfChunksInBlock > MaxNumOfChunksInBlock) ||
-      (m->chunkNumber == 0) || (m->dataSize == 0) || (m->rvbDigestsSize >= m->dataSize)) {
+      (m->chunkNumber == 0) || (m->dataSize == 0) || (m->rvbDigestsSize >= m->dataSize) ||
+      !isValidChunkCompression(m->compression())) {
     LOG_WARN(logger_,
              "Msg is invalid: " << KVLOG(replicaId,
                                          msgLen,
@@ -2452,7 +2693,8 @@ bool BCStateTran::onMessage(const ItemDataMsg *m,
                                          MaxNumOfChunksInBlock,
                                          m->chunkNumber,
                                          m->rvbDigestsSize,
-                                         m->dataSize));
+                                         m->dataSize,
+                                         m->isCompressed()));
     metrics_.invalid_item_data_msg_++;
     return true;
   }
@@ -2465,6 +2707,9 @@ bool BCStateTran::onMessage(const ItemDataMsg *m,
     // 3) Not enough memory to put block
     // We do not drop on different requestMsgSeqNum - the block arrives from the expected source and might have been
     // delayed due to retransmissions, but it should still be valid block with an expected ID. No reason to drop.
+    if ((sourceSelector_.currentReplica() != replicaId) && (stripes_.count(replicaId) != 0)) {
+      return onStripeItemDataMsg(m, replicaId);
+    }
     if ((sourceSelector_.currentReplica() != replicaId) || (fetchState_.minBlockId > m->blockNumber) ||
         (fetchState_.nextBlockId < m->blockNumber) ||
         (m->dataSize + totalSizeOfPendingItemDataMsgs > config_.maxPendingDataFromSourceReplica)) {
@@ -2530,7 +2775,7 @@ bool BCStateTran::onMessage(const ItemDataMsg *m,
     metrics_.num_pending_item_data_msgs_.Get().Set(pendingItemDataMsgs.size());
     totalSizeOfPendingItemDataMsgs += m->dataSize;
     metrics_.total_size_of_pending_item_data_msgs_.Get().Set(totalSizeOfPendingItemDataMsgs);
-    processData(m->lastInBatch, m->rvbDigestsSize);
+    processData(m->lastInBatch);
     return false;
   } else {
     LOG_INFO(
@@ -2679,6 +2924,7 @@ void BCStateTran::clearAllPendingItemsData() {
 
   pendingItemDataMsgs.clear();
   totalSizeOfPendingItemDataMsgs = 0;
+  stripeSourceOfFetchState_ = NO_REPLICA;
   metrics_.num_pending_item_data_msgs_.Get().Set(0);
   metrics_.total_size_of_pending_item_data_msgs_.Get().Set(0);
 }
@@ -2708,6 +2954,7 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
                                    int16_t &outLastChunkInRequiredBlock,
                                    char *outBlock,
                                    uint32_t &outBlockSize,
+                                   uint32_t &outRvbDigestsSize,
                                    bool isVBLock) {
   ConcordAssertGE(requiredBlock, 1);
 
@@ -2716,11 +2963,13 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
   outBadDataDetected = false;
   outLastChunkInRequiredBlock = 0;
   outBlockSize = 0;
+  outRvbDigestsSize = 0;
   bool badData = false;
   bool fullBlock = false;
   uint16_t totalNumberOfChunks = 0;
   uint16_t maxAvailableChunk = 0;
   uint32_t blockSize = 0;
+  uint8_t compression = 0;
 
   auto it = pendingItemDataMsgs.begin();
   while ((it != pendingItemDataMsgs.end()) && ((*it)->blockNumber == requiredBlock)) {
@@ -2729,10 +2978,16 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
     // the conditions of these asserts are checked when receiving the message
     ConcordAssertGT(msg->totalNumberOfChunksInBlock, 0);
     ConcordAssertGE(msg->chunkNumber, 1);
-    if (totalNumberOfChunks == 0) totalNumberOfChunks = msg->totalNumberOfChunksInBlock;
+    if (totalNumberOfChunks == 0) {
+      totalNumberOfChunks = msg->totalNumberOfChunksInBlock;
+      compression = msg->compression();
+    }
     blockSize += (msg->dataSize - msg->rvbDigestsSize);
+    // RVB digests are piggybacked only on the 1st chunk of a block, ahead of the block data. A block is compressed only
+    // if it shrinks, hence a compressed block is smaller than maxSize as well.
     if (totalNumberOfChunks != msg->totalNumberOfChunksInBlock || msg->chunkNumber > totalNumberOfChunks ||
-        blockSize > maxSize) {
+        blockSize > maxSize || ((msg->chunkNumber > 1) && (msg->rvbDigestsSize > 0)) ||
+        (compression != msg->compression())) {
       badData = true;
       break;
     }
@@ -2762,9 +3017,15 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
     return false;
   }
 
-  // construct the block
+  // construct the block. A compressed block is constructed in dstCompressedBlock_ and then decompressed into outBlock,
+  // after the RVB digests.
+  const auto blockCompression = static_cast<ChunkCompression>(compression);
+  if ((blockCompression != ChunkCompression::NONE) && !dstCompressedBlock_) {
+    dstCompressedBlock_.reset(new char[maxItemSize_]);
+  }
   uint16_t currentChunk = 0;
   uint32_t currentPos = 0;
+  uint32_t compressedPos = 0;
 
   it = pendingItemDataMsgs.begin();
   while (true) {
@@ -2778,9 +3039,21 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
     ConcordAssertEQ(currentChunk + 1, msg->chunkNumber);
     ConcordAssertLE(currentPos + msg->dataSize - msg->rvbDigestsSize, maxSize);
 
-    memcpy(outBlock + currentPos, msg->data, msg->dataSize);
+    if (blockCompression == ChunkCompression::NONE) {
+      memcpy(outBlock + currentPos, msg->data, msg->dataSize);
+      currentPos += msg->dataSize;
+    } else {
+      memcpy(outBlock + currentPos, msg->data, msg->rvbDigestsSize);
+      currentPos += msg->rvbDigestsSize;
+      memcpy(dstCompressedBlock_.get() + compressedPos,
+             msg->data + msg->rvbDigestsSize,
+             msg->dataSize - msg->rvbDigestsSize);
+      compressedPos += (msg->dataSize - msg->rvbDigestsSize);
+    }
+    if (msg->chunkNumber == 1) {
+      outRvbDigestsSize = msg->rvbDigestsSize;
+    }
     currentChunk = msg->chunkNumber;
-    currentPos += msg->dataSize;
     totalSizeOfPendingItemDataMsgs -= (*it)->dataSize;
     replicaForStateTransfer_->freeStateTransferMsg(reinterpret_cast<char *>(*it));
     it = pendingItemDataMsgs.erase(it);
@@ -2788,10 +3061,269 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
     metrics_.total_size_of_pending_item_data_msgs_.Get().Set(totalSizeOfPendingItemDataMsgs);
 
     if (currentChunk == totalNumberOfChunks) {
-      outBlockSize = currentPos;
-      return true;
+      break;
     }
   }  // while (true)
+
+  if (blockCompression != ChunkCompression::NONE) {
+    // outBlock is of maxItemSize_ bytes
+    const uint32_t capacity = (currentPos < maxItemSize_) ? std::min(maxSize, maxItemSize_ - currentPos) : 0;
+    uint32_t decompressedSize = 0;
+    {
+      TimeRecorder scoped_timer(*histograms_.dst_decompress_block_duration);
+      decompressedSize =
+          decompressBlock(blockCompression, dstCompressedBlock_.get(), compressedPos, outBlock + currentPos, capacity);
+    }
+    if (decompressedSize == 0) {
+      LOG_WARN(logger_, "Failed to decompress block:" << KVLOG(requiredBlock, blockCompression, compressedPos));
+      metrics_.dst_decompression_failures_++;
+      outBadDataDetected = true;
+      outLastChunkInRequiredBlock = 0;
+      return false;
+    }
+    currentPos += decompressedSize;
+    metrics_.dst_decompressed_blocks_++;
+    metrics_.dst_bytes_before_decompression_ += compressedPos;
+    metrics_.dst_bytes_after_decompression_ += decompressedSize;
+    const auto bytesAfterDecompression = metrics_.dst_bytes_after_decompression_.Get().Get();
+    if (bytesAfterDecompression > 0) {
+      metrics_.dst_compressed_size_percent_.Get().Set((100 * metrics_.dst_bytes_before_decompression_.Get().Get()) /
+                                                      bytesAfterDecompression);
+    }
+  }
+  outBlockSize = currentPos;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Striped fetching
+///////////////////////////////////////////////////////////////////////////
+
+void BCStateTran::trySendStripeFetchBlocksMsgs() {
+  if ((config_.maxNumOfStripeSources == 0) || (getFetchingState() != FetchingState::GettingMissingBlocks) ||
+      !fetchState_.isValid() || !sourceSelector_.hasSource()) {
+    return;
+  }
+
+  // Drop the stripes of replicas which are not stripe sources anymore (e.g. one of them became the current source)
+  const auto stripeSources = sourceSelector_.updateStripeSources();
+  for (auto it = stripes_.begin(); it != stripes_.end();) {
+    if (std::find(stripeSources.cbegin(), stripeSources.cend(), it->first) == stripeSources.cend()) {
+      it = eraseStripe(it);
+    } else {
+      ++it;
+    }
+  }
+
+  const uint64_t lastRequiredBlock = psd_->getLastRequiredBlock();
+  for (const auto replicaId : stripeSources) {
+    if (stripes_.count(replicaId) != 0) {
+      continue;
+    }
+    if (totalSizeOfStripeItemDataMsgs_ >= config_.maxPendingDataFromSourceReplica) {
+      break;
+    }
+    std::map<uint64_t, uint64_t> stripeRanges;
+    for (const auto &[id, stripe] : stripes_) {
+      (void)id;
+      stripeRanges.emplace(stripe.batch.minBlockId, stripe.batch.maxBlockId);
+    }
+    // The lowest block from blockId which is not fetched by another stripe, and the upper bound of its range
+    auto nextFreeRange = [&stripeRanges](uint64_t blockId) {
+      auto range = stripeRanges.lower_bound(blockId);
+      while ((range != stripeRanges.end()) && (range->first == blockId)) {
+        blockId = range->second + 1;
+        ++range;
+      }
+      const uint64_t upperBoundBlockId =
+          (range != stripeRanges.end()) ? (range->first - 1) : std::numeric_limits<uint64_t>::max();
+      return std::make_pair(blockId, upperBoundBlockId);
+    };
+    auto [minBlockId, upperBoundBlockId] = nextFreeRange(fetchState_.maxBlockId + 1);
+    if ((stripeSourceOfFetchState_ != NO_REPLICA) && (minBlockId <= lastRequiredBlock)) {
+      // The batch in fetchState_ was taken over from a stripe source. It is processed right away, and so are the
+      // complete stripes above it, while the current source is idle: a stripe right above them would never be complete
+      // in time. Leave the next batch to the current source.
+      const auto nextBatch = computeBatchToFetch(minBlockId, config_.maxNumberOfChunksInBatch, upperBoundBlockId);
+      std::tie(minBlockId, upperBoundBlockId) = nextFreeRange(nextBatch.maxBlockId + 1);
+    }
+    if (minBlockId > lastRequiredBlock) {
+      break;
+    }
+
+    auto &stripe = stripes_[replicaId];
+    stripe.batch = computeBatchToFetch(minBlockId, sourceSelector_.stripeWindow(replicaId), upperBoundBlockId);
+    stripe.startTimeMilli = getMonotonicTimeMilli();
+    stripe.lastActivityTimeMilli = stripe.startTimeMilli;
+    sendStripeFetchBlocksMsg(replicaId, stripe);
+  }
+  metrics_.num_stripes_.Get().Set(stripes_.size());
+}
+
+void BCStateTran::sendStripeFetchBlocksMsg(uint16_t replicaId, Stripe &stripe) {
+  // Ask only for the blocks which are not full yet. The source sends them from the highest to the lowest one.
+  uint64_t maxBlockId = stripe.batch.maxBlockId;
+  while (stripe.fullBlocks.count(maxBlockId) != 0) {
+    --maxBlockId;
+  }
+  ConcordAssertGE(maxBlockId, stripe.batch.minBlockId);
+
+  CompressedFetchBlocksMsg msg;
+  stripe.msgSeqNum = uniqueMsgSeqNum();
+  msg.msgSeqNum = stripe.msgSeqNum;
+  msg.minBlockId = stripe.batch.minBlockId;
+  msg.maxBlockId = maxBlockId;
+  msg.maxBlockIdInCycle = psd_->getLastRequiredBlock();
+  msg.lastKnownChunkInLastRequiredBlock = 0;
+  // RVB digests are piggybacked on the highest block of the batch
+  msg.rvbGroupId = (maxBlockId == stripe.batch.maxBlockId)
+                       ? rvbm_->getFetchBlocksRvbGroupId(stripe.batch.minBlockId, stripe.batch.maxBlockId)
+                       : 0;
+  msg.compression = static_cast<uint8_t>(config_.chunkCompression);
+
+  LOG_INFO(logger_,
+           "Sending stripe FetchBlocksMsg:" << KVLOG(replicaId,
+                                                     msg.msgSeqNum,
+                                                     msg.minBlockId,
+                                                     msg.maxBlockId,
+                                                     stripe.batch,
+                                                     sourceSelector_.stripeWindow(replicaId),
+                                                     msg.rvbGroupId));
+  replicaForStateTransfer_->sendStateTransferMessage(reinterpret_cast<char *>(&msg), msg.size(), replicaId);
+  metrics_.sent_stripe_fetch_blocks_msg_++;
+}
+
+bool BCStateTran::onStripeItemDataMsg(const ItemDataMsg *m, uint16_t replicaId) {
+  auto &stripe = stripes_.at(replicaId);
+  if (stripe.isComplete() || (stripe.batch.minBlockId > m->blockNumber) || (stripe.batch.maxBlockId < m->blockNumber) ||
+      (m->dataSize + totalSizeOfStripeItemDataMsgs_ > config_.maxPendingDataFromSourceReplica)) {
+    LOG_WARN(logger_,
+             "Stripe msg is irrelevant: " << KVLOG(replicaId,
+                                                   m->requestMsgSeqNum,
+                                                   stripe.msgSeqNum,
+                                                   m->blockNumber,
+                                                   stripe.batch,
+                                                   m->dataSize,
+                                                   totalSizeOfStripeItemDataMsgs_,
+                                                   config_.maxPendingDataFromSourceReplica));
+    metrics_.irrelevant_item_data_msg_++;
+    return true;
+  }
+
+  bool added = false;
+  tie(std::ignore, added) = stripe.items.insert(const_cast<ItemDataMsg *>(m));
+  if (!added) {
+    LOG_DEBUG(logger_, "Stripe ItemDataMsg was NOT added: " << KVLOG(replicaId, m->blockNumber, m->chunkNumber));
+    return true;
+  }
+  stripe.totalSize += m->dataSize;
+  totalSizeOfStripeItemDataMsgs_ += m->dataSize;
+  // The chunks are checked when the stripe is taken over, a block which is falsely counted as full is bad data
+  if (++stripe.numOfChunksReceived[m->blockNumber] >= m->totalNumberOfChunksInBlock) {
+    stripe.fullBlocks.insert(m->blockNumber);
+  }
+  const uint64_t currTime = getMonotonicTimeMilli();
+  stripe.lastActivityTimeMilli = currTime;
+  metrics_.received_stripe_item_data_msg_++;
+  metrics_.total_size_of_stripe_item_data_msgs_.Get().Set(totalSizeOfStripeItemDataMsgs_);
+
+  if (stripe.isComplete()) {
+    LOG_INFO(logger_, "Stripe is complete:" << KVLOG(replicaId, stripe.batch, stripe.totalSize));
+    sourceSelector_.onStripeCompleted(replicaId, stripe.totalSize, currTime - stripe.startTimeMilli);
+  } else if (m->lastInBatch) {
+    // The source is done with its batch (e.g. it is limited by its own batch size), ask for the rest
+    sendStripeFetchBlocksMsg(replicaId, stripe);
+  }
+  return false;
+}
+
+bool BCStateTran::takeOverStripe() {
+  stripeSourceOfFetchState_ = NO_REPLICA;
+  auto it = std::find_if(stripes_.begin(), stripes_.end(), [this](const auto &s) {
+    return s.second.batch.minBlockId == fetchState_.minBlockId;
+  });
+  if (it == stripes_.end()) {
+    return false;
+  }
+
+  const uint16_t replicaId = it->first;
+  auto &stripe = it->second;
+  if (!stripe.isComplete() ||
+      (stripe.totalSize + totalSizeOfPendingItemDataMsgs > config_.maxPendingDataFromSourceReplica)) {
+    // Too slow: the current source fetches the batch instead
+    LOG_INFO(logger_,
+             "Stripe is not taken over:" << KVLOG(replicaId, stripe.batch, fetchState_, stripe.fullBlocks.size()));
+    sourceSelector_.onStripeExpired(replicaId);
+    metrics_.stripes_expired_++;
+    eraseStripe(it);
+    metrics_.num_stripes_.Get().Set(stripes_.size());
+    return true;
+  }
+
+  LOG_INFO(logger_, "Taking over stripe:" << KVLOG(replicaId, stripe.batch, fetchState_, stripe.totalSize));
+  fetchState_ = stripe.batch;
+  for (auto *item : stripe.items) {
+    pendingItemDataMsgs.insert(item);
+  }
+  totalSizeOfPendingItemDataMsgs += stripe.totalSize;
+  totalSizeOfStripeItemDataMsgs_ -= stripe.totalSize;
+  stripe.items.clear();
+  stripes_.erase(it);
+  stripeSourceOfFetchState_ = replicaId;
+  metrics_.stripes_taken_over_++;
+  metrics_.num_stripes_.Get().Set(stripes_.size());
+  metrics_.num_pending_item_data_msgs_.Get().Set(pendingItemDataMsgs.size());
+  metrics_.total_size_of_pending_item_data_msgs_.Get().Set(totalSizeOfPendingItemDataMsgs);
+  metrics_.total_size_of_stripe_item_data_msgs_.Get().Set(totalSizeOfStripeItemDataMsgs_);
+  return true;
+}
+
+std::map<uint16_t, BCStateTran::Stripe>::iterator BCStateTran::eraseStripe(std::map<uint16_t, Stripe>::iterator it) {
+  for (auto *item : it->second.items) {
+    replicaForStateTransfer_->freeStateTransferMsg(reinterpret_cast<char *>(item));
+  }
+  ConcordAssertGE(totalSizeOfStripeItemDataMsgs_, it->second.totalSize);
+  totalSizeOfStripeItemDataMsgs_ -= it->second.totalSize;
+  metrics_.total_size_of_stripe_item_data_msgs_.Get().Set(totalSizeOfStripeItemDataMsgs_);
+  return stripes_.erase(it);
+}
+
+void BCStateTran::clearAllStripes() {
+  for (auto it = stripes_.begin(); it != stripes_.end();) {
+    it = eraseStripe(it);
+  }
+  ConcordAssertEQ(totalSizeOfStripeItemDataMsgs_, 0);
+  metrics_.num_stripes_.Get().Set(0);
+}
+
+void BCStateTran::cancelExpiredStripes(uint64_t currTimeMilli) {
+  bool expired = false;
+  for (auto it = stripes_.begin(); it != stripes_.end();) {
+    const auto &stripe = it->second;
+    if (!stripe.isComplete() && (currTimeMilli - stripe.lastActivityTimeMilli > config_.fetchRetransmissionTimeoutMs)) {
+      LOG_WARN(logger_, "Stripe expired:" << KVLOG(it->first, stripe.batch, stripe.fullBlocks.size()));
+      sourceSelector_.onStripeExpired(it->first);
+      metrics_.stripes_expired_++;
+      it = eraseStripe(it);
+      expired = true;
+    } else {
+      ++it;
+    }
+  }
+  if (expired) {
+    trySendStripeFetchBlocksMsgs();
+  }
+}
+
+uint64_t BCStateTran::minStripeBlockIdAbove(uint64_t blockId) const {
+  uint64_t minBlockId = 0;
+  for (const auto &[replicaId, stripe] : stripes_) {
+    (void)replicaId;
+    if ((stripe.batch.minBlockId > blockId) && ((minBlockId == 0) || (stripe.batch.minBlockId < minBlockId))) {
+      minBlockId = stripe.batch.minBlockId;
+    }
+  }
+  return minBlockId;
 }
 
 bool BCStateTran::checkBlock(uint64_t blockId, char *block, uint32_t blockSize) const {
@@ -3073,14 +3605,33 @@ bool BCStateTran::finalizePutblockAsync(PutBlockWaitPolicy waitPolicy, DataStore
 // Compute the next batch reqired, taking into accont: minRequiredBlockId
 // and configuration parameters fetchRangeSize and maxNumberOfChunksInBatch
 BCStateTran::BlocksBatchDesc BCStateTran::computeNextBatchToFetch(uint64_t minRequiredBlockId) {
-  uint64_t maxRequiredBlockId = minRequiredBlockId + config_.maxNumberOfChunksInBatch - 1;
+  // Do not overlap the stripes which are fetched from other sources
+  const auto minStripeBlockId = minStripeBlockIdAbove(minRequiredBlockId);
+  const auto upperBoundBlockId =
+      (minStripeBlockId > 0) ? (minStripeBlockId - 1) : std::numeric_limits<uint64_t>::max();
+  BlocksBatchDesc fetchBatch =
+      computeBatchToFetch(minRequiredBlockId, config_.maxNumberOfChunksInBatch, upperBoundBlockId);
+  digestOfNextRequiredBlock_.makeZero();
+  ConcordAssertLT(fetchState_.nextBlockId, config_.maxNumberOfChunksInBatch + fetchBatch.minBlockId);
+  LOG_INFO(logger_, KVLOG(minRequiredBlockId, fetchBatch, minStripeBlockId));
+  return fetchBatch;
+}
+
+// Compute a batch of at most maxNumOfBlocks blocks starting at minRequiredBlockId, which ends at an RVB (if there is
+// one in range) and does not cross upperBoundBlockId or the border of an RVB group
+BCStateTran::BlocksBatchDesc BCStateTran::computeBatchToFetch(uint64_t minRequiredBlockId,
+                                                               uint64_t maxNumOfBlocks,
+                                                               uint64_t upperBoundBlockId) const {
+  ConcordAssertGT(maxNumOfBlocks, 0);
+  ConcordAssertLE(minRequiredBlockId, upperBoundBlockId);
+  uint64_t maxRequiredBlockId = minRequiredBlockId + maxNumOfBlocks - 1;
   if (!isRvbBlockId(maxRequiredBlockId)) {
     uint64_t deltaToNearestRVB = maxRequiredBlockId % config_.fetchRangeSize;
     if ((maxRequiredBlockId >= deltaToNearestRVB) && (maxRequiredBlockId - deltaToNearestRVB >= minRequiredBlockId))
       maxRequiredBlockId = maxRequiredBlockId - deltaToNearestRVB;
   }
   auto lastRequiredBlock = psd_->getLastRequiredBlock();
-  maxRequiredBlockId = std::min(maxRequiredBlockId, lastRequiredBlock);
+  maxRequiredBlockId = std::min({maxRequiredBlockId, lastRequiredBlock, upperBoundBlockId});
 
   // Check with RVB manager that we are not between borders of RVB groups. This is rare, but we want to avoid the case
   // where we will need to ask for multiple digest groups. This make code more complicated.
@@ -3091,10 +3642,10 @@ BCStateTran::BlocksBatchDesc BCStateTran::computeNextBatchToFetch(uint64_t minRe
   fetchBatch.nextBlockId = maxRequiredBlockId;
   fetchBatch.upperBoundBlockId = maxRequiredBlockId;
   fetchBatch.minBlockId = minRequiredBlockId;
-  digestOfNextRequiredBlock_.makeZero();
   ConcordAssert(fetchBatch.isValid());
-  ConcordAssertLT(fetchState_.nextBlockId, config_.maxNumberOfChunksInBatch + fetchBatch.minBlockId);
-  LOG_INFO(logger_, KVLOG(minRequiredBlockId, maxRequiredBlockId, rvbmUpperBound, fetchBatch, lastRequiredBlock));
+  LOG_DEBUG(
+      logger_,
+      KVLOG(minRequiredBlockId, maxNumOfBlocks, upperBoundBlockId, rvbmUpperBound, fetchBatch, lastRequiredBlock));
   return fetchBatch;
 }
 
@@ -3185,6 +3736,7 @@ void BCStateTran::stReset(DataStoreTransaction *txn, bool resetRvbm, bool resetS
   }
   digestOfNextRequiredBlock_.makeZero();
   clearAllPendingItemsData();
+  clearAllStripes();
   clearInfoAboutGettingCheckpointSummary();
   fetchState_.reset();
   commitState_.reset();
@@ -3211,6 +3763,7 @@ void BCStateTran::stReset(DataStoreTransaction *txn, bool resetRvbm, bool resetS
   summariesCerts.clear();
   numOfSummariesFromOtherReplicas.clear();
   clearIoContexts();
+  clearSrcReadAhead();
   ConcordAssert(ioPool_.full());
   verifyEmptyInfoAboutGettingCheckpointSummary();
 
@@ -3233,7 +3786,7 @@ void BCStateTran::stReset(DataStoreTransaction *txn, bool resetRvbm, bool resetS
   }
 }
 
-void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
+void BCStateTran::processData(bool lastInBatch) {
   const FetchingState fs = getFetchingState();
   const auto fetchingState = fs;
   LOG_DEBUG(logger_, KVLOG(fetchingState));
@@ -3264,6 +3817,7 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
       if (srcReplacementMode == SourceReplacementMode::IMMEDIATE) {
         clearAllPendingItemsData();
       }
+      trySendStripeFetchBlocksMsgs();
     }
 
     // We have a valid source replica at this point
@@ -3293,6 +3847,7 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
     //////////////////////////////////////////////////////////////////////////
     int16_t lastChunkInRequiredBlock = 0;
     uint32_t actualBuffersize = 0;
+    uint32_t rvbDigestsSize = 0;
 
     // TODO (GL) - for now (for simplicity) to support chunking, we call with buffer_ as an input. Later on we copy
     // buffer_ into BlockIOContext::blockData when the block is full.
@@ -3304,6 +3859,7 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
                                            lastChunkInRequiredBlock,
                                            buffer_.get(),
                                            actualBuffersize,
+                                           rvbDigestsSize,
                                            !isGettingBlocks);
     bool newBlockIsValid = false;
     char *blockData = buffer_.get() + rvbDigestsSize;
@@ -3313,7 +3869,10 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
       TimeRecorder scoped_timer(*histograms_.dst_digest_calc_duration);
       ConcordAssert(!badDataFromCurrentSourceReplica);
 
-      if (rvbDigestsSize > 0) {
+      // The digests might have been already set while fetching a lower batch of the same RVB group: a stripe is
+      // requested before the batches below it are validated.
+      if ((rvbDigestsSize > 0) &&
+          (rvbm_->getFetchBlocksRvbGroupId(fetchState_.minBlockId, fetchState_.maxBlockId) != 0)) {
         LOG_INFO(logger_, "Setting RVB digests into RVB manager:" << KVLOG(rvbDigestsSize));
         if (!rvbm_->setSerializedDigestsOfRvbGroup(rvbDigests,
                                                    rvbDigestsSize,
@@ -3344,6 +3903,20 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
       ConcordAssertAND(!newBlock, actualBuffersize == 0);
     }
 
+    if (!newBlockIsValid && (stripeSourceOfFetchState_ != NO_REPLICA)) {
+      // The batch was taken over complete from a stripe source, hence a missing or an invalid block is bad data from
+      // that source, and not from the current source. Fetch the rest of the batch from the current source.
+      LOG_WARN(logger_,
+               "Bad data from stripe source:" << KVLOG(stripeSourceOfFetchState_, fetchState_, newBlock));
+      metrics_.bad_data_from_stripe_source_++;
+      sourceSelector_.removeStripeSource(stripeSourceOfFetchState_);
+      clearAllPendingItemsData();
+      DataStoreTransaction::Guard g(psd_->beginTransaction());
+      finalizePutblockAsync(PutBlockWaitPolicy::NO_WAIT, g.txn());
+      trySendFetchBlocksMsg(0, "bad data from stripe source");
+      break;
+    }
+
     LOG_DEBUG(logger_,
               std::boolalpha << KVLOG(newBlock,
                                       newBlockIsValid,
@@ -3361,7 +3934,9 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
         //////////////////////////////////////////////////////////////////////////
         ConcordAssertAND(lastChunkInRequiredBlock >= 1, actualBuffersize > 0);
 
-        sourceSelector_.onReceivedValidBlockFromSource();
+        if (stripeSourceOfFetchState_ == NO_REPLICA) {
+          sourceSelector_.onReceivedValidBlockFromSource();
+        }
         bool lastFetchedBlockIdInCycle = isLastFetchedBlockIdInCycle(fetchState_.nextBlockId);
         bool minBlockIdInCurrentBatch = fetchState_.isMinBlockId(fetchState_.nextBlockId);
 
@@ -3391,6 +3966,8 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
           histograms_.dst_num_pending_blocks_to_commit->record(ioContexts_.size());
           as_->getPrevDigestFromBlock(
               blockData, blockDataSize, reinterpret_cast<StateTransferDigest *>(&digestOfNextRequiredBlock_));
+          // The current source has nothing to send if the batch was taken over from a stripe source
+          bool currentSourceIdle = false;
           if (minBlockIdInCurrentBatch) {
             //////////////////////////////////////////////////////////////////////////
             // Last block Collected in batch!
@@ -3403,7 +3980,11 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
             // TODO - it should be possible to push fetchState_ into a new data structure and replace it with
             // commitState upperBound  work on in the next batch
             finalizePutblockAsync(PutBlockWaitPolicy::WAIT_ALL_JOBS, g.txn());
+            currentSourceIdle = (stripeSourceOfFetchState_ != NO_REPLICA);
             fetchState_ = computeNextBatchToFetch(nextBatcheMinBlockId);
+            if (takeOverStripe()) {
+              trySendStripeFetchBlocksMsgs();
+            }
             commitState_ = fetchState_;
             LOG_TRACE(logger_, KVLOG(fetchState_, nextBatcheMinBlockId));
             ConcordAssert(commitState_.isValid());
@@ -3413,8 +3994,10 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
           } else {
             --fetchState_.nextBlockId;
           }
-          if (lastInBatch || postponedSendFetchBlocksMsg_ || newSourceReplica) {
-            trySendFetchBlocksMsg(0, KVLOG(lastInBatch, postponedSendFetchBlocksMsg_, newSourceReplica));
+          if ((stripeSourceOfFetchState_ == NO_REPLICA) &&
+              (lastInBatch || postponedSendFetchBlocksMsg_ || newSourceReplica || currentSourceIdle)) {
+            trySendFetchBlocksMsg(
+                0, KVLOG(lastInBatch, postponedSendFetchBlocksMsg_, newSourceReplica, currentSourceIdle));
             break;
           }
         } else {  // lastFetchedBlockIdInCycle == true
@@ -3572,6 +4155,7 @@ void BCStateTran::onGettingMissingBlocksEnd(DataStoreTransaction *txn) {
   fetchState_.reset();
   commitState_.reset();
   clearAllPendingItemsData();
+  clearAllStripes();
   digestOfNextRequiredBlock_ = targetCheckpointDesc_.digestOfResPagesDescriptor;
   txn->setFirstRequiredBlock(0);
   txn->setLastRequiredBlock(0);
@@ -4062,6 +4646,7 @@ void BCStateTran::SourceBatch::init(uint64_t batchNumber,
                                     const Config &config,
                                     size_t rvbGroupDigestsExpectedSize,
                                     const FetchBlocksMsg *msg,
+                                    ChunkCompression compression,
                                     uint16_t destReplicaId) {
   numSentBytes = 0;
   numSentChunks = 0;
@@ -4078,6 +4663,10 @@ void BCStateTran::SourceBatch::init(uint64_t batchNumber,
   this->rvbGroupDigestsExpectedSize = rvbGroupDigestsExpectedSize;
   this->destRequest = *msg;
   this->destReplicaId = destReplicaId;
+  this->compression = compression;
+  preparedBlockId = 0;
+  blockCompression = ChunkCompression::NONE;
+  blockSize = 0;
 }
 
 }  // namespace impl
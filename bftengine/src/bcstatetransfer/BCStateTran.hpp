@@ -32,6 +32,7 @@
 #include "Messages.hpp"
 #include "Metrics.hpp"
 #include "SourceSelector.hpp"
+#include "SourceBlockCache.hpp"
 #include "callback_registry.hpp"
 #include "Handoff.hpp"
 #include "SysConsts.hpp"
@@ -282,6 +283,10 @@ class BCStateTran : public IStateTransfer {
   IReplicaForStateTransfer* replicaForStateTransfer_;
 
   std::unique_ptr<char[]> buffer_;  // general use buffer
+  // Compressed blocks (see BlockCompression.hpp), allocated on first use: the block being sent by a source, and the
+  // block being assembled from chunks by a destination
+  std::unique_ptr<char[]> srcCompressedBlock_;
+  std::unique_ptr<char[]> dstCompressedBlock_;
 
   // random generator
   std::random_device randomDevice_;
@@ -453,6 +458,43 @@ class BCStateTran : public IStateTransfer {
   set<ItemDataMsg*, compareItemDataMsg> pendingItemDataMsgs;
   uint32_t totalSizeOfPendingItemDataMsgs = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // Striped fetching
+  ///////////////////////////////////////////////////////////////////////////
+
+  // A batch of blocks above fetchState_, requested from a stripe source (see SourceSelector). Its chunks are kept aside
+  // until fetchState_ reaches the batch, and are then moved into pendingItemDataMsgs if the batch is complete, so that
+  // the blocks are still validated from the highest to the lowest one. Stripes are aligned to fetch ranges, the same
+  // way batches fetched from the current source are.
+  struct Stripe {
+    BlocksBatchDesc batch;
+    uint64_t msgSeqNum = 0;
+    uint64_t startTimeMilli = 0;
+    uint64_t lastActivityTimeMilli = 0;
+    set<ItemDataMsg*, compareItemDataMsg> items;
+    std::map<uint64_t, uint16_t> numOfChunksReceived;
+    std::set<uint64_t> fullBlocks;
+    uint32_t totalSize = 0;
+
+    bool isComplete() const { return fullBlocks.size() == (batch.maxBlockId - batch.minBlockId + 1); }
+  };
+
+  // Stripes by the ID of their source replica
+  std::map<uint16_t, Stripe> stripes_;
+  uint32_t totalSizeOfStripeItemDataMsgs_ = 0;
+  // The stripe source the batch in fetchState_ was taken over from, NO_REPLICA if it is fetched from the current source
+  uint16_t stripeSourceOfFetchState_ = NO_REPLICA;
+
+  void trySendStripeFetchBlocksMsgs();
+  void sendStripeFetchBlocksMsg(uint16_t replicaId, Stripe& stripe);
+  bool onStripeItemDataMsg(const ItemDataMsg* m, uint16_t replicaId);
+  bool takeOverStripe();
+  std::map<uint16_t, Stripe>::iterator eraseStripe(std::map<uint16_t, Stripe>::iterator it);
+  void clearAllStripes();
+  void cancelExpiredStripes(uint64_t currTimeMilli);
+  // The lowest block ID of a stripe above blockId, 0 if there is none
+  uint64_t minStripeBlockIdAbove(uint64_t blockId) const;
+
   void stReset(DataStoreTransaction* txn,
                bool resetRvbm = false,
                bool resetStoredCp = false,
@@ -464,19 +506,23 @@ class BCStateTran : public IStateTransfer {
                         int16_t& outLastChunkInRequiredBlock,
                         char* outBlock,
                         uint32_t& outBlockSize,
+                        uint32_t& outRvbDigestsSize,
                         bool isVBLock);
 
   // enter a new cycle internally
   void startCollectingStateInternal();
 
   BlocksBatchDesc computeNextBatchToFetch(uint64_t minRequiredBlockId);
+  BlocksBatchDesc computeBatchToFetch(uint64_t minRequiredBlockId,
+                                      uint64_t maxNumOfBlocks,
+                                      uint64_t upperBoundBlockId) const;
   bool checkBlock(uint64_t blockNum, char* block, uint32_t blockSize) const;
 
   bool checkVirtualBlockOfResPages(const Digest& expectedDigestOfResPagesDescriptor,
                                    char* vblock,
                                    uint32_t vblockSize) const;
 
-  void processData(bool lastInBatch = false, uint32_t rvbDigestsSize = 0);
+  void processData(bool lastInBatch = false);
   void cycleEndSummary();
   void onGettingMissingBlocksEnd(DataStoreTransaction* txn);
   set<uint16_t> allOtherReplicas();
@@ -558,6 +604,32 @@ class BCStateTran : public IStateTransfer {
   void sourcePrepareBatch(uint64_t numBlocksRequested);
   void clearIoContexts();
 
+  ///////////////////////////////////////////////////////////////////////////
+  // Source read ahead
+  //
+  // Once a destination fetches batches sequentially, the source reads ahead (async) up to
+  // config_.sourceReadAheadBlocks blocks above the last requested batch. The blocks read are kept in srcBlockCache_
+  // and the next batches are served from memory. Read ahead contexts are allocated from ioPool_, which has
+  // numSrcReadAheadContexts() more contexts than needed for a batch.
+  ///////////////////////////////////////////////////////////////////////////
+  SourceBlockCache srcBlockCache_;
+  std::deque<BlockIOContextPtr> srcReadAheadContexts_;
+  uint16_t srcReadAheadDestReplicaId_;
+  uint64_t srcLastRequestedMaxBlockId_;
+  // Next block to read ahead, and the last block of the read ahead window. The window is empty if the former is greater
+  uint64_t srcReadAheadNextBlockId_;
+  uint64_t srcReadAheadMaxBlockId_;
+
+  uint16_t numSrcReadAheadContexts() const;
+  // Detect if the destination fetches batches sequentially, and update the read ahead window accordingly
+  void srcUpdateReadAhead(const FetchBlocksMsg* m, uint16_t replicaId);
+  // Move the blocks read so far into srcBlockCache_ and read ahead the next blocks in the window
+  void srcContinueReadAhead();
+  // Cache the block of a context once the block is read. If wait is false, skip the context if not done yet.
+  // Return true if the context is done.
+  bool srcCacheBlockOfContext(BlockIOContextPtr& ctx, bool wait);
+  void clearSrcReadAhead();
+
   // lastBlock: is true if we put the oldest block (firstRequiredBlock)
   //
   // waitPolicy:
@@ -678,6 +750,31 @@ class BCStateTran : public IStateTransfer {
     GaugeHandle src_num_io_contexts_dropped_;
     GaugeHandle src_num_io_contexts_invoked_;
     CounterHandle src_num_io_contexts_consumed_;
+
+    GaugeHandle num_stripes_;
+    GaugeHandle total_size_of_stripe_item_data_msgs_;
+    CounterHandle sent_stripe_fetch_blocks_msg_;
+    CounterHandle received_stripe_item_data_msg_;
+    CounterHandle stripes_taken_over_;
+    CounterHandle stripes_expired_;
+    CounterHandle bad_data_from_stripe_source_;
+
+    CounterHandle src_compressed_blocks_;
+    CounterHandle src_bytes_before_compression_;
+    CounterHandle src_bytes_after_compression_;
+    GaugeHandle src_compressed_size_percent_;
+    CounterHandle dst_decompressed_blocks_;
+    CounterHandle dst_bytes_before_decompression_;
+    CounterHandle dst_bytes_after_decompression_;
+    GaugeHandle dst_compressed_size_percent_;
+    CounterHandle dst_decompression_failures_;
+
+    CounterHandle src_read_ahead_blocks_;
+    CounterHandle src_block_cache_hits_;
+    CounterHandle src_block_cache_misses_;
+    CounterHandle src_block_cache_evictions_;
+    GaugeHandle src_block_cache_num_blocks_;
+    GaugeHandle src_block_cache_size_bytes_;
   };
   mutable Metrics metrics_;
   Metrics createRegisterMetrics();
@@ -798,7 +895,11 @@ class BCStateTran : public IStateTransfer {
           getNextBlock{false},
           rvbGroupDigestsExpectedSize{0},
           destReplicaId{0},
-          prefetched{false} {}
+          prefetched{false},
+          compression{ChunkCompression::NONE},
+          preparedBlockId{0},
+          blockCompression{ChunkCompression::NONE},
+          blockSize{0} {}
     std::string toString() const;
     void init(uint64_t batchNumber,
               uint64_t maxBlockId,
@@ -808,6 +909,7 @@ class BCStateTran : public IStateTransfer {
               const Config& config,
               size_t rvbGroupDigestsExpectedSize,
               const FetchBlocksMsg* msg,
+              ChunkCompression compression,
               uint16_t destReplicaId);
 
     bool active;
@@ -822,6 +924,11 @@ class BCStateTran : public IStateTransfer {
     FetchBlocksMsg destRequest;
     uint16_t destReplicaId;
     bool prefetched;  // true if this batch succeed with pre-fetch prediction
+    ChunkCompression compression;  // asked by the destination
+    // The block being sent, once compressed (if it shrinks)
+    uint64_t preparedBlockId;
+    ChunkCompression blockCompression;
+    uint32_t blockSize;
   };
 
   SourceBatch sourceBatch_;
@@ -829,6 +936,8 @@ class BCStateTran : public IStateTransfer {
 
   friend std::ostream& operator<<(std::ostream& os, const BCStateTran::SourceBatch& batch);
   void continueSendBatch();
+  // Compress the next block to send, if asked by the destination
+  void prepareBlockToSend(const BlockIOContext& ctx);
   void sendRejectFetchingMsg(const uint16_t rejectionCode,
                              uint64_t msgSeqNum,
                              uint16_t destReplicaId,
@@ -862,7 +971,8 @@ class BCStateTran : public IStateTransfer {
                                         dst_num_pending_blocks_to_commit,
                                         dst_digest_calc_duration,
                                         dst_time_ItemData_msg_in_incoming_events_queue,
-                                        time_in_post_processing_events_queue});
+                                        time_in_post_processing_events_queue,
+                                        dst_decompress_block_duration});
       // source component
       registrar.perf.registerComponent("state_transfer_src",
                                        {src_handle_FetchBlocks_msg_duration,
@@ -873,7 +983,8 @@ class BCStateTran : public IStateTransfer {
                                         src_send_on_spot_batch_duration,
                                         src_send_batch_size_bytes,
                                         src_send_batch_num_of_chunks,
-                                        src_next_block_wait_duration});
+                                        src_next_block_wait_duration,
+                                        src_compress_block_duration});
     }
     ~Recorders() {
       auto& registrar = concord::diagnostics::RegistrarSingleton::getInstance();
@@ -911,6 +1022,8 @@ class BCStateTran : public IStateTransfer {
                            concord::diagnostics::Unit::MICROSECONDS);
     DEFINE_SHARED_RECORDER(
         time_in_post_processing_events_queue, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        dst_decompress_block_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
     // source
     DEFINE_SHARED_RECORDER(
         src_handle_FetchBlocks_msg_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
@@ -928,6 +1041,8 @@ class BCStateTran : public IStateTransfer {
         src_send_batch_num_of_chunks, 1, MAX_BATCH_SIZE_BLOCKS, 3, concord::diagnostics::Unit::COUNT);
     DEFINE_SHARED_RECORDER(
         src_next_block_wait_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        src_compress_block_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
   };
   Recorders histograms_;
 
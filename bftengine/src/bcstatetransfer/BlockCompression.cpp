@@ -0,0 +1,67 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "BlockCompression.hpp"
+
+#include <lz4.h>
+#include <zstd.h>
+
+namespace bftEngine::bcst::impl {
+
+namespace {
+// Favor speed: a source replica compresses the blocks it sends in its main thread
+constexpr int kZstdLevel = 1;
+}  // namespace
+
+bool isValidChunkCompression(uint8_t compression) {
+  return compression <= static_cast<uint8_t>(ChunkCompression::ZSTD);
+}
+
+uint32_t compressBlock(
+    ChunkCompression compression, const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity) {
+  size_t compressedSize = 0;
+  switch (compression) {
+    case ChunkCompression::NONE:
+      return 0;
+    case ChunkCompression::LZ4: {
+      const auto size = LZ4_compress_default(src, dst, static_cast<int>(srcSize), static_cast<int>(dstCapacity));
+      compressedSize = (size > 0) ? static_cast<size_t>(size) : 0;
+      break;
+    }
+    case ChunkCompression::ZSTD: {
+      const auto size = ZSTD_compress(dst, dstCapacity, src, srcSize, kZstdLevel);
+      compressedSize = ZSTD_isError(size) ? 0 : size;
+      break;
+    }
+  }
+  return (compressedSize < srcSize) ? static_cast<uint32_t>(compressedSize) : 0;
+}
+
+uint32_t decompressBlock(
+    ChunkCompression compression, const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity) {
+  switch (compression) {
+    case ChunkCompression::NONE:
+      return 0;
+    case ChunkCompression::LZ4: {
+      const auto size = LZ4_decompress_safe(src, dst, static_cast<int>(srcSize), static_cast<int>(dstCapacity));
+      return (size > 0) ? static_cast<uint32_t>(size) : 0;
+    }
+    case ChunkCompression::ZSTD: {
+      const auto size = ZSTD_decompress(dst, dstCapacity, src, srcSize);
+      return ZSTD_isError(size) ? 0 : static_cast<uint32_t>(size);
+    }
+  }
+  return 0;
+}
+
+}  // namespace bftEngine::bcst::impl
@@ -0,0 +1,37 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <cstdint>
+
+#include "SimpleBCStateTransfer.hpp"
+
+namespace bftEngine::bcst::impl {
+
+// Compression of the blocks a source replica sends in ItemDataMsg chunks. A block is compressed as a whole and the
+// compressed block is then split into chunks. The RVB digests piggybacked on the 1st chunk are never compressed.
+
+bool isValidChunkCompression(uint8_t compression);
+
+// Compress src into dst and return the compressed size. Return 0 if the block does not shrink or does not fit into
+// dstCapacity, in which case it should be sent as is.
+uint32_t compressBlock(
+    ChunkCompression compression, const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity);
+
+// Decompress src into dst and return the decompressed size. Return 0 if src is corrupted or does not fit into
+// dstCapacity.
+uint32_t decompressBlock(
+    ChunkCompression compression, const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity);
+
+}  // namespace bftEngine::bcst::impl
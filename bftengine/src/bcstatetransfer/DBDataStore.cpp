@@ -2,6 +2,7 @@
 #include "DBDataStore.hpp"
 #include "storage/db_interface.h"
 #include "Serializable.h"
+#include "RangeValidationTree.hpp"
 
 using concord::serialize::Serializable;
 
@@ -101,6 +102,7 @@ void DBDataStore::load(bool loadResPages_) {
     deserializePrunedBlocksDigests(iss, digests);
     inmem_->setPrunedBlocksDigests(digests);
   }
+  loadRvbDataChain();
   memoryStateToLog();
 
   if (get<bool>(EraseDataOnStartup)) {
@@ -173,24 +175,31 @@ void DBDataStore::setReplicas(const std::set<std::uint16_t>& replicas) {
 /** ******************************************************************************************************************
  *  Checkpoint
  */
-void DBDataStore::serializeCheckpoint(std::ostream& os, const CheckpointDesc& desc) const {
+void DBDataStore::serializeCheckpoint(std::ostream& os, const CheckpointDesc& desc, bool rvbDataIsChained) const {
+  static const std::vector<char> noRvbData;
   Serializable::serialize(os, desc.checkpointNum);
   Serializable::serialize(os, desc.maxBlockId);
   Serializable::serialize(os, desc.digestOfMaxBlockId.get(), DIGEST_SIZE);
   Serializable::serialize(os, desc.digestOfResPagesDescriptor.get(), DIGEST_SIZE);
-  Serializable::serialize(os, desc.rvbData);
+  Serializable::serialize(os, rvbDataIsChained ? noRvbData : desc.rvbData);
+  Serializable::serialize(os, rvbDataIsChained);
 }
-void DBDataStore::deserializeCheckpoint(std::istream& is, CheckpointDesc& desc) const {
+bool DBDataStore::deserializeCheckpoint(std::istream& is, CheckpointDesc& desc) const {
   Serializable::deserialize(is, desc.checkpointNum);
   Serializable::deserialize(is, desc.maxBlockId);
   Serializable::deserialize(is, desc.digestOfMaxBlockId.getForUpdate(), DIGEST_SIZE);
   Serializable::deserialize(is, desc.digestOfResPagesDescriptor.getForUpdate(), DIGEST_SIZE);
   Serializable::deserialize(is, desc.rvbData);
+  // Descriptors persisted before the RVB data chain was introduced end here
+  bool rvbDataIsChained = false;
+  if (is.peek() != std::istream::traits_type::eof()) Serializable::deserialize(is, rvbDataIsChained);
+  return rvbDataIsChained;
 }
 void DBDataStore::setCheckpointDesc(uint64_t checkpoint, const CheckpointDesc& desc, const bool checkIfAlreadyExists) {
-  LOG_DEBUG(logger(), toString(desc));
+  LOG_DEBUG(logger(), toString(desc) << " rvbDataDelta size:" << desc.rvbDataDelta.size());
+  const bool rvbDataIsChained = !desc.rvbData.empty() && chainRvbData(checkpoint, desc);
   std::ostringstream oss;
-  serializeCheckpoint(oss, desc);
+  serializeCheckpoint(oss, desc, rvbDataIsChained);
   put(chkpDescKey(checkpoint), oss.str());
   inmem_->setCheckpointDesc(checkpoint, desc, checkIfAlreadyExists);
 }
@@ -200,7 +209,7 @@ bool DBDataStore::hasCheckpointDesc(uint64_t checkpoint) {
   if (!get(chkpDescKey(checkpoint), val)) return false;
   std::istringstream iss(std::string(reinterpret_cast<const char*>(val.data()), val.length()));
   DataStore::CheckpointDesc cpd;
-  deserializeCheckpoint(iss, cpd);
+  if (deserializeCheckpoint(iss, cpd)) cpd.rvbData = getChainedRvbData(checkpoint);
   inmem_->setCheckpointDesc(checkpoint, cpd);
   return true;
 }
@@ -237,6 +246,7 @@ void DBDataStore::deleteDescOfSmallerCheckpoints(uint64_t checkpoint) {
     deleteDescOfSmallerCheckpointsTxn(checkpoint, g.txn());
   }
   inmem_->deleteDescOfSmallerCheckpoints(checkpoint);
+  compactRvbDataChain(checkpoint);
 }
 void DBDataStore::setCheckpointBeingFetched(const CheckpointDesc& desc) {
   LOG_DEBUG(logger(), toString(desc));
@@ -457,6 +467,7 @@ void DBDataStore::clearDataStoreData() {
   deleteCheckpointBeingFetched();
   deleteAllResPages();
   deleteAllDesc();
+  deleteRvbDataChain();
 
   inmem_.reset(new InMemoryDataStore(inmem_->getSizeOfReservedPage()));
 }
@@ -493,6 +504,210 @@ void DBDataStore::setPrunedBlocksDigests(const std::vector<std::pair<BlockId, Di
   inmem_->setPrunedBlocksDigests(digests);
 }
 
+/** ******************************************************************************************************************
+ *  RVB data chain
+ *
+ *  Base record:  [checkpoint][rvbData]
+ *  Delta record: [checkpoint][previous checkpoint][rvbDataDelta]
+ */
+void DBDataStore::loadRvbDataChain() {
+  Sliver base;
+  if (!get(RvbDataBase, base)) return;
+  auto& chain = *rvbDataChain_;
+  std::istringstream iss(std::string(reinterpret_cast<const char*>(base.data()), base.length()));
+  Serializable::deserialize(iss, chain.baseCheckpoint);
+  chain.baseSize = base.length();
+
+  for (auto checkpoint = get<uint64_t>(RvbDataLastCheckpoint); checkpoint > chain.baseCheckpoint;) {
+    Sliver delta;
+    uint64_t deltaCheckpoint{0};
+    uint64_t prevCheckpoint{0};
+    if (get(rvbDataDeltaKey(checkpoint), delta)) {
+      std::istringstream diss(std::string(reinterpret_cast<const char*>(delta.data()), delta.length()));
+      Serializable::deserialize(diss, deltaCheckpoint);
+      Serializable::deserialize(diss, prevCheckpoint);
+    }
+    if ((deltaCheckpoint != checkpoint) || (prevCheckpoint >= checkpoint)) {
+      LOG_ERROR(logger(), "Broken RVB data chain:" << KVLOG(checkpoint, deltaCheckpoint, prevCheckpoint));
+      break;
+    }
+    chain.deltaSizes[checkpoint] = delta.length();
+    checkpoint = prevCheckpoint;
+  }
+  LOG_INFO(logger(),
+           "RVB data chain:" << KVLOG(
+               chain.baseCheckpoint, chain.baseSize, chain.lastCheckpoint(), chain.deltaSizes.size()));
+}
+
+void DBDataStore::putRvbDataBase(uint64_t checkpoint, const std::vector<char>& rvbData) {
+  std::ostringstream oss;
+  Serializable::serialize(oss, checkpoint);
+  Serializable::serialize(oss, rvbData);
+  put(RvbDataBase, oss.str());
+  rvbDataChain_->baseCheckpoint = checkpoint;
+  rvbDataChain_->baseSize = rvbData.size();
+}
+
+bool DBDataStore::chainRvbData(uint64_t checkpoint, const CheckpointDesc& desc) {
+  // All stored checkpoints must fit into the chain, along with the obsolete deltas kept until the base moves forward
+  if (inmem_->getMaxNumOfStoredCheckpoints() >= kMaxRvbDataChainLength / 2) return false;
+  auto& chain = *rvbDataChain_;
+  const auto lastCheckpoint = chain.lastCheckpoint();
+  if ((chain.baseCheckpoint > 0) && (checkpoint > lastCheckpoint) &&
+      (checkpoint - chain.baseCheckpoint < kMaxRvbDataDeltas) && (chain.deltaSizes.size() < kMaxRvbDataChainLength) &&
+      !desc.rvbDataDelta.empty() && (desc.rvbDataDeltaBase == lastCheckpoint)) {
+    std::ostringstream oss;
+    Serializable::serialize(oss, checkpoint);
+    Serializable::serialize(oss, lastCheckpoint);
+    Serializable::serialize(oss, desc.rvbDataDelta);
+    put(rvbDataDeltaKey(checkpoint), oss.str());
+    putInt(RvbDataLastCheckpoint, checkpoint);
+    chain.deltaSizes[checkpoint] = desc.rvbDataDelta.size();
+    LOG_DEBUG(logger(), KVLOG(checkpoint, lastCheckpoint, desc.rvbDataDelta.size()));
+    return true;
+  }
+  if ((chain.baseCheckpoint > 0) && (checkpoint <= lastCheckpoint)) {
+    const bool inChain = (checkpoint == chain.baseCheckpoint) || (chain.deltaSizes.count(checkpoint) > 0);
+    if (!inChain) return false;
+    // A checkpoint of the chain is overwritten, normally with the same RVB data. Otherwise, the chain doesn't describe
+    // the checkpoint anymore.
+    if (hasCheckpointDesc(checkpoint) && (inmem_->getCheckpointDesc(checkpoint).rvbData == desc.rvbData)) return true;
+    detachRvbDataChain();
+    return false;
+  }
+
+  if (chain.baseCheckpoint > 0) detachRvbDataChain();
+  putRvbDataBase(checkpoint, desc.rvbData);
+  putInt(RvbDataLastCheckpoint, checkpoint);
+  LOG_INFO(logger(), "New RVB data chain base:" << KVLOG(checkpoint, desc.rvbData.size()));
+  return true;
+}
+
+std::vector<char> DBDataStore::getChainedRvbData(uint64_t checkpoint) {
+  const auto& chain = *rvbDataChain_;
+  std::vector<char> rvbData;
+  std::vector<std::vector<char>> deltas;  // from checkpoint backwards
+  for (auto cp = checkpoint;;) {
+    if ((cp != checkpoint) && inmem_->hasCheckpointDesc(cp)) {
+      rvbData = inmem_->getCheckpointDesc(cp).rvbData;
+      if (!rvbData.empty()) break;
+    }
+    if ((chain.baseCheckpoint == 0) || (cp < chain.baseCheckpoint)) {
+      throw std::runtime_error("RVB data of checkpoint " + std::to_string(checkpoint) + " isn't in the chain");
+    }
+    Sliver val;
+    if (cp == chain.baseCheckpoint) {
+      uint64_t baseCheckpoint{0};
+      if (get(RvbDataBase, val)) {
+        std::istringstream iss(std::string(reinterpret_cast<const char*>(val.data()), val.length()));
+        Serializable::deserialize(iss, baseCheckpoint);
+        Serializable::deserialize(iss, rvbData);
+      }
+      if (baseCheckpoint != cp) {
+        throw std::runtime_error("RVB data chain base mismatch: " + std::to_string(baseCheckpoint) +
+                                 " != " + std::to_string(cp));
+      }
+      break;
+    }
+    uint64_t deltaCheckpoint{0};
+    uint64_t prevCheckpoint{0};
+    std::vector<char> delta;
+    if (get(rvbDataDeltaKey(cp), val)) {
+      std::istringstream iss(std::string(reinterpret_cast<const char*>(val.data()), val.length()));
+      Serializable::deserialize(iss, deltaCheckpoint);
+      Serializable::deserialize(iss, prevCheckpoint);
+      Serializable::deserialize(iss, delta);
+    }
+    if ((deltaCheckpoint != cp) || (prevCheckpoint >= cp)) {
+      throw std::runtime_error("Broken RVB data chain at checkpoint " + std::to_string(cp));
+    }
+    deltas.push_back(std::move(delta));
+    cp = prevCheckpoint;
+  }
+
+  if (!deltas.empty()) {
+    // Apply all the deltas in a single pass over the base
+    std::istringstream base_is(std::string(rvbData.begin(), rvbData.end()));
+    std::vector<std::istringstream> deltas_iss;
+    deltas_iss.reserve(deltas.size());
+    std::vector<std::istream*> deltas_is;
+    for (auto it = deltas.rbegin(); it != deltas.rend(); ++it) {
+      deltas_is.push_back(&deltas_iss.emplace_back(std::string(it->begin(), it->end())));
+    }
+    std::ostringstream oss;
+    if (!RangeValidationTree::applySerializedRvbDataDeltas(base_is, deltas_is, oss)) {
+      throw std::runtime_error("Failed to apply RVB data deltas of checkpoint " + std::to_string(checkpoint));
+    }
+    const auto& str = oss.str();
+    rvbData.assign(str.begin(), str.end());
+  }
+  LOG_DEBUG(logger(), KVLOG(checkpoint, deltas.size(), rvbData.size()));
+  return rvbData;
+}
+
+void DBDataStore::compactRvbDataChain(uint64_t firstCheckpoint) {
+  auto& chain = *rvbDataChain_;
+  if ((chain.baseCheckpoint == 0) || (chain.baseCheckpoint >= firstCheckpoint)) return;
+  const auto newBase = chain.deltaSizes.lower_bound(firstCheckpoint);
+  if (newBase == chain.deltaSizes.end()) {
+    deleteRvbDataChain();
+    return;
+  }
+  // Move the base forward only once the deltas it makes obsolete outweigh the base itself, so that the cost of
+  // rewriting the base is amortized over the checkpoints. The number of deltas is capped too, as every delta is read
+  // when RVB data is rebuilt.
+  size_t obsoleteSize{0};
+  size_t numObsoleteDeltas{0};
+  for (auto it = chain.deltaSizes.begin(); it != std::next(newBase); ++it, ++numObsoleteDeltas) {
+    obsoleteSize += it->second;
+  }
+  if ((obsoleteSize < chain.baseSize) && (numObsoleteDeltas < kMaxRvbDataChainLength / 2) &&
+      (chain.lastCheckpoint() - chain.baseCheckpoint < kMaxRvbDataDeltas / 2)) {
+    return;
+  }
+
+  const auto newBaseCheckpoint = newBase->first;
+  const auto rvbData =
+      hasCheckpointDesc(newBaseCheckpoint) ? inmem_->getCheckpointDesc(newBaseCheckpoint).rvbData : std::vector<char>{};
+  if (rvbData.empty()) {
+    LOG_WARN(logger(), "No RVB data for the new RVB data chain base:" << KVLOG(newBaseCheckpoint));
+    detachRvbDataChain(firstCheckpoint);
+    return;
+  }
+  // Write the new base first, the delta records below it are then not reachable anymore
+  putRvbDataBase(newBaseCheckpoint, rvbData);
+  for (auto it = chain.deltaSizes.begin(); (it != chain.deltaSizes.end()) && (it->first <= newBaseCheckpoint);) {
+    delInTxn(rvbDataDeltaKey(it->first));
+    it = chain.deltaSizes.erase(it);
+  }
+  LOG_INFO(logger(),
+           "RVB data chain compacted:" << KVLOG(
+               newBaseCheckpoint, obsoleteSize, numObsoleteDeltas, chain.deltaSizes.size()));
+}
+
+void DBDataStore::detachRvbDataChain(uint64_t firstCheckpoint) {
+  auto& chain = *rvbDataChain_;
+  std::vector<uint64_t> checkpoints{chain.baseCheckpoint};
+  for (const auto& p : chain.deltaSizes) checkpoints.push_back(p.first);
+  for (const auto checkpoint : checkpoints) {
+    if ((checkpoint < firstCheckpoint) || !hasCheckpointDesc(checkpoint)) continue;
+    std::ostringstream oss;
+    serializeCheckpoint(oss, inmem_->getCheckpointDesc(checkpoint));
+    put(chkpDescKey(checkpoint), oss.str());
+  }
+  LOG_INFO(logger(), "RVB data chain detached:" << KVLOG(chain.baseCheckpoint, chain.lastCheckpoint()));
+  deleteRvbDataChain();
+}
+
+void DBDataStore::deleteRvbDataChain() {
+  auto& chain = *rvbDataChain_;
+  if (chain.baseCheckpoint == 0) return;
+  for (const auto& p : chain.deltaSizes) delInTxn(rvbDataDeltaKey(p.first));
+  delInTxn(genKey(RvbDataBase));
+  delInTxn(genKey(RvbDataLastCheckpoint));
+  chain = RvbDataChain{};
+}
+
 /** ******************************************************************************************************************/
 }  // namespace impl
 }  // namespace bcst
@@ -140,15 +140,53 @@ class DBDataStore : public DataStore {
     CheckpointBeingFetched,
     EraseDataOnStartup,
     PrunedBlocksDigests,
+    RvbDataBase,
+    RvbDataLastCheckpoint,
   };
 
+  /** *****************************************************************************************************************
+   * RVB data chain
+   *
+   * The RVB data of a checkpoint is the complete serialized RVT, which grows with the blockchain. Instead of writing it
+   * in full for every checkpoint, it is persisted as a chain: a base record with the complete RVB data of one
+   * checkpoint, followed by a delta record per later checkpoint, which holds only the RVT nodes changed since the
+   * previous one. Descriptors of chained checkpoints are persisted without RVB data, which is rebuilt when they are
+   * loaded.
+   *
+   * Delta records are kept in a ring of kMaxRvbDataDeltas keys. They outlive the descriptors of their checkpoints until
+   * the base is moved forward (see compactRvbDataChain). A chain has at most kMaxRvbDataChainLength deltas, all of
+   * which are applied in a single pass when the RVB data of its last checkpoint is rebuilt.
+   */
+  static constexpr ObjectId kRvbDataDeltasFirstId = 0x10000;
+  static constexpr uint64_t kMaxRvbDataDeltas = 1024;
+  static constexpr size_t kMaxRvbDataChainLength = 256;
+
+  struct RvbDataChain {
+    uint64_t lastCheckpoint() const { return deltaSizes.empty() ? baseCheckpoint : deltaSizes.rbegin()->first; }
+
+    uint64_t baseCheckpoint = 0;  // 0 if there is no chain
+    size_t baseSize = 0;
+    std::map<uint64_t, size_t> deltaSizes;  // checkpoint -> size of its delta
+  };
+
+  void loadRvbDataChain();
+  // Return false if the RVB data must be persisted with the descriptor
+  bool chainRvbData(uint64_t checkpoint, const CheckpointDesc& desc);
+  std::vector<char> getChainedRvbData(uint64_t checkpoint);
+  void putRvbDataBase(uint64_t checkpoint, const std::vector<char>& rvbData);
+  void compactRvbDataChain(uint64_t firstCheckpoint);
+  // Persist the RVB data of the chain checkpoints (from firstCheckpoint) with their descriptors, then delete the chain
+  void detachRvbDataChain(uint64_t firstCheckpoint = 0);
+  void deleteRvbDataChain();
+
   void load(bool loadResPages);
   void loadResPages();
   void loadPendingPages();
   void deleteAllResPages();
 
-  void serializeCheckpoint(std::ostream& os, const CheckpointDesc& desc) const;
-  void deserializeCheckpoint(std::istream& is, CheckpointDesc& desc) const;
+  void serializeCheckpoint(std::ostream& os, const CheckpointDesc& desc, bool rvbDataIsChained = false) const;
+  // Return true if the RVB data of the checkpoint is chained (not serialized with the descriptor)
+  bool deserializeCheckpoint(std::istream& is, CheckpointDesc& desc) const;
 
   void serializeResPage(std::ostream&, uint32_t, uint64_t, const Digest&, const char*) const;
   void deserializeResPage(std::istream&, uint32_t&, uint64_t&, Digest&, char*&) const;
@@ -201,6 +239,13 @@ class DBDataStore : public DataStore {
    * @throw  otherwise
    */
   bool del(GeneralIds objId) { return del(genKey(objId)); }
+  void delInTxn(const Sliver& key) {
+    if (txn_) {
+      txn_->del(key);
+    } else {
+      del(key);
+    }
+  }
   bool del(const Sliver& key) {
     LOG_TRACE(logger(), "delete k.ey:" << key.toHexString());
     Status s = dbc_->del(key);
@@ -234,6 +279,9 @@ class DBDataStore : public DataStore {
   }
   Sliver pendingPageKey(uint32_t pageid) const { return keymanip_->generateSTPendingPageKey(pageid); }
   Sliver chkpDescKey(uint64_t chkpt) const { return keymanip_->generateSTCheckpointDescriptorKey(chkpt); }
+  Sliver rvbDataDeltaKey(uint64_t chkpt) const {
+    return genKey(static_cast<ObjectId>(kRvbDataDeltasFirstId + chkpt % kMaxRvbDataDeltas));
+  }
   Sliver genKey(const ObjectId& objId) const { return keymanip_->generateStateTransferKey(objId); }
   /** ****************************************************************************************************************/
   logging::Logger& logger() {
@@ -242,7 +290,8 @@ class DBDataStore : public DataStore {
   }
 
  protected:
-  std::shared_ptr<InMemoryDataStore> inmem_;  // one copy among instances
+  std::shared_ptr<InMemoryDataStore> inmem_;                                        // one copy among instances
+  std::shared_ptr<RvbDataChain> rvbDataChain_ = std::make_shared<RvbDataChain>();  // one copy among instances
   ITransaction* txn_ = nullptr;
   IDBClient::ptr dbc_;
   std::shared_ptr<concord::storage::ISTKeyManipulator> keymanip_;
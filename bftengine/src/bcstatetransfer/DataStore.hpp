@@ -84,6 +84,8 @@ class DataStore : public std::enable_shared_from_this<DataStore> {
       digestOfMaxBlockId.makeZero();
       digestOfResPagesDescriptor.makeZero();
       rvbData.clear();
+      rvbDataDeltaBase = 0;
+      rvbDataDelta.clear();
     }
 
     uint64_t checkpointNum = 0;
@@ -91,6 +93,11 @@ class DataStore : public std::enable_shared_from_this<DataStore> {
     Digest digestOfMaxBlockId;
     Digest digestOfResPagesDescriptor;
     std::vector<char> rvbData{};
+    // Optional: the RVB data nodes which changed since checkpoint rvbDataDeltaBase (see
+    // RangeValidationTree::getSerializedRvbDataDelta). Used by persistent data stores to store rvbData incrementally.
+    // Not part of the checkpoint digest, and not returned by getCheckpointDesc.
+    uint64_t rvbDataDeltaBase = 0;
+    std::vector<char> rvbDataDelta{};
   };
 
   virtual void setCheckpointDesc(uint64_t checkpoint,
@@ -92,7 +92,9 @@ void InMemoryDataStore::setCheckpointDesc(uint64_t checkpoint,
   ConcordAssert(checkpoint == desc.checkpointNum);
   ConcordAssertOR(!checkIfAlreadyExists, descMap.count(checkpoint) == 0);
 
-  descMap[checkpoint] = desc;
+  auto& storedDesc = descMap[checkpoint] = desc;
+  storedDesc.rvbDataDeltaBase = 0;
+  storedDesc.rvbDataDelta.clear();
 
   //  ConcordAssert(descMap.size() < 21);  // TODO(GG): delete - debug only
 }
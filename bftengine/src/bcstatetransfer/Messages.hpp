@@ -35,7 +35,8 @@ class MsgType {
     FetchBlocks,
     FetchResPages,
     RejectFetching,
-    ItemData
+    ItemData,
+    CompressedItemData
   };
 };
 
@@ -181,6 +182,24 @@ struct FetchBlocksMsg : public BCStateTranBaseMsg {
   uint16_t lastKnownChunkInLastRequiredBlock;
 };
 
+// A FetchBlocksMsg which asks for compressed blocks: the ChunkCompression is appended to the FetchBlocksMsg layout.
+// The appended field is sent only if compression is asked for, hence FetchBlocksMsg of uncompressed transfers is
+// unchanged. A replica which does not support compression ignores it, and replies with uncompressed blocks.
+struct CompressedFetchBlocksMsg : public FetchBlocksMsg {
+  CompressedFetchBlocksMsg() : compression{0} {}
+
+  uint8_t compression;  // ChunkCompression the blocks are asked to be sent with
+
+  // Size of the message to send
+  uint32_t size() const { return (compression != 0) ? sizeof(CompressedFetchBlocksMsg) : sizeof(FetchBlocksMsg); }
+
+  // The compression asked for by a received FetchBlocksMsg of msgLen bytes
+  static uint8_t compressionOf(const FetchBlocksMsg* m, uint32_t msgLen) {
+    return (msgLen >= sizeof(CompressedFetchBlocksMsg)) ? static_cast<const CompressedFetchBlocksMsg*>(m)->compression
+                                                        : 0;
+  }
+};
+
 struct FetchResPagesMsg : public BCStateTranBaseMsg {
   FetchResPagesMsg() {
     memset(this, 0, sizeof(FetchResPagesMsg));
@@ -231,16 +250,22 @@ struct RejectFetchingMsg : public BCStateTranBaseMsg {
       {Reason::DIGESTS_FOR_RVBGROUP_NOT_FOUND, "Digests for RVB group not found"}};
 };
 
+// A chunk of a compressed block is sent as a CompressedItemData message: the ItemDataMsg layout, with the block's
+// ChunkCompression appended after data, hence dataSize must not change once allocated. Chunks of uncompressed blocks
+// are sent as ItemData messages, which are unchanged.
 struct ItemDataMsg : public BCStateTranBaseMsg {
-  static ItemDataMsg* alloc(uint32_t dataSize) {
-    size_t msgSize = sizeof(ItemDataMsg) - 1 + dataSize;
+  static ItemDataMsg* alloc(uint32_t dataSize, uint8_t compression = 0) {
+    size_t msgSize = sizeof(ItemDataMsg) - 1 + dataSize + ((compression != 0) ? sizeof(compression) : 0);
     ItemDataMsg* msg = static_cast<ItemDataMsg*>(std::malloc(msgSize));
     if (!msg) {
       throw std::bad_alloc();
     }
     memset(msg, 0, msgSize);
-    msg->type = MsgType::ItemData;
+    msg->type = (compression != 0) ? MsgType::CompressedItemData : MsgType::ItemData;
     msg->dataSize = dataSize;
+    if (compression != 0) {
+      msg->data[dataSize] = static_cast<char>(compression);
+    }
     return msg;
   }
 
@@ -256,7 +281,10 @@ struct ItemDataMsg : public BCStateTranBaseMsg {
                             // digests from the total of dataSize (rvbDigestsSize < dataSize)
   char data[1];             // MSB[raw block of size dataSize-rvbDigestsSize|RVB DIGESTS of size rvbDigestsSize]LSB
 
-  uint32_t size() const { return sizeof(ItemDataMsg) - 1 + dataSize; }
+  bool isCompressed() const { return type == MsgType::CompressedItemData; }
+  // ChunkCompression of the block, the same in all of its chunks
+  uint8_t compression() const { return isCompressed() ? static_cast<uint8_t>(data[dataSize]) : 0; }
+  uint32_t size() const { return sizeof(ItemDataMsg) - 1 + dataSize + (isCompressed() ? sizeof(uint8_t) : 0); }
 };
 
 #pragma pack(pop)
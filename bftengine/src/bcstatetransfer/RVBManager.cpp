@@ -10,10 +10,14 @@
 // file.
 
 #include <algorithm>
+#include <deque>
+#include <future>
+#include <vector>
 
 #include "RangeValidationTree.hpp"
 #include "RVBManager.hpp"
 #include "throughput.hpp"
+#include "thread_pool.hpp"
 
 using concord::util::digest::DigestUtil;
 using namespace std;
@@ -102,6 +106,10 @@ void RVBManager::init(bool fetching) {
           rvb_data_source_ = RvbDataInitialSource::NIL;
         } else {
           LOG_INFO(logger_, "Success setting and validating new RVB data from stored checkpoint");
+          if (!hasCheckpointBeingFetched) {
+            in_mem_rvt_->resetChangedNodes();
+            rvb_data_delta_base_checkpoint_ = desc.checkpointNum;
+          }
         }
       }
     }
@@ -272,6 +280,18 @@ void RVBManager::updateRvbDataDuringCheckpoint(CheckpointDesc& new_checkpoint_de
       const std::string s = rvb_data.str();
       ConcordAssert(!s.empty());
       std::copy(s.c_str(), s.c_str() + s.length(), back_inserter(new_checkpoint_desc.rvbData));
+
+      // Keep also the nodes changed since the previous checkpoint, so that the data store can persist only them
+      std::ostringstream rvb_data_delta;
+      if ((rvb_data_delta_base_checkpoint_ > 0) && in_mem_rvt_->getSerializedRvbDataDelta(rvb_data_delta)) {
+        const std::string delta = rvb_data_delta.str();
+        new_checkpoint_desc.rvbDataDelta.assign(delta.begin(), delta.end());
+        new_checkpoint_desc.rvbDataDeltaBase = rvb_data_delta_base_checkpoint_;
+        LOG_DEBUG(logger_,
+                  KVLOG(new_checkpoint_desc.checkpointNum, rvb_data_delta_base_checkpoint_, s.size(), delta.size()));
+      }
+      in_mem_rvt_->resetChangedNodes();
+      rvb_data_delta_base_checkpoint_ = new_checkpoint_desc.checkpointNum;
     } else {
       new_checkpoint_desc.rvbData.clear();
     }
@@ -679,24 +699,23 @@ uint64_t RVBManager::addRvbDataOnBlockRange(uint64_t min_block_id,
   }
   uint64_t current_rvb_id = nextRvbBlockId(min_block_id);
   RVBId max_rvb_id_in_rvt = in_mem_rvt_->getMaxRvbId();
+  if (current_rvb_id <= max_rvb_id_in_rvt) {
+    current_rvb_id = max_rvb_id_in_rvt + config_.fetchRangeSize;
+  }
+  // Read the digests concurrently if there is more than a single chunk of them
+  if ((config_.numOfRvbReconstructionThreads > 0) && (current_rvb_id < max_block_id) &&
+      ((max_block_id - current_rvb_id) / config_.fetchRangeSize >= config_.RVT_K)) {
+    auto last_rvb_id = prevRvbBlockId(max_block_id - 1);
+    num_rvbs_added += addRvbDigestsConcurrently(current_rvb_id, last_rvb_id);
+    current_rvb_id = last_rvb_id + config_.fetchRangeSize;
+  }
   while (current_rvb_id < max_block_id) {  // we handle case of current_rvb_id == max_block_id later
-    // TODO - As a 2nd phase - should use the thread pool to fetch a batch of digests or move to a background
-    // process
-    if (current_rvb_id > max_rvb_id_in_rvt) {
-      Digest digest;
-      if (!as_->getPrevDigestFromBlock(current_rvb_id + 1,
-                                       reinterpret_cast<StateTransferDigest*>(digest.getForUpdate()))) {
-        LOG_FATAL(logger_,
-                  "Digest not found:" << KVLOG(
-                      min_block_id, max_block_id, current_rvb_id, max_rvb_id_in_rvt, num_rvbs_added));
-        ConcordAssert(false);
-      }
-      LOG_DEBUG(logger_,
-                "Add digest for block " << current_rvb_id << " "
-                                        << " Digest: " << digest.toString());
-      in_mem_rvt_->addRightNode(current_rvb_id, digest.getForUpdate(), DIGEST_SIZE);
-      ++num_rvbs_added;
-    }
+    auto digest = getRvbDigestFromStorage(current_rvb_id);
+    LOG_DEBUG(logger_,
+              "Add digest for block " << current_rvb_id << " "
+                                      << " Digest: " << digest.toString());
+    in_mem_rvt_->addRightNode(current_rvb_id, digest.getForUpdate(), DIGEST_SIZE);
+    ++num_rvbs_added;
     current_rvb_id += config_.fetchRangeSize;
   }
   if ((current_rvb_id == max_block_id) && (current_rvb_id > max_rvb_id_in_rvt)) {
@@ -723,6 +742,61 @@ uint64_t RVBManager::addRvbDataOnBlockRange(uint64_t min_block_id,
   return num_rvbs_added;
 }
 
+Digest RVBManager::getRvbDigestFromStorage(RVBId rvb_id) const {
+  Digest digest;
+  if (!as_->getPrevDigestFromBlock(rvb_id + 1, reinterpret_cast<StateTransferDigest*>(digest.getForUpdate()))) {
+    LOG_FATAL(logger_, "Digest not found:" << KVLOG(rvb_id));
+    ConcordAssert(false);
+  }
+  return digest;
+}
+
+uint64_t RVBManager::addRvbDigestsConcurrently(RVBId from_rvb_id, RVBId to_rvb_id) {
+  ConcordAssertLE(from_rvb_id, to_rvb_id);
+  ConcordAssertGT(config_.numOfRvbReconstructionThreads, 0);
+  DurationTracker<std::chrono::milliseconds> add_dt("add_rvb_digests_concurrently_dt", true);
+  const uint64_t chunk_span = config_.RVT_K * static_cast<uint64_t>(config_.fetchRangeSize);
+  const size_t max_chunks_in_flight = 2 * config_.numOfRvbReconstructionThreads;
+  concord::util::ThreadPool pool{config_.numOfRvbReconstructionThreads};
+  std::deque<std::future<std::vector<Digest>>> chunks;
+  RVBId next_chunk_rvb_id = from_rvb_id;
+  RVBId next_rvb_id = from_rvb_id;
+  uint64_t num_rvbs_added{};
+
+  LOG_INFO(logger_, KVLOG(from_rvb_id, to_rvb_id, config_.numOfRvbReconstructionThreads, config_.RVT_K));
+  while (next_rvb_id <= to_rvb_id) {
+    // Keep the pool busy, while bounding the memory of the digests read but not added yet
+    while ((chunks.size() < max_chunks_in_flight) && (next_chunk_rvb_id <= to_rvb_id)) {
+      auto last_rvb_id_in_chunk = std::min(to_rvb_id, next_chunk_rvb_id + chunk_span - config_.fetchRangeSize);
+      chunks.push_back(pool.async(
+          [this](RVBId first_rvb_id, RVBId last_rvb_id) {
+            std::vector<Digest> digests;
+            digests.reserve((last_rvb_id - first_rvb_id) / config_.fetchRangeSize + 1);
+            for (auto rvb_id = first_rvb_id; rvb_id <= last_rvb_id; rvb_id += config_.fetchRangeSize) {
+              digests.push_back(getRvbDigestFromStorage(rvb_id));
+            }
+            return digests;
+          },
+          next_chunk_rvb_id,
+          last_rvb_id_in_chunk));
+      next_chunk_rvb_id = last_rvb_id_in_chunk + config_.fetchRangeSize;
+    }
+
+    // RVBs must be added to the tree in order
+    auto digests = chunks.front().get();
+    chunks.pop_front();
+    for (auto& digest : digests) {
+      in_mem_rvt_->addRightNode(next_rvb_id, digest.getForUpdate(), DIGEST_SIZE);
+      next_rvb_id += config_.fetchRangeSize;
+      ++num_rvbs_added;
+    }
+  }
+  ConcordAssert(chunks.empty());
+  auto total_duration = add_dt.totalDuration(true);
+  LOG_INFO(logger_, KVLOG(from_rvb_id, to_rvb_id, num_rvbs_added, total_duration));
+  return num_rvbs_added;
+}
+
 RVBId RVBManager::nextRvbBlockId(BlockId block_id) const {
   uint64_t next_rvb_id = config_.fetchRangeSize * (block_id / config_.fetchRangeSize);
   if (next_rvb_id < block_id) {
@@ -824,6 +898,7 @@ void RVBManager::reset(RvbDataInitialSource inital_source) {
   stored_rvb_digests_.clear();
   stored_rvb_digests_group_ids_.clear();
   last_checkpoint_desc_.makeZero();
+  rvb_data_delta_base_checkpoint_ = 0;
   rvb_data_source_ = inital_source;
   // we do not clear the pruned digests
 }
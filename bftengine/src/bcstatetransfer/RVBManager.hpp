@@ -159,6 +159,8 @@ class RVBManager {
   // RVB data update during checkpointing / pruning
   std::vector<std::pair<BlockId, Digest>> pruned_blocks_digests_;
   CheckpointDesc last_checkpoint_desc_;
+  // The checkpoint which the changes tracked by in_mem_rvt_ are relative to, 0 if changes are not tracked
+  uint64_t rvb_data_delta_base_checkpoint_{0};
 
   // Actual RVB data
   // RangeValidationTree is an incomplete type, define a deleter for the unique ptr
@@ -189,6 +191,12 @@ class RVBManager {
   uint64_t addRvbDataOnBlockRange(uint64_t min_block_id,
                                   uint64_t max_block_id,
                                   const std::optional<Digest>& digest_of_max_block_id);
+  // Returns the digest of RVB rvb_id, which is stored in block rvb_id + 1
+  Digest getRvbDigestFromStorage(RVBId rvb_id) const;
+  // Adds the RVBs [from_rvb_id, to_rvb_id] to the RVT. The digests are read from storage by
+  // config_.numOfRvbReconstructionThreads threads, in chunks of RVT_K RVBs, and are added in order.
+  // Returns # of RVBs added
+  uint64_t addRvbDigestsConcurrently(RVBId from_rvb_id, RVBId to_rvb_id);
   // returns the next RVB ID after block_id. If block_id is an RVB ID, returns block_id.
   RVBId nextRvbBlockId(BlockId block_id) const;
 
@@ -12,6 +12,7 @@
 // LICENSE file.
 
 #include <queue>
+#include <map>
 #include <algorithm>
 #include <type_traits>
 
@@ -271,17 +272,11 @@ std::ostringstream RVTNode::serialize() const {
   return os;
 }
 
-RVTNodePtr RVTNode::createFromSerialized(std::istringstream& is) {
+RVTNodePtr RVTNode::createFromSerialized(std::istream& is) {
   SerializedRVTNode snode;
-  Serializable::deserialize(is, snode.id);
-  Serializable::deserialize(is, snode.parent_id);
-  Serializable::deserialize(is, snode.last_insertion_index);
-  // Serializable::deserialize(is, nchilds);
-  Serializable::deserialize(is, snode.child_ids);
-  Serializable::deserialize(is, snode.current_value_encoded_size);
-  std::unique_ptr<char[]> ptr_cur = std::make_unique<char[]>(snode.current_value_encoded_size);
-  Serializable::deserialize(is, ptr_cur.get(), snode.current_value_encoded_size);
-  return std::make_shared<RVTNode>(snode, ptr_cur.get(), snode.current_value_encoded_size);
+  std::vector<char> value;
+  deserializeNode(is, snode, value);
+  return std::make_shared<RVTNode>(snode, value.data(), snode.current_value_encoded_size);
 }
 
 // In some cases RVB node might be inserted in as a middle child (see more details in above ctor)
@@ -743,6 +738,7 @@ void RangeValidationTree::addValueToInternalNodes(const RVTNodePtr& bottom_node,
   auto current_node = bottom_node;
   do {
     current_node->addValue(value);
+    markChangedNode(current_node);
     if (current_node->parent_id_ != 0) {
       ConcordAssert(root_ != current_node);
       current_node = getRVTNodeByType(current_node, NodeType::PARENT);
@@ -753,6 +749,7 @@ void RangeValidationTree::addValueToInternalNodes(const RVTNodePtr& bottom_node,
   } while (current_node != root_);
   if (current_node != bottom_node) {
     current_node->addValue(value);
+    markChangedNode(current_node);
   }
 }
 
@@ -796,6 +793,8 @@ void RangeValidationTree::addInternalNode(const RVTNodePtr& node_to_add) {
       ConcordAssert(parent_node != nullptr);
       parent_node->addValue(val_to_add);
     }
+    markChangedNode(current_node);
+    markChangedNode(parent_node);
     current_node = parent_node;
   }
 
@@ -848,6 +847,8 @@ void RangeValidationTree::addInternalNode(const RVTNodePtr& node_to_add) {
       new_root_sib->addValue(current_node->current_value_);
       updateOpenRvtNodeArrays(ArrUpdateType::ADD_NODE_TO_RIGHT, new_root_sib);
       ConcordAssert(new_root_sib->numChildren() <= RVT_K);
+      markChangedNode(current_node);
+      markChangedNode(new_root_sib);
       current_node = new_root_sib;
     } else {
       // common parent found
@@ -855,6 +856,8 @@ void RangeValidationTree::addInternalNode(const RVTNodePtr& node_to_add) {
       new_root->pushChildId(current_node->info_.id());
       new_root->addValue(current_node->current_value_);
       ConcordAssert(new_root->numChildren() <= RVT_K);
+      markChangedNode(current_node);
+      markChangedNode(new_root);
       break;
     }
   } while (current_root_parent_rvb_index != current_root_sibling_rvb_index);
@@ -881,11 +884,13 @@ void RangeValidationTree::removeAndUpdateInternalNodes(const RVTNodePtr& rvt_nod
       }
     }
     cur_node->substractValue(value);
+    markChangedNode(cur_node);
     cur_node = parent_node;
   }
 
   ConcordAssertEQ(cur_node, root_);
   root_->substractValue(value);
+  markChangedNode(root_);
 
   if (root_->hasNoChilds()) {
     setNewRoot(nullptr);
@@ -912,6 +917,7 @@ void RangeValidationTree::setNewRoot(const RVTNodePtr& new_root) {
   }
   if (root_) {
     // replacing roots
+    markChangedNode(root_);
     int new_root_level = static_cast<int>(new_root->info_.level());
     int old_root_level = static_cast<int>(root_->info_.level());
     ConcordAssert(new_root_level != 0);
@@ -926,6 +932,7 @@ void RangeValidationTree::setNewRoot(const RVTNodePtr& new_root) {
   }
   root_ = new_root;
   root_->parent_id_ = 0;
+  markChangedNode(root_);
   DEBUG_PRINT(logger_, "Set new root" << root_->info_.toString() << " id " << root_->info_.id());
   updateOpenRvtNodeArrays(ArrUpdateType::ADD_NODE_TO_RIGHT, new_root);
 }
@@ -997,6 +1004,60 @@ void RangeValidationTree::clear() noexcept {
   max_rvb_index_ = 0;
   min_rvb_index_ = 0;
   node_ids_to_erase_.clear();
+  track_changed_nodes_ = false;
+  changed_node_ids_.clear();
+  removed_node_ids_.clear();
+}
+
+void RangeValidationTree::markChangedNode(const RVTNodePtr& node) {
+  if (track_changed_nodes_) {
+    changed_node_ids_.insert(node->info_.id());
+    removed_node_ids_.erase(node->info_.id());
+  }
+}
+
+void RangeValidationTree::serializeOpenRvtNodeArrays(std::ostream& os) const {
+  uint64_t null_node_id = 0;
+  auto max_levels = root_->info_.level();
+  for (uint64_t i = 0; i <= max_levels; i++) {
+    auto node = rightmost_rvt_node_[i];
+    if (!node) {
+      Serializable::serialize(os, null_node_id);
+    } else {
+      Serializable::serialize(os, node->info_.id());
+    }
+  }
+  for (uint64_t i = 0; i <= max_levels; i++) {
+    auto node = leftmost_rvt_node_[i];
+    if (!node) {
+      Serializable::serialize(os, null_node_id);
+    } else {
+      Serializable::serialize(os, node->info_.id());
+    }
+  }
+}
+
+void RangeValidationTree::deserializeNode(std::istream& is, SerializedRVTNode& node, std::vector<char>& value) {
+  Serializable::deserialize(is, node.id);
+  Serializable::deserialize(is, node.parent_id);
+  Serializable::deserialize(is, node.last_insertion_index);
+  node.child_ids.clear();
+  Serializable::deserialize(is, node.child_ids);
+  Serializable::deserialize(is, node.current_value_encoded_size);
+  value.resize(node.current_value_encoded_size);
+  Serializable::deserialize(is, value.data(), node.current_value_encoded_size);
+}
+
+// Must match RVTNode::serialize()
+void RangeValidationTree::serializeNode(std::ostream& os,
+                                        const SerializedRVTNode& node,
+                                        const std::vector<char>& value) {
+  Serializable::serialize(os, node.id);
+  Serializable::serialize(os, node.parent_id);
+  Serializable::serialize(os, node.last_insertion_index);
+  Serializable::serialize(os, node.child_ids);
+  Serializable::serialize(os, node.current_value_encoded_size);
+  Serializable::serialize(os, value.data(), node.current_value_encoded_size);
 }
 
 /////////////////////////////////// start of API //////////////////////////////////////////////
@@ -1036,6 +1097,10 @@ void RangeValidationTree::removeLeftNode(const RVBId rvb_id, const char* data, s
     // Keep for debug
     DEBUG_PRINT(logger_, "Removed node id " << id);
     id_to_node_.erase(id);
+    if (track_changed_nodes_) {
+      changed_node_ids_.erase(id);
+      removed_node_ids_.insert(id);
+    }
   }
   node_ids_to_erase_.clear();
   if (!root_) {
@@ -1067,25 +1132,7 @@ std::ostringstream RangeValidationTree::getSerializedRvbData() const {
     auto serialized_node = itr.second->serialize();
     Serializable::serialize(os, serialized_node.str().data(), serialized_node.str().size());
   }
-
-  uint64_t null_node_id = 0;
-  auto max_levels = root_->info_.level();
-  for (uint64_t i = 0; i <= max_levels; i++) {
-    auto node = rightmost_rvt_node_[i];
-    if (!node) {
-      Serializable::serialize(os, null_node_id);
-    } else {
-      Serializable::serialize(os, node->info_.id());
-    }
-  }
-  for (uint64_t i = 0; i <= max_levels; i++) {
-    auto node = leftmost_rvt_node_[i];
-    if (!node) {
-      Serializable::serialize(os, null_node_id);
-    } else {
-      Serializable::serialize(os, node->info_.id());
-    }
-  }
+  serializeOpenRvtNodeArrays(os);
 
   LOG_TRACE(logger_, KVLOG(os.str().size()));
   metrics_.serialized_rvt_size_.Get().Set(os.str().size());
@@ -1093,8 +1140,8 @@ std::ostringstream RangeValidationTree::getSerializedRvbData() const {
   return os;
 }
 
-bool RangeValidationTree::setSerializedRvbData(std::istringstream& is) {
-  if (!(is.str().size())) {
+bool RangeValidationTree::setSerializedRvbData(std::istream& is) {
+  if (is.peek() == std::istream::traits_type::eof()) {
     LOG_ERROR(logger_, "invalid input");
     return false;
   }
@@ -1168,6 +1215,7 @@ bool RangeValidationTree::setSerializedRvbData(std::istringstream& is) {
     }
   }
 
+  const auto serialized_size = static_cast<uint64_t>(is.tellg());
   is.peek();
   if (not is.eof()) {
     LOG_ERROR(logger_, "Still some data left to read from stream");
@@ -1180,11 +1228,140 @@ bool RangeValidationTree::setSerializedRvbData(std::istringstream& is) {
   metrics_.total_rvt_levels_.Get().Set(totalLevels());
   metrics_.rvt_min_rvb_id_.Get().Set(getMinRvbId());
   metrics_.rvt_max_rvb_id_.Get().Set(getMaxRvbId());
-  metrics_.serialized_rvt_size_.Get().Set(is.str().size());
+  metrics_.serialized_rvt_size_.Get().Set(serialized_size);
   LOG_TRACE(logger_, "Nodes:" << totalNodes() << " root value:" << root_->current_value_.toString());
   return true;
 }
 
+// Delta format: metadata, removed node IDs, changed nodes and the open nodes arrays. Node IDs and nodes are sorted by
+// ID, like in the complete serialized tree.
+bool RangeValidationTree::getSerializedRvbDataDelta(std::ostream& os) const {
+  LOG_TRACE(logger_, KVLOG(track_changed_nodes_, changed_node_ids_.size(), removed_node_ids_.size()));
+  if (!root_ || !track_changed_nodes_) {
+    return false;
+  }
+
+  RVTMetadata data{magic_num_, version_num_, RVT_K, fetch_range_size_, value_size_, root_->info_.id(), totalNodes()};
+  Serializable::serialize(os, reinterpret_cast<char*>(&data), sizeof(data));
+
+  Serializable::serialize(os, static_cast<uint64_t>(removed_node_ids_.size()));
+  for (auto id : removed_node_ids_) {
+    Serializable::serialize(os, id);
+  }
+  Serializable::serialize(os, static_cast<uint64_t>(changed_node_ids_.size()));
+  for (auto id : changed_node_ids_) {
+    auto iter = id_to_node_.find(id);
+    ConcordAssert(iter != id_to_node_.end());
+    const auto serialized_node = iter->second->serialize().str();
+    Serializable::serialize(os, serialized_node.data(), serialized_node.size());
+  }
+  serializeOpenRvtNodeArrays(os);
+  return true;
+}
+
+void RangeValidationTree::resetChangedNodes() {
+  changed_node_ids_.clear();
+  removed_node_ids_.clear();
+  track_changed_nodes_ = true;
+}
+
+bool RangeValidationTree::applySerializedRvbDataDelta(std::istream& base_is, std::istream& delta_is, std::ostream& os) {
+  return applySerializedRvbDataDeltas(base_is, {&delta_is}, os);
+}
+
+bool RangeValidationTree::applySerializedRvbDataDeltas(std::istream& base_is,
+                                                       const std::vector<std::istream*>& deltas_is,
+                                                       std::ostream& os) {
+  RVTMetadata base_data{}, delta_data{};
+  Serializable::deserialize(base_is, reinterpret_cast<char*>(&base_data), sizeof(base_data));
+  if (deltas_is.empty() || base_is.fail() || (base_data.magic_num != magic_num_)) {
+    return false;
+  }
+
+  // Merge the deltas into a single one, oldest first: a node changed or removed by a newer delta overrides the older
+  // deltas. The open nodes arrays are taken from the newest delta.
+  std::map<uint64_t, std::pair<SerializedRVTNode, std::vector<char>>> changed_nodes;
+  std::set<uint64_t> removed_node_ids;
+  std::vector<uint64_t> open_node_ids;
+  uint64_t num_removed_nodes{}, num_changed_nodes{}, node_id{};
+  for (auto* delta_is : deltas_is) {
+    Serializable::deserialize(*delta_is, reinterpret_cast<char*>(&delta_data), sizeof(delta_data));
+    if (delta_is->fail() || (delta_data.magic_num != magic_num_) || (base_data.version_num != delta_data.version_num) ||
+        (base_data.RVT_K != delta_data.RVT_K) || (base_data.fetch_range_size != delta_data.fetch_range_size) ||
+        (base_data.value_size != delta_data.value_size)) {
+      return false;
+    }
+    Serializable::deserialize(*delta_is, num_removed_nodes);
+    for (uint64_t i = 0; (i < num_removed_nodes) && delta_is->good(); i++) {
+      Serializable::deserialize(*delta_is, node_id);
+      removed_node_ids.insert(node_id);
+      changed_nodes.erase(node_id);
+    }
+    Serializable::deserialize(*delta_is, num_changed_nodes);
+    for (uint64_t i = 0; (i < num_changed_nodes) && delta_is->good(); i++) {
+      SerializedRVTNode changed_node{};
+      std::vector<char> changed_value;
+      deserializeNode(*delta_is, changed_node, changed_value);
+      removed_node_ids.erase(changed_node.id);
+      changed_nodes[changed_node.id] = {std::move(changed_node), std::move(changed_value)};
+    }
+    open_node_ids.resize(2 * (NodeInfo::level(delta_data.root_node_id) + 1ULL));
+    for (auto& id : open_node_ids) {
+      Serializable::deserialize(*delta_is, id);
+    }
+    if (delta_is->fail()) {
+      return false;
+    }
+    delta_is->peek();
+    if (!delta_is->eof()) {
+      return false;
+    }
+  }
+  Serializable::serialize(os, reinterpret_cast<char*>(&delta_data), sizeof(delta_data));
+
+  // Both the base and the changed nodes are sorted by node ID: stream the base side by side with the changed nodes. A
+  // changed node replaces the base node with the same ID.
+  SerializedRVTNode base_node{};
+  std::vector<char> base_value;
+  uint64_t total_nodes{};
+  auto changed_it = changed_nodes.begin();
+  for (uint64_t base_nodes_left{base_data.total_nodes}; base_nodes_left > 0; --base_nodes_left) {
+    deserializeNode(base_is, base_node, base_value);
+    if (base_is.fail()) {
+      return false;
+    }
+    for (; (changed_it != changed_nodes.end()) && (changed_it->first < base_node.id); ++changed_it, ++total_nodes) {
+      serializeNode(os, changed_it->second.first, changed_it->second.second);
+    }
+    if ((changed_it != changed_nodes.end()) && (changed_it->first == base_node.id)) {
+      serializeNode(os, changed_it->second.first, changed_it->second.second);
+      ++changed_it;
+      ++total_nodes;
+    } else if (removed_node_ids.find(base_node.id) == removed_node_ids.end()) {
+      serializeNode(os, base_node, base_value);
+      ++total_nodes;
+    }
+  }
+  for (; changed_it != changed_nodes.end(); ++changed_it, ++total_nodes) {
+    serializeNode(os, changed_it->second.first, changed_it->second.second);
+  }
+  if (total_nodes != delta_data.total_nodes) {
+    return false;
+  }
+
+  for (uint64_t i = 0; i < 2 * (NodeInfo::level(base_data.root_node_id) + 1ULL); i++) {
+    Serializable::deserialize(base_is, node_id);
+  }
+  for (auto id : open_node_ids) {
+    Serializable::serialize(os, id);
+  }
+  if (base_is.fail()) {
+    return false;
+  }
+  base_is.peek();
+  return base_is.eof();
+}
+
 // TODO - move to a common file, this function is duplicated
 template <typename T>
 static inline std::string vecToStr(const std::vector<T>& vec) {
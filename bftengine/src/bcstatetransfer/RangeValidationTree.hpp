@@ -21,6 +21,7 @@
 #include <cmath>
 #include <limits>
 #include <unordered_set>
+#include <set>
 
 #include <cryptopp/integer.h>
 
@@ -95,10 +96,30 @@ class RangeValidationTree {
   // In case of failure can assert
   std::ostringstream getSerializedRvbData() const;
 
-  // Initialize metadata & build tree by deserializing input stream
+  // Initialize metadata & build tree by deserializing input stream, one node at a time.
   // If function fails, tree reset to null and returns false.
   // In case of failure can assert
-  bool setSerializedRvbData(std::istringstream& iss);
+  bool setSerializedRvbData(std::istream& is);
+
+  // Incremental serialization: write the nodes which were added, changed or removed since the last call to
+  // resetChangedNodes(), together with the metadata, to the output stream.
+  // Returns false (and writes nothing) if the tree is empty, or if it was cleared or replaced since then - in that case
+  // only the complete tree can be serialized.
+  bool getSerializedRvbDataDelta(std::ostream& os) const;
+
+  // Start tracking the changed nodes from the current state of the tree.
+  void resetChangedNodes();
+
+  // Merge a delta written by getSerializedRvbDataDelta into the complete serialized tree it was taken against, and
+  // write the complete serialized tree which matches the delta. The inputs are streamed one node at a time, and the
+  // output is identical to what getSerializedRvbData returns.
+  // Returns false if the inputs do not match each other.
+  static bool applySerializedRvbDataDelta(std::istream& base_is, std::istream& delta_is, std::ostream& os);
+  // Same, for a chain of deltas, oldest first, each taken against the tree the previous one results in. The deltas are
+  // merged into a single one, in which the newest change of every node wins, and the base is streamed once.
+  static bool applySerializedRvbDataDeltas(std::istream& base_is,
+                                           const std::vector<std::istream*>& deltas_is,
+                                           std::ostream& os);
 
   // Returns RVB group ids for the range [start_block_id, end_block_id] in ascending order.
   // In case of failure, returns an empty vector.
@@ -294,7 +315,7 @@ class RangeValidationTree {
     explicit RVTNode(const RVBNodePtr& child_node);
     RVTNode(uint8_t level, uint64_t rvb_index);
     RVTNode(SerializedRVTNode& node, char* cur_val_ptr, size_t cur_value_size);
-    static RVTNodePtr createFromSerialized(std::istringstream& is);
+    static RVTNodePtr createFromSerialized(std::istream& is);
 
     void addValue(const NodeVal& nvalue);
     void substractValue(const NodeVal& nvalue);
@@ -356,6 +377,12 @@ class RangeValidationTree {
   enum class ArrUpdateType { ADD_NODE_TO_RIGHT, CHECK_REMOVE_NODE };
   void updateOpenRvtNodeArrays(ArrUpdateType update_type, const RVTNodePtr& node);
 
+  // serialization helper functions
+  void markChangedNode(const RVTNodePtr& node);
+  void serializeOpenRvtNodeArrays(std::ostream& os) const;
+  static void deserializeNode(std::istream& is, SerializedRVTNode& node, std::vector<char>& value);
+  static void serializeNode(std::ostream& os, const SerializedRVTNode& node, const std::vector<char>& value);
+
  protected:
   // vector index represents level in tree
   // level 0 represents RVB node so it would always hold 0x0
@@ -366,6 +393,11 @@ class RangeValidationTree {
   uint64_t min_rvb_index_{};  // RVB index is (RVB ID / fetch range size). This is the minimal index in the tree.
   uint64_t max_rvb_index_{};  // RVB index is (RVB ID / fetch range size). This is the maximal index in the tree.
   std::unordered_set<uint64_t> node_ids_to_erase_;
+  // Nodes changed/removed since the last resetChangedNodes(), kept sorted as they are serialized. Changes are not
+  // tracked before the 1st reset, and after the tree is cleared.
+  bool track_changed_nodes_{false};
+  std::set<uint64_t> changed_node_ids_;
+  std::set<uint64_t> removed_node_ids_;
   const logging::Logger& logger_;
 
   // constants
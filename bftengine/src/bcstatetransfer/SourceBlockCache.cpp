@@ -0,0 +1,60 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "SourceBlockCache.hpp"
+
+namespace bftEngine::bcst::impl {
+
+const std::string* SourceBlockCache::get(uint64_t blockId) const {
+  auto it = blocks_.find(blockId);
+  return (it != blocks_.end()) ? &it->second : nullptr;
+}
+
+size_t SourceBlockCache::put(uint64_t blockId, const char* data, uint32_t size) {
+  erase(blockId);
+  blocks_.emplace(blockId, std::string(data, size));
+  bytes_ += size;
+
+  size_t numEvicted{0};
+  while (bytes_ > maxBytes_) {
+    auto it = blocks_.begin();
+    bytes_ -= it->second.size();
+    blocks_.erase(it);
+    ++numEvicted;
+  }
+  return numEvicted;
+}
+
+void SourceBlockCache::erase(uint64_t blockId) {
+  auto it = blocks_.find(blockId);
+  if (it != blocks_.end()) {
+    bytes_ -= it->second.size();
+    blocks_.erase(it);
+  }
+}
+
+size_t SourceBlockCache::eraseBelow(uint64_t blockId) {
+  size_t numErased{0};
+  for (auto it = blocks_.begin(); (it != blocks_.end()) && (it->first < blockId); ++numErased) {
+    bytes_ -= it->second.size();
+    it = blocks_.erase(it);
+  }
+  return numErased;
+}
+
+void SourceBlockCache::clear() {
+  blocks_.clear();
+  bytes_ = 0;
+}
+
+}  // namespace bftEngine::bcst::impl
@@ -0,0 +1,52 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace bftEngine::bcst::impl {
+
+// A bounded cache of the serialized blocks a source replica read ahead of the batches requested by a destination.
+// Destinations fetch blocks in ascending order, hence once the cache is full, the blocks with the lowest IDs are
+// evicted first.
+class SourceBlockCache {
+ public:
+  explicit SourceBlockCache(size_t maxBytes) : maxBytes_{maxBytes} {}
+
+  // Return the cached block, nullptr if it is not cached.
+  const std::string* get(uint64_t blockId) const;
+  bool contains(uint64_t blockId) const { return blocks_.find(blockId) != blocks_.end(); }
+
+  // Cache (or replace) a block and evict the lowest blocks while the cache is too big. Return the number of evicted
+  // blocks, which might include the block itself.
+  size_t put(uint64_t blockId, const char* data, uint32_t size);
+
+  void erase(uint64_t blockId);
+  // Erase all blocks below blockId (exclusive). Return the number of erased blocks.
+  size_t eraseBelow(uint64_t blockId);
+  void clear();
+
+  size_t size() const { return blocks_.size(); }
+  size_t bytes() const { return bytes_; }
+
+ private:
+  const size_t maxBytes_;
+  std::map<uint64_t, std::string> blocks_;
+  size_t bytes_{0};
+};
+
+}  // namespace bftEngine::bcst::impl
@@ -71,14 +71,16 @@ void SourceSelector::reset() {
   currentPrimary_ = NO_REPLICA;
   nominatedPrimary_ = NO_REPLICA;
   nominatedPrimaryCounter_ = 0;
+  stripeSources_.clear();
   metrics_.current_source_replica_.Get().Set(currentReplica_);
   metrics_.preferred_replicas_.Get().Set("");
+  metrics_.num_stripe_sources_.Get().Set(0);
 }
 
 bool SourceSelector::isReset() const {
   return preferredReplicas_.empty() && (currentReplica_ == NO_REPLICA) && (sourceSelectionTimeMilli_ == 0) &&
          (fetchingTimeStamp_ == 0) && (fetchRetransmissionCounter_ == 0) && !fetchRetransmissionOngoing_ &&
-         actualSources_.empty() && !receivedValidBlockFromSrc_;
+         actualSources_.empty() && !receivedValidBlockFromSrc_ && stripeSources_.empty();
 }
 
 bool SourceSelector::retransmissionTimeoutExpired(uint64_t currTimeMilli) const {
@@ -264,6 +266,93 @@ void SourceSelector::updateCurrentPrimary(uint16_t newPrimary) {
   currentPrimary_ = newPrimary;
 }
 
+std::vector<uint16_t> SourceSelector::updateStripeSources() {
+  auto isEligible = [this](uint16_t replicaId) {
+    return isPreferredSourceId(replicaId) && (replicaId != currentReplica_) && (replicaId != currentPrimary_);
+  };
+  for (auto it = stripeSources_.begin(); it != stripeSources_.end();) {
+    if (!isEligible(it->first)) {
+      LOG_INFO(logger_, "Stop using stripe source " << it->first);
+      it = stripeSources_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto replicaId : preferredReplicas_) {
+    if (stripeSources_.size() >= maxStripeSources_) {
+      break;
+    }
+    if (isEligible(replicaId) && stripeSources_.emplace(replicaId, StripeSource{minStripeWindow_, 0}).second) {
+      LOG_INFO(logger_, "Start using stripe source " << replicaId << KVLOG(minStripeWindow_));
+    }
+  }
+  metrics_.num_stripe_sources_.Get().Set(stripeSources_.size());
+
+  std::vector<uint16_t> stripeSources;
+  stripeSources.reserve(stripeSources_.size());
+  for (const auto &[replicaId, _] : stripeSources_) {
+    stripeSources.push_back(replicaId);
+  }
+  return stripeSources;
+}
+
+uint32_t SourceSelector::stripeWindow(uint16_t replicaId) const {
+  auto it = stripeSources_.find(replicaId);
+  return (it == stripeSources_.end()) ? minStripeWindow_ : it->second.window;
+}
+
+void SourceSelector::onStripeCompleted(uint16_t replicaId, uint64_t bytes, uint64_t durationMilli) {
+  auto it = stripeSources_.find(replicaId);
+  if (it == stripeSources_.end()) {
+    return;
+  }
+  auto &source = it->second;
+  const uint64_t bytesPerSec = (bytes * 1000) / std::max<uint64_t>(durationMilli, 1);
+  source.bytesPerSec = (source.bytesPerSec == 0) ? bytesPerSec : (source.bytesPerSec + bytesPerSec) / 2;
+
+  // The fastest stripe source is asked for the largest window, and the others for windows in proportion to their
+  // throughput, such that all stripes take about the same time. A window is at most doubled per completed stripe.
+  uint64_t maxBytesPerSec = 0;
+  for (const auto &[_, s] : stripeSources_) {
+    maxBytesPerSec = std::max(maxBytesPerSec, s.bytesPerSec);
+  }
+  uint64_t window = (maxBytesPerSec == 0) ? maxStripeWindow_ : (maxStripeWindow_ * source.bytesPerSec) / maxBytesPerSec;
+  window = std::min(window, std::min<uint64_t>(2ULL * source.window, maxStripeWindow_));
+  window = std::max<uint64_t>(window, minStripeWindow_);
+  if (window > source.window) {
+    metrics_.stripe_window_grown_++;
+  } else if (window < source.window) {
+    metrics_.stripe_window_shrunk_++;
+  }
+  LOG_DEBUG(logger_, KVLOG(replicaId, bytes, durationMilli, source.bytesPerSec, maxBytesPerSec, source.window, window));
+  source.window = static_cast<uint32_t>(window);
+}
+
+void SourceSelector::onStripeExpired(uint16_t replicaId) {
+  auto it = stripeSources_.find(replicaId);
+  if (it == stripeSources_.end()) {
+    return;
+  }
+  auto &source = it->second;
+  const auto window = std::max(source.window / 2, minStripeWindow_);
+  if (window < source.window) {
+    metrics_.stripe_window_shrunk_++;
+  }
+  LOG_INFO(logger_, "Stripe expired:" << KVLOG(replicaId, source.window, window));
+  source.window = window;
+}
+
+void SourceSelector::removeStripeSource(uint16_t replicaId) {
+  LOG_INFO(logger_, "Remove stripe source " << replicaId);
+  stripeSources_.erase(replicaId);
+  metrics_.stripe_sources_removed_++;
+  metrics_.num_stripe_sources_.Get().Set(stripeSources_.size());
+  if (isPreferredSourceId(replicaId)) {
+    removePreferredReplica(replicaId);
+    metrics_.preferred_replicas_.Get().Set(preferredReplicasToString());
+  }
+}
+
 }  // namespace impl
 }  // namespace bcst
 }  // namespace bftEngine
@@ -12,10 +12,13 @@
 // file.
 #pragma once
 
+#include <algorithm>
+#include <map>
 #include <random>
 #include <set>
 #include <stdint.h>
 #include <sstream>
+#include <vector>
 
 #include "Logger.hpp"
 #include "assertUtils.hpp"
@@ -38,6 +41,11 @@ enum class SourceReplacementMode { GRACEFUL, IMMEDIATE, DO_NOT };
 
 // Information about which current source is selected and which replicas are
 // preferred, as well as data that helps to select a current source replica.
+//
+// Besides the current source, up to maxStripeSources other preferred replicas may be used as stripe sources: each is
+// asked for a batch of blocks ahead of the one fetched from the current source. The number of blocks asked from a
+// stripe source is its window, which starts at minStripeWindow and adapts to the throughput measured on the stripes it
+// completed, such that slower sources are asked for less blocks.
 class SourceSelector {
   // This class is strictly used for testing
   friend class BcStTestDelegator;
@@ -48,7 +56,10 @@ class SourceSelector {
                  uint32_t sourceReplicaReplacementTimeoutMilli,
                  uint32_t maxFetchRetransmissions,
                  uint16_t minPrePrepareMsgsForPrimaryAwareness,
-                 logging::Logger &logger)
+                 logging::Logger &logger,
+                 uint16_t maxStripeSources = 0,
+                 uint32_t minStripeWindow = 1,
+                 uint32_t maxStripeWindow = 1)
       : allOtherReplicas_(std::move(allOtherReplicas)),
         randomGen_(std::random_device()()),
         sourceReplacementTimeoutMilli_(sourceReplicaReplacementTimeoutMilli),
@@ -57,6 +68,9 @@ class SourceSelector {
         fetchRetransmissionOngoing_(false),
         receivedValidBlockFromSrc_(false),
         minPrePrepareMsgsForPrimaryAwareness_(minPrePrepareMsgsForPrimaryAwareness),
+        maxStripeSources_(maxStripeSources),
+        minStripeWindow_(minStripeWindow),
+        maxStripeWindow_(std::max(minStripeWindow, maxStripeWindow)),
         logger_(logger),
         metrics_component_{concordMetrics::Component("state_transfer_source_selector",
                                                      std::make_shared<concordMetrics::Aggregator>())},
@@ -68,7 +82,13 @@ class SourceSelector {
                  metrics_component_.RegisterCounter("replacement_due_to_periodic_change"),
                  metrics_component_.RegisterCounter("replacement_due_to_source_same_as_primary"),
                  metrics_component_.RegisterCounter("total_replacements"),
-                 metrics_component_.RegisterCounter("total_retransmissions_expired")} {}
+                 metrics_component_.RegisterCounter("total_retransmissions_expired"),
+                 metrics_component_.RegisterGauge("num_stripe_sources", 0),
+                 metrics_component_.RegisterCounter("stripe_window_grown"),
+                 metrics_component_.RegisterCounter("stripe_window_shrunk"),
+                 metrics_component_.RegisterCounter("stripe_sources_removed")} {
+    ConcordAssertGT(minStripeWindow_, 0);
+  }
 
   bool hasSource() const;
   void removeCurrentReplica();
@@ -125,6 +145,25 @@ class SourceSelector {
 
   void checkAndRefillPreferredReplicas();
 
+  // Striped fetching
+  // Drop the stripe sources which are no longer preferred, or became the current source or the primary, and add
+  // preferred replicas up to maxStripeSources. Return the stripe sources.
+  std::vector<uint16_t> updateStripeSources();
+
+  bool isStripeSource(uint16_t replicaId) const { return stripeSources_.count(replicaId) != 0; }
+
+  // The number of blocks to ask from a stripe source
+  uint32_t stripeWindow(uint16_t replicaId) const;
+
+  // A stripe source has sent all the blocks of its stripe. Adapt its window to the measured throughput.
+  void onStripeCompleted(uint16_t replicaId, uint64_t bytes, uint64_t durationMilli);
+
+  // The stripe of a stripe source was not completed in time
+  void onStripeExpired(uint16_t replicaId);
+
+  // A stripe source sent bad data or rejected its stripe: it is no longer preferred
+  void removeStripeSource(uint16_t replicaId);
+
   // Metric
   void setAggregator(std::shared_ptr<concordMetrics::Aggregator> aggregator) {
     metrics_component_.SetAggregator(aggregator);
@@ -160,6 +199,17 @@ class SourceSelector {
   uint16_t nominatedPrimary_ = NO_REPLICA;
   uint16_t nominatedPrimaryCounter_ = 0;
   uint16_t minPrePrepareMsgsForPrimaryAwareness_ = 10;
+
+  // Stripe sources
+  struct StripeSource {
+    uint32_t window = 0;
+    uint64_t bytesPerSec = 0;  // 0 until a stripe is completed
+  };
+  const uint16_t maxStripeSources_;
+  const uint32_t minStripeWindow_;
+  const uint32_t maxStripeWindow_;
+  std::map<uint16_t, StripeSource> stripeSources_;
+
   logging::Logger &logger_;
 
  protected:
@@ -177,6 +227,11 @@ class SourceSelector {
     CounterHandle total_replacements_;
 
     CounterHandle total_retransmissions_expired_;
+
+    GaugeHandle num_stripe_sources_;
+    CounterHandle stripe_window_grown_;
+    CounterHandle stripe_window_shrunk_;
+    CounterHandle stripe_sources_removed_;
   };
   mutable Metrics metrics_;
 };
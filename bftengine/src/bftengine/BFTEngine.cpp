@@ -218,7 +218,11 @@ IReplica::IReplicaPtr IReplica::createNewReplica(const ReplicaConfig &replicaCon
   auto replicaInternal = std::make_unique<ReplicaInternal>();
   shared_ptr<MsgHandlersRegistrator> msgHandlersPtr(new MsgHandlersRegistrator());
   auto incomingMsgsStorageImpPtr =
-      std::make_unique<IncomingMsgsStorageImp>(msgHandlersPtr, timersResolution, replicaConfig.replicaId);
+      std::make_unique<IncomingMsgsStorageImp>(msgHandlersPtr,
+                                               timersResolution,
+                                               replicaConfig.replicaId,
+                                               replicaConfig.enableLockFreeIncomingMsgsQueues,
+                                               replicaConfig.numOfMsgValidationThreads);
   auto &timers = incomingMsgsStorageImpPtr->timers();
   shared_ptr<IncomingMsgsStorage> incomingMsgsStoragePtr{std::move(incomingMsgsStorageImpPtr)};
   shared_ptr<bft::communication::IReceiver> msgReceiverPtr(new MsgReceiver(incomingMsgsStoragePtr));
@@ -278,7 +282,10 @@ IReplica::IReplicaPtr IReplica::createNewRoReplica(const ReplicaConfig &replicaC
   auto replicaInternal = std::make_unique<ReplicaInternal>();
   auto msgHandlers = std::make_shared<MsgHandlersRegistrator>();
   auto incomingMsgsStorageImpPtr =
-      std::make_unique<IncomingMsgsStorageImp>(msgHandlers, timersResolution, replicaConfig.replicaId);
+      std::make_unique<IncomingMsgsStorageImp>(msgHandlers,
+                                               timersResolution,
+                                               replicaConfig.replicaId,
+                                               replicaConfig.enableLockFreeIncomingMsgsQueues);
   auto &timers = incomingMsgsStorageImpPtr->timers();
   std::shared_ptr<IncomingMsgsStorage> incomingMsgsStorage{std::move(incomingMsgsStorageImpPtr)};
   auto msgReceiver = std::make_shared<MsgReceiver>(incomingMsgsStorage);
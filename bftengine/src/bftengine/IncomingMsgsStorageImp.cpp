@@ -24,21 +24,40 @@ namespace bftEngine::impl {
 
 IncomingMsgsStorageImp::IncomingMsgsStorageImp(const std::shared_ptr<MsgHandlersRegistrator>& msgHandlersPtr,
                                                std::chrono::milliseconds msgWaitTimeout,
-                                               uint16_t replicaId)
+                                               uint16_t replicaId,
+                                               bool lockFreeQueuesEnabled,
+                                               uint16_t numOfValidationThreads)
     : IncomingMsgsStorage(),
+      lockFreeQueuesEnabled_(lockFreeQueuesEnabled),
       msgHandlers_(msgHandlersPtr),
       msgWaitTimeout_(msgWaitTimeout),
       take_lock_recorder_(histograms_.take_lock),
       wait_for_cv_recorder_(histograms_.wait_for_cv) {
   replicaId_ = replicaId;
-  ptrProtectedQueueForExternalMessages_ = new queue<MessageWithCallback>();
+  ptrProtectedQueueForExternalMessages_ = new queue<ExternalMsg>();
   ptrProtectedQueueForInternalMessages_ = new queue<InternalMessage>();
   lastOverflowWarning_ = MinTime;
-  ptrThreadLocalQueueForExternalMessages_ = new queue<MessageWithCallback>();
+  ptrThreadLocalQueueForExternalMessages_ = new queue<ExternalMsg>();
   ptrThreadLocalQueueForInternalMessages_ = new queue<InternalMessage>();
+  if (lockFreeQueuesEnabled_) {
+    consensusLane_ = std::make_unique<ExternalLane>(maxNumberOfPendingExternalMsgs_);
+    clientLane_ = std::make_unique<ExternalLane>(maxNumberOfPendingExternalMsgs_);
+    internalLane_ = std::make_unique<InternalLane>();
+    LOG_INFO(GL, "Lock-free incoming message lanes enabled" << KVLOG(consensusLane_->capacity()));
+  }
+  if (numOfValidationThreads > 0) {
+    msgsValidator_ = std::make_unique<IncomingMsgsValidator>(
+        numOfValidationThreads,
+        maxNumberOfPendingExternalMsgs_,
+        msgHandlers_,
+        [this](ExternalMsg&& msg) { enqueueExternalMsg(std::move(msg)); },
+        replicaId_);
+  }
 }
 
 IncomingMsgsStorageImp::~IncomingMsgsStorageImp() {
+  // Validation threads push to the queues below
+  msgsValidator_.reset();
   delete ptrProtectedQueueForExternalMessages_;
   delete ptrProtectedQueueForInternalMessages_;
   delete ptrThreadLocalQueueForExternalMessages_;
@@ -46,6 +65,7 @@ IncomingMsgsStorageImp::~IncomingMsgsStorageImp() {
 }
 
 void IncomingMsgsStorageImp::start() {
+  if (msgsValidator_) msgsValidator_->start();
   if (!dispatcherThread_.joinable()) {
     std::future<void> futureObj = signalStarted_.get_future();
     dispatcherThread_ = std::thread([=] { dispatchMessages(signalStarted_); });
@@ -55,8 +75,10 @@ void IncomingMsgsStorageImp::start() {
 }
 
 void IncomingMsgsStorageImp::stop() {
+  if (msgsValidator_) msgsValidator_->stop();
   if (dispatcherThread_.joinable()) {
     stopped_ = true;
+    if (lockFreeQueuesEnabled_) wakeUpDispatcher();
     dispatcherThread_.join();
     LOG_INFO(GL, "Dispatching thread stopped");
   }
@@ -70,10 +92,18 @@ bool IncomingMsgsStorageImp::pushExternalMsg(std::unique_ptr<MessageBase> msg) {
 bool IncomingMsgsStorageImp::pushExternalMsg(std::unique_ptr<MessageBase> msg, Callback onMsgPopped) {
   MsgCode::Type type = static_cast<MsgCode::Type>(msg->type());
   LOG_TRACE(MSGS, type);
+  // All messages take the same path, so that messages of the same sender stay ordered
+  if (msgsValidator_) return msgsValidator_->push(std::move(msg), std::move(onMsgPopped));
+  return enqueueExternalMsg(ExternalMsg{std::move(msg), std::move(onMsgPopped), std::nullopt, std::nullopt});
+}
+
+// can be called by any thread
+bool IncomingMsgsStorageImp::enqueueExternalMsg(ExternalMsg&& msg) {
+  if (lockFreeQueuesEnabled_) return pushExternalMsgToLane(std::move(msg));
   std::unique_lock<std::mutex> mlock(lock_);
   if (ptrProtectedQueueForExternalMessages_->size() >= maxNumberOfPendingExternalMsgs_) {
     Time now = getMonotonicTime();
-    auto msg_type = static_cast<MsgCode::Type>(msg->type());
+    auto msg_type = static_cast<MsgCode::Type>(msg.preValidatedMsgType ? *msg.preValidatedMsgType : msg.msg->type());
     if ((now - lastOverflowWarning_) > (milliseconds(minTimeBetweenOverflowWarningsMilli_))) {
       LOG_WARN(GL, "Queue Full. Dropping some msgs." << KVLOG(maxNumberOfPendingExternalMsgs_, msg_type));
       lastOverflowWarning_ = now;
@@ -83,7 +113,7 @@ bool IncomingMsgsStorageImp::pushExternalMsg(std::unique_ptr<MessageBase> msg, C
   }
   histograms_.dropped_msgs_in_a_row->record(dropped_msgs);
   dropped_msgs = 0;
-  ptrProtectedQueueForExternalMessages_->push(std::make_pair(std::move(msg), std::move(onMsgPopped)));
+  ptrProtectedQueueForExternalMessages_->push(std::move(msg));
   condVar_.notify_one();
   return true;
 }
@@ -100,6 +130,11 @@ bool IncomingMsgsStorageImp::pushExternalMsgRaw(char* msg, size_t size, Callback
 
 // can be called by any thread
 void IncomingMsgsStorageImp::pushInternalMsg(InternalMessage&& msg) {
+  if (lockFreeQueuesEnabled_) {
+    internalLane_->push(QueuedInternalMsg{std::move(msg), getMonotonicTime()});
+    wakeUpDispatcher();
+    return;
+  }
   std::unique_lock<std::mutex> mlock(lock_);
   ptrProtectedQueueForInternalMessages_->push(std::move(msg));
   condVar_.notify_one();
@@ -107,6 +142,7 @@ void IncomingMsgsStorageImp::pushInternalMsg(InternalMessage&& msg) {
 
 // should only be called by the dispatching thread
 IncomingMsg IncomingMsgsStorageImp::getMsgForProcessing() {
+  if (lockFreeQueuesEnabled_) return getMsgFromLanes();
   auto msg = popThreadLocal();
   if (msg.tag != IncomingMsg::INVALID) return msg;
   {
@@ -148,11 +184,7 @@ IncomingMsg IncomingMsgsStorageImp::popThreadLocal() {
     ptrThreadLocalQueueForInternalMessages_->pop();
     return msg;
   } else if (!ptrThreadLocalQueueForExternalMessages_->empty()) {
-    auto& item = ptrThreadLocalQueueForExternalMessages_->front();
-    if (item.second) {
-      item.second();
-    }
-    auto msg = IncomingMsg{std::move(item.first)};
+    auto msg = toIncomingMsg(std::move(ptrThreadLocalQueueForExternalMessages_->front()));
     ptrThreadLocalQueueForExternalMessages_->pop();
     return msg;
   } else {
@@ -160,6 +192,134 @@ IncomingMsg IncomingMsgsStorageImp::popThreadLocal() {
   }
 }
 
+// should only be called by the dispatching thread
+IncomingMsg IncomingMsgsStorageImp::toIncomingMsg(ExternalMsg&& msg) {
+  if (msg.preValidatedMsgType) return IncomingMsg{*msg.preValidatedMsgType, std::move(msg.validated)};
+  if (msg.onMsgPopped) {
+    msg.onMsgPopped();
+  }
+  return IncomingMsg{std::move(msg.msg)};
+}
+
+bool IncomingMsgsStorageImp::isClientMsg(uint16_t msgType) {
+  switch (msgType) {
+    case MsgCode::ClientRequest:
+    case MsgCode::ClientBatchRequest:
+    case MsgCode::ClientPreProcessRequest:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// can be called by any thread
+bool IncomingMsgsStorageImp::pushExternalMsgToLane(ExternalMsg&& msg) {
+  const auto msgType = msg.preValidatedMsgType ? *msg.preValidatedMsgType : msg.msg->type();
+  auto& lane = isClientMsg(msgType) ? *clientLane_ : *consensusLane_;
+  const bool full = pendingLaneMsgs_.fetch_add(1, std::memory_order_relaxed) >= maxNumberOfPendingExternalMsgs_;
+  if (full || !lane.tryPush(QueuedExternalMsg{std::move(msg), getMonotonicTime()})) {
+    pendingLaneMsgs_.fetch_sub(1, std::memory_order_relaxed);
+    const auto nowMilli = static_cast<int64_t>(getMonotonicTimeMilli());
+    auto lastWarningMilli = lastLaneOverflowWarningMilli_.load(std::memory_order_relaxed);
+    if (nowMilli - lastWarningMilli > static_cast<int64_t>(minTimeBetweenOverflowWarningsMilli_) &&
+        lastLaneOverflowWarningMilli_.compare_exchange_strong(lastWarningMilli, nowMilli)) {
+      const auto msg_type = static_cast<MsgCode::Type>(msgType);
+      LOG_WARN(GL, "Lane Full. Dropping some msgs." << KVLOG(maxNumberOfPendingExternalMsgs_, msg_type));
+    }
+    droppedLaneMsgs_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  wakeUpDispatcher();
+  return true;
+}
+
+// should only be called by the dispatching thread
+IncomingMsg IncomingMsgsStorageImp::getMsgFromLanes() {
+  auto msg = popFromLanes();
+  if (msg.tag != IncomingMsg::INVALID) return msg;
+
+  // Spin for a while before parking - at high message rates the next message is likely to show up within microseconds
+  // and parking would cost a futex wait and a wake up on each side.
+  const auto spinStart = getMonotonicTime();
+  const auto spinPeriod = microseconds(spinMicros_);
+  auto iterations = 0u;
+  while (!stopped_) {
+    if (auto spunMsg = popFromLanes(); spunMsg.tag != IncomingMsg::INVALID) {
+      const auto spun = duration_cast<microseconds>(getMonotonicTime() - spinStart).count();
+      histograms_.spin_found_msg->record(spun);
+      spinMicros_ = std::min(spinMicros_ * 2, maxSpinMicros_);
+      return spunMsg;
+    }
+    if ((++iterations % 64) == 0) {
+      if (getMonotonicTime() - spinStart >= spinPeriod) break;
+      std::this_thread::yield();
+    }
+  }
+  histograms_.spin_period->record(spinMicros_);
+  spinMicros_ = std::max(spinMicros_ / 2, minSpinMicros_);
+
+  parkDispatcher();
+  return popFromLanes();
+}
+
+// should only be called by the dispatching thread
+IncomingMsg IncomingMsgsStorageImp::popFromLanes() {
+  // Internal messages first, then consensus messages, then client requests - a replica flooded by clients must keep
+  // making consensus progress.
+  if (auto internal = internalLane_->tryPop()) {
+    histograms_.internal_lane_depth->record(internalLane_->size());
+    histograms_.internal_lane_wait_time->record(
+        duration_cast<microseconds>(getMonotonicTime() - internal->pushTime).count());
+    return IncomingMsg{std::move(internal->msg)};
+  }
+  for (auto* lane : {consensusLane_.get(), clientLane_.get()}) {
+    auto external = lane->tryPop();
+    if (!external) continue;
+    pendingLaneMsgs_.fetch_sub(1, std::memory_order_relaxed);
+    const auto isConsensusLane = (lane == consensusLane_.get());
+    (isConsensusLane ? histograms_.consensus_lane_depth : histograms_.client_lane_depth)->record(lane->size());
+    (isConsensusLane ? histograms_.consensus_lane_wait_time : histograms_.client_lane_wait_time)
+        ->record(duration_cast<microseconds>(getMonotonicTime() - external->pushTime).count());
+    if (const auto dropped = droppedLaneMsgs_.exchange(0, std::memory_order_relaxed); dropped > 0) {
+      histograms_.dropped_msgs_in_a_row->record(dropped);
+    }
+    return toIncomingMsg(std::move(external->msg));
+  }
+  return IncomingMsg{};
+}
+
+bool IncomingMsgsStorageImp::lanesEmpty() const {
+  return internalLane_->empty() && consensusLane_->empty() && clientLane_->empty();
+}
+
+// should only be called by the dispatching thread
+void IncomingMsgsStorageImp::parkDispatcher() {
+  take_lock_recorder_.start();
+  std::unique_lock<std::mutex> mlock(lock_);
+  take_lock_recorder_.end();
+  dispatcherParked_ = true;
+  // Pairs with the fence in wakeUpDispatcher(): either the producer sees dispatcherParked_ set, or we see its message.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (stopped_ || !lanesEmpty()) {
+    dispatcherParked_ = false;
+    return;
+  }
+  LOG_TRACE(MSGS, "Waiting for condition variable");
+  wait_for_cv_recorder_.start();
+  condVar_.wait_for(mlock, msgWaitTimeout_, [this]() { return !dispatcherParked_; });
+  wait_for_cv_recorder_.end();
+  dispatcherParked_ = false;
+}
+
+// can be called by any thread
+void IncomingMsgsStorageImp::wakeUpDispatcher() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!dispatcherParked_) return;
+  std::unique_lock<std::mutex> mlock(lock_);
+  dispatcherParked_ = false;
+  condVar_.notify_one();
+}
+
 void IncomingMsgsStorageImp::dispatchMessages(std::promise<void>& signalStarted) {
   signalStarted.set_value();
   MDC_PUT(MDC_REPLICA_ID_KEY, std::to_string(replicaId_));
@@ -196,6 +356,9 @@ void IncomingMsgsStorageImp::dispatchMessages(std::promise<void>& signalStarted)
         } break;
         case IncomingMsg::INTERNAL:
           msgHandlers_->handleInternalMsg(std::move(msg.internal));
+          break;
+        case IncomingMsg::PRE_VALIDATED:
+          msgHandlers_->handlePreValidatedMsg(msg.preValidatedMsgType, std::move(msg.preValidated));
       };
     }
   } catch (const std::exception& e) {
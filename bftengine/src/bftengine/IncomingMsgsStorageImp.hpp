@@ -14,10 +14,12 @@
 #pragma once
 
 #include "IncomingMsgsStorage.hpp"
+#include "IncomingMsgsValidator.hpp"
 #include "MsgHandlersRegistrator.hpp"
 #include "Timers.hpp"
 #include "diagnostics.h"
 #include "performance_handler.h"
+#include "lock_free_queue.hpp"
 
 #include <queue>
 #include <atomic>
@@ -29,11 +31,23 @@
 
 namespace bftEngine::impl {
 
+// Incoming messages are handed from the communication threads to a single dispatching thread. Two queueing modes are
+// supported:
+// 1. The default mode: all producers push to mutex-protected queues that are swapped with the dispatcher's thread-local
+//    queues.
+// 2. The lock-free mode: producers push to lock-free multi-producer/single-consumer lanes - a bounded lane for
+//    consensus messages, a bounded lane for client messages and an unbounded lane for internal messages. The
+//    dispatcher spins on the lanes for an adaptive period and parks on a condition variable only when they stay empty.
+// In both modes, if numOfValidationThreads is positive, all external messages go through an IncomingMsgsValidator
+// worker pool, which keeps them ordered per sender. Messages that have a pre-validator registered reach the dispatcher
+// as the result of their validation.
 class IncomingMsgsStorageImp : public IncomingMsgsStorage {
  public:
   explicit IncomingMsgsStorageImp(const std::shared_ptr<MsgHandlersRegistrator>& msgHandlersPtr,
                                   std::chrono::milliseconds msgWaitTimeout,
-                                  uint16_t replicaId);
+                                  uint16_t replicaId,
+                                  bool lockFreeQueuesEnabled = false,
+                                  uint16_t numOfValidationThreads = 0);
   ~IncomingMsgsStorageImp() override;
 
   void start() override;
@@ -54,16 +68,43 @@ class IncomingMsgsStorageImp : public IncomingMsgsStorage {
 
   auto& timers() { return timers_; }
 
+  [[nodiscard]] bool lockFreeQueuesEnabled() const { return lockFreeQueuesEnabled_; }
+
  private:
   void dispatchMessages(std::promise<void>& signalStarted);
   IncomingMsg getMsgForProcessing();
   IncomingMsg popThreadLocal();
 
+  // Push to the dispatcher's queues, or drop the message if they are full
+  bool enqueueExternalMsg(ExternalMsg&& msg);
+  static IncomingMsg toIncomingMsg(ExternalMsg&& msg);
+
+  // Lock-free mode
+  struct QueuedExternalMsg {
+    ExternalMsg msg;
+    Time pushTime;
+  };
+  struct QueuedInternalMsg {
+    InternalMessage msg;
+    Time pushTime;
+  };
+  using ExternalLane = concord::util::MpscRingQueue<QueuedExternalMsg>;
+  using InternalLane = concord::util::MpscLinkedQueue<QueuedInternalMsg>;
+
+  static bool isClientMsg(uint16_t msgType);
+  bool pushExternalMsgToLane(ExternalMsg&& msg);
+  IncomingMsg getMsgFromLanes();
+  IncomingMsg popFromLanes();
+  bool lanesEmpty() const;
+  void parkDispatcher();
+  void wakeUpDispatcher();
+
  private:
   const uint64_t minTimeBetweenOverflowWarningsMilli_ = 5 * 1000;
   const uint16_t maxNumberOfPendingExternalMsgs_ = 20000;
 
   uint16_t replicaId_;
+  const bool lockFreeQueuesEnabled_;
 
   std::mutex lock_;
   std::condition_variable condVar_;
@@ -71,10 +112,8 @@ class IncomingMsgsStorageImp : public IncomingMsgsStorage {
   std::shared_ptr<MsgHandlersRegistrator> msgHandlers_;
   std::chrono::milliseconds msgWaitTimeout_;
 
-  using MessageWithCallback = std::pair<std::unique_ptr<MessageBase>, Callback>;
-
   // New messages are pushed to ptrProtectedQueue.... ; protected by lock
-  std::queue<MessageWithCallback>* ptrProtectedQueueForExternalMessages_;
+  std::queue<ExternalMsg>* ptrProtectedQueueForExternalMessages_;
   std::queue<InternalMessage>* ptrProtectedQueueForInternalMessages_;
 
   // Time of last queue overflow; protected by lock
@@ -82,9 +121,32 @@ class IncomingMsgsStorageImp : public IncomingMsgsStorage {
   size_t dropped_msgs = 0;
 
   // Messages are fetched from ptrThreadLocalQueue...; should be accessed only by the dispatching thread
-  std::queue<MessageWithCallback>* ptrThreadLocalQueueForExternalMessages_;
+  std::queue<ExternalMsg>* ptrThreadLocalQueueForExternalMessages_;
   std::queue<InternalMessage>* ptrThreadLocalQueueForInternalMessages_;
 
+  // Lanes are used only in the lock-free mode. Bounded lanes are sized to hold maxNumberOfPendingExternalMsgs_.
+  std::unique_ptr<ExternalLane> consensusLane_;
+  std::unique_ptr<ExternalLane> clientLane_;
+  // Internal messages must never be dropped, hence an unbounded lane.
+  std::unique_ptr<InternalLane> internalLane_;
+
+  // Set by the dispatcher right before it waits on condVar_. Producers take lock_ only if it is set.
+  std::atomic_bool dispatcherParked_ = false;
+  // Number of external messages in the consensus and client lanes. The lanes' capacity is rounded up to a power of two,
+  // hence maxNumberOfPendingExternalMsgs_ is enforced with this count.
+  std::atomic_size_t pendingLaneMsgs_ = 0;
+  // Number of external messages dropped since the dispatcher last popped from a lane.
+  std::atomic_size_t droppedLaneMsgs_ = 0;
+  std::atomic<int64_t> lastLaneOverflowWarningMilli_ = 0;
+
+  // How long the dispatcher spins on empty lanes before parking. It doubles every time a message shows up while
+  // spinning and halves every time the dispatcher has to park, within [minSpinMicros_, maxSpinMicros_].
+  static constexpr int64_t minSpinMicros_ = 1;
+  static constexpr int64_t maxSpinMicros_ = 200;
+  int64_t spinMicros_ = 50;
+
+  std::unique_ptr<IncomingMsgsValidator> msgsValidator_;
+
   std::thread dispatcherThread_;
   std::promise<void> signalStarted_;
   std::atomic<bool> stopped_ = false;
@@ -106,7 +168,15 @@ class IncomingMsgsStorageImp : public IncomingMsgsStorage {
                                           evaluate_timers,
                                           take_lock,
                                           wait_for_cv,
-                                          dropped_msgs_in_a_row});
+                                          dropped_msgs_in_a_row,
+                                          consensus_lane_depth,
+                                          client_lane_depth,
+                                          internal_lane_depth,
+                                          consensus_lane_wait_time,
+                                          client_lane_wait_time,
+                                          internal_lane_wait_time,
+                                          spin_found_msg,
+                                          spin_period});
       }
     }
     DEFINE_SHARED_RECORDER(external_queue_len_at_swap, 1, 10000, 3, concord::diagnostics::Unit::COUNT);
@@ -115,6 +185,17 @@ class IncomingMsgsStorageImp : public IncomingMsgsStorage {
     DEFINE_SHARED_RECORDER(wait_for_cv, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
     DEFINE_SHARED_RECORDER(evaluate_timers, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
     DEFINE_SHARED_RECORDER(dropped_msgs_in_a_row, 1, 100000, 3, concord::diagnostics::Unit::COUNT);
+    // Lock-free mode: lane depth is sampled when a message is popped, wait time is measured from push to pop.
+    DEFINE_SHARED_RECORDER(consensus_lane_depth, 1, 100000, 3, concord::diagnostics::Unit::COUNT);
+    DEFINE_SHARED_RECORDER(client_lane_depth, 1, 100000, 3, concord::diagnostics::Unit::COUNT);
+    DEFINE_SHARED_RECORDER(internal_lane_depth, 1, 100000, 3, concord::diagnostics::Unit::COUNT);
+    DEFINE_SHARED_RECORDER(
+        consensus_lane_wait_time, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(client_lane_wait_time, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        internal_lane_wait_time, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(spin_found_msg, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(spin_period, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
   };
   Recorders histograms_;
 
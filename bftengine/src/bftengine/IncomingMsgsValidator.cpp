@@ -0,0 +1,112 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the sub-component's license, as noted in the LICENSE
+// file.
+
+#include "IncomingMsgsValidator.hpp"
+#include "assertUtils.hpp"
+#include "Logger.hpp"
+
+using namespace std::chrono;
+using namespace concord::diagnostics;
+
+namespace bftEngine::impl {
+
+IncomingMsgsValidator::IncomingMsgsValidator(uint16_t numOfThreads,
+                                             size_t maxNumOfPendingMsgs,
+                                             const std::shared_ptr<MsgHandlersRegistrator>& msgHandlers,
+                                             MsgSink msgSink,
+                                             uint16_t replicaId)
+    : maxNumOfPendingMsgsPerWorker_{std::max<size_t>(maxNumOfPendingMsgs / std::max<uint16_t>(numOfThreads, 1), 1)},
+      msgHandlers_{msgHandlers},
+      msgSink_{std::move(msgSink)},
+      replicaId_{replicaId} {
+  ConcordAssertGT(numOfThreads, 0);
+  for (auto i = 0u; i < numOfThreads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+}
+
+IncomingMsgsValidator::~IncomingMsgsValidator() { stop(); }
+
+void IncomingMsgsValidator::start() {
+  stopped_ = false;
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) continue;
+    worker->thread = std::thread([this, &worker = *worker] { validateMessages(worker); });
+  }
+  LOG_INFO(GL, "Incoming messages validation stage started" << KVLOG(workers_.size(), maxNumOfPendingMsgsPerWorker_));
+}
+
+void IncomingMsgsValidator::stop() {
+  stopped_ = true;
+  for (auto& worker : workers_) {
+    {
+      std::lock_guard<std::mutex> lg(worker->lock);
+      worker->condVar.notify_one();
+    }
+    if (worker->thread.joinable()) worker->thread.join();
+  }
+}
+
+// can be called by any thread
+bool IncomingMsgsValidator::push(std::unique_ptr<MessageBase> msg, IncomingMsgsStorage::Callback onMsgPopped) {
+  // Messages of the same sender are always handled by the same worker to keep them ordered.
+  auto& worker = *workers_[msg->senderId() % workers_.size()];
+  {
+    std::lock_guard<std::mutex> lg(worker.lock);
+    if (worker.msgs.size() >= maxNumOfPendingMsgsPerWorker_) return false;
+    worker.msgs.push(PendingMsg{std::move(msg), std::move(onMsgPopped), steady_clock::now()});
+  }
+  worker.condVar.notify_one();
+  return true;
+}
+
+void IncomingMsgsValidator::validateMessages(Worker& worker) {
+  MDC_PUT(MDC_REPLICA_ID_KEY, std::to_string(replicaId_));
+  MDC_PUT(MDC_THREAD_KEY, "message-validation");
+  std::queue<PendingMsg> localMsgs;
+  try {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> ul(worker.lock);
+        worker.condVar.wait(ul, [this, &worker] { return stopped_ || !worker.msgs.empty(); });
+        if (stopped_) break;
+        histograms_.queue_len->recordAtomic(worker.msgs.size());
+        localMsgs.swap(worker.msgs);
+      }
+      while (!localMsgs.empty()) {
+        auto& pending = localMsgs.front();
+        histograms_.time_in_queue->recordAtomic(
+            duration_cast<microseconds>(steady_clock::now() - pending.pushTime).count());
+        const auto msgType = pending.msg->type();
+        // The callback of a message must be called when the dispatcher pops it, hence such messages are not validated
+        auto preValidator = pending.onMsgPopped ? nullptr : msgHandlers_->getMsgPreValidator(msgType);
+        if (preValidator) {
+          auto validated = [&preValidator, &pending, this]() {
+            TimeRecorder<true> scoped_timer(*histograms_.validate);
+            return preValidator(pending.msg.release());
+          }();
+          msgSink_(ExternalMsg{nullptr, nullptr, msgType, std::move(validated)});
+        } else {
+          msgSink_(ExternalMsg{std::move(pending.msg), std::move(pending.onMsgPopped), std::nullopt, std::nullopt});
+        }
+        localMsgs.pop();
+      }
+    }
+  } catch (const std::exception& e) {
+    LOG_FATAL(GL, "Exception: " << e.what() << " exiting ...");
+    std::terminate();
+  }
+  LOG_INFO(GL, "Message validation thread stopped" << KVLOG(worker.msgs.size()));
+}
+
+}  // namespace bftEngine::impl
@@ -0,0 +1,112 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the sub-component's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include "IncomingMsgsStorage.hpp"
+#include "MsgHandlersRegistrator.hpp"
+#include "messages/MessageBase.hpp"
+#include "messages/InternalMessage.hpp"
+#include "diagnostics.h"
+#include "performance_handler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace bftEngine::impl {
+
+// An external message on its way to the dispatcher. A message which has been through a pre-validator is replaced by
+// the result of its validation.
+struct ExternalMsg {
+  std::unique_ptr<MessageBase> msg;
+  IncomingMsgsStorage::Callback onMsgPopped;
+  // Pre-validated messages only: the type of the original message and the result of its validation (std::nullopt if
+  // the message is invalid)
+  std::optional<uint16_t> preValidatedMsgType;
+  std::optional<InternalMessage> validated;
+};
+
+// IncomingMsgsValidator is a validation stage that sits in front of the message dispatcher.
+// All external messages go through it: messages of the same sender are always handled by the same worker thread, in
+// the order they were pushed, and are passed on to the dispatcher via msgSink in that order. Messages that have a
+// pre-validator registered in MsgHandlersRegistrator (and no onMsgPopped callback) are validated by the worker, and
+// only the result of the validation is passed on. Other messages are passed on as is, to be validated by the
+// dispatcher. Hence per-sender ordering is preserved, whichever path a message takes.
+class IncomingMsgsValidator {
+ public:
+  using MsgSink = std::function<void(ExternalMsg&&)>;
+
+  IncomingMsgsValidator(uint16_t numOfThreads,
+                        size_t maxNumOfPendingMsgs,
+                        const std::shared_ptr<MsgHandlersRegistrator>& msgHandlers,
+                        MsgSink msgSink,
+                        uint16_t replicaId);
+  ~IncomingMsgsValidator();
+
+  void start();
+  void stop();
+
+  // Can be called by any thread. Returns false if the worker's queue is full and the message is dropped.
+  bool push(std::unique_ptr<MessageBase> msg, IncomingMsgsStorage::Callback onMsgPopped);
+
+  [[nodiscard]] uint16_t numOfThreads() const { return static_cast<uint16_t>(workers_.size()); }
+
+ private:
+  struct PendingMsg {
+    std::unique_ptr<MessageBase> msg;
+    IncomingMsgsStorage::Callback onMsgPopped;
+    std::chrono::steady_clock::time_point pushTime;
+  };
+  struct Worker {
+    std::mutex lock;
+    std::condition_variable condVar;
+    std::queue<PendingMsg> msgs;
+    std::thread thread;
+  };
+
+  void validateMessages(Worker& worker);
+
+ private:
+  const size_t maxNumOfPendingMsgsPerWorker_;
+  std::shared_ptr<MsgHandlersRegistrator> msgHandlers_;
+  MsgSink msgSink_;
+  const uint16_t replicaId_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic_bool stopped_ = false;
+
+  // 60 seconds
+  static constexpr int64_t MAX_VALUE_MICROSECONDS = 1000 * 1000 * 60l;
+  struct Recorders {
+    Recorders() {
+      auto& registrar = concord::diagnostics::RegistrarSingleton::getInstance();
+      const auto component = "incomingMsgsValidator";
+      if (!registrar.perf.isRegisteredComponent(component)) {
+        registrar.perf.registerComponent(component, {validate, time_in_queue, queue_len});
+      }
+    }
+    DEFINE_SHARED_RECORDER(validate, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(time_in_queue, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(queue_len, 1, 100000, 3, concord::diagnostics::Unit::COUNT);
+  };
+  Recorders histograms_;
+};
+
+}  // namespace bftEngine::impl
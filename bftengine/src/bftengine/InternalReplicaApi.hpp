@@ -16,6 +16,7 @@
 
 #include "PrimitiveTypes.hpp"
 #include "IncomingMsgsStorage.hpp"
+#include "TimeUtils.hpp"
 
 class IThresholdVerifier;
 namespace concord::util {
@@ -43,6 +44,8 @@ class InternalReplicaApi  // TODO(GG): rename + clean + split to several classes
   virtual bool isClientRequestInProcess(NodeIdType clientId, ReqId reqSeqNum) const = 0;
   virtual SeqNum getPrimaryLastUsedSeqNum() const = 0;
   virtual uint64_t getRequestsInQueue() const = 0;
+  // Arrival time of the oldest request in the primary queue, or MinTime if the queue is empty
+  virtual Time getOldestRequestArrivalTime() const { return MinTime; }
   virtual SeqNum getLastExecutedSeqNum() const = 0;
   virtual std::pair<PrePrepareMsg*, bool> buildPrePrepareMessage() { return std::make_pair(nullptr, false); }
   virtual bool tryToSendPrePrepareMsg(bool batchingLogic) { return false; }
@@ -11,6 +11,7 @@
 
 #pragma once
 #include <functional>
+#include <optional>
 #include <unordered_map>
 
 #include "messages/MessageBase.hpp"
@@ -28,6 +29,12 @@ using CallbackTypeWithRefArg = std::function<void(T&&)>;
 using MsgHandlerCallback = CallbackTypeWithPtrArg<MessageBase>;
 using ValidatedMsgHandlerCallback = CallbackTypeWithPtrArg<CarrierMesssage>;
 using InternalMsgHandlerCallback = CallbackTypeWithRefArg<InternalMessage>;
+// Takes ownership of the given external message. Returns the internal message to be dispatched instead, or nullopt
+// if the message is invalid (and has been disposed of).
+using MsgPreValidatorCallback = std::function<std::optional<InternalMessage>(MessageBase*)>;
+// Called by the dispatcher for every pre-validated message, with the type of the original message and the result of
+// its pre-validation.
+using PreValidatedMsgHandlerCallback = std::function<void(uint16_t, std::optional<InternalMessage>&&)>;
 
 // MsgHandlersRegistrator class contains message handling callback functions.
 // Logically it's a singleton - only one message handler could be registered for every message type,
@@ -41,7 +48,10 @@ using InternalMsgHandlerCallback = CallbackTypeWithRefArg<InternalMessage>;
 //     message will happen.
 //  3) Internal message callback handler which will be called by the Internal message
 //     dispatcher.
+//  4) Pre-validator callback which will be called by the IncomingMsgsValidator worker threads,
+//     before the message reaches the dispatcher.
 // MsgHandlersRegistrator is a repository of all kinds of callbacks.
+// Note: callbacks must be registered before the incoming messages storage is started.
 
 class MsgHandlersRegistrator {
  public:
@@ -59,6 +69,13 @@ class MsgHandlersRegistrator {
 
   void registerInternalMsgHandler(const InternalMsgHandlerCallback& cb) { internalMsgHandler_ = cb; }
 
+  // A pre-validator is called from multiple threads concurrently, so it must be thread safe.
+  void registerMsgPreValidator(uint16_t msgId, const MsgPreValidatorCallback& preValidatorFunc) {
+    msgPreValidators_[msgId] = preValidatorFunc;
+  }
+
+  void registerPreValidatedMsgHandler(const PreValidatedMsgHandlerCallback& cb) { preValidatedMsgHandler_ = cb; }
+
   MsgHandlerCallback getCallback(uint16_t msgId) {
     auto iterator = msgHandlers_.find(msgId);
     if (iterator != msgHandlers_.end()) return iterator->second;
@@ -74,12 +91,26 @@ class MsgHandlersRegistrator {
     return nullptr;
   }
 
+  MsgPreValidatorCallback getMsgPreValidator(uint16_t msgId) const {
+    auto iterator = msgPreValidators_.find(msgId);
+    if (iterator != msgPreValidators_.end()) return iterator->second;
+    return nullptr;
+  }
+
   void handleInternalMsg(InternalMessage&& msg) { internalMsgHandler_(std::move(msg)); }
 
+  // If no handler is registered, valid pre-validated messages are handled as internal messages.
+  void handlePreValidatedMsg(uint16_t msgType, std::optional<InternalMessage>&& msg) {
+    if (preValidatedMsgHandler_) return preValidatedMsgHandler_(msgType, std::move(msg));
+    if (msg) internalMsgHandler_(std::move(*msg));
+  }
+
  private:
   std::unordered_map<uint16_t, MsgHandlerCallback> msgHandlers_;
   std::unordered_map<uint16_t, ValidatedMsgHandlerCallback> validatedMsgHandlers_;
+  std::unordered_map<uint16_t, MsgPreValidatorCallback> msgPreValidators_;
   InternalMsgHandlerCallback internalMsgHandler_;
+  PreValidatedMsgHandlerCallback preValidatedMsgHandler_;
 };
 
 }  // namespace bftEngine::impl
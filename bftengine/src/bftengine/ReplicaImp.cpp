@@ -160,6 +160,23 @@ void ReplicaImp::registerMsgHandlers() {
                                    bind(&ReplicaImp::messageHandler<StateTransferMsg>, this, _1));
 
   msgHandlers_->registerInternalMsgHandler([this](InternalMessage &&msg) { onInternalMsg(std::move(msg)); });
+
+  // These messages are validated ahead of the dispatcher by the IncomingMsgsValidator threads, if enabled.
+  msgHandlers_->registerMsgPreValidator(MsgCode::PrePrepare,
+                                        bind(&ReplicaImp::preValidateMessage<PrePrepareMsg>, this, _1));
+  msgHandlers_->registerMsgPreValidator(MsgCode::CommitPartial,
+                                        bind(&ReplicaImp::preValidateMessage<CommitPartialMsg>, this, _1));
+  msgHandlers_->registerMsgPreValidator(MsgCode::CommitFull,
+                                        bind(&ReplicaImp::preValidateMessage<CommitFullMsg>, this, _1));
+  msgHandlers_->registerMsgPreValidator(MsgCode::Checkpoint,
+                                        bind(&ReplicaImp::preValidateMessage<CheckpointMsg>, this, _1));
+  msgHandlers_->registerMsgPreValidator(MsgCode::ClientRequest,
+                                        bind(&ReplicaImp::preValidateMessage<ClientRequestMsg>, this, _1));
+  msgHandlers_->registerPreValidatedMsgHandler([this](uint16_t msgType, std::optional<InternalMessage> &&msg) {
+    // Counted here rather than in the pre-validator, as the statistics may only be accessed by the dispatcher
+    if (config_.debugStatisticsEnabled) DebugStatistics::onReceivedExMessage(msgType);
+    if (msg) onInternalMsg(std::move(*msg));
+  });
 }
 
 template <typename T>
@@ -255,8 +272,46 @@ void ReplicaImp::validatedMessageHandler(CarrierMesssage *msg) {
   if (!isCollectingState()) {
     onMessage<T>(trueTypeObj);
   } else {
+    peekConsensusMessage<T>(trueTypeObj);
+    delete trueTypeObj;
+  }
+}
+
+/**
+ * preValidateMessage<T> This is a family of pre-validation callbacks, called by the IncomingMsgsValidator threads
+ * before the message reaches the dispatcher. It performs the same validation that the dispatcher would have done in
+ * messageHandler<T> and translates the message into an internal message.
+ *
+ * @param msg : The external message, owned by this function.
+ * @return : returns the internal message to dispatch, or nullopt if the message is invalid.
+ */
+template <typename T>
+std::optional<InternalMessage> ReplicaImp::preValidateMessage(MessageBase *msg) {
+  T *trueTypeObj = new T(msg);
+  delete msg;
+  try {
+    trueTypeObj->validate(*repsInfo);
+  } catch (std::exception &e) {
+    onReportAboutInvalidMessage(trueTypeObj, e.what());
     delete trueTypeObj;
+    return std::nullopt;
   }
+
+  if constexpr (std::is_same_v<T, PrePrepareMsg>) {
+    if (getReplicaConfig().prePrepareFinalizeAsyncEnabled) {
+      // Same as validatePrePrepareMsg(), but the view is taken from the message as the current view may only be
+      // accessed by the dispatcher. A view change indicator from an old view is ignored by the dispatcher.
+      const auto viewNum = trueTypeObj->viewNumber();
+      if (!validatePreProcessedResults(trueTypeObj, viewNum)) {
+        delete trueTypeObj;
+        return ViewChangeIndicatorInternalMsg(ReplicaAsksToLeaveViewMsg::Reason::PrimarySentBadPreProcessResult,
+                                              viewNum);
+      }
+      return PrePrepareCarrierInternalMsg(trueTypeObj);
+    }
+  }
+  CarrierMesssage *validatedCarrierMsg = new ValidatedMessageCarrierInternalMsg<T>(trueTypeObj);
+  return validatedCarrierMsg;
 }
 /**
  * validateMessage This is synchronous validate message.
@@ -491,6 +546,7 @@ void ReplicaImp::onMessage<ClientRequestMsg>(ClientRequestMsg *m) {
         if (time_to_collect_batch_ == MinTime) time_to_collect_batch_ = getMonotonicTime();
         metric_primary_batching_duration_.addStartTimeStamp(m->getCid());
         requestsQueueOfPrimary.push(m);
+        requestsArrivalTimesOfPrimary.push(getMonotonicTime());
         primaryCombinedReqSize += m->size();
         primary_queue_size_.Get().Set(requestsQueueOfPrimary.size());
         tryToSendPrePrepareMsg(true);
@@ -616,6 +672,7 @@ void ReplicaImp::removeDuplicatedRequestsFromRequestsQueue() {
   while (first != nullptr && !clientsManager->canBecomePending(first->clientProxyId(), first->requestSeqNum())) {
     primaryCombinedReqSize -= first->size();
     requestsQueueOfPrimary.pop();
+    requestsArrivalTimesOfPrimary.pop();
     delete first;
     first = (!requestsQueueOfPrimary.empty() ? requestsQueueOfPrimary.front() : nullptr);
   }
@@ -675,9 +732,11 @@ bool ReplicaImp::tryToSendPrePrepareMsg(bool batchingLogic) {
       time_to_collect_batch_ = MinTime;
     }
   } else {
+    const auto oldestRequestArrivalTime = getOldestRequestArrivalTime();
     auto builtReq = buildPrePrepareMessage();
     isSent = builtReq.second;
     if (isSent) {
+      reqBatchingLogic_.recordRequestToPrePrepareDelay(oldestRequestArrivalTime);
       pp = builtReq.first;
       batch_closed_on_logic_off_++;
       time_to_collect_batch_ = MinTime;
@@ -726,6 +785,7 @@ ClientRequestMsg *ReplicaImp::addRequestToPrePrepareMessage(ClientRequestMsg *&n
   }
   primaryCombinedReqSize -= nextRequest->size();
   requestsQueueOfPrimary.pop();
+  requestsArrivalTimesOfPrimary.pop();
   delete nextRequest;
   primary_queue_size_.Get().Set(requestsQueueOfPrimary.size());
   return (!requestsQueueOfPrimary.empty() ? requestsQueueOfPrimary.front() : nullptr);
@@ -1008,7 +1068,12 @@ bool ReplicaImp::validatePreProcessedResults(const PrePrepareMsg *msg, const Vie
   std::vector<std::optional<std::string>> errors(msg->numberOfRequests());
   size_t error_id = 0;
   // The thread pool is initialized once and kept with this function.
-  // This function is called in a single thread as the queue by dispatcher will not allow multiple threads together.
+  // This function runs concurrently: the IncomingMsgsValidator threads call it from preValidateMessage<PrePrepareMsg>,
+  // while the dispatcher and the validatePrePrepareMsg() task may call it for other PrePrepares. Sharing the static
+  // pool is safe: the function-local static is initialized once under the C++ static initialization guarantee,
+  // ThreadPool::async() pushes to a mutex-protected task queue, and every call only waits on the futures and writes to
+  // the errors vector it owns. The pool tasks never call back into this function, so callers blocking on their own
+  // futures cannot starve the pool.
   try {
     static auto &threadPool = RequestThreadPool::getThreadPool(RequestThreadPool::PoolLevel::FIRSTLEVEL);
 
@@ -1556,6 +1621,7 @@ void ReplicaImp::onInternalMsg(InternalMessage &&msg) {
   if (auto *ppcim = std::get_if<PrePrepareCarrierInternalMsg>(&msg)) {
     if (isCollectingState() || bftEngine::ControlStateManager::instance().getPruningProcessStatus()) {
       LOG_INFO(GL, "Received PrePrepareCarrierInternalMsg while pruning or state transfer, so ignoring the message");
+      if (isCollectingState()) peekConsensusMessage<PrePrepareMsg>(ppcim->ppm_);
       delete ppcim->ppm_;
       ppcim->ppm_ = nullptr;
       return;
@@ -3245,6 +3311,7 @@ void ReplicaImp::onNewView(const std::vector<PrePrepareMsg *> &prePreparesForNew
     auto msg = requestsQueueOfPrimary.front();
     primaryCombinedReqSize -= msg->size();
     requestsQueueOfPrimary.pop();
+    requestsArrivalTimesOfPrimary.pop();
     delete msg;
   }
 
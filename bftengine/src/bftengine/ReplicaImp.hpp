@@ -116,6 +116,7 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   // requests queue (used by the primary)
   std::queue<ClientRequestMsg*> requestsQueueOfPrimary;  // only used by the primary
   size_t primaryCombinedReqSize = 0;                     // only used by the primary
+  std::queue<Time> requestsArrivalTimesOfPrimary;        // parallel to requestsQueueOfPrimary
 
   std::map<uint64_t, std::pair<Time, ClientRequestMsg*>>
       requestsOfNonPrimary;  // used to retransmit client requests by a non primary replica
@@ -384,6 +385,9 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   }
   SeqNum getPrimaryLastUsedSeqNum() const override { return primaryLastUsedSeqNum; }
   uint64_t getRequestsInQueue() const override { return requestsQueueOfPrimary.size(); }
+  Time getOldestRequestArrivalTime() const override {
+    return requestsArrivalTimesOfPrimary.empty() ? MinTime : requestsArrivalTimesOfPrimary.front();
+  }
   SeqNum getLastExecutedSeqNum() const override { return lastExecutedSeqNum; }
   std::pair<PrePrepareMsg*, bool> buildPrePrepareMessage() override;
   bool tryToSendPrePrepareMsg(bool batchingLogic = false) override;
@@ -445,6 +449,10 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   template <typename T>
   void validatedMessageHandler(CarrierMesssage* msg);
 
+  // Called by the IncomingMsgsValidator threads - must not touch the replica state.
+  template <typename T>
+  std::optional<InternalMessage> preValidateMessage(MessageBase* msg);
+
   void send(MessageBase*, NodeIdType) override;
   void sendAndIncrementMetric(MessageBase*, NodeIdType, CounterHandle&);
 
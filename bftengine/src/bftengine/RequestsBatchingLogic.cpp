@@ -23,6 +23,7 @@ RequestsBatchingLogic::RequestsBatchingLogic(InternalReplicaApi &replica,
                                              concordUtil::Timers &timers)
     : replica_(replica),
       metric_not_enough_client_requests_event_{metrics.RegisterCounter("notEnoughClientRequestsEvent")},
+      metric_pipelined_preprepare_proposals_{metrics.RegisterCounter("pipelinedPrePrepareProposals")},
       batchingPolicy_((BatchingPolicy)config.batchingPolicy),
       batchingFactorCoefficient_(config.batchingFactorCoefficient),
       maxInitialBatchSize_(config.maxInitialBatchSize),
@@ -35,15 +36,40 @@ RequestsBatchingLogic::RequestsBatchingLogic(InternalReplicaApi &replica,
       minIncreaseCondition_(stod(config.adaptiveBatchingMinIncCond)),
       initialBatchSize_(config.maxNumOfRequestsInBatch),
       maxBatchSizeInBytes_(config.maxBatchSizeInBytes),
-      timers_(timers) {
+      timers_(timers),
+      proposalPipelineDepth_(config.prePrepareFinalizeAsyncEnabled
+                                 ? std::max<uint16_t>(config.prePrepareProposalPipelineDepth, 1)
+                                 : 1),
+      benchmarkReportPeriodSec_(config.prePrepareProposalBenchmarkReportPeriodSec) {
   if (batchingPolicy_ != BATCH_SELF_ADJUSTED)
     batchFlushTimer_ = timers_.add(milliseconds(batchFlushPeriodMs_),
                                    Timers::Timer::RECURRING,
                                    [this](Timers::Handle h) { onBatchFlushTimer(h); });
+  if (benchmarkReportPeriodSec_ > 0)
+    benchmarkReportTimer_ = timers_.add(seconds(benchmarkReportPeriodSec_),
+                                        Timers::Timer::RECURRING,
+                                        [this](Timers::Handle h) { onBenchmarkReportTimer(h); });
+  if (config.prePrepareProposalPipelineDepth > 1 && !config.prePrepareFinalizeAsyncEnabled)
+    LOG_WARN(GL,
+             "PrePrepare proposal pipelining requires prePrepareFinalizeAsyncEnabled; proposing one message at a time"
+                 << KVLOG(config.prePrepareProposalPipelineDepth));
 }
 
 RequestsBatchingLogic::~RequestsBatchingLogic() {
   if (batchingPolicy_ != BATCH_SELF_ADJUSTED) timers_.cancel(batchFlushTimer_);
+  if (benchmarkReportPeriodSec_ > 0) timers_.cancel(benchmarkReportTimer_);
+}
+
+void RequestsBatchingLogic::onBenchmarkReportTimer(Timers::Handle) {
+  auto &registrar = concord::diagnostics::RegistrarSingleton::getInstance();
+  registrar.perf.snapshot(kDiagnosticsComponent);
+  LOG_INFO(GL, "PrePrepare proposal benchmark:\n" << registrar.perf.toString(registrar.perf.get(kDiagnosticsComponent)));
+}
+
+void RequestsBatchingLogic::recordRequestToPrePrepareDelay(Time oldestRequestArrivalTime) {
+  if (oldestRequestArrivalTime == MinTime) return;
+  histograms_.request_to_preprepare_delay->record(
+      duration_cast<microseconds>(getMonotonicTime() - oldestRequestArrivalTime).count());
 }
 
 void RequestsBatchingLogic::onBatchFlushTimer(Timers::Handle) {
@@ -112,9 +138,39 @@ void RequestsBatchingLogic::adjustPreprepareSize() {
 }
 
 std::pair<PrePrepareMsg *, bool> RequestsBatchingLogic::batchRequests() {
+  auto prePrepareMsgWithResult = proposeBatch();
+  // A successful proposal without a message means that the PrePrepare is being finalized by a helper thread, and will
+  // reach the dispatcher later on. Meanwhile, the requests of the next slots can be collected.
+  if (!prePrepareMsgWithResult.first && prePrepareMsgWithResult.second) proposeNextSlots();
+  return prePrepareMsgWithResult;
+}
+
+// The self-adjusted policy puts all the pending requests in a single PrePrepare message, so only the other policies
+// are pipelined. Every slot goes through the replica's PrePrepare prerequisites, so the concurrency and work windows
+// (which count the PrePrepare messages that are still being finalized) bound the pipeline as well.
+void RequestsBatchingLogic::proposeNextSlots() {
+  if (batchingPolicy_ == BATCH_SELF_ADJUSTED) return;
+  uint16_t slots = 1;
+  while (slots < proposalPipelineDepth_) {
+    const auto prePrepareMsgWithResult = proposeBatch();
+    if (!prePrepareMsgWithResult.second) break;
+    ConcordAssert(prePrepareMsgWithResult.first == nullptr);
+    metric_pipelined_preprepare_proposals_++;
+    ++slots;
+  }
+  histograms_.slots_per_proposal->record(slots);
+}
+
+std::pair<PrePrepareMsg *, bool> RequestsBatchingLogic::proposeBatch() {
+  concord::diagnostics::TimeRecorder scoped_timer(*histograms_.proposal_latency);
   const auto requestsInQueue = replica_.getRequestsInQueue();
-  if (requestsInQueue == 0) return std::make_pair(nullptr, false);
+  if (requestsInQueue == 0) {
+    scoped_timer.doNotRecord();
+    return std::make_pair(nullptr, false);
+  }
 
+  // Taken before the requests are consumed, so that every proposed slot (pipelined ones included) is measured
+  const auto oldestRequestArrivalTime = replica_.getOldestRequestArrivalTime();
   std::pair<PrePrepareMsg *, bool> prePrepareMsgWithResult{nullptr, false};
   switch (batchingPolicy_) {
     case BATCH_SELF_ADJUSTED:
@@ -158,6 +214,11 @@ std::pair<PrePrepareMsg *, bool> RequestsBatchingLogic::batchRequests() {
       }
     } break;
   }
+  if (prePrepareMsgWithResult.second) {
+    recordRequestToPrePrepareDelay(oldestRequestArrivalTime);
+  } else {
+    scoped_timer.doNotRecord();
+  }
   return prePrepareMsgWithResult;
 }
 
@@ -18,6 +18,7 @@
 #include "InternalReplicaApi.hpp"
 #include "messages/PrePrepareMsg.hpp"
 #include "Timers.hpp"
+#include "diagnostics.h"
 #include "performance_handler.h"
 
 namespace bftEngine::batchingLogic {
@@ -33,10 +34,19 @@ class RequestsBatchingLogic {
   uint32_t getMaxNumberOfPendingRequestsInRecentHistory() const { return maxNumberOfPendingRequestsInRecentHistory_; }
   uint32_t getBatchingFactor() const { return batchingFactor_; }
 
+  // Proposes a PrePrepare message. When the PrePrepare finalization is asynchronous and the policy permits it, up to
+  // prePrepareProposalPipelineDepth messages are proposed back to back (see proposeNextSlots()).
   std::pair<PrePrepareMsg *, bool> batchRequests();
 
+  // Called for every proposed PrePrepare message, with the arrival time of its oldest request. The replica calls it
+  // for the messages it builds without the batching logic.
+  void recordRequestToPrePrepareDelay(Time oldestRequestArrivalTime);
+
  private:
+  std::pair<PrePrepareMsg *, bool> proposeBatch();
+  void proposeNextSlots();
   void onBatchFlushTimer(concordUtil::Timers::Handle timer);
+  void onBenchmarkReportTimer(concordUtil::Timers::Handle timer);
   std::pair<PrePrepareMsg *, bool> batchRequestsSelfAdjustedPolicy(SeqNum primaryLastUsedSeqNum,
                                                                    uint64_t requestsInQueue,
                                                                    SeqNum lastExecutedSeqNum);
@@ -45,6 +55,7 @@ class RequestsBatchingLogic {
  private:
   InternalReplicaApi &replica_;
   concordMetrics::CounterHandle metric_not_enough_client_requests_event_;
+  concordMetrics::CounterHandle metric_pipelined_preprepare_proposals_;
   BatchingPolicy batchingPolicy_;
   // Variables used to heuristically compute the 'optimal' batch size
   uint32_t maxNumberOfPendingRequestsInRecentHistory_ = 0;
@@ -65,9 +76,29 @@ class RequestsBatchingLogic {
   const uint32_t maxBatchSizeInBytes_;
   concordUtil::Timers &timers_;
   concordUtil::Timers::Handle batchFlushTimer_;
+  const uint16_t proposalPipelineDepth_;
+  const uint32_t benchmarkReportPeriodSec_;
+  concordUtil::Timers::Handle benchmarkReportTimer_;
   std::mutex batchProcessingLock_;
 
   static constexpr uint64_t MAX_VALUE_MICROSECONDS = 1000lu * 1000 * 60;
+  static constexpr auto kDiagnosticsComponent = "requestsBatchingLogic";
+  struct Recorders {
+    Recorders() {
+      auto &registrar = concord::diagnostics::RegistrarSingleton::getInstance();
+      if (!registrar.perf.isRegisteredComponent(kDiagnosticsComponent)) {
+        registrar.perf.registerComponent(kDiagnosticsComponent,
+                                         {proposal_latency, request_to_preprepare_delay, slots_per_proposal});
+      }
+    }
+    // Time to build one PrePrepare message, not including the asynchronous finalization
+    DEFINE_SHARED_RECORDER(proposal_latency, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    // Time the oldest request of every proposed PrePrepare message waited in the primary queue
+    DEFINE_SHARED_RECORDER(
+        request_to_preprepare_delay, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(slots_per_proposal, 1, kWorkWindowSize, 3, concord::diagnostics::Unit::COUNT);
+  };
+  Recorders histograms_;
 };
 
 }  // namespace bftEngine::batchingLogic
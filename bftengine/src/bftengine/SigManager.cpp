@@ -129,7 +129,13 @@ SigManager::SigManager(PrincipalId myId,
           metrics_component_.RegisterAtomicCounter("external_client_request_signatures_verified"),
           metrics_component_.RegisterAtomicCounter("peer_replicas_signature_verification_failed"),
           metrics_component_.RegisterAtomicCounter("peer_replicas_signatures_verified"),
-          metrics_component_.RegisterAtomicCounter("signature_verification_failed_on_unrecognized_participant_id")} {
+          metrics_component_.RegisterAtomicCounter("signature_verification_failed_on_unrecognized_participant_id"),
+          metrics_component_.RegisterAtomicCounter("signature_verification_batches"),
+          metrics_component_.RegisterAtomicCounter("signatures_verified_in_batches")},
+      numOfSigVerificationThreads_{ReplicaConfig::instance().numOfSigVerificationThreads} {
+  if (numOfSigVerificationThreads_ > 0) {
+    sigVerificationPool_ = std::make_unique<concord::util::ThreadPool>(numOfSigVerificationThreads_);
+  }
   map<KeyIndex, std::shared_ptr<concord::util::crypto::IVerifier>> publicKeyIndexToVerifier;
   size_t numPublickeys = publickeys.size();
 
@@ -210,6 +216,70 @@ bool SigManager::verifySig(
       return false;
     }
   }
+  updateSigVerificationMetrics(pid, result);
+  return result;
+}
+
+std::vector<bool> SigManager::verifySigs(const std::vector<SigVerificationRequest>& requests) const {
+  const auto numOfRequests = requests.size();
+  std::vector<std::shared_ptr<concord::util::crypto::IVerifier>> verifiers;
+  verifiers.reserve(numOfRequests);
+  {
+    std::shared_lock lock(mutex_);
+    for (const auto& req : requests) {
+      auto pos = verifiers_.find(req.pid);
+      verifiers.push_back(pos != verifiers_.end() ? pos->second : nullptr);
+    }
+  }
+
+  // std::vector<bool> packs its elements, so concurrent writes to different elements are not safe
+  std::vector<uint8_t> results(numOfRequests, false);
+  auto verifyRange = [&requests, &verifiers, &results](size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      if (!verifiers[i]) continue;
+      const auto& req = requests[i];
+      results[i] = verifiers[i]->verify(std::string(req.data, req.dataLength), std::string(req.sig, req.sigLength));
+    }
+  };
+  const auto numOfChunks = sigVerificationPool_ ? std::min(numOfRequests, numOfSigVerificationThreads_ + 1) : 1;
+  if (numOfChunks <= 1) {
+    verifyRange(0, numOfRequests);
+  } else {
+    // The first chunk is verified by the calling thread, while the pool verifies the rest
+    const auto chunkSize = (numOfRequests + numOfChunks - 1) / numOfChunks;
+    std::vector<std::future<void>> futures;
+    for (auto begin = chunkSize; begin < numOfRequests; begin += chunkSize) {
+      futures.push_back(sigVerificationPool_->async(verifyRange, begin, std::min(begin + chunkSize, numOfRequests)));
+    }
+    std::exception_ptr error;
+    try {
+      verifyRange(0, chunkSize);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    // The pool tasks refer to local data - wait for all of them before leaving, even on failure
+    for (auto& f : futures) f.wait();
+    if (error) std::rethrow_exception(error);
+    for (auto& f : futures) f.get();
+  }
+
+  std::vector<bool> ret(numOfRequests, false);
+  for (size_t i = 0; i < numOfRequests; ++i) {
+    if (!verifiers[i]) {
+      LOG_ERROR(GL, "Unrecognized pid " << requests[i].pid);
+      metrics_.sigVerificationFailedOnUnrecognizedParticipantId_++;
+      metrics_component_.UpdateAggregator();
+      continue;
+    }
+    ret[i] = results[i];
+    updateSigVerificationMetrics(requests[i].pid, ret[i]);
+  }
+  metrics_.sigVerificationBatches_++;
+  metrics_.sigsVerifiedInBatches_ += numOfRequests;
+  return ret;
+}
+
+void SigManager::updateSigVerificationMetrics(PrincipalId pid, bool result) const {
   bool idOfReplica = false, idOfExternalClient = false, idOfReadOnlyReplica = false;
   idOfExternalClient = replicasInfo_.isIdOfExternalClient(pid);
   if (!idOfExternalClient) {
@@ -234,7 +304,6 @@ bool SigManager::verifySig(
         metrics_component_.UpdateAggregator();
     }
   }
-  return result;
 }
 
 void SigManager::sign(const char* data, size_t dataLength, char* outSig, uint16_t outSigLength) const {
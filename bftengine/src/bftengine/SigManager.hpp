@@ -14,6 +14,7 @@
 #include "assertUtils.hpp"
 #include "Metrics.hpp"
 #include "crypto_utils.hpp"
+#include "thread_pool.hpp"
 
 #include <utility>
 #include <vector>
@@ -59,6 +60,18 @@ class SigManager {
   uint16_t getSigLength(PrincipalId pid) const;
   // returns false if actual verification failed, or if pid is invalid
   bool verifySig(PrincipalId pid, const char* data, size_t dataLength, const char* sig, uint16_t sigLength) const;
+
+  struct SigVerificationRequest {
+    PrincipalId pid;
+    const char* data;
+    size_t dataLength;
+    const char* sig;
+    uint16_t sigLength;
+  };
+  // Verifies a batch of signatures and returns the result of every request, in the same order. The verifiers are
+  // looked up once for the whole batch, and the verification itself is split between the calling thread and the
+  // signature verification thread pool (see ReplicaConfig::numOfSigVerificationThreads).
+  std::vector<bool> verifySigs(const std::vector<SigVerificationRequest>& requests) const;
   void sign(const char* data, size_t dataLength, char* outSig, uint16_t outSigLength) const;
   uint16_t getMySigLength() const;
   bool isClientTransactionSigningEnabled() { return clientTransactionSigningEnabled_; }
@@ -98,6 +111,8 @@ class SigManager {
                               concord::util::crypto::KeyFormat clientsKeysFormat,
                               ReplicasInfo& replicasInfo);
 
+  void updateSigVerificationMetrics(PrincipalId pid, bool result) const;
+
   const PrincipalId myId_;
   std::unique_ptr<concord::util::crypto::ISigner> mySigner_;
   std::map<PrincipalId, std::shared_ptr<concord::util::crypto::IVerifier>> verifiers_;
@@ -112,11 +127,17 @@ class SigManager {
     AtomicCounterHandle replicaSigVerified_;
 
     AtomicCounterHandle sigVerificationFailedOnUnrecognizedParticipantId_;
+
+    AtomicCounterHandle sigVerificationBatches_;
+    AtomicCounterHandle sigsVerifiedInBatches_;
   };
 
   mutable concordMetrics::Component metrics_component_;
   mutable Metrics metrics_;
   mutable std::shared_mutex mutex_;
+  // Helps the calling thread to verify batches, see verifySigs(). Not created if no helper threads are configured.
+  std::unique_ptr<concord::util::ThreadPool> sigVerificationPool_;
+  size_t numOfSigVerificationThreads_ = 0;
   // These methods bypass the singelton, and can be used (STRICTLY) for testing.
   // Define the below flag in order to use them in your test.
 #ifdef CONCORD_BFT_TESTING
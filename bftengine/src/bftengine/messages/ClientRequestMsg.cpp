@@ -97,6 +97,28 @@ bool ClientRequestMsg::shouldValidateAsync() const {
 }
 
 void ClientRequestMsg::validateImp(const ReplicasInfo& repInfo) const {
+  if (!validateWithoutSigVerification(repInfo)) return;
+
+  const auto* header = msgBody();
+  PrincipalId clientId = header->idOfClientProxy;
+  if (!SigManager::instance()->verifySig(
+          clientId, requestBuf(), header->requestLength, requestSignature(), header->reqSignatureLength)) {
+    std::stringstream msg;
+    LOG_WARN(CNSUS, "Signature verification failed for" << KVLOG(header->reqSeqNum, this->senderId(), clientId));
+    msg << "Signature verification failed for: "
+        << KVLOG(clientId,
+                 this->senderId(),
+                 header->reqSeqNum,
+                 header->requestLength,
+                 header->reqSignatureLength,
+                 getCid(),
+                 this->senderId());
+    throw std::runtime_error(msg.str());
+  }
+  LOG_TRACE(CNSUS, "Signature verified for" << KVLOG(header->reqSeqNum, this->senderId(), clientId));
+}
+
+bool ClientRequestMsg::validateWithoutSigVerification(const ReplicasInfo& repInfo) const {
   const auto* header = msgBody();
   const auto msgSize = size();
 
@@ -128,7 +150,7 @@ void ClientRequestMsg::validateImp(const ReplicasInfo& repInfo) const {
   if ((header->flags & RECONFIG_FLAG) != 0 &&
       (repInfo.isIdOfReplica(clientId) || repInfo.isIdOfPeerRoReplica(clientId))) {
     // Allow every reconfiguration message from replicas (it will be verified in the reconfiguration handler)
-    return;
+    return false;
   }
   if (!repInfo.isValidPrincipalId(clientId)) {
     msg << "Invalid clientId " << clientId;
@@ -194,23 +216,7 @@ void ClientRequestMsg::validateImp(const ReplicasInfo& repInfo) const {
     LOG_ERROR(CNSUS, msg.str());
     throw std::runtime_error(msg.str());
   }
-  if (doSigVerify) {
-    if (!sigManager->verifySig(
-            clientId, requestBuf(), header->requestLength, requestSignature(), header->reqSignatureLength)) {
-      std::stringstream msg;
-      LOG_WARN(CNSUS, "Signature verification failed for" << KVLOG(header->reqSeqNum, this->senderId(), clientId));
-      msg << "Signature verification failed for: "
-          << KVLOG(clientId,
-                   this->senderId(),
-                   header->reqSeqNum,
-                   header->requestLength,
-                   header->reqSignatureLength,
-                   getCid(),
-                   this->senderId());
-      throw std::runtime_error(msg.str());
-    }
-    LOG_TRACE(CNSUS, "Signature verified for" << KVLOG(header->reqSeqNum, this->senderId(), clientId));
-  }
+  return doSigVerify;
 }
 
 void ClientRequestMsg::setParams(NodeIdType sender,
@@ -74,6 +74,10 @@ class ClientRequestMsg : public MessageBase {
 
   void validate(const ReplicasInfo& repInfo) const override { validateImp(repInfo); }
 
+  // Same as validate(), except that the request signature is not verified. Returns true if the caller is expected to
+  // verify the signature, e.g. together with the other requests of a batch (see SigManager::verifySigs).
+  bool validateWithoutSigVerification(const ReplicasInfo& repInfo) const;
+
   bool shouldValidateAsync() const override;
 
  protected:
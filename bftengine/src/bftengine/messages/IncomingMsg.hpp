@@ -12,6 +12,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "messages/InternalMessage.hpp"
 
@@ -32,14 +33,20 @@ class MessageBase;
 // variant is only available in c++17.
 class IncomingMsg {
  public:
-  enum { EXTERNAL, INTERNAL, INVALID } tag;
+  enum { EXTERNAL, INTERNAL, PRE_VALIDATED, INVALID } tag;
 
   IncomingMsg() : tag(IncomingMsg::INVALID) {}
   explicit IncomingMsg(std::unique_ptr<MessageBase> msg) : tag(IncomingMsg::EXTERNAL), external(std::move(msg)) {}
   explicit IncomingMsg(InternalMessage&& msg) : tag(IncomingMsg::INTERNAL), internal(std::move(msg)) {}
+  // An external message that was validated ahead of the dispatcher: the type of the original message, and the result
+  // of its validation (std::nullopt if the message is invalid).
+  IncomingMsg(uint16_t msgType, std::optional<InternalMessage>&& validated)
+      : tag(IncomingMsg::PRE_VALIDATED), preValidatedMsgType(msgType), preValidated(std::move(validated)) {}
 
   std::unique_ptr<MessageBase> external;
   InternalMessage internal;
+  uint16_t preValidatedMsgType = 0;
+  std::optional<InternalMessage> preValidated;
 };
 
 }  // namespace bftEngine::impl
\ No newline at end of file
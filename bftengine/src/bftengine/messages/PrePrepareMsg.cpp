@@ -9,7 +9,9 @@
 // these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <sstream>
 #include <utility>
+#include <vector>
 #include <bftengine/ClientMsgs.hpp>
 #include "OpenTracing.hpp"
 #include "PrePrepareMsg.hpp"
@@ -116,11 +118,32 @@ void PrePrepareMsg::validate(const ReplicasInfo& repInfo) const {
   if (SigManager::instance()->isClientTransactionSigningEnabled()) {
     auto it = RequestsIterator(this);
     char* requestBody = nullptr;
-    // Here we validate each of the client requests arriving encapsulated inside the pre-prepare message
-    // This might also include validating the request's client signature
+    // Here we validate each of the client requests arriving encapsulated inside the pre-prepare message. The client
+    // signatures of all the requests are then verified at once, after all the other checks have passed.
+    // The requests point into this message's buffer, so the verification requests stay valid after req is destroyed.
+    std::vector<SigManager::SigVerificationRequest> sigVerificationRequests;
+    std::vector<std::pair<ReqId, NodeIdType>> sigVerificationReqIds;
     while (it.getAndGoToNext(requestBody)) {
       ClientRequestMsg req((ClientRequestMsgHeader*)requestBody);
-      req.validate(repInfo);
+      if (req.validateWithoutSigVerification(repInfo)) {
+        sigVerificationRequests.push_back({req.clientProxyId(),
+                                           req.requestBuf(),
+                                           req.requestLength(),
+                                           req.requestSignature(),
+                                           static_cast<uint16_t>(req.requestSignatureLength())});
+        sigVerificationReqIds.emplace_back(req.requestSeqNum(), req.clientProxyId());
+      }
+    }
+    if (sigVerificationRequests.empty()) return;
+
+    const auto sigVerificationResults = SigManager::instance()->verifySigs(sigVerificationRequests);
+    for (size_t i = 0; i < sigVerificationResults.size(); ++i) {
+      if (sigVerificationResults[i]) continue;
+      const auto& [reqSeqNum, clientId] = sigVerificationReqIds[i];
+      std::stringstream msg;
+      msg << __PRETTY_FUNCTION__ << ": client signature verification failed "
+          << KVLOG(reqSeqNum, clientId, senderId(), b()->seqNum);
+      throw std::runtime_error(msg.str());
     }
   }
 }
@@ -574,6 +574,9 @@ bool PreProcessor::checkClientBatchMsgCorrectness(const ClientBatchRequestMsgUni
 
   const auto &clientRequestMsgs = clientBatchReqMsg->getClientPreProcessRequestMsgs();
   bool valid = true;
+  // The signatures of the whole batch are verified at once, after all the other checks have passed
+  vector<SigManager::SigVerificationRequest> sigVerificationRequests;
+  vector<const ClientPreProcessRequestMsg *> sigVerificationMsgs;
   for (const auto &msg : clientRequestMsgs) {
     if (!checkClientMsgCorrectness(msg->requestSeqNum(),
                                    msg->getCid(),
@@ -583,11 +586,35 @@ bool PreProcessor::checkClientBatchMsgCorrectness(const ClientBatchRequestMsgUni
                                    clientBatchReqMsg->getCid())) {
       preProcessorMetrics_.preProcReqIgnored++;
       valid = false;
-    } else if (!validateMessage(msg.get())) {
+      continue;
+    }
+    try {
+      if (msg->validateWithoutSigVerification(myReplica_.getReplicasInfo())) {
+        sigVerificationRequests.push_back({msg->clientProxyId(),
+                                           msg->requestBuf(),
+                                           msg->requestLength(),
+                                           msg->requestSignature(),
+                                           static_cast<uint16_t>(msg->requestSignatureLength())});
+        sigVerificationMsgs.push_back(msg.get());
+      }
+    } catch (std::exception &e) {
+      LOG_WARN(logger(), "Message validation failed" << KVLOG(msg->type(), e.what()));
       preProcessorMetrics_.preProcReqInvalid++;
       valid = false;
     }
   }
+  if (!valid || sigVerificationRequests.empty()) return valid;
+
+  const auto sigVerificationResults = SigManager::instance()->verifySigs(sigVerificationRequests);
+  for (size_t i = 0; i < sigVerificationResults.size(); ++i) {
+    if (sigVerificationResults[i]) continue;
+    const auto *msg = sigVerificationMsgs[i];
+    LOG_WARN(logger(),
+             "Signature verification failed"
+                 << KVLOG(msg->requestSeqNum(), msg->getCid(), msg->clientProxyId(), clientBatchReqMsg->getCid()));
+    preProcessorMetrics_.preProcReqInvalid++;
+    valid = false;
+  }
   return valid;
 }
 
@@ -339,7 +339,12 @@ SimpleStateTran::SimpleStateTran(
       true,                                 // enableReservedPages
       true,                                 // enableSourceBlocksPreFetch
       true,                                 // enableSourceSelectorPrimaryAwareness
-      true                                  // enableStoreRvbDataDuringCheckpointing
+      true,                                 // enableStoreRvbDataDuringCheckpointing
+      0,                                    // maxNumOfStripeSources
+      bcst::ChunkCompression::NONE,         // chunkCompression
+      0,                                    // sourceReadAheadBlocks
+      256 * 1024 * 1024,                    // sourceBlockCacheSize
+      0                                     // numOfRvbReconstructionThreads
   };
 
   auto comparator = concord::storage::memorydb::KeyComparator();
@@ -184,6 +184,86 @@ TEST(SigManagerTest, ReplicasOnlyCheckVerify) {
   }
 }
 
+TEST(SigManagerTest, ReplicasOnlyCheckBatchVerify) {
+  constexpr size_t numReplicas{4};
+  constexpr PrincipalId myId{0};
+  constexpr size_t sigsPerReplica{5};
+  constexpr PrincipalId unknownPid{1000};
+  string myPrivKey;
+  unique_ptr<concord::util::crypto::RSASigner> signers[numReplicas];
+  set<pair<PrincipalId, const string>> publicKeysOfReplicas;
+
+  generateKeyPairs(numReplicas);
+
+  for (size_t i{1}; i <= numReplicas; ++i) {
+    string privKey, pubKey;
+    string privateKeyFullPath({string(KEYS_BASE_PATH) + string("/") + to_string(i) + string("/") + PRIV_KEY_NAME});
+    readFile(privateKeyFullPath, privKey);
+    PrincipalId pid = i - 1;  // folders are 1-indexed
+
+    if (pid == myId) {
+      myPrivKey = privKey;
+      continue;
+    }
+
+    signers[pid].reset(new concord::util::crypto::RSASigner(privKey, concord::util::crypto::KeyFormat::PemFormat));
+    string pubKeyFullPath({string(KEYS_BASE_PATH) + string("/") + to_string(i) + string("/") + PUB_KEY_NAME});
+    readFile(pubKeyFullPath, pubKey);
+    publicKeysOfReplicas.insert(make_pair(pid, pubKey));
+  }
+
+  // Verify the batch with helper threads, so that it is split into several chunks
+  auto& replicaConfig = createReplicaConfig();
+  replicaConfig.numOfSigVerificationThreads = 2;
+  ReplicasInfo replicaInfo(replicaConfig, false, false);
+  unique_ptr<SigManager> sigManager(SigManager::init(myId,
+                                                     myPrivKey,
+                                                     publicKeysOfReplicas,
+                                                     concord::util::crypto::KeyFormat::PemFormat,
+                                                     nullptr,
+                                                     concord::util::crypto::KeyFormat::PemFormat,
+                                                     replicaInfo));
+  replicaConfig.numOfSigVerificationThreads = 0;
+
+  vector<string> data;
+  vector<string> sigs;
+  vector<PrincipalId> pids;
+  vector<bool> expectedResults;
+  for (size_t i{0}; i < numReplicas; ++i) {
+    if (i == myId) continue;
+    for (size_t j{0}; j < sigsPerReplica; ++j) {
+      char buf[RANDOM_DATA_SIZE]{0};
+      generateRandomData(buf, RANDOM_DATA_SIZE);
+      data.emplace_back(buf, RANDOM_DATA_SIZE);
+      sigs.push_back(signers[i]->sign(data.back()));
+      pids.push_back(i);
+      // Corrupt every other signature, expect failure
+      const bool valid = (j % 2 == 0);
+      if (!valid) corrupt(sigs.back().data(), 1);
+      expectedResults.push_back(valid);
+    }
+  }
+  // A valid signature attributed to an unknown participant, expect failure
+  data.push_back(data.front());
+  sigs.push_back(sigs.front());
+  pids.push_back(unknownPid);
+  expectedResults.push_back(false);
+
+  vector<SigManager::SigVerificationRequest> requests;
+  for (size_t i{0}; i < data.size(); ++i) {
+    requests.push_back(
+        {pids[i], data[i].data(), data[i].size(), sigs[i].data(), static_cast<uint16_t>(sigs[i].size())});
+  }
+  ASSERT_EQ(expectedResults, sigManager->verifySigs(requests));
+  ASSERT_TRUE(sigManager->verifySigs({}).empty());
+
+  // The batch and the single signature verification agree
+  for (size_t i{0}; i < requests.size() - 1; ++i) {
+    const auto& r = requests[i];
+    ASSERT_EQ(expectedResults[i], sigManager->verifySig(r.pid, r.data, r.dataLength, r.sig, r.sigLength));
+  }
+}
+
 TEST(SigManagerTest, ReplicasOnlyCheckSign) {
   constexpr size_t numReplicas{4};
   constexpr PrincipalId myId{0};
@@ -107,6 +107,8 @@ class BcStTestDelegator {
   void clear() const { ASSERT_NFF(return rvt_->clear()); }
   std::ostringstream getSerializedRvbData() const { return rvt_->getSerializedRvbData(); }
   bool setSerializedRvbData(std::istringstream& iss) const { return rvt_->setSerializedRvbData(iss); }
+  bool getSerializedRvbDataDelta(std::ostringstream& oss) const { return rvt_->getSerializedRvbDataDelta(oss); }
+  void resetChangedNodes() const { rvt_->resetChangedNodes(); }
   std::string getRootCurrentValueStr() const { return rvt_->getRootCurrentValueStr(); }
   RVBId getMaxRvbId() const { return rvt_->getMaxRvbId(); }
   RVBId getMinRvbId() const { return rvt_->getMinRvbId(); }
@@ -341,6 +343,103 @@ INSTANTIATE_TEST_CASE_P(
                       std::make_pair(DataGenerator::randomNum(3, 10), DataGenerator::randomNum(4, 20)),
                       std::make_pair(DataGenerator::randomNum(3, 10), DataGenerator::randomNum(4, 20))), );
 
+TEST_P(RVTTestserializeDeserializeTreeFixture, serializeDeserializeTreeIncrementally) {
+  auto inputs = GetParam();
+  const uint32_t RVT_K = inputs.first;
+  const uint32_t fetch_range_size = inputs.second;
+  auto config = RVTConfig(RVT_K, fetch_range_size, 32);
+  init(config);
+  ASSERT_NFF(rvt_delegator_->addRightNode(fetch_range_size, fetch_range_size * 10 * RVT_K));
+
+  std::ostringstream delta;
+  ASSERT_FALSE(rvt_delegator_->getSerializedRvbDataDelta(delta));
+  rvt_delegator_->resetChangedNodes();
+  auto base = rvt_delegator_->getSerializedRvbData().str();
+  for (size_t i{}; i < 10; ++i) {
+    // add and remove some nodes, then merge the changes into the previous serialized tree
+    size_t num_of_nodes_to_add = DataGenerator::randomNum(1, 2 * RVT_K);
+    size_t num_of_nodes_to_remove = DataGenerator::randomNum(1, RVT_K / 2);
+    std::cout << KVLOG(i, num_of_nodes_to_add, num_of_nodes_to_remove) << std::endl;
+    ASSERT_NFF(rvt_delegator_->addRightNode(rvt_delegator_->getMaxRvbId() + fetch_range_size,
+                                            rvt_delegator_->getMaxRvbId() + fetch_range_size * num_of_nodes_to_add));
+    ASSERT_NFF(rvt_delegator_->removeLeftNode(
+        rvt_delegator_->getMinRvbId(),
+        rvt_delegator_->getMinRvbId() + fetch_range_size * (num_of_nodes_to_remove - 1)));
+    const auto full = rvt_delegator_->getSerializedRvbData().str();
+    delta.str("");
+    ASSERT_TRUE(rvt_delegator_->getSerializedRvbDataDelta(delta));
+    rvt_delegator_->resetChangedNodes();
+
+    std::istringstream base_iss(base);
+    std::istringstream delta_iss(delta.str());
+    std::ostringstream merged;
+    ASSERT_TRUE(RangeValidationTree::applySerializedRvbDataDelta(base_iss, delta_iss, merged));
+    ASSERT_EQ(full, merged.str());
+    base = merged.str();
+  }
+
+  auto root_hash = rvt_delegator_->getRootCurrentValueStr();
+  auto total_nodes = rvt_delegator_->totalNodes();
+  std::istringstream iss(base);
+  ASSERT_TRUE(rvt_delegator_->setSerializedRvbData(iss));
+  ASSERT_EQ(root_hash, rvt_delegator_->getRootCurrentValueStr());
+  ASSERT_EQ(total_nodes, rvt_delegator_->totalNodes());
+  // A tree which was replaced has no delta
+  ASSERT_FALSE(rvt_delegator_->getSerializedRvbDataDelta(delta));
+}
+
+TEST_P(RVTTestserializeDeserializeTreeFixture, serializeDeserializeTreeWithDeltaChain) {
+  auto inputs = GetParam();
+  const uint32_t RVT_K = inputs.first;
+  const uint32_t fetch_range_size = inputs.second;
+  auto config = RVTConfig(RVT_K, fetch_range_size, 32);
+  init(config);
+  ASSERT_NFF(rvt_delegator_->addRightNode(fetch_range_size, fetch_range_size * 10 * RVT_K));
+  rvt_delegator_->resetChangedNodes();
+  const auto base = rvt_delegator_->getSerializedRvbData().str();
+
+  // A chain without deltas is rejected
+  {
+    std::istringstream base_iss(base);
+    std::ostringstream merged;
+    ASSERT_FALSE(RangeValidationTree::applySerializedRvbDataDeltas(base_iss, {}, merged));
+  }
+  std::vector<std::string> deltas;
+  for (size_t i{}; i < 10; ++i) {
+    // add and remove some nodes, then apply all the deltas so far to the base in a single pass. The rightmost nodes are
+    // changed by every delta, and some nodes are added by a delta and removed by a later one.
+    size_t num_of_nodes_to_add = DataGenerator::randomNum(1, 2 * RVT_K);
+    size_t num_of_nodes_to_remove = DataGenerator::randomNum(1, RVT_K / 2);
+    std::cout << KVLOG(i, num_of_nodes_to_add, num_of_nodes_to_remove) << std::endl;
+    ASSERT_NFF(rvt_delegator_->addRightNode(rvt_delegator_->getMaxRvbId() + fetch_range_size,
+                                            rvt_delegator_->getMaxRvbId() + fetch_range_size * num_of_nodes_to_add));
+    ASSERT_NFF(rvt_delegator_->removeLeftNode(
+        rvt_delegator_->getMinRvbId(),
+        rvt_delegator_->getMinRvbId() + fetch_range_size * (num_of_nodes_to_remove - 1)));
+    std::ostringstream delta;
+    ASSERT_TRUE(rvt_delegator_->getSerializedRvbDataDelta(delta));
+    rvt_delegator_->resetChangedNodes();
+    deltas.push_back(delta.str());
+
+    std::istringstream base_iss(base);
+    std::vector<std::istringstream> deltas_iss(deltas.begin(), deltas.end());
+    std::vector<std::istream*> deltas_is;
+    for (auto& delta_iss : deltas_iss) deltas_is.push_back(&delta_iss);
+    std::ostringstream merged;
+    ASSERT_TRUE(RangeValidationTree::applySerializedRvbDataDeltas(base_iss, deltas_is, merged));
+    ASSERT_EQ(rvt_delegator_->getSerializedRvbData().str(), merged.str());
+  }
+
+  // The deltas must be applied in order
+  if (deltas.size() > 1) {
+    std::istringstream base_iss(base);
+    std::istringstream newest_delta_iss(deltas.back());
+    std::ostringstream merged;
+    ASSERT_FALSE(RangeValidationTree::applySerializedRvbDataDeltas(base_iss, {&newest_delta_iss}, merged) &&
+                 (merged.str() == rvt_delegator_->getSerializedRvbData().str()));
+  }
+}
+
 class RVTTestTreeLevelsByFormulaFixture : public RVTTest,
                                           public testing::WithParamInterface<std::pair<uint32_t, uint32_t>> {};
 TEST_P(RVTTestTreeLevelsByFormulaFixture, validateTreeLevelsByFormula) {
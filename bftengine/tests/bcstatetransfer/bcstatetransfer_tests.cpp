@@ -39,6 +39,7 @@
 #include "ReservedPagesMock.hpp"
 #include "EpochManager.hpp"
 #include "Messages.hpp"
+#include "BlockCompression.hpp"
 #include "messages/PrePrepareMsg.hpp"
 #include "hex_tools.h"
 #include "RVBManager.hpp"
@@ -145,7 +146,8 @@ Config targetConfig() {
       true,               // enableReservedPages
       true,               // enableSourceBlocksPreFetch
       true,               // enableSourceSelectorPrimaryAwareness
-      true                // enableStoreRvbDataDuringCheckpointing
+      true,               // enableStoreRvbDataDuringCheckpointing
+      0                   // maxNumOfStripeSources
   };
 }
 
@@ -186,6 +188,9 @@ struct TestConfig {
   uint32_t checkpointWindowSize = 150;
   uint32_t minBlockDataSize = 300;
   uint32_t lastReachedConsensusCheckpointNum = 10;
+  bool compressibleBlocks = false;             // generate blocks which shrink when compressed
+  bool fakeSourcesIgnoreCompression = false;  // fake sources reply with uncompressed blocks, as sources which do not
+                                              // support compression do
   bool productDbDeleteOnStart = true;
   bool productDbDeleteOnEnd = true;
   bool fakeDbDeleteOnStart = true;
@@ -215,7 +220,8 @@ static inline std::ostream& operator<<(std::ostream& os, const TestConfig& c) {
               c.fakeDbDeleteOnStart,
               c.fakeDbDeleteOnEnd,
               c.testTarget,
-              c.logLevel);
+              c.logLevel)
+     << KVLOG(c.compressibleBlocks, c.fakeSourcesIgnoreCompression);
   return os;
 }
 
@@ -398,6 +404,7 @@ class BcStTestDelegator {
   SimpleMemoryPool<BCStateTran::BlockIOContext>& getIoPool() const { return stateTransfer_->ioPool_; }
   std::deque<BCStateTran::BlockIOContextPtr>& getIoContexts() const { return stateTransfer_->ioContexts_; }
   void clearIoContexts() { stateTransfer_->clearIoContexts(); }
+  void clearSrcReadAhead() { stateTransfer_->clearSrcReadAhead(); }
   RVBId nextRvbBlockId(BlockId blockId) const { return stateTransfer_->rvbm_->nextRvbBlockId(blockId); }
   RVBId prevRvbBlockId(BlockId blockId) const { return stateTransfer_->rvbm_->prevRvbBlockId(blockId); }
   RangeValidationTree* getRvt() { return stateTransfer_->rvbm_->in_mem_rvt_.get(); }
@@ -434,6 +441,13 @@ class BcStTestDelegator {
     g.txn()->setIsFetchingState(true);
   }
   void setEraseMetadataFlag() { stateTransfer_->setEraseMetadataFlagImpl(); }
+  uint64_t getNumOfStripesTakenOver() { return stateTransfer_->metrics_.stripes_taken_over_.Get().Get(); }
+  uint64_t getDstBytesBeforeDecompression() {
+    return stateTransfer_->metrics_.dst_bytes_before_decompression_.Get().Get();
+  }
+  uint64_t getNumOfSentStripeFetchBlocksMsgs() {
+    return stateTransfer_->metrics_.sent_stripe_fetch_blocks_msg_.Get().Get();
+  }
 
   // Source Selector
   void assertSourceSelectorMetricKeyVal(const std::string& key, uint64_t val);
@@ -551,6 +565,9 @@ class FakeSources : public FakeReplicaBase {
   // Source (fake) Replies
   void replyAskForCheckpointSummariesMsg(bool generateBlocksAndDescriptors = true);
   void replyFetchBlocksMsg();
+  // Reply to a FetchBlocksMsg sent to any source, e.g. to a stripe source. If corruptData is true, the highest block
+  // sent is corrupted.
+  void replyFetchBlocksMsg(const Msg& msg, bool corruptData = false);
   void replyResPagesMsg(bool& outDoneSending);
   void rejectFetchingMsg(uint16_t rejCode, uint64_t reqMsgSeqNum, uint16_t destReplicaId);
 
@@ -635,6 +652,15 @@ class BcStTest : public ::testing::Test {
                              list<uint16_t> rejectionReasons = list<uint16_t>(),
                              size_t sleepDurationAfterReplyMilli = 20);
 
+  // Like getMissingblocksStage, while blocks are fetched from stripe sources too. In every round the fake sources
+  // reply first to the stripe sources' FetchBlocksMsgs, and then to the current source's one, as returned by
+  // fetchBlocksReply (default: reply). The current source always replies.
+  enum class TFetchBlocksReply { Reply, Skip, Reject, CorruptData };
+  using FetchBlocksReplyFunc =
+      std::function<TFetchBlocksReply(uint16_t /* to */, const FetchBlocksMsg&, bool /* stripe */)>;
+  void getMissingblocksStageWithStripes(const FetchBlocksReplyFunc& fetchBlocksReply = nullptr,
+                                        size_t sleepDurationAfterReplyMilli = 20);
+
   void getReservedPagesStage(TSkipReplyFlag skipReply = TSkipReplyFlag::False,
                              TRejectFlag reject = TRejectFlag::False,
                              uint16_t rejectionReason = 0,
@@ -677,7 +703,11 @@ void DataGenerator::generateBlocks(TestAppState& appState, uint64_t fromBlockId,
     uint32_t dataSize = static_cast<uint32_t>(rand()) % (maxBlockDataSize - testConfig_.minBlockDataSize + 1) +
                         testConfig_.minBlockDataSize;
     ConcordAssertLE(dataSize, maxBlockDataSize);
-    fillRandomBytes(buff.get(), dataSize);
+    if (testConfig_.compressibleBlocks) {
+      std::fill(buff.get(), buff.get() + dataSize, static_cast<char>(i));
+    } else {
+      fillRandomBytes(buff.get(), dataSize);
+    }
     std::shared_ptr<Block> blk;
     StateTransferDigest digestPrev{1};
     if ((i == fromBlockId) && (!appState.hasBlock(i - 1))) {
@@ -808,6 +838,20 @@ void BcStTestDelegator::assertBCStateTranMetricKeyVal(const std::string& key, ui
     ASSERT_EQ(stMetrics_.src_num_io_contexts_consumed_.Get().Get(), val);
   } else if (key == "received_reject_fetching_msg") {
     ASSERT_EQ(stMetrics_.received_reject_fetching_msg_.Get().Get(), val);
+  } else if (key == "overall_rvb_digest_groups_validated") {
+    ASSERT_EQ(stMetrics_.overall_rvb_digest_groups_validated_.Get().Get(), val);
+  } else if (key == "overall_rvb_digest_groups_validation_failed") {
+    ASSERT_EQ(stMetrics_.overall_rvb_digest_groups_validation_failed_.Get().Get(), val);
+  } else if (key == "stripes_expired") {
+    ASSERT_EQ(stMetrics_.stripes_expired_.Get().Get(), val);
+  } else if (key == "bad_data_from_stripe_source") {
+    ASSERT_EQ(stMetrics_.bad_data_from_stripe_source_.Get().Get(), val);
+  } else if (key == "src_block_cache_hits") {
+    ASSERT_EQ(stMetrics_.src_block_cache_hits_.Get().Get(), val);
+  } else if (key == "src_block_cache_misses") {
+    ASSERT_EQ(stMetrics_.src_block_cache_misses_.Get().Get(), val);
+  } else if (key == "dst_decompression_failures") {
+    ASSERT_EQ(stMetrics_.dst_decompression_failures_.Get().Get(), val);
   } else {
     FAIL() << "Unexpected key!";
   }
@@ -828,6 +872,8 @@ void BcStTestDelegator::assertSourceSelectorMetricKeyVal(const std::string& key,
     ASSERT_EQ(ssMetrics_.replacement_due_to_periodic_change_.Get().Get(), val);
   } else if (key == "replacement_due_to_source_same_as_primary") {
     ASSERT_EQ(ssMetrics_.replacement_due_to_source_same_as_primary_.Get().Get(), val);
+  } else if (key == "stripe_sources_removed") {
+    ASSERT_EQ(ssMetrics_.stripe_sources_removed_.Get().Get(), val);
   } else {
     FAIL() << "Unexpected key!";
   }
@@ -967,7 +1013,7 @@ void FakeDestination::sendFetchBlocksMsg(uint64_t minBlockId,
   // Remove this line if we would like to make negative tests
   ASSERT_GE(maxBlockId, minBlockId);
   ASSERT_GE(maxBlockIdInCycle, maxBlockId);
-  FetchBlocksMsg fetchBlocksMsg;
+  CompressedFetchBlocksMsg fetchBlocksMsg;
   lastMsgSeqNum_ = stDelegator_->uniqueMsgSeqNum();
 
   // Simplify things compare to a real destination - ask for a batch of a size up to maxNumberOfChunksInBatch, without
@@ -978,14 +1024,16 @@ void FakeDestination::sendFetchBlocksMsg(uint64_t minBlockId,
   fetchBlocksMsg.maxBlockIdInCycle = maxBlockIdInCycle;
   fetchBlocksMsg.lastKnownChunkInLastRequiredBlock = 0;  // for now, chunking is not supported
   fetchBlocksMsg.rvbGroupId = rvbGroupId;
+  // Without compression, the message has the layout of a FetchBlocksMsg
+  fetchBlocksMsg.compression = static_cast<uint8_t>(targetConfig_.chunkCompression);
   ASSERT_NE(senderReplicaId, targetConfig_.myReplicaId);
   senderReplicaId = (senderReplicaId == kDefaultSenderReplicaId)
                         ? ((targetConfig_.myReplicaId + 1) % targetConfig_.numReplicas)
                         : senderReplicaId;
   char* fetchBlocksMsgBuff{nullptr};
   ASSERT_NFF(TestUtils::allocCopyStateTransferMsg(
-      reinterpret_cast<char*>(&fetchBlocksMsg), sizeof(FetchBlocksMsg), &fetchBlocksMsgBuff));
-  stDelegator_->handleStateTransferMessage(fetchBlocksMsgBuff, sizeof(FetchBlocksMsg), senderReplicaId);
+      reinterpret_cast<char*>(&fetchBlocksMsg), fetchBlocksMsg.size(), &fetchBlocksMsgBuff));
+  stDelegator_->handleStateTransferMessage(fetchBlocksMsgBuff, fetchBlocksMsg.size(), senderReplicaId);
   do {
     const auto [isTriggered, duration] = testedReplicaIf_.popOneShotTimerDurationMilli();
     if (!isTriggered) {
@@ -1126,7 +1174,11 @@ void FakeSources::replyAskForCheckpointSummariesMsg(bool generateBlocksAndDescri
 
 void FakeSources::replyFetchBlocksMsg() {
   ASSERT_EQ(testedReplicaIf_.sent_messages_.size(), 1);
-  const auto& msg = testedReplicaIf_.sent_messages_.front();
+  ASSERT_NFF(replyFetchBlocksMsg(testedReplicaIf_.sent_messages_.front()));
+  testedReplicaIf_.sent_messages_.pop_front();
+}
+
+void FakeSources::replyFetchBlocksMsg(const Msg& msg, bool corruptData) {
   ASSERT_NFF(assertMsgType(msg, MsgType::FetchBlocks));
   auto fetchBlocksMsg = reinterpret_cast<FetchBlocksMsg*>(msg.data_.get());
   uint64_t nextBlockId = fetchBlocksMsg->maxBlockId;
@@ -1135,7 +1187,6 @@ void FakeSources::replyFetchBlocksMsg() {
   // very basic validity check, no simulate corruption
   if ((fetchBlocksMsg->minBlockId == 0) || (fetchBlocksMsg->maxBlockId == 0)) {
     rejectFetchingMsg(RejectFetchingMsg::Reason::BLOCK_NOT_FOUND_IN_STORAGE, fetchBlocksMsg->msgSeqNum, msg.to_);
-    testedReplicaIf_.sent_messages_.pop_front();
     return;
   }
 
@@ -1146,10 +1197,38 @@ void FakeSources::replyFetchBlocksMsg() {
       (fetchBlocksMsg->rvbGroupId != 0)
           ? rvbm_->getSerializedDigestsOfRvbGroup(fetchBlocksMsg->rvbGroupId, nullptr, 0, true)
           : 0;
+  // Like a real source, compress a block only if the destination asks for it and the block shrinks
+  const auto compression =
+      testConfig_.fakeSourcesIgnoreCompression
+          ? ChunkCompression::NONE
+          : static_cast<ChunkCompression>(CompressedFetchBlocksMsg::compressionOf(fetchBlocksMsg, msg.len_));
+  const auto maxBlockSize = Block::getMaxTotalBlockSize();
+  auto compressedBlk = std::make_unique<char[]>(maxBlockSize);
   while (true) {
     size_t rvbGroupDigestsActualSize{0};
     auto blk = appState_.peekBlock(nextBlockId);
-    ItemDataMsg* itemDataMsg = ItemDataMsg::alloc(blk->totalBlockSize + rvbGroupDigestsExpectedSize);
+    const char* blkData = reinterpret_cast<const char*>(blk.get());
+    uint32_t blkSize = blk->totalBlockSize;
+    auto blkCompression = ChunkCompression::NONE;
+    if (compression != ChunkCompression::NONE) {
+      const auto compressedSize = compressBlock(compression, blkData, blkSize, compressedBlk.get(), maxBlockSize);
+      if (compressedSize > 0) {
+        blkData = compressedBlk.get();
+        blkSize = compressedSize;
+        blkCompression = compression;
+      }
+    }
+    // The compression is appended after the data, hence the actual size of the RVB digests is needed to allocate
+    std::vector<char> rvbGroupDigests(rvbGroupDigestsExpectedSize);
+    if (rvbGroupDigestsExpectedSize > 0) {
+      // Serialize RVB digests
+      rvbGroupDigestsActualSize = rvbm_->getSerializedDigestsOfRvbGroup(
+          fetchBlocksMsg->rvbGroupId, rvbGroupDigests.data(), rvbGroupDigestsExpectedSize, false);
+      ConcordAssertLE(rvbGroupDigestsActualSize, rvbGroupDigestsExpectedSize);
+      rvbGroupDigestsExpectedSize = 0;
+    }
+    ItemDataMsg* itemDataMsg =
+        ItemDataMsg::alloc(blkSize + rvbGroupDigestsActualSize, static_cast<uint8_t>(blkCompression));
     ASSERT_TRUE(itemDataMsg);
     bool lastInBatch = ((numOfSentChunks + 1) >= targetConfig_.maxNumberOfChunksInBatch) ||
                        ((nextBlockId - 1) < fetchBlocksMsg->minBlockId);
@@ -1158,17 +1237,12 @@ void FakeSources::replyFetchBlocksMsg() {
     itemDataMsg->totalNumberOfChunksInBlock = 1;
     itemDataMsg->chunkNumber = 1;
     itemDataMsg->requestMsgSeqNum = fetchBlocksMsg->msgSeqNum;
-
-    if (rvbGroupDigestsExpectedSize > 0) {
-      // Serialize RVB digests
-      rvbGroupDigestsActualSize = rvbm_->getSerializedDigestsOfRvbGroup(
-          fetchBlocksMsg->rvbGroupId, itemDataMsg->data, rvbGroupDigestsExpectedSize, false);
-      ConcordAssertLE(rvbGroupDigestsActualSize, rvbGroupDigestsActualSize);
-      rvbGroupDigestsExpectedSize = 0;
-    }
-    itemDataMsg->dataSize = blk->totalBlockSize + rvbGroupDigestsActualSize;
     itemDataMsg->rvbDigestsSize = rvbGroupDigestsActualSize;
-    memcpy(itemDataMsg->data + rvbGroupDigestsActualSize, blk.get(), blk->totalBlockSize);
+    std::copy(rvbGroupDigests.begin(), rvbGroupDigests.begin() + rvbGroupDigestsActualSize, itemDataMsg->data);
+    memcpy(itemDataMsg->data + rvbGroupDigestsActualSize, blkData, blkSize);
+    if (corruptData && (nextBlockId == fetchBlocksMsg->maxBlockId)) {
+      itemDataMsg->data[itemDataMsg->dataSize - 1] ^= 0xFF;
+    }
     char* msgBytes{nullptr};
     ASSERT_NFF(
         TestUtils::allocCopyStateTransferMsg(reinterpret_cast<char*>(itemDataMsg), itemDataMsg->size(), &msgBytes));
@@ -1180,7 +1254,6 @@ void FakeSources::replyFetchBlocksMsg() {
     --nextBlockId;
     ++numOfSentChunks;
   }
-  testedReplicaIf_.sent_messages_.pop_front();
 }
 
 // To ASSERT_ / EXPECT_  inside this function, we must pass output as a parameter
@@ -1458,9 +1531,17 @@ void BcStTest::srcAssertItemDataMsgBatchSentWithBlocks(uint64_t minExpectedBlock
   ASSERT_EQ(FetchingState::NotFetching, stDelegator_->getFetchingState());
   ASSERT_EQ(testedReplicaIf_.sent_messages_.size(), maxExpectedBlockId - minExpectedBlockId + 1);
   uint64_t currentBlockId = maxExpectedBlockId;  // we expect to get blocks in reverse order, chunking not supported
+  // Blocks are sent compressed only if the fake destination asked for it and they shrink, otherwise the messages keep
+  // the ItemDataMsg layout
+  const bool expectCompressed =
+      testConfig_.compressibleBlocks && (targetConfig_.chunkCompression != ChunkCompression::NONE);
+  const auto maxBlockSize = Block::getMaxTotalBlockSize();
+  auto decompressedBlk = std::make_unique<char[]>(maxBlockSize);
 
   for (const auto& msg : testedReplicaIf_.sent_messages_) {
+    ASSERT_NFF(assertMsgType(msg, expectCompressed ? MsgType::CompressedItemData : MsgType::ItemData));
     const auto* itemDataMsg = reinterpret_cast<ItemDataMsg*>(msg.data_.get());
+    ASSERT_EQ(msg.len_, itemDataMsg->size());
     ASSERT_EQ(1, itemDataMsg->totalNumberOfChunksInBlock);
     ASSERT_EQ(1, itemDataMsg->chunkNumber);
     ASSERT_EQ(itemDataMsg->requestMsgSeqNum, fakeDstReplica_->getLastMsgSeqNum());
@@ -1471,16 +1552,18 @@ void BcStTest::srcAssertItemDataMsgBatchSentWithBlocks(uint64_t minExpectedBlock
     // just compare the blocks, dont validate digests.
     if (itemDataMsg->rvbDigestsSize > 0) {
       ASSERT_GT(itemDataMsg->dataSize, itemDataMsg->rvbDigestsSize);
-      ASSERT_EQ(blk->totalBlockSize, itemDataMsg->dataSize - itemDataMsg->rvbDigestsSize);
-      ASSERT_EQ(memcmp(reinterpret_cast<char*>(blk.get()),
-                       itemDataMsg->data + itemDataMsg->rvbDigestsSize,
-                       itemDataMsg->dataSize - itemDataMsg->rvbDigestsSize),
-                0);
       // TODO - add here check for the RVB data. Need to get RVB group id from fake dest?
-    } else {
-      ASSERT_EQ(blk->totalBlockSize, itemDataMsg->dataSize);
-      ASSERT_EQ(memcmp(reinterpret_cast<char*>(blk.get()), itemDataMsg->data, itemDataMsg->dataSize), 0);
     }
+    const char* blkData = itemDataMsg->data + itemDataMsg->rvbDigestsSize;
+    uint32_t blkSize = itemDataMsg->dataSize - itemDataMsg->rvbDigestsSize;
+    if (expectCompressed) {
+      ASSERT_EQ(itemDataMsg->compression(), static_cast<uint8_t>(targetConfig_.chunkCompression));
+      ASSERT_LT(blkSize, blk->totalBlockSize);
+      blkSize = decompressBlock(targetConfig_.chunkCompression, blkData, blkSize, decompressedBlk.get(), maxBlockSize);
+      blkData = decompressedBlk.get();
+    }
+    ASSERT_EQ(blk->totalBlockSize, blkSize);
+    ASSERT_EQ(memcmp(reinterpret_cast<char*>(blk.get()), blkData, blkSize), 0);
     --currentBlockId;
   }
 }
@@ -1658,6 +1741,49 @@ void BcStTest::getMissingblocksStage(const std::function<R(Args...)>& callAtStar
   }
 }
 
+void BcStTest::getMissingblocksStageWithStripes(const FetchBlocksReplyFunc& fetchBlocksReply,
+                                                size_t sleepDurationAfterReplyMilli) {
+  testState_.nextRequiredBlock = stDelegator_->getNextRequiredBlock();
+  while (datastore_->getFirstRequiredBlock() != 0) {
+    ASSERT_FALSE(testedReplicaIf_.sent_messages_.empty());
+    const auto currentSourceId = stDelegator_->getSourceSelector().currentReplica();
+    std::deque<Msg> msgs;
+    msgs.swap(testedReplicaIf_.sent_messages_);
+    // Reply to the stripe sources first, so their stripes are complete when the current source reaches them
+    for (const bool stripe : {true, false}) {
+      for (const auto& msg : msgs) {
+        if ((msg.to_ != currentSourceId) != stripe) {
+          continue;
+        }
+        ASSERT_NFF(assertMsgType(msg, MsgType::FetchBlocks));
+        const auto fetchBlocksMsg = reinterpret_cast<FetchBlocksMsg*>(msg.data_.get());
+        const auto reply =
+            fetchBlocksReply ? fetchBlocksReply(msg.to_, *fetchBlocksMsg, stripe) : TFetchBlocksReply::Reply;
+        ASSERT_TRUE(stripe || (reply == TFetchBlocksReply::Reply));
+        switch (reply) {
+          case TFetchBlocksReply::Reply:
+          case TFetchBlocksReply::CorruptData:
+            ASSERT_NFF(fakeSrcReplica_->replyFetchBlocksMsg(msg, reply == TFetchBlocksReply::CorruptData));
+            break;
+          case TFetchBlocksReply::Reject:
+            ASSERT_NFF(fakeSrcReplica_->rejectFetchingMsg(
+                RejectFetchingMsg::Reason::IN_STATE_TRANSFER, fetchBlocksMsg->msgSeqNum, msg.to_));
+            break;
+          case TFetchBlocksReply::Skip:
+            break;
+        }
+      }
+    }
+    // There might be pending jobs for putBlock, we need to wait some time and then finalize them by calling onTimer
+    this_thread::sleep_for(chrono::milliseconds(sleepDurationAfterReplyMilli));
+    stateTransfer_->onTimer();
+    testState_.minRequiredBlockId = datastore_->getFirstRequiredBlock();
+    testState_.nextRequiredBlock = stDelegator_->getNextRequiredBlock();
+  }
+  // The stripe sources might have been sent FetchBlocksMsgs before the last batch was done
+  fakeSrcReplica_->clearSentMessagesByMessageType(MsgType::FetchBlocks);
+}
+
 void BcStTest::getReservedPagesStage(TSkipReplyFlag skipReply,
                                      TRejectFlag reject,
                                      uint16_t rejectionReason,
@@ -2097,6 +2223,206 @@ INSTANTIATE_TEST_CASE_P(BcStTest,
                                           RejectFetchingMsg::Reason::BLOCK_NOT_FOUND_IN_STORAGE,
                                           RejectFetchingMsg::Reason::DIGESTS_FOR_RVBGROUP_NOT_FOUND), );
 
+class BcStTestParamFixtureStripes : public BcStTest,
+                                    public testing::WithParamInterface<tuple<uint32_t, uint32_t, uint32_t, uint16_t>> {
+};
+
+// Validate a full state transfer, while batches of blocks are fetched from stripe sources too
+TEST_P(BcStTestParamFixtureStripes, dstFullStateTransferWithStripes) {
+  targetConfig_.maxNumberOfChunksInBatch = get<0>(GetParam());
+  targetConfig_.fetchRangeSize = get<1>(GetParam());
+  targetConfig_.RVT_K = get<2>(GetParam());
+  targetConfig_.maxNumOfStripeSources = get<3>(GetParam());
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  ASSERT_NFF(getMissingblocksStageWithStripes());
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_GT(stDelegator_->getNumOfSentStripeFetchBlocksMsgs(), 0);
+  ASSERT_GT(stDelegator_->getNumOfStripesTakenOver(), 0);
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("stripes_expired", 0));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("bad_data_from_stripe_source", 0));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("overall_rvb_digest_groups_validation_failed", 0));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("stripe_sources_removed", 0));
+}
+
+// 1st element - maxNumberOfChunksInBatch
+// 2nd element - fetchRangeSize
+// 3rd element - RVT_K
+// 4th element - maxNumOfStripeSources
+using BcStTestParamFixtureStripesInput = tuple<uint32_t, uint32_t, uint32_t, uint16_t>;
+INSTANTIATE_TEST_CASE_P(BcStTest,
+                        BcStTestParamFixtureStripes,
+                        ::testing::Values(BcStTestParamFixtureStripesInput(128, 16, 16, 1),
+                                          BcStTestParamFixtureStripesInput(128, 16, 16, 2),
+                                          BcStTestParamFixtureStripesInput(64, 16, 1024, 2),
+                                          BcStTestParamFixtureStripesInput(64, 16, 32, 4),
+                                          BcStTestParamFixtureStripesInput(256, 128, 16, 2)), );
+
+// A stripe which is not complete when the destination reaches it expires, and its blocks are fetched from the current
+// source. The stripe source keeps being used.
+TEST_F(BcStTest, dstStripeExpired) {
+  targetConfig_.maxNumberOfChunksInBatch = 128;
+  targetConfig_.fetchRangeSize = 16;
+  targetConfig_.RVT_K = 16;
+  targetConfig_.maxNumOfStripeSources = 2;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  bool skipped = false;
+  auto skipFirstStripe = [&skipped](uint16_t, const FetchBlocksMsg&, bool stripe) {
+    if (stripe && !skipped) {
+      skipped = true;
+      return TFetchBlocksReply::Skip;
+    }
+    return TFetchBlocksReply::Reply;
+  };
+  ASSERT_NFF(getMissingblocksStageWithStripes(skipFirstStripe));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_TRUE(skipped);
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("stripes_expired", 1));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("bad_data_from_stripe_source", 0));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("stripe_sources_removed", 0));
+  ASSERT_GT(stDelegator_->getNumOfStripesTakenOver(), 0);
+}
+
+// Bad data in a stripe which was taken over is blamed on the stripe source, not on the current source: the stripe
+// source is no longer preferred, and the rest of the batch is fetched from the current source.
+TEST_F(BcStTest, dstStripeSourceSendsBadData) {
+  targetConfig_.maxNumberOfChunksInBatch = 128;
+  targetConfig_.fetchRangeSize = 16;
+  targetConfig_.RVT_K = 16;
+  targetConfig_.maxNumOfStripeSources = 2;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  uint16_t badStripeSourceId = NO_REPLICA;
+  auto corruptFirstStripe = [&badStripeSourceId](uint16_t to, const FetchBlocksMsg&, bool stripe) {
+    if (stripe && (badStripeSourceId == NO_REPLICA)) {
+      badStripeSourceId = to;
+      return TFetchBlocksReply::CorruptData;
+    }
+    return TFetchBlocksReply::Reply;
+  };
+  ASSERT_NFF(getMissingblocksStageWithStripes(corruptFirstStripe));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_NE(badStripeSourceId, NO_REPLICA);
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("bad_data_from_stripe_source", 1));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("stripe_sources_removed", 1));
+  // The current source is kept
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("total_replacements", 1));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("replacement_due_to_bad_data", 0));
+  ASSERT_EQ(stDelegator_->getPreferredReplicas().count(badStripeSourceId), 0);
+}
+
+// A stripe source which rejects its stripe is no longer preferred, and the stripe is fetched from other sources
+TEST_F(BcStTest, dstStripeSourceRejectsStripe) {
+  targetConfig_.maxNumberOfChunksInBatch = 128;
+  targetConfig_.fetchRangeSize = 16;
+  targetConfig_.RVT_K = 16;
+  targetConfig_.maxNumOfStripeSources = 2;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  uint16_t rejectingStripeSourceId = NO_REPLICA;
+  auto rejectFirstStripe = [&rejectingStripeSourceId](uint16_t to, const FetchBlocksMsg&, bool stripe) {
+    if (stripe && (rejectingStripeSourceId == NO_REPLICA)) {
+      rejectingStripeSourceId = to;
+      return TFetchBlocksReply::Reject;
+    }
+    return TFetchBlocksReply::Reply;
+  };
+  ASSERT_NFF(getMissingblocksStageWithStripes(rejectFirstStripe));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_NE(rejectingStripeSourceId, NO_REPLICA);
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("received_reject_fetching_msg", 1));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("stripe_sources_removed", 1));
+  // The current source is kept
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("total_replacements", 1));
+  ASSERT_EQ(stDelegator_->getPreferredReplicas().count(rejectingStripeSourceId), 0);
+  ASSERT_GT(stDelegator_->getNumOfStripesTakenOver(), 0);
+}
+
+// A stripe asks for the RVB group digests which the batch below it, in the same RVB group, asks for too. Each RVB
+// group is validated only once: the digests sent with a stripe of an already stored RVB group are skipped.
+TEST_F(BcStTest, dstStripeSkipsRvbDigestsOfStoredGroup) {
+  // An RVB group spans 2 batches
+  targetConfig_.maxNumberOfChunksInBatch = 128;
+  targetConfig_.fetchRangeSize = 16;
+  targetConfig_.RVT_K = 16;
+  targetConfig_.maxNumOfStripeSources = 2;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  std::map<uint64_t, size_t> numOfRequestsPerRvbGroupId;
+  size_t numOfStripeRequestsWithRvbGroupId = 0;
+  auto countRvbGroupRequests = [&](uint16_t, const FetchBlocksMsg& msg, bool stripe) {
+    if (msg.rvbGroupId != 0) {
+      ++numOfRequestsPerRvbGroupId[msg.rvbGroupId];
+      numOfStripeRequestsWithRvbGroupId += stripe ? 1 : 0;
+    }
+    return TFetchBlocksReply::Reply;
+  };
+  ASSERT_NFF(getMissingblocksStageWithStripes(countRvbGroupRequests));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_GT(numOfStripeRequestsWithRvbGroupId, 0);
+  // Some RVB group was asked for more than once, and yet every RVB group was validated once
+  ASSERT_TRUE(std::any_of(numOfRequestsPerRvbGroupId.cbegin(), numOfRequestsPerRvbGroupId.cend(), [](const auto& e) {
+    return e.second > 1;
+  }));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("overall_rvb_digest_groups_validated",
+                                                         numOfRequestsPerRvbGroupId.size()));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("overall_rvb_digest_groups_validation_failed", 0));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("stripes_expired", 0));
+}
+
+class BcStTestParamFixtureCompression : public BcStTest,
+                                        public testing::WithParamInterface<tuple<ChunkCompression, bool>> {};
+
+// Validate a full state transfer of compressible blocks, while the destination asks for compressed blocks. Sources
+// which do not support compression ignore it and reply with ItemData messages of the uncompressed layout.
+TEST_P(BcStTestParamFixtureCompression, dstFullStateTransferWithCompression) {
+  targetConfig_.chunkCompression = get<0>(GetParam());
+  testConfig_.fakeSourcesIgnoreCompression = get<1>(GetParam());
+  testConfig_.compressibleBlocks = true;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  ASSERT_NFF(getMissingblocksStage<void>());
+  ASSERT_NFF(getReservedPagesStage());
+  // now validate completion
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_EQ(stDelegator_->getDstBytesBeforeDecompression() > 0, !testConfig_.fakeSourcesIgnoreCompression);
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("dst_decompression_failures", 0));
+}
+
+// 1st element - chunkCompression asked by the destination
+// 2nd element - fakeSourcesIgnoreCompression
+using BcStTestParamFixtureCompressionInput = tuple<ChunkCompression, bool>;
+INSTANTIATE_TEST_CASE_P(BcStTest,
+                        BcStTestParamFixtureCompression,
+                        ::testing::Values(BcStTestParamFixtureCompressionInput(ChunkCompression::LZ4, false),
+                                          BcStTestParamFixtureCompressionInput(ChunkCompression::ZSTD, false),
+                                          BcStTestParamFixtureCompressionInput(ChunkCompression::LZ4, true),
+                                          BcStTestParamFixtureCompressionInput(ChunkCompression::ZSTD, true)), );
+
 /////////////////////////////////////////////////////////
 //
 //       BcStTest Source Test Cases
@@ -2165,6 +2491,36 @@ TEST_F(BcStTest, srcHandleFetchBlocksMsg) {
   ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_overall_on_spot_batches_sent", 1));
 }
 
+class BcStTestParamFixtureSrcCompression : public BcStTest, public testing::WithParamInterface<ChunkCompression> {};
+
+// Compressible blocks are sent in CompressedItemData messages only if the destination asks for compression. A
+// destination which does not, sends a FetchBlocksMsg of the uncompressed layout, and gets ItemData messages of the
+// uncompressed layout.
+TEST_P(BcStTestParamFixtureSrcCompression, srcHandleFetchBlocksMsgWithCompression) {
+  testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
+  testConfig_.compressibleBlocks = true;
+  targetConfig_.chunkCompression = GetParam();
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  // Generate the data needed for a tested ST backup replica
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  ASSERT_NFF(dataGen_->generateCheckpointDescriptors(appState_,
+                                                     datastore_,
+                                                     testState_.minRepliedCheckpointNum,
+                                                     testState_.maxRepliedCheckpointNum,
+                                                     stDelegator_->getRvbManager()));
+
+  ASSERT_NFF(fakeDstReplica_->sendFetchBlocksMsg<void>(testState_.minRequiredBlockId, testState_.maxRequiredBlockId));
+  uint64_t maxExpectedBlockId = (testState_.numBlocksToCollect > targetConfig_.maxNumberOfChunksInBatch)
+                                    ? (testState_.minRequiredBlockId + targetConfig_.maxNumberOfChunksInBatch - 1)
+                                    : testState_.maxRequiredBlockId;
+  ASSERT_NFF(srcAssertItemDataMsgBatchSentWithBlocks(testState_.minRequiredBlockId, maxExpectedBlockId));
+}
+
+INSTANTIATE_TEST_CASE_P(BcStTest,
+                        BcStTestParamFixtureSrcCompression,
+                        ::testing::Values(ChunkCompression::NONE, ChunkCompression::LZ4, ChunkCompression::ZSTD), );
+
 TEST_F(BcStTest, srcRejectFetchBlocksMsgOnRvbGroupDigests) {
   testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
   ASSERT_NFF(initialize());
@@ -2607,6 +2963,58 @@ TEST_F(BcStTest, srcTestSourcePrepareIoContexts) {
                                             src_num_io_contexts_consumed += targetConfig_.maxNumberOfChunksInBatch));
 }
 
+// Once a destination fetches batches sequentially, the source reads ahead the next batches and serves them from
+// memory. Pre-fetch is disabled, so that all blocks not read ahead are read on spot.
+TEST_F(BcStTest, srcTestSourceReadAhead) {
+  testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
+  targetConfig_.maxNumberOfChunksInBatch = 10;
+  targetConfig_.fetchRangeSize = 10;
+  targetConfig_.enableSourceBlocksPreFetch = false;
+  targetConfig_.sourceReadAheadBlocks = 2 * targetConfig_.maxNumberOfChunksInBatch;
+
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  // Generate the data needed for a tested ST backup replica
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  ASSERT_NFF(dataGen_->generateCheckpointDescriptors(appState_,
+                                                     datastore_,
+                                                     testState_.minRepliedCheckpointNum,
+                                                     testState_.maxRepliedCheckpointNum,
+                                                     stDelegator_->getRvbManager()));
+  const auto batchSize = targetConfig_.maxNumberOfChunksInBatch;
+  ASSERT_GE(testState_.numBlocksToCollect, 4 * batchSize + targetConfig_.sourceReadAheadBlocks);
+  auto& ioPool = stDelegator_->getIoPool();
+  const auto ioPoolSize = ioPool.numFreeElements();
+  ASSERT_EQ(ioPoolSize, batchSize + std::min<uint32_t>(targetConfig_.sourceReadAheadBlocks, batchSize));
+
+  auto sendFetchBlocksMsgAndValidate = [&](uint64_t src_block_cache_hits, uint64_t src_block_cache_misses) {
+    ASSERT_NFF(fakeDstReplica_->sendFetchBlocksMsg<void>(testState_.minRequiredBlockId, testState_.maxRequiredBlockId));
+    ASSERT_NFF(srcAssertItemDataMsgBatchSentWithBlocks(testState_.minRequiredBlockId,
+                                                       testState_.minRequiredBlockId + batchSize - 1));
+    ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_block_cache_hits", src_block_cache_hits));
+    ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_block_cache_misses", src_block_cache_misses));
+    testedReplicaIf_.sent_messages_.clear();
+    testState_.minRequiredBlockId += batchSize;
+  };
+
+  // 1) The 1st batch is read on spot, and nothing is read ahead before the destination is known to be sequential
+  ASSERT_NFF(sendFetchBlocksMsgAndValidate(0, batchSize));
+  // 2) The next batch is sequential: it is read on spot, and the following batches are read ahead
+  ASSERT_NFF(sendFetchBlocksMsgAndValidate(0, 2 * batchSize));
+  // 3) The next batches are served from the blocks read ahead
+  ASSERT_NFF(sendFetchBlocksMsgAndValidate(batchSize, 2 * batchSize));
+  ASSERT_NFF(sendFetchBlocksMsgAndValidate(2 * batchSize, 2 * batchSize));
+
+  // 4) All the contexts read ahead go back to the pool once read ahead is cleared
+  stDelegator_->clearIoContexts();
+  stDelegator_->clearSrcReadAhead();
+  ASSERT_TRUE(ioPool.full());
+  ASSERT_EQ(ioPool.numFreeElements(), ioPoolSize);
+
+  // 5) Once cleared, a request is not considered sequential anymore, and the batch is read on spot
+  ASSERT_NFF(sendFetchBlocksMsgAndValidate(2 * batchSize, 3 * batchSize));
+}
+
 /////////////////////////////////////////////////////////////////
 //
 //  BcStTest Backup Replica (Initialization, Checkpointing) Tests
@@ -2713,6 +3121,34 @@ TEST_F(BcStTest, bkpValidateRvbDataInitialSource) {
   testConfig_.productDbDeleteOnEnd = true;
 }
 
+// Check that RVB data reconstructed from storage by several threads is identical to the RVB data reconstructed serially
+TEST_F(BcStTest, bkpValidateConcurrentRvbDataReconstruction) {
+  // do not store RVB data in checkpoints, to reconstruct it from storage on each restart
+  targetConfig_.enableStoreRvbDataDuringCheckpointing = false;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  for (size_t i{testState_.minRepliedCheckpointNum}; i <= testState_.maxRepliedCheckpointNum; ++i) {
+    stDelegator_->createCheckpointOfCurrentState(i);
+  }
+
+  ASSERT_NFF(dstRestart(false, FetchingState::NotFetching));
+  ASSERT_EQ(stDelegator_->getRvbManager()->getRvbDataSource(),
+            RVBManager::RvbDataInitialSource::FROM_STORAGE_RECONSTRUCTION);
+  auto serial_root_hash = stDelegator_->getRvt()->getRootCurrentValueStr();
+  ASSERT_FALSE(serial_root_hash.empty());
+
+  for (uint16_t num_threads : {1, 4}) {
+    targetConfig_.numOfRvbReconstructionThreads = num_threads;
+    ASSERT_NFF(dstRestart(false, FetchingState::NotFetching));
+    ASSERT_EQ(stDelegator_->getRvbManager()->getRvbDataSource(),
+              RVBManager::RvbDataInitialSource::FROM_STORAGE_RECONSTRUCTION);
+    ASSERT_EQ(stDelegator_->getRvt()->getRootCurrentValueStr(), serial_root_hash);
+  }
+
+  testConfig_.productDbDeleteOnEnd = true;
+}
+
 // Validate differenent combinations of scenarios in which RVT construction will happen while replica coming up
 // Part of such scenarios have also been convered with test=bkpValidateRvbDataInitialSource
 // 1. Restart replica with non-zero checkpoints
@@ -0,0 +1,102 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include "gtest/gtest.h"
+
+#include "BlockCompression.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using bftEngine::bcst::ChunkCompression;
+using bftEngine::bcst::impl::compressBlock;
+using bftEngine::bcst::impl::decompressBlock;
+using bftEngine::bcst::impl::isValidChunkCompression;
+
+class block_compression : public ::testing::TestWithParam<ChunkCompression> {
+ protected:
+  // JSON-like, hence compressible
+  static std::string compressibleBlock() {
+    auto block = std::string{};
+    for (auto i = 0; i < 1000; ++i) {
+      block += "{\"key\": \"key" + std::to_string(i) + "\", \"value\": \"value" + std::to_string(i % 10) + "\"}";
+    }
+    return block;
+  }
+
+  static std::string randomBlock(std::size_t size) {
+    auto gen = std::mt19937{42};
+    auto dist = std::uniform_int_distribution<int>{0, 255};
+    auto block = std::string(size, '\0');
+    for (auto& c : block) {
+      c = static_cast<char>(dist(gen));
+    }
+    return block;
+  }
+};
+
+TEST_P(block_compression, round_trip) {
+  const auto block = compressibleBlock();
+  auto compressed = std::vector<char>(block.size());
+  const auto compressedSize = compressBlock(GetParam(), block.data(), block.size(), compressed.data(), block.size());
+  ASSERT_GT(compressedSize, 0);
+  ASSERT_LT(compressedSize, block.size() / 4);
+
+  auto decompressed = std::vector<char>(block.size());
+  ASSERT_EQ(decompressBlock(GetParam(), compressed.data(), compressedSize, decompressed.data(), decompressed.size()),
+            block.size());
+  ASSERT_EQ(std::string(decompressed.data(), decompressed.size()), block);
+}
+
+TEST_P(block_compression, incompressible_block_is_not_compressed) {
+  const auto block = randomBlock(4096);
+  auto compressed = std::vector<char>(block.size());
+  ASSERT_EQ(compressBlock(GetParam(), block.data(), block.size(), compressed.data(), compressed.size()), 0);
+}
+
+TEST_P(block_compression, decompressing_into_a_small_buffer_fails) {
+  const auto block = compressibleBlock();
+  auto compressed = std::vector<char>(block.size());
+  const auto compressedSize = compressBlock(GetParam(), block.data(), block.size(), compressed.data(), block.size());
+  ASSERT_GT(compressedSize, 0);
+  auto decompressed = std::vector<char>(block.size() - 1);
+  ASSERT_EQ(decompressBlock(GetParam(), compressed.data(), compressedSize, decompressed.data(), decompressed.size()),
+            0);
+}
+
+TEST_P(block_compression, decompressing_corrupted_data_fails) {
+  const auto block = randomBlock(4096);
+  auto decompressed = std::vector<char>(2 * block.size());
+  ASSERT_EQ(decompressBlock(GetParam(), block.data(), block.size(), decompressed.data(), decompressed.size()), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(codecs, block_compression, ::testing::Values(ChunkCompression::LZ4, ChunkCompression::ZSTD));
+
+TEST(block_compression_none, does_not_compress) {
+  const auto block = std::string(1024, 'a');
+  auto out = std::vector<char>(block.size());
+  ASSERT_EQ(compressBlock(ChunkCompression::NONE, block.data(), block.size(), out.data(), out.size()), 0);
+  ASSERT_EQ(decompressBlock(ChunkCompression::NONE, block.data(), block.size(), out.data(), out.size()), 0);
+}
+
+TEST(block_compression_none, valid_compressions) {
+  ASSERT_TRUE(isValidChunkCompression(static_cast<uint8_t>(ChunkCompression::NONE)));
+  ASSERT_TRUE(isValidChunkCompression(static_cast<uint8_t>(ChunkCompression::LZ4)));
+  ASSERT_TRUE(isValidChunkCompression(static_cast<uint8_t>(ChunkCompression::ZSTD)));
+  ASSERT_FALSE(isValidChunkCompression(3));
+}
+
+}  // namespace
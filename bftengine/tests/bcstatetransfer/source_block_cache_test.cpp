@@ -0,0 +1,100 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include "gtest/gtest.h"
+
+#include "SourceBlockCache.hpp"
+
+#include <string>
+
+namespace {
+
+using bftEngine::bcst::impl::SourceBlockCache;
+
+void put(SourceBlockCache& cache, uint64_t blockId, const std::string& block) {
+  cache.put(blockId, block.data(), block.size());
+}
+
+TEST(source_block_cache, miss) {
+  auto cache = SourceBlockCache{1024};
+  ASSERT_EQ(cache.get(1), nullptr);
+  ASSERT_FALSE(cache.contains(1));
+  ASSERT_EQ(cache.size(), 0u);
+  ASSERT_EQ(cache.bytes(), 0u);
+}
+
+TEST(source_block_cache, put_and_get) {
+  auto cache = SourceBlockCache{1024};
+  put(cache, 1, "block1");
+  put(cache, 2, "block22");
+  ASSERT_TRUE(cache.contains(1));
+  ASSERT_EQ(*cache.get(1), "block1");
+  ASSERT_EQ(*cache.get(2), "block22");
+  ASSERT_EQ(cache.size(), 2u);
+  ASSERT_EQ(cache.bytes(), 13u);
+}
+
+TEST(source_block_cache, put_replaces_block) {
+  auto cache = SourceBlockCache{1024};
+  put(cache, 1, "block1");
+  put(cache, 1, "block11");
+  ASSERT_EQ(*cache.get(1), "block11");
+  ASSERT_EQ(cache.size(), 1u);
+  ASSERT_EQ(cache.bytes(), 7u);
+}
+
+TEST(source_block_cache, evicts_lowest_blocks) {
+  auto cache = SourceBlockCache{30};
+  for (uint64_t i = 10; i < 20; ++i) {
+    put(cache, i, std::string(10, 'b'));
+  }
+  ASSERT_EQ(cache.size(), 3u);
+  ASSERT_EQ(cache.bytes(), 30u);
+  ASSERT_FALSE(cache.contains(16));
+  ASSERT_TRUE(cache.contains(17));
+  ASSERT_TRUE(cache.contains(19));
+
+  // A block lower than all cached blocks is evicted right away
+  ASSERT_EQ(cache.put(5, "12345", 5), 1u);
+  ASSERT_FALSE(cache.contains(5));
+  ASSERT_EQ(cache.size(), 3u);
+}
+
+TEST(source_block_cache, block_larger_than_cache_is_not_cached) {
+  auto cache = SourceBlockCache{10};
+  put(cache, 1, "block1");
+  ASSERT_EQ(cache.put(2, std::string(11, 'b').data(), 11), 2u);
+  ASSERT_EQ(cache.size(), 0u);
+  ASSERT_EQ(cache.bytes(), 0u);
+}
+
+TEST(source_block_cache, erase) {
+  auto cache = SourceBlockCache{1024};
+  for (uint64_t i = 1; i <= 10; ++i) {
+    put(cache, i, "block");
+  }
+  cache.erase(10);
+  cache.erase(11);
+  ASSERT_FALSE(cache.contains(10));
+  ASSERT_EQ(cache.eraseBelow(4), 3u);
+  ASSERT_FALSE(cache.contains(3));
+  ASSERT_TRUE(cache.contains(4));
+  ASSERT_EQ(cache.size(), 6u);
+  ASSERT_EQ(cache.bytes(), 30u);
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0u);
+  ASSERT_EQ(cache.bytes(), 0u);
+}
+
+}  // namespace
@@ -352,6 +352,113 @@ TEST_F(SourceSelectorTestFixture, change_source_after_too_many_retransmissions)
   ASSERT_EQ(source_selector.shouldReplaceSource(curTimeMs, false, false), SourceReplacementMode::DO_NOT);
 }
 
+// Striped fetching
+constexpr uint16_t kMaxStripeSources = 2;
+constexpr uint32_t kMinStripeWindow = 16;
+constexpr uint32_t kMaxStripeWindow = 256;
+
+SourceSelector makeStripingSourceSelector(const std::set<uint16_t>& all_replicas) {
+  return SourceSelector(all_replicas,
+                        kRetransmissionTimeoutMs,
+                        kReplicaReplacementTimeoutMs,
+                        maxFetchRetransmissions,
+                        kminPrePrepareMsgsForPrimaryAwareness,
+                        GL,
+                        kMaxStripeSources,
+                        kMinStripeWindow,
+                        kMaxStripeWindow);
+}
+
+TEST_F(SourceSelectorTestFixture, no_stripe_sources_by_default) {
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  ASSERT_TRUE(source_selector.updateStripeSources().empty());
+}
+
+TEST_F(SourceSelectorTestFixture, stripe_sources_are_preferred_replicas_other_than_the_current_source) {
+  auto source_selector = makeStripingSourceSelector({1, 2, 3, 4, 5});
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  const auto stripe_sources = source_selector.updateStripeSources();
+  ASSERT_EQ(stripe_sources.size(), kMaxStripeSources);
+  for (const auto& r : stripe_sources) {
+    ASSERT_NE(r, source_selector.currentReplica());
+    ASSERT_TRUE(source_selector.isPreferredSourceId(r));
+    ASSERT_TRUE(source_selector.isStripeSource(r));
+    ASSERT_EQ(source_selector.stripeWindow(r), kMinStripeWindow);
+  }
+}
+
+TEST_F(SourceSelectorTestFixture, the_primary_is_not_a_stripe_source) {
+  auto source_selector = makeStripingSourceSelector({1, 2, 3});
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  const auto primary = (source_selector.currentReplica() == 1) ? 2 : 1;
+  for (uint16_t i = 1; i <= source_selector.minPrePrepareMsgsForPrimaryAwareness(); i++) {
+    source_selector.updateCurrentPrimary(primary);
+  }
+  ASSERT_EQ(source_selector.currentPrimary(), primary);
+  const auto stripe_sources = source_selector.updateStripeSources();
+  ASSERT_EQ(stripe_sources.size(), 1);
+  ASSERT_NE(stripe_sources[0], primary);
+  ASSERT_NE(stripe_sources[0], source_selector.currentReplica());
+}
+
+TEST_F(SourceSelectorTestFixture, stripe_windows_adapt_to_throughput) {
+  auto source_selector = makeStripingSourceSelector({1, 2, 3});
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  const auto stripe_sources = source_selector.updateStripeSources();
+  ASSERT_EQ(stripe_sources.size(), 2);
+  const auto fast = stripe_sources[0];
+  const auto slow = stripe_sources[1];
+
+  // The window of the fast source grows up to the maximum, at most doubling each time
+  auto window = source_selector.stripeWindow(fast);
+  while (window < kMaxStripeWindow) {
+    source_selector.onStripeCompleted(fast, 1000 * window, 100);
+    ASSERT_GT(source_selector.stripeWindow(fast), window);
+    ASSERT_LE(source_selector.stripeWindow(fast), 2 * window);
+    window = source_selector.stripeWindow(fast);
+  }
+  ASSERT_EQ(window, kMaxStripeWindow);
+
+  // The slow source, with a quarter of the throughput of the fast one, ends up with a quarter of the maximum window
+  for (int i = 0; i < 10; ++i) {
+    source_selector.onStripeCompleted(slow, 250 * kMaxStripeWindow, 100);
+    source_selector.onStripeCompleted(fast, 1000 * kMaxStripeWindow, 100);
+  }
+  ASSERT_EQ(source_selector.stripeWindow(fast), kMaxStripeWindow);
+  ASSERT_EQ(source_selector.stripeWindow(slow), kMaxStripeWindow / 4);
+}
+
+TEST_F(SourceSelectorTestFixture, stripe_window_is_halved_on_expiry) {
+  auto source_selector = makeStripingSourceSelector({1, 2, 3});
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  const auto r = source_selector.updateStripeSources()[0];
+  source_selector.onStripeCompleted(r, 1000, 10);
+  ASSERT_EQ(source_selector.stripeWindow(r), 2 * kMinStripeWindow);
+  source_selector.onStripeExpired(r);
+  ASSERT_EQ(source_selector.stripeWindow(r), kMinStripeWindow);
+  source_selector.onStripeExpired(r);
+  ASSERT_EQ(source_selector.stripeWindow(r), kMinStripeWindow);
+}
+
+TEST_F(SourceSelectorTestFixture, removed_stripe_source_is_not_preferred) {
+  auto source_selector = makeStripingSourceSelector({1, 2, 3});
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  const auto r = source_selector.updateStripeSources()[0];
+  source_selector.removeStripeSource(r);
+  ASSERT_FALSE(source_selector.isStripeSource(r));
+  ASSERT_FALSE(source_selector.isPreferredSourceId(r));
+  const auto stripe_sources = source_selector.updateStripeSources();
+  ASSERT_EQ(std::count(stripe_sources.cbegin(), stripe_sources.cend(), r), 0);
+}
+
+TEST_F(SourceSelectorTestFixture, reset_removes_stripe_sources) {
+  auto source_selector = makeStripingSourceSelector({1, 2, 3});
+  source_selector.updateSource(kSampleCurrentTimeMs);
+  ASSERT_FALSE(source_selector.updateStripeSources().empty());
+  source_selector.reset();
+  ASSERT_TRUE(source_selector.isReset());
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
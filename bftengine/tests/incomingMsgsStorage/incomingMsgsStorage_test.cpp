@@ -19,20 +19,24 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <future>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace {
 
 using namespace bftEngine::impl;
 using namespace std::chrono_literals;
 
-class incoming_msgs_storage_test : public ::testing::Test {
+// The parameter determines whether the lock-free queues are enabled.
+class incoming_msgs_storage_test : public ::testing::TestWithParam<bool> {
   void SetUp() override {
     reg_->registerMsgHandler(msg_id_, [this](MessageBase* msg) { consumer_(msg); });
-    storage_.emplace(reg_, msg_wait_timeout_, replica_id_);
+    storage_.emplace(reg_, msg_wait_timeout_, replica_id_, GetParam());
     storage_->start();
   }
 
@@ -56,7 +60,7 @@ class incoming_msgs_storage_test : public ::testing::Test {
   std::optional<IncomingMsgsStorageImp> storage_;
 };
 
-TEST_F(incoming_msgs_storage_test, push_external_without_callback) {
+TEST_P(incoming_msgs_storage_test, push_external_without_callback) {
   ASSERT_TRUE(storage_->pushExternalMsg(newMsg()));
   auto msg = waitTillMsgConsumed();
   ASSERT_EQ(msg_size_, msg->size());
@@ -64,7 +68,7 @@ TEST_F(incoming_msgs_storage_test, push_external_without_callback) {
   ASSERT_EQ(msg_id_, msg->type());
 }
 
-TEST_F(incoming_msgs_storage_test, push_external_raw_without_callback) {
+TEST_P(incoming_msgs_storage_test, push_external_raw_without_callback) {
   auto msg_before = newMsg();
   auto buf = buffer();
   auto ptr = buf.data();
@@ -76,7 +80,7 @@ TEST_F(incoming_msgs_storage_test, push_external_raw_without_callback) {
   ASSERT_EQ(msg_id_, msg_after->type());
 }
 
-TEST_F(incoming_msgs_storage_test, push_external_with_callback) {
+TEST_P(incoming_msgs_storage_test, push_external_with_callback) {
   auto popped = std::atomic_bool{false};
   ASSERT_TRUE(storage_->pushExternalMsg(newMsg(), [&popped]() { popped = true; }));
   auto msg = waitTillMsgConsumed();
@@ -88,7 +92,7 @@ TEST_F(incoming_msgs_storage_test, push_external_with_callback) {
 
 // Push a message with `msg_id_` that is consumed by a consumer that pushes another message with `msg_id_ + 1` that has
 // a callback. Wait for both consumers and make sure the callback was called.
-TEST_F(incoming_msgs_storage_test, push_external_from_consumer_thread) {
+TEST_P(incoming_msgs_storage_test, push_external_from_consumer_thread) {
   // Create a local registrator, storage and consumer to override the default test ones.
   auto popped = std::atomic_bool{false};
   auto reg = std::make_shared<MsgHandlersRegistrator>();
@@ -101,7 +105,7 @@ TEST_F(incoming_msgs_storage_test, push_external_from_consumer_thread) {
       std::packaged_task<std::unique_ptr<MessageBase>(MessageBase*)>{[&](MessageBase* msg) { return own(msg); }};
   reg->registerMsgHandler(msg_id_, [&](MessageBase* msg) { consumer1(msg); });
   reg->registerMsgHandler(msg_id_ + 1, [&](MessageBase* msg) { consumer2(msg); });
-  storage = std::make_unique<IncomingMsgsStorageImp>(reg, msg_wait_timeout_, replica_id_);
+  storage = std::make_unique<IncomingMsgsStorageImp>(reg, msg_wait_timeout_, replica_id_, GetParam());
   storage->start();
   storage->pushExternalMsg(newMsg(msg_id_));
   consumer1.get_future().wait();
@@ -110,7 +114,7 @@ TEST_F(incoming_msgs_storage_test, push_external_from_consumer_thread) {
   storage->stop();
 }
 
-TEST_F(incoming_msgs_storage_test, push_external_raw_with_callback) {
+TEST_P(incoming_msgs_storage_test, push_external_raw_with_callback) {
   auto popped = std::atomic_bool{false};
   auto msg_before = newMsg();
   auto buf = buffer();
@@ -124,14 +128,14 @@ TEST_F(incoming_msgs_storage_test, push_external_raw_with_callback) {
   ASSERT_TRUE(popped);
 }
 
-TEST_F(incoming_msgs_storage_test, push_external_callback_not_called_before_consume) {
+TEST_P(incoming_msgs_storage_test, push_external_callback_not_called_before_consume) {
   storage_->stop();
   auto popped = std::atomic_bool{false};
   ASSERT_TRUE(storage_->pushExternalMsg(newMsg(), [&popped]() { popped = true; }));
   ASSERT_FALSE(popped);
 }
 
-TEST_F(incoming_msgs_storage_test, push_external_raw_callback_not_called_before_consume) {
+TEST_P(incoming_msgs_storage_test, push_external_raw_callback_not_called_before_consume) {
   storage_->stop();
   auto popped = std::atomic_bool{false};
   auto msg = newMsg();
@@ -142,4 +146,159 @@ TEST_F(incoming_msgs_storage_test, push_external_raw_callback_not_called_before_
   ASSERT_FALSE(popped);
 }
 
+TEST_P(incoming_msgs_storage_test, push_external_fails_when_full) {
+  storage_->stop();
+  auto pushed = 0u;
+  while (storage_->pushExternalMsg(newMsg())) {
+    ++pushed;
+    ASSERT_LE(pushed, 1u << 16);
+  }
+  ASSERT_EQ(pushed, 20000u);
+}
+
+// Messages pushed by many producers are all dispatched and the ones from a single producer are dispatched in order.
+TEST_P(incoming_msgs_storage_test, push_external_from_multiple_threads) {
+  constexpr auto producers = 4u;
+  constexpr auto msgs_per_producer = 1000u;
+  auto reg = std::make_shared<MsgHandlersRegistrator>();
+  auto storage = IncomingMsgsStorageImp{reg, msg_wait_timeout_, replica_id_, GetParam()};
+  auto next_expected = std::vector<std::uint32_t>(producers, 0);
+  auto out_of_order = std::atomic_bool{false};
+  auto done = std::promise<void>{};
+  auto consumed = 0u;
+  reg->registerMsgHandler(msg_id_, [&](MessageBase* msg) {
+    auto owned = own(msg);
+    const auto producer = msg->senderId();
+    auto seq = std::uint32_t{0};
+    std::memcpy(&seq, msg->body() + sizeof(MessageBase::Header), sizeof(seq));
+    if (next_expected[producer]++ != seq) out_of_order = true;
+    if (++consumed == producers * msgs_per_producer) done.set_value();
+  });
+  storage.start();
+  auto threads = std::vector<std::thread>{};
+  for (auto p = 0u; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (auto i = 0u; i < msgs_per_producer; ++i) {
+        auto msg = std::make_unique<MessageBase>(p, msg_id_, msg_size_ + sizeof(std::uint32_t));
+        std::memcpy(msg->body() + sizeof(MessageBase::Header), &i, sizeof(i));
+        while (!storage.pushExternalMsg(std::move(msg))) {
+          msg = std::make_unique<MessageBase>(p, msg_id_, msg_size_ + sizeof(std::uint32_t));
+          std::memcpy(msg->body() + sizeof(MessageBase::Header), &i, sizeof(i));
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(10s));
+  storage.stop();
+  ASSERT_FALSE(out_of_order);
+}
+
+// Messages with a pre-validator are validated by the validation threads and dispatched as internal messages in the
+// per-sender order. Invalid messages are not dispatched at all.
+TEST_P(incoming_msgs_storage_test, pre_validated_msgs_keep_per_sender_order) {
+  constexpr auto senders = 5u;
+  constexpr auto msgs_per_sender = 200u;
+  constexpr auto validation_threads = 3u;
+  auto reg = std::make_shared<MsgHandlersRegistrator>();
+  auto storage = IncomingMsgsStorageImp{reg, msg_wait_timeout_, replica_id_, GetParam(), validation_threads};
+  const auto seq_of = [](const MessageBase* msg) {
+    auto seq = std::uint32_t{0};
+    std::memcpy(&seq, msg->body() + sizeof(MessageBase::Header), sizeof(seq));
+    return seq;
+  };
+  // Odd sequence numbers are invalid.
+  reg->registerMsgPreValidator(msg_id_, [&](MessageBase* msg) -> std::optional<InternalMessage> {
+    if (seq_of(msg) % 2) {
+      delete msg;
+      return std::nullopt;
+    }
+    CarrierMesssage* carrier = new ValidatedMessageCarrierInternalMsg<MessageBase>(msg);
+    return carrier;
+  });
+  reg->registerMsgHandler(msg_id_, [](MessageBase* msg) {
+    delete msg;
+    FAIL() << "Message was not pre-validated";
+  });
+  auto next_expected = std::vector<std::uint32_t>(senders, 0);
+  auto out_of_order = std::atomic_bool{false};
+  auto done = std::promise<void>{};
+  auto consumed = 0u;
+  reg->registerInternalMsgHandler([&](InternalMessage&& im) {
+    auto carrier = std::unique_ptr<CarrierMesssage>{std::get<CarrierMesssage*>(im)};
+    auto msg = own(static_cast<ValidatedMessageCarrierInternalMsg<MessageBase>*>(carrier.get())->returnMessageToOwner());
+    if (next_expected[msg->senderId()] != seq_of(msg.get())) out_of_order = true;
+    next_expected[msg->senderId()] += 2;
+    if (++consumed == senders * msgs_per_sender / 2) done.set_value();
+  });
+  storage.start();
+  for (auto i = 0u; i < msgs_per_sender; ++i) {
+    for (auto sender = 0u; sender < senders; ++sender) {
+      auto msg = std::make_unique<MessageBase>(sender, msg_id_, msg_size_ + sizeof(std::uint32_t));
+      std::memcpy(msg->body() + sizeof(MessageBase::Header), &i, sizeof(i));
+      ASSERT_TRUE(storage.pushExternalMsg(std::move(msg)));
+    }
+  }
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(10s));
+  storage.stop();
+  ASSERT_FALSE(out_of_order);
+}
+
+TEST_P(incoming_msgs_storage_test, validated_and_unvalidated_msgs_keep_per_sender_order) {
+  constexpr auto senders = 5u;
+  constexpr auto msgs_per_sender = 300u;
+  constexpr auto validation_threads = 3u;
+  const auto unvalidated_msg_id = static_cast<std::uint16_t>(msg_id_ + 1);
+  auto reg = std::make_shared<MsgHandlersRegistrator>();
+  auto storage = IncomingMsgsStorageImp{reg, msg_wait_timeout_, replica_id_, GetParam(), validation_threads};
+  const auto seq_of = [](const MessageBase* msg) {
+    auto seq = std::uint32_t{0};
+    std::memcpy(&seq, msg->body() + sizeof(MessageBase::Header), sizeof(seq));
+    return seq;
+  };
+  auto next_expected = std::vector<std::uint32_t>(senders, 0);
+  auto out_of_order = std::atomic_bool{false};
+  auto done = std::promise<void>{};
+  auto consumed = 0u;
+  auto callbacks = std::atomic_uint{0};
+  const auto on_msg = [&](std::unique_ptr<MessageBase> msg) {
+    if (next_expected[msg->senderId()]++ != seq_of(msg.get())) out_of_order = true;
+    if (++consumed == senders * msgs_per_sender) done.set_value();
+  };
+  // Only msg_id_ messages are pre-validated; every third message has no pre-validator and every fifth has a callback.
+  reg->registerMsgPreValidator(msg_id_, [](MessageBase* msg) -> std::optional<InternalMessage> {
+    CarrierMesssage* carrier = new ValidatedMessageCarrierInternalMsg<MessageBase>(msg);
+    return carrier;
+  });
+  reg->registerPreValidatedMsgHandler([&](std::uint16_t msg_type, std::optional<InternalMessage>&& im) {
+    EXPECT_EQ(msg_id_, msg_type);
+    auto carrier = std::unique_ptr<CarrierMesssage>{std::get<CarrierMesssage*>(*im)};
+    on_msg(own(static_cast<ValidatedMessageCarrierInternalMsg<MessageBase>*>(carrier.get())->returnMessageToOwner()));
+  });
+  reg->registerMsgHandler(msg_id_, [&](MessageBase* msg) { on_msg(own(msg)); });
+  reg->registerMsgHandler(unvalidated_msg_id, [&](MessageBase* msg) { on_msg(own(msg)); });
+  storage.start();
+  for (auto i = 0u; i < msgs_per_sender; ++i) {
+    for (auto sender = 0u; sender < senders; ++sender) {
+      auto msg = std::make_unique<MessageBase>(
+          sender, i % 3 ? msg_id_ : unvalidated_msg_id, msg_size_ + sizeof(std::uint32_t));
+      std::memcpy(msg->body() + sizeof(MessageBase::Header), &i, sizeof(i));
+      auto on_popped = i % 5 ? IncomingMsgsStorage::Callback{} : [&callbacks]() { ++callbacks; };
+      ASSERT_TRUE(storage.pushExternalMsg(std::move(msg), std::move(on_popped)));
+    }
+  }
+  const auto status = done.get_future().wait_for(10s);
+  storage.stop();
+  ASSERT_EQ(std::future_status::ready, status);
+  ASSERT_FALSE(out_of_order);
+  ASSERT_EQ(senders * msgs_per_sender / 5, callbacks);
+}
+
+INSTANTIATE_TEST_CASE_P(incoming_msgs_storage_test_instance,
+                        incoming_msgs_storage_test,
+                        ::testing::Values(false, true),
+                        [](const ::testing::TestParamInfo<bool>& info) {
+                          return info.param ? "lock_free_queues" : "locked_queues";
+                        });
+
 }  // namespace
@@ -0,0 +1,96 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms.
+// Your use of these subcomponents is subject to the terms and conditions of the sub-component's license,
+// as noted in the LICENSE file.
+
+#include "gtest/gtest.h"
+
+#include "RequestsBatchingLogic.hpp"
+
+#include <deque>
+#include <stdexcept>
+
+namespace {
+
+using namespace bftEngine;
+using namespace bftEngine::impl;
+using namespace bftEngine::batchingLogic;
+using namespace std::chrono;
+
+class TestReplicaConfig : public ReplicaConfig {};
+
+// A primary whose queue holds only the arrival times of its requests. PrePrepare messages are "finalized
+// asynchronously": they consume requests from the queue and are reported as sent without a message.
+class TestReplica : public InternalReplicaApi {
+ public:
+  explicit TestReplica(const ReplicaConfig& config) : config_{config} {}
+
+  const ReplicasInfo& getReplicasInfo() const override { throw std::logic_error{"not implemented"}; }
+  bool isValidClient(NodeIdType) const override { return true; }
+  bool isIdOfReplica(NodeIdType) const override { return false; }
+  const std::set<ReplicaId>& getIdsOfPeerReplicas() const override { return replicaIds_; }
+  ViewNum getCurrentView() const override { return 0; }
+  ReplicaId currentPrimary() const override { return 0; }
+  bool isCurrentPrimary() const override { return true; }
+  bool currentViewIsActive() const override { return true; }
+  bool isReplyAlreadySentToClient(NodeIdType, ReqId) const override { return false; }
+  bool isClientRequestInProcess(NodeIdType, ReqId) const override { return false; }
+  SeqNum getPrimaryLastUsedSeqNum() const override { return 0; }
+  uint64_t getRequestsInQueue() const override { return requests_.size(); }
+  Time getOldestRequestArrivalTime() const override { return requests_.empty() ? MinTime : requests_.front(); }
+  SeqNum getLastExecutedSeqNum() const override { return 0; }
+  std::pair<PrePrepareMsg*, bool> buildPrePrepareMsgBatchByRequestsNum(uint32_t requiredRequestsNum) override {
+    if (requests_.size() < requiredRequestsNum) return std::make_pair(nullptr, false);
+    requests_.erase(requests_.begin(), requests_.begin() + requiredRequestsNum);
+    return std::make_pair(nullptr, true);
+  }
+  IncomingMsgsStorage& getIncomingMsgsStorage() override { throw std::logic_error{"not implemented"}; }
+  concord::util::SimpleThreadPool& getInternalThreadPool() override { throw std::logic_error{"not implemented"}; }
+  bool isCollectingState() const override { return false; }
+  const ReplicaConfig& getReplicaConfig() const override { return config_; }
+
+  void addRequest(Time arrivalTime) { requests_.push_back(arrivalTime); }
+
+ private:
+  const ReplicaConfig& config_;
+  std::set<ReplicaId> replicaIds_;
+  std::deque<Time> requests_;
+};
+
+TEST(RequestsBatchingLogic, request_to_preprepare_delay_is_recorded_for_every_pipelined_slot) {
+  auto config = TestReplicaConfig{};
+  config.batchingPolicy = BATCH_BY_REQ_NUM;
+  config.maxNumOfRequestsInBatch = 2;
+  config.prePrepareFinalizeAsyncEnabled = true;
+  config.prePrepareProposalPipelineDepth = 3;
+  auto replica = TestReplica{config};
+  auto metrics = concordMetrics::Component{"replica", std::make_shared<concordMetrics::Aggregator>()};
+  auto timers = concordUtil::Timers{};
+  auto batchingLogic = RequestsBatchingLogic{replica, config, metrics, timers};
+
+  // Three batches, whose oldest requests arrived 300ms, 200ms and 100ms ago
+  const auto now = getMonotonicTime();
+  for (const auto age : {300ms, 290ms, 200ms, 190ms, 100ms, 90ms}) replica.addRequest(now - age);
+  const auto result = batchingLogic.batchRequests();
+  ASSERT_TRUE(result.second);
+  ASSERT_EQ(0u, replica.getRequestsInQueue());
+
+  auto& registrar = concord::diagnostics::RegistrarSingleton::getInstance();
+  registrar.perf.snapshot("requestsBatchingLogic");
+  const auto delay = registrar.perf.get("requestsBatchingLogic", "request_to_preprepare_delay").last_snapshot;
+  ASSERT_EQ(3, delay.count);
+  ASSERT_GE(delay.min, duration_cast<microseconds>(100ms).count());
+  ASSERT_LT(delay.min, duration_cast<microseconds>(190ms).count());
+  ASSERT_GE(delay.max, duration_cast<microseconds>(300ms).count() * 999 / 1000);
+  const auto slots = registrar.perf.get("requestsBatchingLogic", "slots_per_proposal").last_snapshot;
+  ASSERT_EQ(1, slots.count);
+  ASSERT_EQ(3, slots.max);
+}
+
+}  // namespace
@@ -46,7 +46,7 @@ struct Header {
 static constexpr size_t MSG_HEADER_SIZE = sizeof(Header);
 typedef std::unordered_map<NodeNum, NodeInfo> NodeMap;
 
-enum CommType { PlainUdp, SimpleAuthUdp, PlainTcp, SimpleAuthTcp, TlsTcp, TlsMultiplex };
+enum CommType { PlainUdp, SimpleAuthUdp, PlainTcp, SimpleAuthTcp, TlsTcp, TlsMultiplex, SharedMemory };
 const static std::unordered_map<CommType, const char *> commTypeToName = {
     {PlainUdp, "PlainUdp"},
     {SimpleAuthUdp, "SimpleAuthUdp"},
@@ -54,6 +54,7 @@ const static std::unordered_map<CommType, const char *> commTypeToName = {
     {SimpleAuthTcp, "SimpleAuthTcp"},
     {TlsTcp, "TlsTcp"},
     {TlsMultiplex, "TlsMultiplex"},
+    {SharedMemory, "SharedMemory"},
 };
 
 class BaseCommConfig {
@@ -151,6 +152,15 @@ class TlsTcpConfig : public PlainTcpConfig {
   std::string cipherSuite_;
   bool useUnifiedCertificates_;
   std::optional<concord::secretsmanager::SecretData> secretData_;
+  // A connection coalesces up to this number of queued messages, and this number of bytes, into a single write.
+  // By default, every message is sent by a separate write.
+  uint32_t maxCoalescedWriteMsgs_ = 1;
+  uint32_t maxCoalescedWriteBytes_ = 64 * 1024;
+  // The number of io_contexts (shards) the connections are spread over, each served by a single thread.
+  // With a single shard, the io_context is served by the pool of threads given to the runner.
+  uint16_t numOfIoShards_ = 1;
+  // Pin the thread of shard k to core k (modulo the number of cores). Only applies to more than one shard.
+  bool pinIoShardsToCores_ = false;
 };
 
 class TlsMultiplexConfig : public TlsTcpConfig {
@@ -186,6 +196,42 @@ class TlsMultiplexConfig : public TlsTcpConfig {
   std::unordered_map<NodeNum, NodeNum> endpointIdToNodeIdMap_;
 };
 
+// Messages to the peers in `sharedMemoryPeers_` are passed through shared memory rings, and messages to all other peers
+// through a communication object created from `remoteConfig_`. A shared memory peer must run on the same host, and
+// must list this node as its shared memory peer as well.
+//
+// For each ordered pair of peers there is a ring named /<sharedMemoryPrefix_>-<sender>-to-<receiver>, created by the
+// receiver. Senders obtain the receiver's eventfd over its unix domain socket at
+// <controlSocketDir_>/<sharedMemoryPrefix_>-<receiver>.sock. Both ends of the socket, and the rings, must belong to the
+// same user, so the directory may be shared with other users.
+class SharedMemoryConfig : public BaseCommConfig {
+ public:
+  SharedMemoryConfig(uint32_t bufLength,
+                     NodeMap nodes,
+                     NodeNum selfId,
+                     std::unordered_set<NodeNum> sharedMemoryPeers,
+                     std::shared_ptr<BaseCommConfig> remoteConfig = nullptr,
+                     UPDATE_CONNECTIVITY_FN statusCallback = nullptr)
+      : BaseCommConfig(CommType::SharedMemory,
+                       remoteConfig ? remoteConfig->listenHost_ : std::string{},
+                       remoteConfig ? remoteConfig->listenPort_ : 0,
+                       bufLength,
+                       nodes,
+                       selfId,
+                       std::move(statusCallback)),
+        sharedMemoryPeers_{std::move(sharedMemoryPeers)},
+        remoteConfig_{std::move(remoteConfig)} {}
+
+ public:
+  std::unordered_set<NodeNum> sharedMemoryPeers_;
+  // May be null if all peers are shared memory peers.
+  std::shared_ptr<BaseCommConfig> remoteConfig_;
+  std::string sharedMemoryPrefix_ = "concord-bft";
+  std::string controlSocketDir_ = "/tmp";
+  // The capacity of each ring in bytes. Must be a power of two, larger than bufferLength_.
+  uint32_t ringCapacity_ = 8 * 1024 * 1024;
+};
+
 class PlainUDPCommunication : public ICommunication {
  public:
   static PlainUDPCommunication *create(const PlainUdpConfig &config);
@@ -258,6 +304,30 @@ class TlsTCPCommunication : public ICommunication {
   explicit TlsTCPCommunication(const TlsTcpConfig &config);
 };
 
+class SharedMemoryCommunication : public ICommunication {
+ public:
+  // Takes ownership of remoteComm, which serves all the peers that are not shared memory peers. It may be null.
+  static SharedMemoryCommunication *create(const SharedMemoryConfig &config, ICommunication *remoteComm);
+
+  int getMaxMessageSize() override;
+  int start() override;
+  int stop() override;
+  bool isRunning() const override;
+  ConnectionStatus getCurrentConnectionStatus(NodeNum node) override;
+  int send(NodeNum destNode, std::vector<uint8_t> &&msg, NodeNum endpointNum) override;
+  std::set<NodeNum> send(std::set<NodeNum> dests, std::vector<uint8_t> &&msg, NodeNum srcEndpointNum) override;
+  void setReceiver(NodeNum receiverNum, IReceiver *receiver) override;
+  void restartCommunication(NodeNum i) override;
+  ~SharedMemoryCommunication() override;
+
+ private:
+  class SharedMemoryImpl;
+  std::unique_ptr<SharedMemoryImpl> impl_;
+  std::unique_ptr<ICommunication> remoteComm_;
+
+  SharedMemoryCommunication(const SharedMemoryConfig &config, ICommunication *remoteComm);
+};
+
 class TlsMultiplexCommunication : public TlsTCPCommunication {
  public:
   static TlsMultiplexCommunication *create(const TlsMultiplexConfig &config);
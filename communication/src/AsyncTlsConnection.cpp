@@ -221,33 +221,32 @@ void AsyncTlsConnection::send(std::shared_ptr<OutgoingMsg>&& msg) {
 }
 
 void AsyncTlsConnection::write(std::shared_ptr<OutgoingMsg> msg) {
-  if (disposed_ || !msg) return;
+  if (disposed_) return;
+  if (msg) write_queue_.push(std::move(msg));
 
-  bool expected = true;
-  // There is already an in-flight msg
-  if (write_msg_used_.compare_exchange_weak(expected, true)) {
-    write_queue_.push(std::move(msg));
-    return;
-  }
-  expected = false;
-  // Set the in-flight msg
-  if (write_msg_used_.compare_exchange_weak(expected, true)) {
-    write_msg_ = std::move(msg);
-  } else {
-    write_queue_.push(std::move(msg));
-    LOG_ERROR(logger_, "write_msg_ already in use by other thread, msg pushed to the write queue.");
+  bool expected = false;
+  // There is already an in-flight write. Its completion handler writes the queued messages.
+  if (!write_msg_used_.compare_exchange_strong(expected, true)) return;
+
+  // Coalesce as many queued messages as allowed into a single gathered write
+  write_msgs_ = write_queue_.popBatch(config_.maxCoalescedWriteMsgs_, config_.maxCoalescedWriteBytes_);
+  if (write_msgs_.empty()) {
+    write_msg_used_ = false;
     return;
   }
-  LOG_DEBUG(logger_, "Writing" << KVLOG(write_msg_->msg.size()));
+  fillWriteBuffers();
+  LOG_DEBUG(logger_, "Writing" << KVLOG(write_msgs_.size(), write_size_));
 
   // We don't want to include tcp transmission time.
-  histograms_.send_time_in_queue->recordAtomic(durationInMicros(write_msg_->send_time));
+  for (const auto& m : write_msgs_) histograms_.send_time_in_queue->recordAtomic(durationInMicros(m->send_time));
+  histograms_.coalesced_write_msgs->recordAtomic(static_cast<int64_t>(write_msgs_.size()));
+  histograms_.coalesced_write_bytes->recordAtomic(static_cast<int64_t>(write_size_));
 
   auto self = shared_from_this();
   auto start = std::chrono::steady_clock::now();
   asio::async_write(
       *socket_,
-      asio::buffer(write_msg_->msg),
+      write_buffers_,
       asio::bind_executor(strand_, [this, self, start](const asio::error_code& ec, auto /*bytes_written*/) {
         if (disposed_) return;
         if (ec) {
@@ -257,23 +256,54 @@ void AsyncTlsConnection::write(std::shared_ptr<OutgoingMsg> msg) {
             return;
           }
           LOG_WARN(logger_,
-                   "Write failed to node " << peer_id_.value() << " for message with size " << write_msg_->msg.size()
-                                           << ": " << ec.message());
+                   "Write failed to node " << peer_id_.value() << " for " << write_msgs_.size()
+                                           << " messages with total size " << write_size_ << ": " << ec.message());
           return dispose();
         }
 
         // The write succeeded.
         histograms_.async_write->recordAtomic(durationInMicros(start));
         write_timer_.cancel();
-        histograms_.sent_msg_size->recordAtomic(static_cast<int64_t>(write_msg_->msg.size()));
-        write_msg_ = nullptr;
+        for (const auto& m : write_msgs_) histograms_.sent_msg_size->recordAtomic(static_cast<int64_t>(m->size()));
+        write_msgs_.clear();
         write_msg_used_ = false;
-        write(write_queue_.pop());
+        write(nullptr);
       }));
   LOG_DEBUG(logger_, "Write:" << KVLOG(peer_id_.value()));
   startWriteTimer();
 }
 
+void AsyncTlsConnection::fillWriteBuffers() {
+  size_t copied_size = 0;
+  write_size_ = 0;
+  for (const auto& m : write_msgs_) {
+    if (m->size() <= MAX_COPIED_MSG_SIZE) copied_size += m->size();
+    write_size_ += m->size();
+  }
+  // Reserving up front guarantees that write_buf_ isn't reallocated while buffers point into it
+  write_buf_.clear();
+  write_buf_.reserve(copied_size);
+  write_buffers_.clear();
+  size_t segment_start = 0;
+  auto closeSegment = [this, &segment_start]() {
+    if (write_buf_.size() > segment_start) {
+      write_buffers_.push_back(asio::buffer(write_buf_.data() + segment_start, write_buf_.size() - segment_start));
+      segment_start = write_buf_.size();
+    }
+  };
+  for (const auto& m : write_msgs_) {
+    if (m->size() <= MAX_COPIED_MSG_SIZE) {
+      write_buf_.insert(write_buf_.end(), m->header.begin(), m->header.end());
+      write_buf_.insert(write_buf_.end(), m->payload->begin(), m->payload->end());
+    } else {
+      closeSegment();
+      write_buffers_.push_back(asio::buffer(m->header));
+      write_buffers_.push_back(asio::buffer(*m->payload));
+    }
+  }
+  closeSegment();
+}
+
 void AsyncTlsConnection::createSSLSocket(asio::ip::tcp::socket&& socket) {
   socket_ = std::make_unique<SSL_SOCKET>(io_context_, ssl_context_);
   socket_->lowest_layer() = std::move(socket);
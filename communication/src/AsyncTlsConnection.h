@@ -123,6 +123,7 @@ class AsyncTlsConnection : public std::enable_shared_from_this<AsyncTlsConnectio
   std::optional<NodeNum> getPeerId() const { return peer_id_; }
 
   SSL_SOCKET& getSocket() { return *socket_.get(); }
+  asio::io_context& getIoContext() const { return io_context_; }
 
   // Wrapper function to be called from the ConnMgr.
   void send(std::shared_ptr<OutgoingMsg>&& msg);
@@ -135,7 +136,8 @@ class AsyncTlsConnection : public std::enable_shared_from_this<AsyncTlsConnectio
   void readMsgSizeHeader();
   void readMsgSizeHeader(std::optional<size_t> bytes_already_read);
 
-  // Write this message in strand_ , or enqueue it if there is already a message being written.
+  // Enqueue this message and, unless there is already a write in flight, write the queued messages in strand_.
+  // Up to maxCoalescedWriteMsgs_ messages, or maxCoalescedWriteBytes_ bytes, are coalesced into a single write.
   void write(std::shared_ptr<OutgoingMsg>);
 
   // Wrapper function to be called from the ConnMgr strand.
@@ -160,6 +162,9 @@ class AsyncTlsConnection : public std::enable_shared_from_this<AsyncTlsConnectio
   void startReadTimer();
   void startWriteTimer();
 
+  // Build write_buffers_ for the messages in write_msgs_.
+  void fillWriteBuffers();
+
   void createSSLSocket(asio::ip::tcp::socket&&);
   void initClientSSLContext(NodeNum destination);
   void initServerSSLContext();
@@ -213,9 +218,17 @@ class AsyncTlsConnection : public std::enable_shared_from_this<AsyncTlsConnectio
   // Last read message
   std::vector<char> read_msg_;
 
-  // Message being currently written.
+  // Messages being currently written, and the total size of the write.
   std::atomic_bool write_msg_used_{false};
-  std::shared_ptr<OutgoingMsg> write_msg_;
+  std::vector<std::shared_ptr<OutgoingMsg>> write_msgs_;
+  size_t write_size_ = 0;
+
+  // TLS encrypts every buffer of a gathered write as a separate record. Consecutive messages that fit in a single
+  // record are therefore copied here together with their headers, while larger ones are written from their own
+  // payload buffer.
+  static constexpr size_t MAX_COPIED_MSG_SIZE = 16 * 1024;
+  std::vector<uint8_t> write_buf_;
+  std::vector<asio::const_buffer> write_buffers_;
 
   TlsTcpConfig& config_;
   TlsStatus& status_;
@@ -11,6 +11,7 @@
 // terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -48,6 +49,17 @@ ICommunication *CommFactory::create(const BaseCommConfig &config) {
       res = TlsMultiplexCommunication::create(dynamic_cast<const TlsMultiplexConfig &>(config));
 #endif
       break;
+    case CommType::SharedMemory: {
+      const auto &sharedMemoryConfig = dynamic_cast<const SharedMemoryConfig &>(config);
+      std::unique_ptr<ICommunication> remoteComm;
+      if (sharedMemoryConfig.remoteConfig_) {
+        remoteComm.reset(create(*sharedMemoryConfig.remoteConfig_));
+        if (!remoteComm) break;
+      }
+      // Ownership passes to the new object only once it is constructed
+      res = SharedMemoryCommunication::create(sharedMemoryConfig, remoteComm.get());
+      remoteComm.release();
+    } break;
   }
 
   LOG_INFO(_logger,
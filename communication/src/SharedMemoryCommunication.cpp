@@ -0,0 +1,578 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use
+// this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license
+// terms. Your use of these subcomponents is subject to the terms and conditions of the
+// subcomponent's license, as noted in the LICENSE file.
+
+#include "assertUtils.hpp"
+#include "Logger.hpp"
+#include "communication/CommDefs.hpp"
+#include "errnoString.hpp"
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace bft::communication {
+
+using shm::Ring;
+
+namespace {
+
+std::runtime_error errnoError(const std::string &what) {
+  return std::runtime_error{what + ": " + concordUtils::errnoString(errno)};
+}
+
+// A mapping of a shared memory segment. Takes ownership of `fd`, which is closed once the segment is mapped.
+class Mapping {
+ public:
+  Mapping(int fd, size_t size) : size_{size} {
+    addr_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr_ == MAP_FAILED) throw errnoError("mmap");
+  }
+  ~Mapping() { munmap(addr_, size_); }
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+
+  void *addr() const { return addr_; }
+  size_t size() const { return size_; }
+
+ private:
+  void *addr_;
+  size_t size_;
+};
+
+}  // namespace
+
+// Receives the messages of all shared memory peers in a single thread, and maintains the connections to them in
+// another. A peer is connected once we obtained its eventfd, and mapped the ring it created for our messages.
+class SharedMemoryCommunication::SharedMemoryImpl {
+  static constexpr std::chrono::milliseconds CONNECT_TICK = std::chrono::milliseconds(1000);
+  static constexpr std::chrono::milliseconds CONTROL_SOCKET_TIMEOUT = std::chrono::milliseconds(1000);
+  // The maximal number of messages consumed from a ring before moving to the next one.
+  static constexpr size_t MAX_MSGS_PER_RING = 64;
+
+ public:
+  explicit SharedMemoryImpl(const SharedMemoryConfig &config)
+      : logger_{logging::getLogger("concord-bft.shm")},
+        selfId_{config.selfId_},
+        prefix_{config.sharedMemoryPrefix_},
+        controlSocketDir_{config.controlSocketDir_},
+        ringCapacity_{config.ringCapacity_},
+        maxMsgSize_{std::min<uint64_t>(config.bufferLength_, ringCapacity_ - sizeof(Ring::RecordHeader))} {
+    for (auto peer : config.sharedMemoryPeers_) {
+      if (peer == selfId_) continue;
+      inbound_.try_emplace(peer);
+      outbound_.try_emplace(peer);
+      validateControlSocketPath(peer);
+    }
+    validateControlSocketPath(selfId_);
+  }
+
+  ~SharedMemoryImpl() { stop(); }
+
+  bool isPeer(NodeNum node) const { return outbound_.count(node) > 0; }
+  int getMaxMessageSize() const { return static_cast<int>(maxMsgSize_); }
+  void setReceiver(IReceiver *receiver) { receiver_ = receiver; }
+  bool isRunning() const { return running_; }
+
+  int start() {
+    std::lock_guard<std::mutex> guard(startStopLock_);
+    if (running_) return -1;
+    if (!receiver_) {
+      LOG_ERROR(logger_, "Cannot start shared memory communication: receiver not set");
+      return -1;
+    }
+    try {
+      createInbound();
+    } catch (const std::exception &e) {
+      LOG_ERROR(logger_, "Failed to start shared memory communication: " << e.what());
+      releaseResources();
+      return -1;
+    }
+    running_ = true;
+    recvThread_ = std::thread([this]() { recvThreadRoutine(); });
+    connectThread_ = std::thread([this]() { connectThreadRoutine(); });
+    LOG_INFO(logger_, "Shared memory communication started" << KVLOG(selfId_, inbound_.size()));
+    return 0;
+  }
+
+  int stop() {
+    std::lock_guard<std::mutex> guard(startStopLock_);
+    if (!running_) return -1;
+    running_ = false;
+    const uint64_t one = 1;
+    if (write(stopFd_, &one, sizeof(one)) < 0) {
+      LOG_WARN(logger_, "Failed to wake up shared memory threads: " << concordUtils::errnoString(errno));
+    }
+    recvThread_.join();
+    connectThread_.join();
+    releaseResources();
+    return 0;
+  }
+
+  ConnectionStatus getCurrentConnectionStatus(NodeNum node) const {
+    auto it = outbound_.find(node);
+    if (it == outbound_.end()) return ConnectionStatus::Unknown;
+    return it->second.connected ? ConnectionStatus::Connected : ConnectionStatus::Disconnected;
+  }
+
+  // Can be called by any thread.
+  int send(NodeNum destination, const std::vector<uint8_t> &msg, NodeNum endpointNum) {
+    if (msg.size() > maxMsgSize_) {
+      LOG_ERROR(logger_, "Msg Dropped. Size exceeds max message size: " << KVLOG(destination, msg.size(), maxMsgSize_));
+      return -1;
+    }
+    auto &channel = outbound_.at(destination);
+    std::lock_guard<std::mutex> guard(channel.lock);
+    if (!channel.ring) return -1;
+    if (!channel.ring->tryPush(msg.data(), static_cast<uint32_t>(msg.size()), endpointNum)) {
+      LOG_DEBUG(logger_, "Msg Dropped. Ring is full" << KVLOG(destination, msg.size()));
+      return -1;
+    }
+    // Pairs with the fence in recvThreadRoutine: either the consumer sees the message before blocking, or we see that
+    // it sleeps and wake it up.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (channel.ring->isConsumerSleeping()) {
+      const uint64_t one = 1;
+      if (write(channel.eventFd, &one, sizeof(one)) < 0) {
+        LOG_WARN(logger_, "Failed to signal peer " << destination << ": " << concordUtils::errnoString(errno));
+      }
+    }
+    return 0;
+  }
+
+ private:
+  struct InboundChannel {
+    std::optional<Mapping> mapping;
+    std::optional<Ring> ring;
+    // The control connection of the peer, kept open so that the peer can tell when we go down.
+    int controlFd = -1;
+  };
+
+  struct OutboundChannel {
+    // Protects the members below against concurrent senders and the connect thread.
+    std::mutex lock;
+    std::optional<Mapping> mapping;
+    std::optional<Ring> ring;
+    int eventFd = -1;
+    int controlFd = -1;
+    std::atomic_bool connected = false;
+  };
+
+  std::string ringName(NodeNum sender, NodeNum receiver) const {
+    return "/" + prefix_ + "-" + std::to_string(sender) + "-to-" + std::to_string(receiver);
+  }
+
+  std::string controlSocketPath(NodeNum node) const {
+    return controlSocketDir_ + "/" + prefix_ + "-" + std::to_string(node) + ".sock";
+  }
+
+  void validateControlSocketPath(NodeNum node) const {
+    const auto path = controlSocketPath(node);
+    if (path.size() >= sizeof(sockaddr_un::sun_path)) {
+      throw std::invalid_argument("Control socket path is too long: " + path);
+    }
+  }
+
+  static sockaddr_un unixAddress(const std::string &path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+  }
+
+  // Create the rings of all peers, the eventfd they signal, and the control socket they obtain it from.
+  void createInbound() {
+    inboundEventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inboundEventFd_ < 0 || stopFd_ < 0) throw errnoError("eventfd");
+
+    for (auto &[peer, channel] : inbound_) {
+      const auto name = ringName(peer, selfId_);
+      // A ring left by a previous run is stale - its sender reconnects once it sees we restarted.
+      shm_unlink(name.c_str());
+      const auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+      if (fd < 0) throw errnoError("shm_open " + name);
+      const auto size = Ring::segmentSize(ringCapacity_);
+      if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        close(fd);
+        throw errnoError("ftruncate " + name);
+      }
+      channel.mapping.emplace(fd, size);
+      Ring::init(channel.mapping->addr(), ringCapacity_);
+      channel.ring.emplace(channel.mapping->addr(), size);
+    }
+
+    const auto path = controlSocketPath(selfId_);
+    const auto addr = unixAddress(path);
+    unlink(path.c_str());
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) throw errnoError("socket");
+    if (::bind(listenFd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) < 0) {
+      throw errnoError("bind " + path);
+    }
+    if (chmod(path.c_str(), S_IRUSR | S_IWUSR) < 0) throw errnoError("chmod " + path);
+    if (listen(listenFd_, static_cast<int>(inbound_.size()) + 1) < 0) throw errnoError("listen " + path);
+  }
+
+  void releaseResources() {
+    for (auto &[peer, channel] : outbound_) {
+      (void)peer;  // unused variable hack
+      disconnect(channel);
+    }
+    for (auto &[peer, channel] : inbound_) {
+      if (channel.controlFd >= 0) close(channel.controlFd);
+      channel.controlFd = -1;
+      channel.ring.reset();
+      if (channel.mapping) shm_unlink(ringName(peer, selfId_).c_str());
+      channel.mapping.reset();
+    }
+    if (listenFd_ >= 0) {
+      close(listenFd_);
+      unlink(controlSocketPath(selfId_).c_str());
+    }
+    for (auto fd : {inboundEventFd_, stopFd_}) {
+      if (fd >= 0) close(fd);
+    }
+    listenFd_ = inboundEventFd_ = stopFd_ = -1;
+  }
+
+  bool consumeInbound() {
+    bool consumed = false;
+    for (auto &[peer, channel] : inbound_) {
+      try {
+        const auto n = channel.ring->consume(
+            [this, peer = peer](const uint8_t *msg, uint32_t size, NodeNum endpointNum) {
+              receiver_->onNewMessage(peer, reinterpret_cast<const char *>(msg), size, endpointNum);
+            },
+            MAX_MSGS_PER_RING);
+        consumed = consumed || n > 0;
+      } catch (const std::runtime_error &e) {
+        LOG_ERROR(logger_, "Dropping the content of the ring of peer " << peer << ": " << e.what());
+      }
+    }
+    return consumed;
+  }
+
+  void setConsumerSleeping(bool sleeping) {
+    for (auto &[peer, channel] : inbound_) {
+      (void)peer;  // unused variable hack
+      channel.ring->setConsumerSleeping(sleeping);
+    }
+  }
+
+  bool inboundEmpty() const {
+    for (const auto &[peer, channel] : inbound_) {
+      (void)peer;  // unused variable hack
+      if (!channel.ring->empty()) return false;
+    }
+    return true;
+  }
+
+  void recvThreadRoutine() {
+    while (running_) {
+      if (consumeInbound()) continue;
+      // About to block - ask the senders to signal the eventfd, unless a message arrived in the meantime.
+      setConsumerSleeping(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (inboundEmpty()) {
+        pollfd fds[] = {{inboundEventFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+          LOG_ERROR(logger_, "poll failed: " << concordUtils::errnoString(errno));
+        }
+        if (fds[0].revents & POLLIN) {
+          // Reset the eventfd counter
+          uint64_t value;
+          [[maybe_unused]] auto ret = read(inboundEventFd_, &value, sizeof(value));
+        }
+      }
+      setConsumerSleeping(false);
+    }
+  }
+
+  void connectThreadRoutine() {
+    while (running_) {
+      for (auto &[peer, channel] : outbound_) {
+        if (channel.connected) {
+          checkConnection(peer, channel);
+        } else {
+          connect(peer, channel);
+        }
+      }
+      pollfd fds[] = {{listenFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+      const auto rc = poll(fds, 2, static_cast<int>(CONNECT_TICK.count()));
+      if (rc < 0 && errno != EINTR) {
+        LOG_ERROR(logger_, "poll failed: " << concordUtils::errnoString(errno));
+      }
+      if (running_ && rc > 0 && (fds[0].revents & POLLIN)) acceptControlConnection();
+    }
+  }
+
+  static void setTimeout(int fd) {
+    timeval tv{};
+    tv.tv_sec = CONTROL_SOCKET_TIMEOUT.count() / 1000;
+    tv.tv_usec = (CONTROL_SOCKET_TIMEOUT.count() % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  }
+
+  // The control socket directory may be shared with other users (e.g. /tmp), so both ends of a control connection
+  // only talk to a process of the same user.
+  static bool peerIsSameUser(int fd) {
+    ucred cred{};
+    socklen_t len = sizeof(cred);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 && len == sizeof(cred) && cred.uid == geteuid();
+  }
+
+  // The sender sends its node id. If it is one of our shared memory peers, we reply with our eventfd.
+  void acceptControlConnection() {
+    const auto fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      LOG_WARN(logger_, "accept failed: " << concordUtils::errnoString(errno));
+      return;
+    }
+    if (!peerIsSameUser(fd)) {
+      LOG_WARN(logger_, "Rejecting a control connection from a process of another user");
+      close(fd);
+      return;
+    }
+    setTimeout(fd);
+    NodeNum peer;
+    if (recv(fd, &peer, sizeof(peer), MSG_WAITALL) != sizeof(peer) || !inbound_.count(peer)) {
+      LOG_WARN(logger_, "Rejecting a control connection from an unknown peer");
+      close(fd);
+      return;
+    }
+
+    char ack = 0;
+    iovec iov{&ack, sizeof(ack)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    auto cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &inboundEventFd_, sizeof(int));
+    if (sendmsg(fd, &msg, MSG_NOSIGNAL) != sizeof(ack)) {
+      LOG_WARN(logger_, "Failed to send eventfd to peer " << peer << ": " << concordUtils::errnoString(errno));
+      close(fd);
+      return;
+    }
+    auto &channel = inbound_.at(peer);
+    if (channel.controlFd >= 0) close(channel.controlFd);
+    channel.controlFd = fd;
+    LOG_INFO(logger_, "Accepted shared memory peer " << peer);
+  }
+
+  void connect(NodeNum peer, OutboundChannel &channel) {
+    const auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return;
+    const auto addr = unixAddress(controlSocketPath(peer));
+    if (::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) < 0) {
+      // The peer isn't up yet
+      close(fd);
+      return;
+    }
+    setTimeout(fd);
+    int eventFd = -1;
+    try {
+      if (!peerIsSameUser(fd)) throw std::runtime_error("the control socket is served by a process of another user");
+      if (::send(fd, &selfId_, sizeof(selfId_), MSG_NOSIGNAL) != sizeof(selfId_)) throw errnoError("send");
+      eventFd = receiveEventFd(fd);
+      const auto name = ringName(selfId_, peer);
+      const auto shmFd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+      if (shmFd < 0) throw errnoError("shm_open " + name);
+      struct stat st {};
+      if (fstat(shmFd, &st) < 0) {
+        close(shmFd);
+        throw errnoError("fstat " + name);
+      }
+      if (st.st_uid != geteuid()) {
+        close(shmFd);
+        throw std::runtime_error("ring " + name + " is owned by another user");
+      }
+      std::lock_guard<std::mutex> guard(channel.lock);
+      channel.mapping.emplace(shmFd, static_cast<size_t>(st.st_size));
+      channel.ring.emplace(channel.mapping->addr(), channel.mapping->size());
+      channel.eventFd = eventFd;
+      channel.controlFd = fd;
+      channel.connected = true;
+    } catch (const std::exception &e) {
+      LOG_WARN(logger_, "Failed to connect to shared memory peer " << peer << ": " << e.what());
+      std::lock_guard<std::mutex> guard(channel.lock);
+      channel.ring.reset();
+      channel.mapping.reset();
+      if (eventFd >= 0) close(eventFd);
+      close(fd);
+      return;
+    }
+    LOG_INFO(logger_, "Connected to shared memory peer " << peer);
+  }
+
+  static int receiveEventFd(int fd) {
+    char ack;
+    iovec iov{&ack, sizeof(ack)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_CMSG_CLOEXEC) != sizeof(ack)) throw errnoError("recvmsg");
+    auto cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      throw std::runtime_error("No eventfd received");
+    }
+    int eventFd;
+    std::memcpy(&eventFd, CMSG_DATA(cmsg), sizeof(int));
+    return eventFd;
+  }
+
+  // The peer never writes to the control connection, so any event means it went down.
+  void checkConnection(NodeNum peer, OutboundChannel &channel) {
+    pollfd fds[] = {{channel.controlFd, POLLIN | POLLRDHUP, 0}};
+    if (poll(fds, 1, 0) > 0) {
+      LOG_WARN(logger_, "Shared memory peer " << peer << " disconnected");
+      disconnect(channel);
+    }
+  }
+
+  static void disconnect(OutboundChannel &channel) {
+    std::lock_guard<std::mutex> guard(channel.lock);
+    channel.connected = false;
+    channel.ring.reset();
+    channel.mapping.reset();
+    for (auto fd : {channel.eventFd, channel.controlFd}) {
+      if (fd >= 0) close(fd);
+    }
+    channel.eventFd = channel.controlFd = -1;
+  }
+
+ private:
+  logging::Logger logger_;
+  const NodeNum selfId_;
+  const std::string prefix_;
+  const std::string controlSocketDir_;
+  const uint64_t ringCapacity_;
+  const uint64_t maxMsgSize_;
+  IReceiver *receiver_ = nullptr;
+
+  // Both maps are populated at construction and never change, so they may be read without locking.
+  // inbound_ is only accessed by the receive and connect threads.
+  std::unordered_map<NodeNum, InboundChannel> inbound_;
+  std::unordered_map<NodeNum, OutboundChannel> outbound_;
+
+  int inboundEventFd_ = -1;
+  int stopFd_ = -1;
+  int listenFd_ = -1;
+
+  std::mutex startStopLock_;
+  std::atomic_bool running_ = false;
+  std::thread recvThread_;
+  std::thread connectThread_;
+};
+
+SharedMemoryCommunication::SharedMemoryCommunication(const SharedMemoryConfig &config, ICommunication *remoteComm)
+    : impl_{std::make_unique<SharedMemoryImpl>(config)}, remoteComm_{remoteComm} {}
+
+SharedMemoryCommunication::~SharedMemoryCommunication() = default;
+
+SharedMemoryCommunication *SharedMemoryCommunication::create(const SharedMemoryConfig &config,
+                                                             ICommunication *remoteComm) {
+  return new SharedMemoryCommunication(config, remoteComm);
+}
+
+int SharedMemoryCommunication::getMaxMessageSize() {
+  if (!remoteComm_) return impl_->getMaxMessageSize();
+  return std::min(impl_->getMaxMessageSize(), remoteComm_->getMaxMessageSize());
+}
+
+int SharedMemoryCommunication::start() {
+  if (remoteComm_) {
+    if (auto ret = remoteComm_->start(); ret != 0) return ret;
+  }
+  return impl_->start();
+}
+
+int SharedMemoryCommunication::stop() {
+  auto ret = impl_->stop();
+  if (remoteComm_) {
+    // Report the first failure, but stop the remote communication regardless
+    if (auto remoteRet = remoteComm_->stop(); ret == 0) ret = remoteRet;
+  }
+  return ret;
+}
+
+bool SharedMemoryCommunication::isRunning() const { return impl_->isRunning(); }
+
+ConnectionStatus SharedMemoryCommunication::getCurrentConnectionStatus(NodeNum node) {
+  if (impl_->isPeer(node)) return impl_->getCurrentConnectionStatus(node);
+  return remoteComm_ ? remoteComm_->getCurrentConnectionStatus(node) : ConnectionStatus::Unknown;
+}
+
+int SharedMemoryCommunication::send(NodeNum destNode, std::vector<uint8_t> &&msg, NodeNum endpointNum) {
+  if (impl_->isPeer(destNode)) return impl_->send(destNode, msg, endpointNum);
+  return remoteComm_ ? remoteComm_->send(destNode, std::move(msg), endpointNum) : -1;
+}
+
+std::set<NodeNum> SharedMemoryCommunication::send(std::set<NodeNum> dests,
+                                                  std::vector<uint8_t> &&msg,
+                                                  NodeNum srcEndpointNum) {
+  std::set<NodeNum> failed;
+  std::set<NodeNum> remoteDests;
+  for (auto dest : dests) {
+    if (!impl_->isPeer(dest)) {
+      remoteDests.insert(dest);
+    } else if (impl_->send(dest, msg, srcEndpointNum) != 0) {
+      failed.insert(dest);
+    }
+  }
+  if (remoteDests.empty()) return failed;
+  if (!remoteComm_) {
+    failed.insert(remoteDests.begin(), remoteDests.end());
+    return failed;
+  }
+  auto remoteFailed = remoteComm_->send(std::move(remoteDests), std::move(msg), srcEndpointNum);
+  failed.insert(remoteFailed.begin(), remoteFailed.end());
+  return failed;
+}
+
+void SharedMemoryCommunication::setReceiver(NodeNum receiverNum, IReceiver *receiver) {
+  impl_->setReceiver(receiver);
+  if (remoteComm_) remoteComm_->setReceiver(receiverNum, receiver);
+}
+
+void SharedMemoryCommunication::restartCommunication(NodeNum i) {
+  // Shared memory peers reconnect by themselves
+  if (!impl_->isPeer(i) && remoteComm_) remoteComm_->restartCommunication(i);
+}
+
+}  // namespace bft::communication
@@ -0,0 +1,164 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use
+// this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license
+// terms. Your use of these subcomponents is subject to the terms and conditions of the
+// subcomponent's license, as noted in the LICENSE file.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include "communication/ICommunication.hpp"
+
+namespace bft::communication::shm {
+
+// A single-producer/single-consumer ring of variable size messages, placed in a shared memory segment so that the
+// producer and the consumer may live in different processes.
+//
+// The segment starts with a RingHeader, followed by `capacity` bytes of records. Each record is a RecordHeader
+// followed by the message, padded to RECORD_ALIGNMENT bytes. A record never wraps around the end of the ring: if it
+// doesn't fit in the remaining space, a WRAP record is written there and the record starts at the beginning.
+//
+// `head` and `tail` are byte positions that only grow, and are stored with release semantics after the records they
+// publish/free. The producer sets nothing else; the consumer may set `consumer_sleeping` before it blocks, in which
+// case the producer should wake it up after a push (see SharedMemoryCommunication).
+//
+// Ring doesn't own the memory - it is just a view over a mapped segment.
+class Ring {
+ public:
+  static constexpr uint64_t RECORD_ALIGNMENT = 16;
+
+  struct alignas(64) RingHeader {
+    static constexpr uint64_t MAGIC = 0x636f6e636f726452;  // "concordR"
+    uint64_t magic;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::atomic<uint32_t> consumer_sleeping;
+  };
+
+  struct RecordHeader {
+    static constexpr uint32_t WRAP = 0xFFFFFFFF;
+    uint32_t size;
+    uint32_t reserved;
+    NodeNum endpoint_num;
+  };
+  static_assert(sizeof(RecordHeader) == RECORD_ALIGNMENT);
+  // The atomics are shared between processes, so they must not be implemented with a lock.
+  static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+
+  // The size of a segment holding a ring with the given capacity. Capacity must be a power of two.
+  static size_t segmentSize(uint64_t capacity) { return sizeof(RingHeader) + capacity; }
+
+  // Initialize an empty ring in a newly created (zeroed) segment.
+  static void init(void* segment, uint64_t capacity) {
+    if (capacity < RECORD_ALIGNMENT || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument("Ring capacity must be a power of two of at least 16 bytes");
+    }
+    auto header = new (segment) RingHeader{};
+    header->capacity = capacity;
+    header->head = 0;
+    header->tail = 0;
+    header->consumer_sleeping = 0;
+    header->magic = RingHeader::MAGIC;
+  }
+
+  // Attach to a ring initialized by init(). `segment_size` is the size of the mapping.
+  Ring(void* segment, size_t segment_size) : header_{static_cast<RingHeader*>(segment)} {
+    if (segment_size < sizeof(RingHeader) || header_->magic != RingHeader::MAGIC ||
+        segmentSize(header_->capacity) != segment_size) {
+      throw std::runtime_error("Not a valid shared memory ring");
+    }
+    capacity_ = header_->capacity;
+    data_ = reinterpret_cast<uint8_t*>(header_ + 1);
+  }
+
+  // Producer only. Returns false if there is no room for the message.
+  bool tryPush(const uint8_t* msg, uint32_t size, NodeNum endpoint_num) {
+    const auto record_size = recordSize(size);
+    if (record_size > capacity_) return false;
+    auto tail = header_->tail.load(std::memory_order_relaxed);
+    const auto head = header_->head.load(std::memory_order_acquire);
+    const auto offset = tail & (capacity_ - 1);
+    const auto contiguous = capacity_ - offset;
+    const auto padding = contiguous < record_size ? contiguous : 0;
+    if (tail + padding + record_size - head > capacity_) return false;
+    if (padding) {
+      writeRecordHeader(offset, RecordHeader::WRAP, 0);
+      tail += padding;
+    }
+    const auto record_offset = tail & (capacity_ - 1);
+    writeRecordHeader(record_offset, size, endpoint_num);
+    std::memcpy(data_ + record_offset + sizeof(RecordHeader), msg, size);
+    header_->tail.store(tail + record_size, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Call `f(const uint8_t* msg, uint32_t size, NodeNum endpoint_num)` for up to `max_msgs` messages and
+  // return the number of messages consumed. A message is freed only after `f` returns.
+  //
+  // Records are written by another process, so they are validated before use. If the ring turns out to be corrupted,
+  // all of its content is discarded.
+  template <typename F>
+  size_t consume(F&& f, size_t max_msgs) {
+    auto head = header_->head.load(std::memory_order_relaxed);
+    const auto tail = header_->tail.load(std::memory_order_acquire);
+    size_t consumed = 0;
+    while (head != tail && consumed < max_msgs) {
+      const auto offset = head & (capacity_ - 1);
+      RecordHeader record;
+      std::memcpy(&record, data_ + offset, sizeof(record));
+      const auto is_wrap = record.size == RecordHeader::WRAP;
+      const auto record_size = is_wrap ? capacity_ - offset : recordSize(record.size);
+      if (offset + record_size > capacity_ || head + record_size > tail) {
+        header_->head.store(tail, std::memory_order_release);
+        throw std::runtime_error("Corrupted shared memory ring");
+      }
+      if (!is_wrap) {
+        f(data_ + offset + sizeof(RecordHeader), record.size, record.endpoint_num);
+        consumed++;
+      }
+      head += record_size;
+      header_->head.store(head, std::memory_order_release);
+    }
+    return consumed;
+  }
+
+  bool empty() const {
+    return header_->head.load(std::memory_order_seq_cst) == header_->tail.load(std::memory_order_seq_cst);
+  }
+
+  // The consumer sets this flag before blocking; the producer reads it after a push to decide whether to signal.
+  void setConsumerSleeping(bool sleeping) { header_->consumer_sleeping.store(sleeping, std::memory_order_seq_cst); }
+  bool isConsumerSleeping() const { return header_->consumer_sleeping.load(std::memory_order_seq_cst) != 0; }
+
+  uint64_t capacity() const { return capacity_; }
+
+  // The largest message that can ever be pushed.
+  uint64_t maxMsgSize() const { return capacity_ - sizeof(RecordHeader); }
+
+ private:
+  static uint64_t recordSize(uint64_t msg_size) {
+    return (sizeof(RecordHeader) + msg_size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+  }
+
+  void writeRecordHeader(uint64_t offset, uint32_t size, NodeNum endpoint_num) {
+    const RecordHeader record{size, 0, endpoint_num};
+    std::memcpy(data_ + offset, &record, sizeof(record));
+  }
+
+  RingHeader* header_;
+  uint64_t capacity_;
+  uint8_t* data_;
+};
+
+}  // namespace bft::communication::shm
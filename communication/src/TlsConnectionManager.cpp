@@ -10,6 +10,7 @@
 // subcomponent's license, as noted in the LICENSE file.
 
 #include <asio/bind_executor.hpp>
+#include <chrono>
 #include <cstdint>
 #include <future>
 #include <string>
@@ -25,10 +26,11 @@ namespace bft::communication::tls {
 
 void setSocketOptions(asio::ip::tcp::socket& socket) { socket.set_option(asio::ip::tcp::no_delay(true)); }
 
-ConnectionManager::ConnectionManager(const TlsTcpConfig& config, asio::io_context& io_context)
+ConnectionManager::ConnectionManager(const TlsTcpConfig& config,
+                                     const std::vector<std::unique_ptr<asio::io_context>>& io_contexts)
     : logger_(logging::getLogger("concord-bft.tls.connMgr")),
       config_(config),
-      io_context_(io_context),
+      io_context_(*io_contexts.front()),
       strand_(asio::make_strand(io_context_)),
       acceptor_(io_context_),
       resolver_(io_context_),
@@ -39,6 +41,19 @@ ConnectionManager::ConnectionManager(const TlsTcpConfig& config, asio::io_contex
   concord::diagnostics::StatusHandler handler(
       "tls" + std::to_string(config.selfId_), "TLS status", [this]() { return status_->status(); });
   registrar.status.registerHandler(handler);
+
+  // A single io_context is served by the connection manager strand only
+  if (io_contexts.size() == 1) return;
+  for (size_t i = 0; i < io_contexts.size(); i++) {
+    shards_.push_back(std::make_unique<Shard>(*io_contexts[i], std::to_string(config.selfId_), i));
+  }
+  for (const auto& [id, _] : config_.nodes_) {
+    (void)_;  // unused variable hack
+    routes_.try_emplace(id);
+  }
+  for (NodeNum id = 0; id <= static_cast<NodeNum>(config_.maxServerId_); id++) {
+    routes_.try_emplace(id);
+  }
 }
 
 void ConnectionManager::start() {
@@ -76,6 +91,17 @@ void ConnectionManager::stop() {
     LOG_DEBUG(logger_, "Closing connection from: " << config_.selfId_ << ", to: " << id);
     syncCloseConnection(conn);
   }
+
+  // The io_contexts are already stopped, so it's safe to access the shards from this thread.
+  for (auto& shard : shards_) {
+    shard->connections.clear();
+  }
+  for (auto& [_, route] : routes_) {
+    (void)_;  // unused variable hack
+    std::lock_guard<std::mutex> lock(route.mutex);
+    route.shard = NO_SHARD;
+    route.pending.clear();
+  }
 }
 
 void ConnectionManager::setReceiver(NodeNum, IReceiver* receiver) { receiver_ = receiver; }
@@ -118,10 +144,14 @@ void ConnectionManager::send(const NodeNum destination, const std::shared_ptr<Ou
     LOG_ERROR(logger_, "Msg Dropped. Size exceeds max message size: " << KVLOG(msg->payload_size(), max_size));
     return;
   }
-  {
-    concord::diagnostics::TimeRecorder<true> scoped_timer(*histograms_.send_post_to_mgr);
+  concord::diagnostics::TimeRecorder<true> scoped_timer(*histograms_.send_post_to_mgr);
+  auto it = routes_.find(destination);
+  // Without shards, or for a node that isn't configured, the connection is only known to strand_
+  if (it == routes_.end()) {
     asio::post(strand_, [this, destination, msg]() { handleSend(destination, msg); });
+    return;
   }
+  routeSend(it->second, destination, msg);
 }
 
 void ConnectionManager::send(const std::set<NodeNum>& destinations, const std::shared_ptr<OutgoingMsg>& msg) {
@@ -131,9 +161,95 @@ void ConnectionManager::send(const std::set<NodeNum>& destinations, const std::s
     LOG_ERROR(logger_, "Msg Dropped. Size exceeds max message size: " << KVLOG(msg->payload_size(), max_size));
     return;
   }
-  {
-    concord::diagnostics::TimeRecorder<true> scoped_timer(*histograms_.send_post_to_mgr);
+  concord::diagnostics::TimeRecorder<true> scoped_timer(*histograms_.send_post_to_mgr);
+  if (shards_.empty()) {
     asio::post(strand_, [this, destinations, msg]() { handleSend(destinations, msg); });
+    return;
+  }
+  // Post a single handler to each shard serving any of the destinations
+  std::vector<std::vector<NodeNum>> destinations_per_shard(shards_.size());
+  std::set<NodeNum> unknown_destinations;
+  for (auto destination : destinations) {
+    auto it = routes_.find(destination);
+    if (it == routes_.end()) {
+      unknown_destinations.insert(destination);
+      continue;
+    }
+    auto& route = it->second;
+    std::unique_lock<std::mutex> lock(route.mutex);
+    if (route.shard != NO_SHARD) {
+      destinations_per_shard[route.shard].push_back(destination);
+      continue;
+    }
+    lock.unlock();
+    routeSend(route, destination, msg);
+  }
+  for (size_t i = 0; i < shards_.size(); i++) {
+    if (destinations_per_shard[i].empty()) continue;
+    auto& shard = *shards_[i];
+    postToShard(shard, [this, &shard, shard_destinations{std::move(destinations_per_shard[i])}, msg]() {
+      handleShardSend(shard, shard_destinations, msg);
+    });
+  }
+  if (!unknown_destinations.empty()) {
+    asio::post(strand_, [this, unknown_destinations{std::move(unknown_destinations)}, msg]() {
+      handleSend(unknown_destinations, msg);
+    });
+  }
+}
+
+void ConnectionManager::routeSend(Route& route, const NodeNum destination, const std::shared_ptr<OutgoingMsg>& msg) {
+  std::lock_guard<std::mutex> lock(route.mutex);
+  if (route.shard == NO_SHARD) {
+    // Only queue while an authenticated connection is being added to its shard. Otherwise the destination isn't
+    // connected, and the send is dropped like any send to an unconnected node.
+    if (route.authenticated && route.pending.size() < MAX_PENDING_SENDS) {
+      route.pending.push_back(msg);
+    } else {
+      status_->total_messages_dropped++;
+    }
+    return;
+  }
+  // Posting under the lock keeps the sends to the destination ordered
+  auto& shard = *shards_[route.shard];
+  postToShard(shard, [this, &shard, destination, msg]() { handleShardSend(shard, destination, msg); });
+}
+
+template <typename Handler>
+void ConnectionManager::postToShard(Shard& shard, Handler&& handler) {
+  shard.histograms.send_queue_depth->recordAtomic(++shard.pending_sends);
+  asio::post(shard.strand,
+             [&shard, handler{std::forward<Handler>(handler)}, start = std::chrono::steady_clock::now()]() mutable {
+               handler();
+               shard.pending_sends--;
+               shard.histograms.send_handler_latency->recordAtomic(
+                   std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                       .count());
+             });
+}
+
+void ConnectionManager::handleShardSend(Shard& shard, const NodeNum destination, std::shared_ptr<OutgoingMsg> msg) {
+  auto it = shard.connections.find(destination);
+  if (it != shard.connections.end()) {
+    it->second->send(std::move(msg));
+    status_->total_messages_sent++;
+  } else {
+    status_->total_messages_dropped++;
+  }
+}
+
+void ConnectionManager::handleShardSend(Shard& shard,
+                                        const std::vector<NodeNum>& destinations,
+                                        const std::shared_ptr<OutgoingMsg>& msg) {
+  for (auto destination : destinations) {
+    auto it = shard.connections.find(destination);
+    if (it != shard.connections.end()) {
+      auto cheap_copy = msg;
+      it->second->send(std::move(cheap_copy));
+      status_->total_messages_sent++;
+    } else {
+      status_->total_messages_dropped++;
+    }
   }
 }
 
@@ -177,6 +293,7 @@ void ConnectionManager::remoteCloseConnection(NodeNum id) {
     auto conn = std::move(connections_.at(id));
     connections_.erase(id);
     status_->num_connections = connections_.size();
+    removeFromShard(conn);
     conn->close();
   });
 }
@@ -188,6 +305,79 @@ void ConnectionManager::closeConnection(std::shared_ptr<AsyncTlsConnection> conn
 
 void ConnectionManager::syncCloseConnection(std::shared_ptr<AsyncTlsConnection>& conn) { conn->close(); }
 
+asio::io_context& ConnectionManager::ioContextForOutgoing(NodeNum destination) {
+  if (shards_.empty()) return io_context_;
+  return shards_[destination % shards_.size()]->io_context;
+}
+
+asio::io_context& ConnectionManager::ioContextForAccepted() {
+  if (shards_.empty()) return io_context_;
+  auto& io_context = shards_[next_accepted_shard_]->io_context;
+  next_accepted_shard_ = (next_accepted_shard_ + 1) % shards_.size();
+  return io_context;
+}
+
+size_t ConnectionManager::shardIndexOf(const AsyncTlsConnection& conn) const {
+  for (size_t i = 0; i < shards_.size(); i++) {
+    if (&shards_[i]->io_context == &conn.getIoContext()) return i;
+  }
+  ConcordAssert(false);
+  return 0;
+}
+
+void ConnectionManager::addToShard(const std::shared_ptr<AsyncTlsConnection>& conn) {
+  const auto peer_id = conn->getPeerId().value();
+  auto route_it = routes_.find(peer_id);
+  if (route_it == routes_.end()) return;
+  auto& route = route_it->second;
+  const auto index = shardIndexOf(*conn);
+  auto& shard = *shards_[index];
+  std::lock_guard<std::mutex> lock(route.mutex);
+  // The connection is added, and the queued sends are handed to it, before any send routed to the shard from now on
+  postToShard(shard, [this, &shard, peer_id, conn, pending{std::move(route.pending)}]() mutable {
+    shard.connections.insert_or_assign(peer_id, conn);
+    for (auto& msg : pending) {
+      conn->send(std::move(msg));
+      status_->total_messages_sent++;
+    }
+  });
+  route.pending.clear();
+  route.authenticated = false;
+  route.shard = static_cast<int>(index);
+}
+
+void ConnectionManager::markAuthenticated(NodeNum peer_id) {
+  auto route_it = routes_.find(peer_id);
+  if (route_it == routes_.end()) return;
+  std::lock_guard<std::mutex> lock(route_it->second.mutex);
+  route_it->second.authenticated = true;
+}
+
+void ConnectionManager::removeFromShard(const std::shared_ptr<AsyncTlsConnection>& conn) {
+  const auto peer_id = conn->getPeerId().value();
+  auto route_it = routes_.find(peer_id);
+  if (route_it == routes_.end()) return;
+  auto& route = route_it->second;
+  const auto index = shardIndexOf(*conn);
+  auto& shard = *shards_[index];
+  {
+    // From now on, sends to the peer are dropped until a new connection is authenticated
+    std::lock_guard<std::mutex> lock(route.mutex);
+    if (route.shard == static_cast<int>(index)) {
+      route.shard = NO_SHARD;
+      route.authenticated = false;
+      status_->total_messages_dropped += route.pending.size();
+      route.pending.clear();
+    }
+  }
+  asio::post(shard.strand, [&shard, peer_id, conn]() {
+    auto it = shard.connections.find(peer_id);
+    // The connection may already have been replaced by a newer connection to the same peer
+    if (it == shard.connections.end() || it->second != conn) return;
+    shard.connections.erase(it);
+  });
+}
+
 void ConnectionManager::onConnectionAuthenticated(std::shared_ptr<AsyncTlsConnection> conn) {
   // Move the connection into the accepted connections map. If there is an existing connection
   // discard it. In this case it was likely that connecting end of the connection thinks there is
@@ -198,9 +388,12 @@ void ConnectionManager::onConnectionAuthenticated(std::shared_ptr<AsyncTlsConnec
   if (it != connections_.end()) {
     LOG_INFO(logger_,
              "New connection accepted from same peer. Closing existing connection to " << conn->getPeerId().value());
+    removeFromShard(it->second);
     closeConnection(std::move(it->second));
   }
   connections_.insert_or_assign(conn->getPeerId().value(), conn);
+  markAuthenticated(conn->getPeerId().value());
+  addToShard(conn);
   status_->num_connections = connections_.size();
   conn->startReading();
 }
@@ -235,10 +428,10 @@ void ConnectionManager::onClientHandshakeComplete(const asio::error_code& ec, No
   onConnectionAuthenticated(std::move(conn));
 }
 
-void ConnectionManager::startServerSSLHandshake(asio::ip::tcp::socket&& socket) {
+void ConnectionManager::startServerSSLHandshake(asio::io_context& io_context, asio::ip::tcp::socket&& socket) {
   auto connection_id = total_accepted_connections_;
   auto conn =
-      AsyncTlsConnection::create(io_context_, std::move(socket), receiver_, *this, config_, *status_, histograms_);
+      AsyncTlsConnection::create(io_context, std::move(socket), receiver_, *this, config_, *status_, histograms_);
   accepted_waiting_for_handshake_.insert({connection_id, conn});
   status_->num_accepted_waiting_for_handshake = accepted_waiting_for_handshake_.size();
   conn->getSocket().async_handshake(asio::ssl::stream_base::server,
@@ -248,8 +441,14 @@ void ConnectionManager::startServerSSLHandshake(asio::ip::tcp::socket&& socket)
 }
 
 void ConnectionManager::startClientSSLHandshake(asio::ip::tcp::socket&& socket, NodeNum destination) {
-  auto conn = AsyncTlsConnection::create(
-      io_context_, std::move(socket), receiver_, *this, destination, config_, *status_, histograms_);
+  auto conn = AsyncTlsConnection::create(ioContextForOutgoing(destination),
+                                         std::move(socket),
+                                         receiver_,
+                                         *this,
+                                         destination,
+                                         config_,
+                                         *status_,
+                                         histograms_);
   connected_waiting_for_handshake_.insert({destination, conn});
   status_->num_connected_waiting_for_handshake = connected_waiting_for_handshake_.size();
   conn->getSocket().async_handshake(asio::ssl::stream_base::client,
@@ -259,31 +458,34 @@ void ConnectionManager::startClientSSLHandshake(asio::ip::tcp::socket&& socket,
 }
 
 void ConnectionManager::accept() {
-  acceptor_.async_accept(asio::bind_executor(strand_, [this](asio::error_code ec, asio::ip::tcp::socket sock) {
-    if (stopped_) return;
-    if (!StateControl::instance().tryLockComm()) {
-      LOG_WARN(logger_, "incoming comm is blocked");
-      return;
-    }
-    if (ec) {
-      LOG_WARN(logger_, "async_accept failed: " << ec.message());
-      // When io_service is stopped, the handlers are destroyed and when the
-      // io_service dtor runs they will be invoked with operation_aborted error.
-      // In this case we dont want to accept again.
-      if (ec == asio::error::operation_aborted) {
-        StateControl::instance().unlockComm();
-        return;
-      }
-    } else {
-      total_accepted_connections_++;
-      status_->total_accepted_connections = total_accepted_connections_;
-      setSocketOptions(sock);
-      LOG_INFO(logger_, "Accepted connection " << total_accepted_connections_);
-      startServerSSLHandshake(std::move(sock));
-      StateControl::instance().unlockComm();
-    }
-    accept();
-  }));
+  // The accepted socket is served by the io_context of the shard it is assigned to
+  auto& io_context = ioContextForAccepted();
+  acceptor_.async_accept(
+      io_context, asio::bind_executor(strand_, [this, &io_context](asio::error_code ec, asio::ip::tcp::socket sock) {
+        if (stopped_) return;
+        if (!StateControl::instance().tryLockComm()) {
+          LOG_WARN(logger_, "incoming comm is blocked");
+          return;
+        }
+        if (ec) {
+          LOG_WARN(logger_, "async_accept failed: " << ec.message());
+          // When io_service is stopped, the handlers are destroyed and when the
+          // io_service dtor runs they will be invoked with operation_aborted error.
+          // In this case we dont want to accept again.
+          if (ec == asio::error::operation_aborted) {
+            StateControl::instance().unlockComm();
+            return;
+          }
+        } else {
+          total_accepted_connections_++;
+          status_->total_accepted_connections = total_accepted_connections_;
+          setSocketOptions(sock);
+          LOG_INFO(logger_, "Accepted connection " << total_accepted_connections_);
+          startServerSSLHandshake(io_context, std::move(sock));
+          StateControl::instance().unlockComm();
+        }
+        accept();
+      }));
 }
 
 void ConnectionManager::resolve(NodeNum i) {
@@ -312,8 +514,8 @@ void ConnectionManager::resolve(NodeNum i) {
 }
 
 void ConnectionManager::connect(NodeNum i, const asio::ip::tcp::endpoint& endpoint) {
-  auto [it, inserted] =
-      connecting_.emplace(i, std::make_pair(asio::ip::tcp::socket(io_context_), asio::steady_timer(io_context_)));
+  auto [it, inserted] = connecting_.emplace(
+      i, std::make_pair(asio::ip::tcp::socket(ioContextForOutgoing(i)), asio::steady_timer(io_context_)));
   ConcordAssert(inserted);
   status_->num_connecting = connecting_.size();
   LOG_DEBUG(logger_, "connecting to node : " << i);
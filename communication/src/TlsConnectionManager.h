@@ -11,7 +11,10 @@
 
 #include <asio.hpp>
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "communication/CommDefs.hpp"
 #include "Logger.hpp"
@@ -27,6 +30,11 @@ class AsyncTlsConnection;
 // Manage all connections for a client or server in a peer-to-peer model.
 //
 // Peers with higher ids connect to peers with lower ids.
+//
+// With TlsTcpConfig::numOfIoShards_ > 1, connections are spread over several io_contexts (shards). Connection
+// establishment and teardown run in `strand_`, on the first io_context. Each shard keeps its own map of authenticated
+// connections, accessed only from the shard's strand, so a send is posted straight to the shard of its destination and
+// never goes through `strand_`. With a single io_context, all sends go through `strand_`.
 class ConnectionManager {
   static constexpr std::chrono::seconds CONNECT_TICK = std::chrono::seconds(1);
   static constexpr std::chrono::seconds CONNECT_DEADLINE = std::chrono::seconds(2);
@@ -34,7 +42,7 @@ class ConnectionManager {
   friend class AsyncTlsConnection;
 
  public:
-  ConnectionManager(const TlsTcpConfig &, asio::io_context &);
+  ConnectionManager(const TlsTcpConfig &, const std::vector<std::unique_ptr<asio::io_context>> &);
 
   //
   // Methods required by ICommunication
@@ -78,7 +86,7 @@ class ConnectionManager {
   void startConnectTimer();
 
   // Trigger the asio async_handshake calls.
-  void startServerSSLHandshake(asio::ip::tcp::socket &&);
+  void startServerSSLHandshake(asio::io_context &, asio::ip::tcp::socket &&);
   void startClientSSLHandshake(asio::ip::tcp::socket &&socket, NodeNum destination);
 
   // Callbacks triggered when asio async_handshake completes for an incoming or outgoing connection.
@@ -110,6 +118,29 @@ class ConnectionManager {
   void handleSend(const NodeNum destination, std::shared_ptr<OutgoingMsg> msg);
   void handleSend(const std::set<NodeNum> &destinations, const std::shared_ptr<OutgoingMsg> &msg);
 
+  // Sends to a destination whose connection lives in `shard` are posted to the shard's strand.
+  struct Shard;
+  struct Route;
+  // Post the send to the shard of the destination's connection, or queue it until the connection is added to a shard
+  void routeSend(Route &route, const NodeNum destination, const std::shared_ptr<OutgoingMsg> &msg);
+  void handleShardSend(Shard &shard, const NodeNum destination, std::shared_ptr<OutgoingMsg> msg);
+  void handleShardSend(Shard &shard, const std::vector<NodeNum> &destinations, const std::shared_ptr<OutgoingMsg> &msg);
+  template <typename Handler>
+  void postToShard(Shard &shard, Handler &&handler);
+
+  // The shard whose io_context serves a new connection. Outgoing connections are assigned by destination and
+  // accepted connections in a round robin fashion, since the peer is only known after the handshake.
+  asio::io_context &ioContextForOutgoing(NodeNum destination);
+  asio::io_context &ioContextForAccepted();
+  size_t shardIndexOf(const AsyncTlsConnection &conn) const;
+
+  // Add/remove an authenticated connection to/from its shard. Called from `strand_`. Adding a connection routes the
+  // sends to its peer to the shard, starting with the sends queued since the connection was marked authenticated.
+  // Removing a connection drops the sends still queued for its peer.
+  void markAuthenticated(NodeNum peer_id);
+  void addToShard(const std::shared_ptr<AsyncTlsConnection> &conn);
+  void removeFromShard(const std::shared_ptr<AsyncTlsConnection> &conn);
+
   // Answer connection status requests from other threads
   // Returns true in the promise if the destination is connected, false otherwise.
   void handleConnStatus(const NodeNum destination, std::promise<bool> &connected) const;
@@ -128,6 +159,7 @@ class ConnectionManager {
   // progress connections when cert validation completes
   size_t total_accepted_connections_ = 0;
 
+  // The first io_context also serves the connection manager itself.
   asio::io_context &io_context_;
   asio::strand<asio::io_context::executor_type> strand_;
   asio::ip::tcp::acceptor acceptor_;
@@ -153,6 +185,35 @@ class ConnectionManager {
   // Active, secured connections.
   std::unordered_map<NodeNum, std::shared_ptr<AsyncTlsConnection>> connections_;
 
+  struct Shard {
+    Shard(asio::io_context &io_context, const std::string &selfId, size_t index)
+        : io_context(io_context), strand(asio::make_strand(io_context)), histograms(selfId, index) {}
+    asio::io_context &io_context;
+    asio::strand<asio::io_context::executor_type> strand;
+    // Active, secured connections served by this shard. Only accessed from `strand`.
+    std::unordered_map<NodeNum, std::shared_ptr<AsyncTlsConnection>> connections;
+    // Handlers posted to `strand` and not yet run.
+    std::atomic<int64_t> pending_sends = 0;
+    ShardRecorders histograms;
+  };
+  std::vector<std::unique_ptr<Shard>> shards_;
+  size_t next_accepted_shard_ = 0;
+
+  // The shard of a node's authenticated connection, or NO_SHARD. Sends to a node without a shard are dropped, except
+  // in the window between its connection being authenticated and added to a shard: these are queued (up to
+  // MAX_PENDING_SENDS) and posted to the shard with the connection. A disconnect drops whatever is still queued.
+  static constexpr int NO_SHARD = -1;
+  static constexpr size_t MAX_PENDING_SENDS = 1024;
+  struct Route {
+    std::mutex mutex;
+    int shard = NO_SHARD;
+    bool authenticated = false;
+    std::vector<std::shared_ptr<OutgoingMsg>> pending;
+  };
+  // Only used with more than one shard. The map itself is immutable after construction: it contains every node in the
+  // configuration, so senders look up a route without locking the map.
+  std::unordered_map<NodeNum, Route> routes_;
+
   // Diagnostics
   std::shared_ptr<TlsStatus> status_;
   Recorders histograms_;
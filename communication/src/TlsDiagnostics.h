@@ -113,6 +113,8 @@ struct Recorders {
       : write_queue_size_in_bytes(
             MAKE_SHARED_RECORDER("write_queue_size_in_bytes", 1, max_queue_size_in_bytes, 3, Unit::BYTES)),
         sent_msg_size(MAKE_SHARED_RECORDER("sent_msg_size", 1, max_msg_size, 3, Unit::BYTES)),
+        coalesced_write_bytes(
+            MAKE_SHARED_RECORDER("coalesced_write_bytes", 1, max_queue_size_in_bytes, 3, Unit::BYTES)),
         received_msg_size(MAKE_SHARED_RECORDER("received_msg_size", 1, max_msg_size, 3, Unit::BYTES)) {
     auto& registrar = concord::diagnostics::RegistrarSingleton::getInstance();
     registrar.perf.registerComponent("tls" + selfId,
@@ -125,6 +127,8 @@ struct Recorders {
                                       send_post_to_mgr,
                                       send_post_to_conn,
                                       async_write,
+                                      coalesced_write_msgs,
+                                      coalesced_write_bytes,
                                       async_read_header_partial,
                                       async_read_header_full,
                                       async_read_msg,
@@ -133,6 +137,8 @@ struct Recorders {
 
   std::shared_ptr<Recorder> write_queue_size_in_bytes;
   std::shared_ptr<Recorder> sent_msg_size;
+  // The total size of the messages sent by a single (coalesced) write
+  std::shared_ptr<Recorder> coalesced_write_bytes;
   std::shared_ptr<Recorder> received_msg_size;
   DEFINE_SHARED_RECORDER(write_queue_len, 1, MAX_QUEUE_LENGTH, 3, Unit::COUNT);
   DEFINE_SHARED_RECORDER(send_time_in_queue, 1, MAX_US, 3, Unit::MICROSECONDS);
@@ -140,10 +146,30 @@ struct Recorders {
   DEFINE_SHARED_RECORDER(send_post_to_mgr, 1, MAX_US, 3, Unit::MICROSECONDS);
   DEFINE_SHARED_RECORDER(send_post_to_conn, 1, MAX_US, 3, Unit::MICROSECONDS);
   DEFINE_SHARED_RECORDER(async_write, 1, MAX_US, 3, Unit::MICROSECONDS);
+  // The number of messages sent by a single (coalesced) write
+  DEFINE_SHARED_RECORDER(coalesced_write_msgs, 1, MAX_QUEUE_LENGTH, 3, Unit::COUNT);
   DEFINE_SHARED_RECORDER(async_read_header_full, 1, MAX_US, 3, Unit::MICROSECONDS);
   DEFINE_SHARED_RECORDER(async_read_header_partial, 1, MAX_US, 3, Unit::MICROSECONDS);
   DEFINE_SHARED_RECORDER(async_read_msg, 1, MAX_US, 3, Unit::MICROSECONDS);
   DEFINE_SHARED_RECORDER(on_connection_authenticated, 1, MAX_US, 3, Unit::MICROSECONDS);
 };
 
+// Histogram Recorders of a single io_context shard of the connection manager.
+struct ShardRecorders {
+  using Unit = concord::diagnostics::Unit;
+
+  ShardRecorders(const std::string& selfId, size_t shard) {
+    auto& registrar = concord::diagnostics::RegistrarSingleton::getInstance();
+    const auto component = "tls" + selfId + "_shard" + std::to_string(shard);
+    if (!registrar.perf.isRegisteredComponent(component)) {
+      registrar.perf.registerComponent(component, {send_queue_depth, send_handler_latency});
+    }
+  }
+
+  // The number of sends posted to the shard and not yet handled, sampled on every post
+  DEFINE_SHARED_RECORDER(send_queue_depth, 1, Recorders::MAX_QUEUE_LENGTH, 3, Unit::COUNT);
+  // The time from posting a send to the shard until it is handed to the connection
+  DEFINE_SHARED_RECORDER(send_handler_latency, 1, Recorders::MAX_US, 3, Unit::MICROSECONDS);
+};
+
 }  // namespace bft::communication
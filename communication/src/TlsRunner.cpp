@@ -9,6 +9,9 @@
 // terms. Your use of these subcomponents is subject to the terms and conditions of the
 // subcomponent's license, as noted in the LICENSE file.
 
+#include <pthread.h>
+#include <algorithm>
+
 #include "assertUtils.hpp"
 #include "TlsRunner.h"
 
@@ -17,7 +20,29 @@ namespace bft::communication::tls {
 Runner::Runner(const TlsTcpConfig& config, const size_t num_threads)
     : logger_(logging::getLogger("concord-bft.tls.runner")),
       num_threads_(num_threads),
-      connectionManager_(config, io_context_) {}
+      pin_to_cores_(config.pinIoShardsToCores_),
+      io_contexts_(createIoContexts(std::max<size_t>(config.numOfIoShards_, 1))),
+      connectionManager_(config, io_contexts_) {}
+
+std::vector<std::unique_ptr<asio::io_context>> Runner::createIoContexts(size_t num_shards) {
+  std::vector<std::unique_ptr<asio::io_context>> io_contexts;
+  for (size_t i = 0; i < num_shards; i++) {
+    // A shard is served by a single thread
+    io_contexts.push_back(num_shards > 1 ? std::make_unique<asio::io_context>(1)
+                                         : std::make_unique<asio::io_context>());
+  }
+  return io_contexts;
+}
+
+void Runner::pinToCore(std::thread& thread, size_t shard) {
+  const auto num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(shard % num_cores, &cpuset);
+  if (auto rc = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset); rc != 0) {
+    LOG_WARN(logger_, "Failed to pin TLS shard thread to a core" << KVLOG(shard, rc));
+  }
+}
 
 bool Runner::isRunning() const {
   std::lock_guard<std::mutex> lock(start_stop_mutex_);
@@ -30,15 +55,26 @@ void Runner::start() {
     LOG_INFO(logger_, "TLS Runner has been already started; ignore operation");
     return;
   }
-  LOG_INFO(logger_, "Starting TLS Runner");
-  io_context_.restart();
+  LOG_INFO(logger_, "Starting TLS Runner" << KVLOG(io_contexts_.size()));
+  for (auto& io_context : io_contexts_) io_context->restart();
 
   // Give the io_context work to do.
   connectionManager_.start();
 
-  // Run the io_context in the thread pool
-  for (std::size_t i = 0; i < num_threads_; i++) {
-    io_threads_.emplace_back([this]() { io_context_.run(); });
+  if (io_contexts_.size() == 1) {
+    // Run the io_context in the thread pool
+    for (std::size_t i = 0; i < num_threads_; i++) {
+      io_threads_.emplace_back([this]() { io_contexts_.front()->run(); });
+    }
+    return;
+  }
+  for (std::size_t shard = 0; shard < io_contexts_.size(); shard++) {
+    // Keep the shards without connections running
+    io_threads_.emplace_back([io_context = io_contexts_[shard].get()]() {
+      auto work = asio::make_work_guard(*io_context);
+      io_context->run();
+    });
+    if (pin_to_cores_) pinToCore(io_threads_.back(), shard);
   }
 }
 
@@ -46,7 +82,7 @@ void Runner::stop() {
   std::lock_guard<std::mutex> lock(start_stop_mutex_);
   if (!io_threads_.empty()) {
     // We want to stop all the thread from processing data before we clean up the connection managers.
-    io_context_.stop();
+    for (auto& io_context : io_contexts_) io_context->stop();
     for (auto& t : io_threads_) {
       t.join();
     }
@@ -10,7 +10,9 @@
 // subcomponent's license, as noted in the LICENSE file.
 
 #include <asio.hpp>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #include "communication/CommDefs.hpp"
 #include "Logger.hpp"
@@ -20,7 +22,12 @@
 
 namespace bft::communication::tls {
 
-// The runner creates an `asio::io_context` and a pool of threads to serve that context.
+// The runner creates the `asio::io_context`s used by the connection manager and its connections, and the threads
+// serving them.
+//
+// With a single io_context (the default), a pool of `num_threads` threads serves it. With TlsTcpConfig::numOfIoShards_
+// greater than 1, connections are spread over that many io_contexts (shards), each one served by its own thread,
+// optionally pinned to a core. The first shard also serves the connection manager itself.
 class Runner {
  public:
   Runner(const TlsTcpConfig& config, const size_t num_threads);
@@ -36,13 +43,17 @@ class Runner {
   void send(std::set<NodeNum> dests, std::shared_ptr<tls::OutgoingMsg> msg) { connectionManager_.send(dests, msg); }
 
  private:
+  static std::vector<std::unique_ptr<asio::io_context>> createIoContexts(size_t num_shards);
+  void pinToCore(std::thread& thread, size_t shard);
+
   logging::Logger logger_;
   size_t num_threads_;
+  const bool pin_to_cores_;
   // Protects io_threads_ whose emptiness is used as the condition of whether a thread is started or stopped.
   mutable std::mutex start_stop_mutex_;
   // A pool of threads from which completion handlers may be invoked.
   std::vector<std::thread> io_threads_;
-  asio::io_context io_context_;
+  std::vector<std::unique_ptr<asio::io_context>> io_contexts_;
   ConnectionManager connectionManager_;
 };
 
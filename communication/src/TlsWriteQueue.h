@@ -14,10 +14,12 @@
 
 #include <arpa/inet.h>
 #include <bits/stdint-uintn.h>
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstring>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -33,19 +35,26 @@ namespace bft::communication::tls {
 // The number is very large right now so as not to affect current setups. In the future we will
 // have better admission control.
 static constexpr size_t MAX_QUEUE_SIZE_IN_BYTES = 1024 * 1024 * 1024;  // 1 GB
+// An outgoing message keeps its header apart from the payload, so that the payload moved in by the caller is never
+// copied: the connection writes both with a single gathered write. The payload is immutable and refcounted, so a
+// broadcast shares the same buffer between all the destination connections.
 struct OutgoingMsg {
   OutgoingMsg(std::vector<uint8_t>&& raw_msg, NodeNum endpointNum)
-      : msg(raw_msg.size() + MSG_HEADER_SIZE), send_time(std::chrono::steady_clock::now()) {
-    uint32_t msg_size = htonl(static_cast<uint32_t>(raw_msg.size()));
+      : OutgoingMsg(std::make_shared<const std::vector<uint8_t>>(std::move(raw_msg)), endpointNum) {}
+  OutgoingMsg(std::shared_ptr<const std::vector<uint8_t>> raw_msg, NodeNum endpointNum)
+      : payload(std::move(raw_msg)), send_time(std::chrono::steady_clock::now()) {
+    uint32_t msg_size = htonl(static_cast<uint32_t>(payload->size()));
     auto const endpoint = concordUtils::hostToNet<NodeNum>(endpointNum);
-    const Header header{msg_size, endpoint};
-    std::memcpy(msg.data(), &header, MSG_HEADER_SIZE);
-    std::memcpy(msg.data() + MSG_HEADER_SIZE, raw_msg.data(), raw_msg.size());
+    const Header hdr{msg_size, endpoint};
+    std::memcpy(header.data(), &hdr, MSG_HEADER_SIZE);
   }
-  std::vector<uint8_t> msg;
+  std::array<uint8_t, MSG_HEADER_SIZE> header;
+  std::shared_ptr<const std::vector<uint8_t>> payload;
   std::chrono::steady_clock::time_point send_time;
 
-  size_t payload_size() { return msg.size() - MSG_HEADER_SIZE; }
+  size_t payload_size() const { return payload->size(); }
+  // The size of the message on the wire
+  size_t size() const { return MSG_HEADER_SIZE + payload->size(); }
 };
 
 class WriteQueue {
@@ -60,21 +69,26 @@ class WriteQueue {
       LOG_WARN(logger_, "Queue full. Dropping message." << KVLOG(destination, msg->payload_size()));
       return std::nullopt;
     }
-    queued_size_in_bytes_ += msg->msg.size();
+    queued_size_in_bytes_ += msg->size();
     msgs_.push_back(std::move(msg));
     return msgs_.size();
   }
 
-  std::shared_ptr<OutgoingMsg> pop() {
+  // Pop the messages at the front of the queue, up to max_msgs messages and max_bytes bytes in total. The first message
+  // is always popped, regardless of its size.
+  std::vector<std::shared_ptr<OutgoingMsg>> popBatch(size_t max_msgs, size_t max_bytes) {
     recorders_.write_queue_len->recordAtomic(msgs_.size());
     recorders_.write_queue_size_in_bytes->recordAtomic(queued_size_in_bytes_);
-    if (msgs_.empty()) {
-      return nullptr;
+    std::vector<std::shared_ptr<OutgoingMsg>> batch;
+    size_t batch_size_in_bytes = 0;
+    while (!msgs_.empty() && (batch.empty() || (batch.size() < max_msgs &&
+                                                batch_size_in_bytes + msgs_.front()->size() <= max_bytes))) {
+      batch_size_in_bytes += msgs_.front()->size();
+      queued_size_in_bytes_ -= msgs_.front()->size();
+      batch.push_back(std::move(msgs_.front()));
+      msgs_.pop_front();
     }
-    auto msg = std::move(msgs_.front());
-    msgs_.pop_front();
-    queued_size_in_bytes_ -= msg->msg.size();
-    return msg;
+    return batch;
   }
 
   void clear() {
@@ -0,0 +1,197 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the sub-component's license, as noted in the LICENSE
+// file.
+
+#include "communication/CommDefs.hpp"
+#include "communication/CommFactory.hpp"
+#include "src/SharedMemoryRing.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace bft::communication;
+using namespace std;
+
+namespace {
+
+const uint32_t bufLength = 64 * 1024;
+
+class CollectingReceiver : public IReceiver {
+ public:
+  void onNewMessage(const NodeNum sourceNode,
+                    const char* const message,
+                    const size_t messageLength,
+                    NodeNum endpointNum) override {
+    lock_guard<mutex> lock(lock_);
+    msgs_.push_back({sourceNode, string(message, messageLength), endpointNum});
+    cond_.notify_all();
+  }
+  void onConnectionStatusChanged(const NodeNum node, const ConnectionStatus newStatus) override {}
+
+  struct Msg {
+    NodeNum source;
+    string data;
+    NodeNum endpoint;
+  };
+
+  vector<Msg> waitFor(size_t numOfMsgs) {
+    unique_lock<mutex> lock(lock_);
+    cond_.wait_for(lock, chrono::seconds(10), [&]() { return msgs_.size() >= numOfMsgs; });
+    return msgs_;
+  }
+
+ private:
+  mutex lock_;
+  condition_variable cond_;
+  vector<Msg> msgs_;
+};
+
+vector<uint8_t> toBytes(const string& s) { return vector<uint8_t>(s.begin(), s.end()); }
+
+TEST(shared_memory_ring, wraps_around_and_rejects_when_full) {
+  const uint64_t capacity = 256;
+  auto segment = vector<uint8_t>(shm::Ring::segmentSize(capacity) + alignof(shm::Ring::RingHeader));
+  auto mem = static_cast<void*>(segment.data());
+  auto space = segment.size();
+  ASSERT_NE(nullptr, align(alignof(shm::Ring::RingHeader), shm::Ring::segmentSize(capacity), mem, space));
+  shm::Ring::init(mem, capacity);
+  shm::Ring ring{mem, shm::Ring::segmentSize(capacity)};
+  ASSERT_THROW(shm::Ring(mem, shm::Ring::segmentSize(capacity) + 1), std::runtime_error);
+
+  const auto msg = string(40, 'x');
+  auto push = [&](char c, NodeNum endpoint) {
+    auto data = string(msg.size(), c);
+    return ring.tryPush(reinterpret_cast<const uint8_t*>(data.data()), data.size(), endpoint);
+  };
+  // Every record takes 64 bytes
+  for (auto i = 0; i < 4; i++) ASSERT_TRUE(push('a' + i, i));
+  ASSERT_FALSE(push('e', 4));
+
+  auto consumed = string{};
+  auto collect = [&](const uint8_t* data, uint32_t size, NodeNum endpoint) {
+    ASSERT_EQ(msg.size(), size);
+    ASSERT_EQ(static_cast<NodeNum>(data[0] - 'a'), endpoint);
+    consumed += static_cast<char>(data[0]);
+  };
+  ASSERT_EQ(4u, ring.consume(collect, 10));
+  ASSERT_EQ("abcd", consumed);
+  ASSERT_TRUE(ring.empty());
+
+  // Leave the tail in the middle of the ring, 64 bytes before its end
+  for (auto i = 4; i < 7; i++) ASSERT_TRUE(push('a' + i, i));
+  auto large = string(100, 'h');
+  // Takes 128 bytes, that neither fit before the end of the ring nor in the free space at its start
+  ASSERT_FALSE(ring.tryPush(reinterpret_cast<const uint8_t*>(large.data()), large.size(), 7));
+  ASSERT_EQ(2u, ring.consume(collect, 2));
+  ASSERT_EQ("abcdef", consumed);
+  // The first 128 bytes of the ring are free now
+
+  // Pads the last 64 bytes with a wrap record, and is written at the start of the ring
+  ASSERT_TRUE(ring.tryPush(reinterpret_cast<const uint8_t*>(large.data()), large.size(), 7));
+  ASSERT_FALSE(push('i', 8));
+  auto records = vector<pair<uint32_t, NodeNum>>{};
+  auto contents = string{};
+  ASSERT_EQ(2u, ring.consume(
+                    [&](const uint8_t* data, uint32_t size, NodeNum endpoint) {
+                      records.emplace_back(size, endpoint);
+                      contents += string(reinterpret_cast<const char*>(data), size);
+                    },
+                    10));
+  ASSERT_EQ((vector<pair<uint32_t, NodeNum>>{{40, 6}, {100, 7}}), records);
+  ASSERT_EQ(string(40, 'g') + large, contents);
+  ASSERT_TRUE(ring.empty());
+
+  // The space of the wrap record is freed as well
+  for (auto i = 0; i < 4; i++) ASSERT_TRUE(push('a' + i, i));
+  ASSERT_FALSE(ring.tryPush(reinterpret_cast<const uint8_t*>(large.data()), capacity, 0));
+}
+
+class shared_memory_comm : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Keep concurrent runs of the test apart
+    const auto prefix = "shm-comm-test-" + to_string(getpid());
+    for (NodeNum i = 0; i < 2; i++) {
+      auto config = SharedMemoryConfig(bufLength, NodeMap{}, i, {0, 1});
+      config.sharedMemoryPrefix_ = prefix;
+      config.ringCapacity_ = 1024 * 1024;
+      comms_[i].reset(CommFactory::create(config));
+      ASSERT_NE(nullptr, comms_[i]);
+      comms_[i]->setReceiver(i, &receivers_[i]);
+      ASSERT_EQ(0, comms_[i]->start());
+    }
+    for (NodeNum i = 0; i < 2; i++) {
+      const auto peer = 1 - i;
+      for (auto j = 0; j < 100 && comms_[i]->getCurrentConnectionStatus(peer) != ConnectionStatus::Connected; j++) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+      }
+      ASSERT_EQ(ConnectionStatus::Connected, comms_[i]->getCurrentConnectionStatus(peer));
+    }
+  }
+
+  void TearDown() override {
+    for (auto& comm : comms_) {
+      if (comm) comm->stop();
+    }
+  }
+
+  unique_ptr<ICommunication> comms_[2];
+  CollectingReceiver receivers_[2];
+};
+
+TEST_F(shared_memory_comm, messages_are_delivered_in_order) {
+  const auto numOfMsgs = 10000u;
+  for (auto i = 0u; i < numOfMsgs; i++) {
+    // The ring may be full for a moment
+    while (comms_[0]->send(1, toBytes(to_string(i)), i) != 0) this_thread::yield();
+  }
+  auto msgs = receivers_[1].waitFor(numOfMsgs);
+  ASSERT_EQ(numOfMsgs, msgs.size());
+  for (auto i = 0u; i < numOfMsgs; i++) {
+    ASSERT_EQ(0u, msgs[i].source);
+    ASSERT_EQ(to_string(i), msgs[i].data);
+    ASSERT_EQ(i, msgs[i].endpoint);
+  }
+
+  ASSERT_TRUE(comms_[1]->send(set<NodeNum>{0}, toBytes("reply"), MAX_ENDPOINT_NUM).empty());
+  msgs = receivers_[0].waitFor(1);
+  ASSERT_EQ(1u, msgs.size());
+  ASSERT_EQ("reply", msgs[0].data);
+}
+
+TEST_F(shared_memory_comm, send_to_unknown_peer_fails) {
+  ASSERT_EQ(ConnectionStatus::Unknown, comms_[0]->getCurrentConnectionStatus(2));
+  ASSERT_NE(0, comms_[0]->send(2, toBytes("msg"), MAX_ENDPOINT_NUM));
+  ASSERT_EQ(set<NodeNum>{2}, comms_[0]->send(set<NodeNum>{1, 2}, toBytes("msg"), MAX_ENDPOINT_NUM));
+  ASSERT_NE(0, comms_[0]->send(1, vector<uint8_t>(bufLength + 1), MAX_ENDPOINT_NUM));
+}
+
+TEST_F(shared_memory_comm, reconnects_after_peer_restart) {
+  ASSERT_EQ(0, comms_[1]->stop());
+  ASSERT_EQ(0, comms_[1]->start());
+  for (auto j = 0; j < 100 && comms_[0]->getCurrentConnectionStatus(1) != ConnectionStatus::Connected; j++) {
+    this_thread::sleep_for(chrono::milliseconds(100));
+  }
+  // The old ring may still be mapped until the disconnection is detected - send until the new one is used
+  for (auto j = 0; j < 100 && receivers_[1].waitFor(0).empty(); j++) {
+    comms_[0]->send(1, toBytes("after restart"), MAX_ENDPOINT_NUM);
+    this_thread::sleep_for(chrono::milliseconds(100));
+  }
+  auto msgs = receivers_[1].waitFor(1);
+  ASSERT_FALSE(msgs.empty());
+  ASSERT_EQ("after restart", msgs.back().data);
+}
+
+}  // namespace
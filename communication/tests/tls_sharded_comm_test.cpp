@@ -0,0 +1,131 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "communication/CommDefs.hpp"
+#include "communication/CommFactory.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace bft::communication;
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Created by create_tls_certs.sh at build time
+const string certRootPath = TLS_CERTS_DIR;
+const string host = "127.0.0.1";
+const uint16_t basePort = 3910;
+const uint32_t bufLength = 64 * 1024;
+// StateControl is a process wide lock that makes an acceptor give up when taken by another node's acceptor, so only
+// one of the nodes in this process accepts connections
+const NodeNum numNodes = 2;
+const uint32_t msgsPerPeer = 2000;
+
+// Records, per source, whether the messages arrived in the order they were sent
+class OrderCheckingReceiver : public IReceiver {
+ public:
+  OrderCheckingReceiver() : next_(numNodes, 0) {}
+
+  void onNewMessage(NodeNum sourceNode, const char* const message, size_t messageLength, NodeNum) override {
+    uint32_t seq = 0;
+    ASSERT_EQ(sizeof(seq), messageLength);
+    std::memcpy(&seq, message, sizeof(seq));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (next_[sourceNode]++ != seq) out_of_order_ = true;
+    if (++received_ == msgsPerPeer * (numNodes - 1)) all_received_.notify_all();
+  }
+  void onConnectionStatusChanged(const NodeNum, const ConnectionStatus) override {}
+
+  bool waitForAll(chrono::seconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return all_received_.wait_for(lock, timeout, [this]() { return received_ == msgsPerPeer * (numNodes - 1); });
+  }
+  bool outOfOrder() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return out_of_order_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::condition_variable all_received_;
+  std::vector<uint32_t> next_;
+  uint32_t received_ = 0;
+  bool out_of_order_ = false;
+};
+
+std::vector<uint8_t> newMsg(uint32_t seq) {
+  std::vector<uint8_t> msg(sizeof(seq));
+  std::memcpy(msg.data(), &seq, sizeof(seq));
+  return msg;
+}
+
+TEST(tls_sharded_comm_test, messages_are_delivered_in_order_over_multiple_shards) {
+  NodeMap nodes;
+  for (NodeNum i = 0; i < numNodes; i++) nodes[i] = NodeInfo{host, static_cast<uint16_t>(basePort + i), true};
+  std::vector<std::unique_ptr<ICommunication>> comms;
+  std::vector<std::unique_ptr<OrderCheckingReceiver>> receivers;
+  for (NodeNum i = 0; i < numNodes; i++) {
+    auto config = TlsTcpConfig(host,
+                               static_cast<uint16_t>(basePort + i),
+                               bufLength,
+                               nodes,
+                               numNodes - 1,
+                               i,
+                               certRootPath,
+                               "TLS_AES_256_GCM_SHA384",
+                               false);
+    // More shards than connections, so that some shards are left without connections
+    config.numOfIoShards_ = 4;
+    comms.emplace_back(CommFactory::create(config));
+    receivers.push_back(std::make_unique<OrderCheckingReceiver>());
+    comms.back()->setReceiver(i, receivers.back().get());
+    ASSERT_EQ(0, comms.back()->start());
+  }
+
+  // Start sending without waiting for the connections: the messages sent before a connection is added to its shard
+  // are queued, and must not be reordered or dropped.
+  std::vector<std::thread> senders;
+  for (NodeNum i = 0; i < numNodes; i++) {
+    senders.emplace_back([&comms, i]() {
+      std::set<NodeNum> peers;
+      for (NodeNum j = 0; j < numNodes; j++) {
+        if (j != i) peers.insert(j);
+      }
+      for (uint32_t seq = 0; seq < msgsPerPeer; seq++) {
+        // Every other message is broadcast
+        if (seq % 2) {
+          comms[i]->send(peers, newMsg(seq), i);
+        } else {
+          for (auto peer : peers) comms[i]->send(peer, newMsg(seq), i);
+        }
+        // Give the connections time to be established once the first messages are queued
+        if (seq == 10) std::this_thread::sleep_for(3s);
+      }
+    });
+  }
+  for (auto& sender : senders) sender.join();
+
+  for (NodeNum i = 0; i < numNodes; i++) {
+    EXPECT_TRUE(receivers[i]->waitForAll(30s)) << "node " << i;
+    EXPECT_FALSE(receivers[i]->outOfOrder()) << "node " << i;
+  }
+  for (auto& comm : comms) comm->stop();
+}
+
+}  // namespace
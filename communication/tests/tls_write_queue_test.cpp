@@ -0,0 +1,102 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "src/TlsWriteQueue.h"
+#include <gtest/gtest.h>
+
+using namespace bft::communication;
+using namespace bft::communication::tls;
+using namespace std;
+
+namespace {
+
+constexpr size_t kMaxMsgSize = 64 * 1024;
+
+class tls_write_queue_test : public ::testing::Test {
+ protected:
+  // Push a message whose size on the wire is MSG_HEADER_SIZE + payload_size
+  void push(size_t payload_size) {
+    ASSERT_TRUE(queue_.push(make_shared<OutgoingMsg>(vector<uint8_t>(payload_size, 'a'), 0)).has_value());
+    pushed_.push_back(payload_size);
+  }
+  // Check that the batch holds the next messages, in the order they were pushed
+  void expectNext(const vector<shared_ptr<OutgoingMsg>>& batch) {
+    for (const auto& msg : batch) {
+      ASSERT_FALSE(pushed_.empty());
+      ASSERT_EQ(pushed_.front(), msg->payload_size());
+      pushed_.pop_front();
+    }
+  }
+
+  // The recorders register a diagnostics component, which may only be done once
+  static Recorders& recorders() {
+    static Recorders recorders{"tls_write_queue_test", kMaxMsgSize, MAX_QUEUE_SIZE_IN_BYTES};
+    return recorders;
+  }
+
+  WriteQueue queue_{recorders()};
+  deque<size_t> pushed_;
+};
+
+TEST_F(tls_write_queue_test, empty_queue_pops_empty_batch) {
+  ASSERT_TRUE(queue_.popBatch(10, kMaxMsgSize).empty());
+  ASSERT_EQ(0u, queue_.sizeInBytes());
+}
+
+TEST_F(tls_write_queue_test, batch_is_bounded_by_number_of_msgs) {
+  for (auto i = 1u; i <= 5; ++i) push(i);
+  auto batch = queue_.popBatch(3, kMaxMsgSize);
+  ASSERT_EQ(3u, batch.size());
+  expectNext(batch);
+  ASSERT_EQ(2u, queue_.size());
+  ASSERT_EQ(4 + 5 + 2 * MSG_HEADER_SIZE, queue_.sizeInBytes());
+
+  // A limit of one message pops the messages one by one
+  batch = queue_.popBatch(1, kMaxMsgSize);
+  ASSERT_EQ(1u, batch.size());
+  expectNext(batch);
+  batch = queue_.popBatch(3, kMaxMsgSize);
+  ASSERT_EQ(1u, batch.size());
+  expectNext(batch);
+  ASSERT_EQ(0u, queue_.size());
+  ASSERT_EQ(0u, queue_.sizeInBytes());
+}
+
+TEST_F(tls_write_queue_test, batch_is_bounded_by_bytes) {
+  for (auto i = 0u; i < 4; ++i) push(100);
+  const auto msg_size = 100 + MSG_HEADER_SIZE;
+  // The limit falls in the middle of the third message, which is left in the queue
+  auto batch = queue_.popBatch(10, 2 * msg_size + msg_size / 2);
+  ASSERT_EQ(2u, batch.size());
+  expectNext(batch);
+  // The limit is inclusive
+  batch = queue_.popBatch(10, 2 * msg_size);
+  ASSERT_EQ(2u, batch.size());
+  expectNext(batch);
+  ASSERT_EQ(0u, queue_.sizeInBytes());
+}
+
+TEST_F(tls_write_queue_test, oversized_first_msg_is_popped_alone) {
+  push(1000);
+  push(10);
+  push(10);
+  // The first message exceeds the bytes limit, but is popped anyway, and without the messages behind it
+  auto batch = queue_.popBatch(10, 100);
+  ASSERT_EQ(1u, batch.size());
+  expectNext(batch);
+  batch = queue_.popBatch(10, 100);
+  ASSERT_EQ(2u, batch.size());
+  expectNext(batch);
+  ASSERT_EQ(0u, queue_.size());
+  ASSERT_EQ(0u, queue_.sizeInBytes());
+}
+
+}  // namespace
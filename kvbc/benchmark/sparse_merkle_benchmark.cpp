@@ -25,6 +25,7 @@
 #include "sha_hash.hpp"
 #include "sparse_merkle/base_types.h"
 #include "sparse_merkle/internal_node.h"
+#include "thread_pool.hpp"
 
 #include <cstddef>
 #include <cstdint>
@@ -300,10 +301,17 @@ struct Blockchain : benchmark::Fixture {
     keyCount = state.range(0);
     keySize = state.range(1);
     valueSize = state.range(2);
+    // Merkle tree update threads, if given (0 updates the tree serially)
+    const auto threads = state.range(3);
 
     auto db = std::make_shared<Client>();
     db->init();
-    adapter = std::make_unique<DBAdapter>(db);
+    auto threadPool = threads > 0 ? std::make_shared<ThreadPool>(static_cast<unsigned int>(threads)) : nullptr;
+    adapter = std::make_unique<DBAdapter>(db,
+                                          true,
+                                          DBAdapter::NonProvableKeySet{},
+                                          std::make_shared<concord::performance::PerformanceManager>(),
+                                          threadPool);
 
     for (auto i = 0ull; i < blockCount; ++i) {
       adapter->addBlock(createBlockUpdates(keyCount, keySize, valueSize));
@@ -407,7 +415,12 @@ BENCHMARK_DEFINE_F(Blockchain, getRawBlock)(benchmark::State &state) {
 //  - key count
 //  - key size
 //  - value size
-const auto blockchainRanges = std::vector<std::pair<std::int64_t, std::int64_t>>{{16, 256}, {4, 512}, {1024, 4 * 1024}};
+//  - merkle tree update threads
+const auto blockchainRanges =
+    std::vector<std::pair<std::int64_t, std::int64_t>>{{16, 256}, {4, 512}, {1024, 4 * 1024}, {0, 0}};
+// Adding blocks with an increasing number of merkle tree update threads, for measuring scaling.
+const auto addBlockRanges =
+    std::vector<std::pair<std::int64_t, std::int64_t>>{{16, 1024}, {4, 512}, {1024, 4 * 1024}, {0, 8}};
 constexpr auto blockchainRangeMultiplier = 2;
 
 constexpr auto shaRangeStart = 8;
@@ -436,7 +449,7 @@ BENCHMARK(calculateSha2)->RangeMultiplier(blockchainRangeMultiplier)->Range(shaR
 BENCHMARK(calculateSha3)->RangeMultiplier(blockchainRangeMultiplier)->Range(shaRangeStart, shaRangeEnd);
 BENCHMARK(stdAsync);
 BENCHMARK(handoff);
-BENCHMARK_REGISTER_F(Blockchain, addBlock)->RangeMultiplier(blockchainRangeMultiplier)->Ranges(blockchainRanges);
+BENCHMARK_REGISTER_F(Blockchain, addBlock)->RangeMultiplier(blockchainRangeMultiplier)->Ranges(addBlockRanges);
 BENCHMARK_REGISTER_F(Blockchain, getInternalFromCache)
     ->RangeMultiplier(blockchainRangeMultiplier)
     ->Ranges(blockchainRanges);
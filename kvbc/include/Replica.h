@@ -131,6 +131,7 @@ class Replica : public IReplica,
   // the main blockchain
   uint64_t getLastBlockNum() const override final;
   size_t postProcessUntilBlockId(uint64_t max_block_id) override final;
+  void flushBlocks() override final;
   /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
   bool getBlockFromObjectStore(uint64_t blockId,
@@ -0,0 +1,111 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+
+#include "kv_types.hpp"
+#include "Digest.hpp"
+#include "thread_pool.hpp"
+
+namespace concord::kvbc {
+
+// Reads the consecutive blocks [from, until] of a state transfer chain, in order, for linking them to the blockchain.
+// If a thread pool is given, up to `depth` blocks are read and hashed ahead, in parallel, on the pool. A block's
+// digest is the parent digest of the next block, so the blockchain can link a run of blocks without waiting for each
+// block to be hashed after the previous one was added. Without a thread pool, blocks are read on next() and are not
+// hashed.
+template <typename BlockT>
+class BlockDigestPipeline {
+ public:
+  struct Item {
+    BlockT block;
+    // The digest of the block, if hashed.
+    std::optional<concord::util::digest::BlockDigest> digest;
+  };
+  // Returns the block or std::nullopt if it doesn't exist. Called concurrently by the pool threads.
+  using Reader = std::function<std::optional<BlockT>(BlockId)>;
+  using Hasher = std::function<concord::util::digest::BlockDigest(BlockId, const BlockT&)>;
+
+  BlockDigestPipeline(
+      util::ThreadPool* pool, std::size_t depth, BlockId from, BlockId until, Reader reader, Hasher hasher)
+      : pool_{pool},
+        depth_{pool ? std::max<std::size_t>(depth, 1) : 0},
+        next_id_{from},
+        until_{until},
+        reader_{std::move(reader)},
+        hasher_{std::move(hasher)} {
+    schedule();
+  }
+
+  // The pool threads use reader_ and hasher_.
+  ~BlockDigestPipeline() {
+    for (auto& item : pending_) item.wait();
+  }
+
+  BlockDigestPipeline(const BlockDigestPipeline&) = delete;
+  BlockDigestPipeline& operator=(const BlockDigestPipeline&) = delete;
+
+  // Returns the next block, or std::nullopt if it is missing or the range is exhausted.
+  std::optional<Item> next() {
+    if (!pool_) {
+      if (next_id_ > until_) return std::nullopt;
+      auto block = reader_(next_id_++);
+      if (!block) return std::nullopt;
+      return Item{std::move(*block), std::nullopt};
+    }
+    if (pending_.empty()) return std::nullopt;
+    auto item = pending_.front().get();
+    pending_.pop_front();
+    if (item) schedule();
+    return item;
+  }
+
+ private:
+  void schedule() {
+    while (pending_.size() < depth_ && next_id_ <= until_) {
+      pending_.push_back(pool_->async(
+          [this](BlockId id) -> std::optional<Item> {
+            auto block = reader_(id);
+            if (!block) return std::nullopt;
+            auto digest = hasher_(id, *block);
+            return Item{std::move(*block), digest};
+          },
+          next_id_++));
+    }
+  }
+
+  util::ThreadPool* const pool_;
+  const std::size_t depth_;
+  BlockId next_id_;
+  const BlockId until_;
+  const Reader reader_;
+  const Hasher hasher_;
+  std::deque<std::future<std::optional<Item>>> pending_;
+};
+
+// A thread pool for pipelines of the given depth, or nullptr if depth is 0 (blocks are not read ahead).
+inline std::unique_ptr<util::ThreadPool> makeBlockDigestThreadPool(std::size_t depth) {
+  if (depth == 0) return nullptr;
+  const auto hw_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  return std::make_unique<util::ThreadPool>(static_cast<unsigned int>(std::min<std::size_t>(depth, hw_threads)));
+}
+
+}  // namespace concord::kvbc
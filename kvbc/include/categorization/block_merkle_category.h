@@ -34,7 +34,11 @@ namespace concord::kvbc::categorization::detail {
 class BlockMerkleCategory {
  public:
   BlockMerkleCategory() = default;  // Gtest usage only
-  BlockMerkleCategory(const std::shared_ptr<storage::rocksdb::NativeClient>&);
+  // If a `node_cache` is passed, the internal nodes of the merkle tree are read through it.
+  // If a `thread_pool` is passed, large updates of the merkle tree are done in parallel on it.
+  BlockMerkleCategory(const std::shared_ptr<storage::rocksdb::NativeClient>&,
+                      const std::shared_ptr<sparse_merkle::InternalNodeCache>& node_cache = nullptr,
+                      const std::shared_ptr<util::ThreadPool>& thread_pool = nullptr);
 
   // Add the given block updates and return the information that needs to be persisted in the block.
   BlockMerkleOutput add(BlockId block_id, BlockMerkleInput&& update, storage::rocksdb::NativeWriteBatch&);
@@ -15,6 +15,7 @@
 
 #include "updates.h"
 #include "blockchain_misc.hpp"
+#include "block_digest_pipeline.hpp"
 #include "rocksdb/native_client.h"
 #include "blocks.h"
 #include "blockchain.h"
@@ -30,7 +31,9 @@
 #include "bftengine/ReplicaConfig.hpp"
 #include "categorized_kvbc_msgs.cmf.hpp"
 
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -155,10 +158,22 @@ class KeyValueBlockchain {
 
  private:
   BlockId addBlock(CategoryInput&& category_updates, concord::storage::rocksdb::NativeWriteBatch& write_batch);
+  // If parent_digest is given, it is used instead of computing the digest of the previous block.
+  BlockId addBlock(CategoryInput&& category_updates,
+                   concord::storage::rocksdb::NativeWriteBatch& write_batch,
+                   const std::optional<BlockDigest>& parent_digest);
 
   // tries to link the state transfer chain to the main blockchain
   void linkSTChainFrom(BlockId block_id);
-  void writeSTLinkTransaction(const BlockId block_id, RawBlock& block);
+  void writeSTLinkTransaction(const BlockId block_id,
+                              RawBlock& block,
+                              const std::optional<BlockDigest>& parent_digest = std::nullopt);
+  // The blocks [from, until] of the state transfer chain, read and hashed ahead by digest_thread_pool_.
+  BlockDigestPipeline<RawBlock> stChainBlocks(BlockId from, BlockId until) const;
+  // Returns the digest of the previous block in the pipeline if it is the parent digest of `item`.
+  static std::optional<BlockDigest> chainedParentDigest(BlockId block_id,
+                                                        const BlockDigestPipeline<RawBlock>::Item& item,
+                                                        const std::optional<BlockDigest>& prev_digest);
 
   // If a block has the genesis ID key, prune up to it. Rationale is that this will preserve the same order of block
   // deletes relative to block adds on source and destination replicas.
@@ -176,6 +191,8 @@ class KeyValueBlockchain {
   // insert a new category into the categories column family and instantiate it.
   void insertCategoryMapping(const std::string& cat_id, const CATEGORY_TYPE type);
   void addNewCategory(const std::string& cat_id, CATEGORY_TYPE type);
+  // Return a cache for the internal nodes of the merkle tree of a block merkle category, nullptr if it is disabled.
+  std::shared_ptr<sparse_merkle::InternalNodeCache> makeMerkleNodeCache(const std::string& cat_id);
 
   // Return nullptr if the category doesn't exist.
   const Category* getCategoryPtr(const std::string& cat_id) const;
@@ -238,6 +255,16 @@ class KeyValueBlockchain {
                                         ImmutableInput&& updates,
                                         concord::storage::rocksdb::NativeWriteBatch& write_batch);
 
+  // Add the updates of a block to their categories concurrently on category_add_thread_pool_, each category into its
+  // own write batch. The batches are appended to `write_batch` in the order of the categories, as if the categories
+  // were added one after another.
+  void addCategoryUpdatesConcurrently(CategoryInput&& category_updates,
+                                      Block& new_block,
+                                      RawBlockData& last_raw_block,
+                                      concord::storage::rocksdb::NativeWriteBatch& write_batch);
+  // Record the time it took to add the updates of a block to a category.
+  void recordCategoryAdd(const std::string& category_id, std::chrono::steady_clock::duration duration);
+
   void addGenesisBlockKey(Updates& updates) const;
 
   /////////////////////// Members ///////////////////////
@@ -257,6 +284,13 @@ class KeyValueBlockchain {
   util::ThreadPool thread_pool_{1};
   // For concurrent deletion of the categories inside a block.
   util::ThreadPool prunning_thread_pool_{2};
+  // Hashes state transfer blocks ahead while they are linked, nullptr if stLinkDigestPipelineDepth is 0.
+  const std::size_t st_link_digest_pipeline_depth_{bftEngine::ReplicaConfig::instance().stLinkDigestPipelineDepth};
+  std::unique_ptr<util::ThreadPool> digest_thread_pool_{makeBlockDigestThreadPool(st_link_digest_pipeline_depth_)};
+  // Adds the updates of a block to its categories concurrently, nullptr if numOfCategoryAddThreads is 0.
+  std::unique_ptr<util::ThreadPool> category_add_thread_pool_;
+  // Shared by the merkle trees of the block merkle categories, nullptr if numOfMerkleUpdateThreads is 0.
+  std::shared_ptr<util::ThreadPool> merkle_update_thread_pool_;
 
   // metrics
   std::shared_ptr<concordMetrics::Aggregator> aggregator_;
@@ -266,9 +300,23 @@ class KeyValueBlockchain {
   concordMetrics::CounterHandle merkle_num_of_deleted_keys_;
 
   concordMetrics::Component add_metrics_comp_;
-  concordMetrics::CounterHandle versioned_num_of_keys_;
-  concordMetrics::CounterHandle immutable_num_of_keys_;
-  concordMetrics::CounterHandle merkle_num_of_keys_;
+  concordMetrics::AtomicCounterHandle versioned_num_of_keys_;
+  concordMetrics::AtomicCounterHandle immutable_num_of_keys_;
+  concordMetrics::AtomicCounterHandle merkle_num_of_keys_;
+
+  // The time it takes to add the updates of a block to a category
+  struct CategoryAddMetrics {
+    CategoryAddMetrics(const std::string& category_id);
+    concordMetrics::Component component;
+    concordMetrics::GaugeHandle last_add_duration_micros;
+    concordMetrics::CounterHandle total_add_duration_micros;
+    concordMetrics::CounterHandle num_of_adds;
+  };
+  // By category, created when a block first updates the category
+  std::map<std::string, std::unique_ptr<CategoryAddMetrics>> category_add_metrics_;
+
+  // The internal node caches of the block merkle categories, for their metrics
+  std::vector<std::shared_ptr<sparse_merkle::InternalNodeCache>> merkle_node_caches_;
 
   std::chrono::seconds dump_delete_metrics_interval_{bftEngine::ReplicaConfig::instance().deleteMetricsDumpInterval};
   std::chrono::seconds last_dump_time_{0};
@@ -296,6 +344,12 @@ class KeyValueBlockchain {
     aggregator_ = aggregator;
     delete_metrics_comp_.SetAggregator(aggregator_);
     add_metrics_comp_.SetAggregator(aggregator_);
+    for (auto& metrics : category_add_metrics_) {
+      metrics.second->component.SetAggregator(aggregator_);
+    }
+    for (auto& cache : merkle_node_caches_) {
+      cache->setAggregator(aggregator_);
+    }
   }
   friend struct KeyValueBlockchain_tester;
 
@@ -13,7 +13,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "db_interfaces.h"
 #include "categorization/base_types.h"
@@ -39,12 +41,27 @@ class KVBCStateSnapshot : public concord::kvbc::IKVBCStateSnapshot {
   //  ...
   //  hN = hash(hN-1 || hash(kN) || vN)
   //
+  // If stateSnapshotHashRangeSize is not 0, the sorted public keys are split into ranges of stateSnapshotHashRangeSize
+  // keys instead. Each range is hashed as above, starting from h0, and the public state hash is:
+  //  hash(r1 || r2 || ... || rM)
+  // where rI is the hash of the I-th range. The hash of an empty public state is hash("") either way. The ranges are
+  // hashed concurrently on numOfStateSnapshotHashThreads threads, which doesn't change the hash.
+  //
   // This method is supposed to be called on DB snapshots only and not on the actual blockchain.
   // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
   void computeAndPersistPublicStateHash(
       BlockId checkpoint_block_id,
       const Converter& value_converter = [](std::string&& s) -> std::string { return std::move(s); }) override final;
 
+  // Computes and persists the public state hash and, in the same iteration, exports the public key values and the hash
+  // to a StateSnapshotFile at `file_path`.
+  //
+  // This method is supposed to be called on DB snapshots only and not on the actual blockchain.
+  // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
+  void exportPublicState(BlockId checkpoint_block_id,
+                         const Converter& value_converter,
+                         const std::string& file_path) override final;
+
   // Returns the public state keys as of the current point in the blockchain's history.
   // Returns std::nullopt if no public keys have been persisted.
   std::optional<concord::kvbc::categorization::PublicStateKeys> getPublicStateKeys() const override final;
@@ -69,8 +86,34 @@ class KVBCStateSnapshot : public concord::kvbc::IKVBCStateSnapshot {
   virtual ~KVBCStateSnapshot() { reader_ = nullptr; }
 
  private:
+  // Return the public state hash. Call `on_key_value` with each public key value before it is hashed, if given.
+  concord::kvbc::categorization::Hash hashPublicState(
+      const Converter& value_converter,
+      const std::function<void(const std::string&, const std::string&)>& on_key_value) const;
+  // Return the hash of the keys in [begin, end), chained as in computeAndPersistPublicStateHash().
+  concord::kvbc::categorization::Hash hashKeyRange(
+      const std::vector<std::string>& keys,
+      std::size_t begin,
+      std::size_t end,
+      const Converter& value_converter,
+      const std::function<void(const std::string&, const std::string&)>& on_key_value) const;
+  // Return the hash of the ranges of `range_size` keys, each one hashed by hashKeyRange(), on `num_threads` threads or
+  // on the calling thread if it is 0. `on_key_value` is called in key order, as ranges are combined.
+  concord::kvbc::categorization::Hash hashKeyRanges(
+      const std::vector<std::string>& keys,
+      std::uint32_t num_threads,
+      std::uint64_t range_size,
+      const Converter& value_converter,
+      const std::function<void(const std::string&, const std::string&)>& on_key_value) const;
+  void persistPublicStateHash(BlockId checkpoint_block_id, const concord::kvbc::categorization::Hash& hash);
+
   bool iteratePublicStateKeyValuesImpl(const std::function<void(std::string&&, std::string&&)>& f,
                                        const std::optional<std::string>& after_key) const;
+  // Iterate over the key values of the keys in [begin, end), reading them in multiGet batches.
+  void iterateKeyValues(const std::vector<std::string>& keys,
+                        std::size_t begin,
+                        std::size_t end,
+                        const std::function<void(std::string&&, std::string&&)>& f) const;
 
  private:
   const concord::kvbc::IReader* reader_{nullptr};
@@ -0,0 +1,132 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the sub-component's license, as noted in the
+// LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "categorization/base_types.h"
+#include "kv_types.hpp"
+
+namespace concord::kvbc::adapter::common::statesnapshot {
+
+// A read-only file of the public state of a state snapshot.
+//
+// The file is exported once, when the snapshot is created, so that streaming and reading the snapshot are served from
+// the memory-mapped file rather than by iterating the RocksDB checkpoint of the snapshot for every request.
+//
+// The key values are sorted by key and stored in LZ4-compressed blocks. A sparse index of the first key of each block
+// locates the only block that can hold a key. The file ends with a fixed-size footer that holds the location of the
+// index, the checkpoint block ID and the public state hash of the snapshot. All integers are big-endian:
+//
+//  file:   block... index footer
+//  block:  LZ4({key size: u32, key, value size: u32, value}...)
+//  index:  {first key size: u32, first key, block offset: u64, compressed block size: u32, block size: u32}...
+//  footer: magic: u64, format version: u32, checkpoint block ID: u64, public state hash: 32 bytes,
+//          number of key values: u64, number of blocks: u64, index offset: u64
+//
+// Values are stored as they are in the blockchain, before the state value conversion.
+//
+// A StateSnapshotFile is immutable and thread safe.
+class StateSnapshotFile {
+ public:
+  // Writes a snapshot file. The file is written to a temporary path and renamed to its path by finish(), so that a
+  // snapshot file is either complete or doesn't exist.
+  class Writer {
+   public:
+    // Blocks are compressed once they reach `block_size` bytes.
+    Writer(const std::string& path, std::size_t block_size);
+    // Remove the temporary file if the writer wasn't finished.
+    ~Writer();
+
+    // Precondition: keys are added in strictly increasing order.
+    void add(const std::string& key, const std::string& value);
+
+    void finish(BlockId checkpoint_block_id, const categorization::Hash& public_state_hash);
+
+   private:
+    void writeBlock();
+    void write(const char* data, std::size_t size);
+
+    const std::string path_;
+    const std::string tmp_path_;
+    const std::size_t block_size_;
+    std::ofstream out_;
+    std::string block_;
+    std::string compressed_block_;
+    std::string first_key_;
+    std::string last_key_;
+    std::string index_;
+    std::uint64_t offset_{0};
+    std::uint64_t num_key_values_{0};
+    std::uint64_t num_blocks_{0};
+    bool finished_{false};
+  };
+
+  // The path of the file exported to the directory of a snapshot.
+  static std::string pathIn(const std::string& snapshot_dir);
+
+  // Throw if the file can't be mapped or is not a valid snapshot file.
+  explicit StateSnapshotFile(const std::string& path);
+  ~StateSnapshotFile();
+
+  StateSnapshotFile(const StateSnapshotFile&) = delete;
+  StateSnapshotFile& operator=(const StateSnapshotFile&) = delete;
+
+  BlockId checkpointBlockId() const { return checkpoint_block_id_; }
+  const categorization::Hash& publicStateHash() const { return public_state_hash_; }
+  std::uint64_t numKeyValues() const { return num_key_values_; }
+
+  std::optional<std::string> get(const std::string& key) const;
+
+  // Same as IKVBCStateSnapshot::iteratePublicStateKeyValues().
+  void iterate(const std::function<void(std::string&&, std::string&&)>& f) const;
+  bool iterate(const std::function<void(std::string&&, std::string&&)>& f, const std::string& after_key) const;
+
+ private:
+  struct BlockHandle {
+    std::string_view first_key;
+    std::uint64_t offset{0};
+    std::uint32_t compressed_size{0};
+    std::uint32_t size{0};
+  };
+
+  // A key value of a decompressed block
+  struct Entry {
+    std::string_view key;
+    std::string_view value;
+  };
+
+  // Return the index of the only block that can hold `key`, std::nullopt if `key` is before the first key.
+  std::optional<std::size_t> blockOf(const std::string& key) const;
+  void readBlock(std::size_t block, std::string& buffer, std::vector<Entry>& entries) const;
+  void iterateFrom(std::size_t block,
+                   std::size_t entry,
+                   const std::function<void(std::string&&, std::string&&)>& f) const;
+
+  const std::string path_;
+  const char* data_{nullptr};
+  std::size_t size_{0};
+  std::vector<BlockHandle> index_;
+  BlockId checkpoint_block_id_{0};
+  categorization::Hash public_state_hash_{};
+  std::uint64_t num_key_values_{0};
+};
+
+}  // namespace concord::kvbc::adapter::common::statesnapshot
@@ -183,6 +183,7 @@ class ReplicaBlockchain : public IBlocksDeleter,
   size_t postProcessUntilBlockId(uint64_t max_block_id) override final {
     return app_state_->postProcessUntilBlockId(max_block_id);
   }
+  void flushBlocks() override final { app_state_->flushBlocks(); }
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
   ////////////////////////////////////IKVBCStateSnapshot////////////////////////////////////////////////////////////////
@@ -192,6 +193,12 @@ class ReplicaBlockchain : public IBlocksDeleter,
     state_snapshot_->computeAndPersistPublicStateHash(checkpoint_block_id, value_converter);
   }
 
+  void exportPublicState(BlockId checkpoint_block_id,
+                         const Converter &value_converter,
+                         const std::string &file_path) override final {
+    state_snapshot_->exportPublicState(checkpoint_block_id, value_converter, file_path);
+  }
+
   std::optional<categorization::PublicStateKeys> getPublicStateKeys() const override final {
     return state_snapshot_->getPublicStateKeys();
   }
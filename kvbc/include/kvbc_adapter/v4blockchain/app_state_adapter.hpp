@@ -71,6 +71,8 @@ class AppStateAdapter : public bftEngine::bcst::IAppState {
 
   virtual size_t postProcessUntilBlockId(uint64_t max_block_id) override;
 
+  virtual void flushBlocks() override { kvbc_->flushBlocks(); }
+
  private:
   concord::kvbc::v4blockchain::KeyValueBlockchain *kvbc_{nullptr};
 };
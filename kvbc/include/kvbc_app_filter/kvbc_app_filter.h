@@ -19,7 +19,9 @@
 #include "categorization/updates.h"
 #include <atomic>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <functional>
 #include <future>
+#include <memory>
 #include <optional>
 #include <set>
 #include "Logger.hpp"
@@ -33,6 +35,8 @@
 #include "event_group_msgs.cmf.hpp"
 #include "endianness.hpp"
 #include "kvbc_key_types.h"
+#include "range_hash_checkpoints.h"
+#include "thread_pool.hpp"
 
 namespace concord {
 namespace kvbc {
@@ -131,6 +135,17 @@ class KvbAppFilter {
     ConcordAssertNE(rostorage_, nullptr);
   }
 
+  // Read and filter up to `depth` blocks or event groups ahead, in parallel on `pool`, in readBlockRange() and
+  // readEventGroups(). Blocks are read one by one, a read is started whenever a block is delivered. Event groups are
+  // read with a single multiGetLatest() whenever half of the window was delivered, and are then filtered one by one.
+  // The updates are still delivered in order. A depth of 0 or no pool (the default) reads one update at a time.
+  void setReadAhead(size_t depth, std::shared_ptr<util::ThreadPool> pool);
+
+  // Continue readBlockRangeHash() and readEventGroupRangeHash() from the closest checkpoint of the client's running
+  // state hash, and keep new checkpoints along the way. Without checkpoints (the default), every range is hashed from
+  // its first update.
+  void setRangeHashCheckpoints(std::shared_ptr<RangeHashCheckpoints> checkpoints);
+
   // Filter legacy events
   KvbFilteredUpdate filterUpdate(const KvbUpdate &update);
 
@@ -191,6 +206,10 @@ class KvbAppFilter {
 
   kvbc::categorization::EventGroup getEventGroup(kvbc::EventGroupId event_group_id) const;
 
+  // Deserialize the stored value of a global event group
+  kvbc::categorization::EventGroup toEventGroup(kvbc::EventGroupId global_event_group_id,
+                                                const std::optional<kvbc::categorization::Value> &value) const;
+
   // Return the oldest global event group id.
   // If no event group can be found then 0 (invalid group id) is returned.
   uint64_t getOldestGlobalEventGroupId() const;
@@ -230,6 +249,11 @@ class KvbAppFilter {
   const std::string cid_key_{kKvbKeyCorrelationId};
 
   std::pair<uint64_t, uint64_t> last_ext_and_global_eg_id_read_{0, 0};
+
+  size_t read_ahead_depth_{0};
+  std::shared_ptr<util::ThreadPool> read_ahead_pool_;
+
+  std::shared_ptr<RangeHashCheckpoints> range_hash_checkpoints_;
 };
 
 }  // namespace kvbc
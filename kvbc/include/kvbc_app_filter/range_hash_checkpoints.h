@@ -0,0 +1,82 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "sha_hash.hpp"
+
+namespace concord {
+namespace kvbc {
+
+// Checkpoints of the running state hash of a client's filtered updates.
+//
+// The state hash of the updates [first, last] is the SHA-256 of their concatenated update hashes. The running hash
+// after `last` - the SHA-256 context that absorbed the update hashes of [first, last] - never changes: blocks are
+// immutable and the event groups of a client are only appended. A range [first, end] with end >= last is therefore
+// hashed by continuing from the checkpoint at `last` rather than from `first`.
+//
+// One instance is shared by the filters of all the clients. It is thread safe.
+class RangeHashCheckpoints {
+ public:
+  enum class Stream { kBlocks, kEventGroups };
+
+  // Keep a checkpoint every `interval` updates and at the end of every range hashed, up to `max_checkpoints` per
+  // client, stream and first update. The checkpoints of the oldest updates are evicted first.
+  // At most `max_ranges` (client, stream, first update) keys are kept; the least recently used key is evicted with all
+  // its checkpoints.
+  RangeHashCheckpoints(uint64_t interval, size_t max_checkpoints, size_t max_ranges);
+
+  // Return the last update and the running hash of the closest checkpoint at or before `last`, if there is one.
+  std::optional<std::pair<uint64_t, util::SHA2_256>> closest(const std::string& client_id,
+                                                              Stream stream,
+                                                              uint64_t first,
+                                                              uint64_t last) const;
+
+  void add(
+      const std::string& client_id, Stream stream, uint64_t first, uint64_t last, const util::SHA2_256& running_hash);
+
+  // Whether a checkpoint is due after the update `last` of a range that starts at `first`.
+  bool isDue(uint64_t first, uint64_t last) const { return (last - first + 1) % interval_ == 0; }
+
+  size_t size() const;
+
+ private:
+  // client id, stream, first update
+  using Key = std::tuple<std::string, Stream, uint64_t>;
+
+  struct Range {
+    // Running hashes by last update
+    std::map<uint64_t, util::SHA2_256> checkpoints;
+    std::list<Key>::iterator lru_position;
+  };
+
+  const uint64_t interval_;
+  const size_t max_checkpoints_;
+  const size_t max_ranges_;
+  mutable std::mutex mutex_;
+  std::map<Key, Range> checkpoints_;
+  // Keys of checkpoints_, most recently used first
+  mutable std::list<Key> lru_;
+};
+
+}  // namespace kvbc
+}  // namespace concord
@@ -62,11 +62,15 @@ class DBAdapter : public IDbAdapter {
   // Note3: The key provided via 'nonProvableKeySet' parameter will be stored outside of the Merkle Tree,
   // the keys must have the same size!
   // Note4: Non-provable keys cannot be deleted for now.
+  // Note5: If a 'merkleUpdateThreadPool' is passed, large updates of the Merkle Tree are done in parallel on it.
+  // Note6: If a 'merkleNodeCache' is passed, the Merkle Tree internal nodes are read through it.
   DBAdapter(const std::shared_ptr<concord::storage::IDBClient> &db,
             bool linkTempSTChain = true,
             const NonProvableKeySet &nonProvableKeySet = NonProvableKeySet{},
             const std::shared_ptr<concord::performance::PerformanceManager> &pm_ =
-                std::make_shared<concord::performance::PerformanceManager>());
+                std::make_shared<concord::performance::PerformanceManager>(),
+            const std::shared_ptr<concord::util::ThreadPool> &merkleUpdateThreadPool = nullptr,
+            const std::shared_ptr<sparse_merkle::InternalNodeCache> &merkleNodeCache = nullptr);
 
   // Make the adapter non-copyable.
   DBAdapter(const DBAdapter &) = delete;
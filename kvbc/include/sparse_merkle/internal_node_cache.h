@@ -0,0 +1,136 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the sub-component's license, as noted in the
+// LICENSE file.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "Metrics.hpp"
+#include "sparse_merkle/db_reader.h"
+#include "sparse_merkle/internal_node.h"
+#include "sparse_merkle/keys.h"
+
+namespace concord {
+namespace kvbc {
+namespace sparse_merkle {
+
+// A bounded cache of the BatchedInternalNodes recently read or written by the updates of a tree.
+//
+// Nodes are immutable once written at a version, so a cached node stays valid until its version is removed from
+// storage by rolling back the tree. The top levels of the tree are read by every update; the cache spares re-reading
+// and deserializing them from the DB block after block.
+//
+// Nodes are evicted least recently used first once the estimated size of the cache exceeds `max_bytes`, and when they
+// have not been used in the last `max_version_age` versions of the tree (0 disables the age limit).
+//
+// The cache is thread safe: it is split into shards, each with its own lock.
+class InternalNodeCache {
+ public:
+  InternalNodeCache(const std::string& name, size_t max_bytes, uint64_t max_version_age);
+
+  InternalNodeCache(const InternalNodeCache&) = delete;
+  InternalNodeCache& operator=(const InternalNodeCache&) = delete;
+
+  std::optional<BatchedInternalNode> get(const InternalNodeKey& key);
+  void put(const InternalNodeKey& key, const BatchedInternalNode& node);
+
+  // The tree was updated to `version`. Evict the nodes that are too old.
+  void advance(Version version);
+
+  // The latest version of the tree in storage is `version`. If the tree was rolled back, the nodes of newer versions
+  // were removed from storage and these versions will be written again, so drop them.
+  void reset(Version version);
+
+  size_t size() const { return size_.load(); }
+  size_t bytes() const { return bytes_.load(); }
+
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+    metrics_component_.SetAggregator(aggregator);
+  }
+  void updateAggregator();
+
+ private:
+  struct Entry {
+    InternalNodeKey key;
+    BatchedInternalNode node;
+    // The version of the tree when the node was last used
+    uint64_t last_used{0};
+    size_t bytes{0};
+  };
+
+  struct KeyHash {
+    size_t operator()(const InternalNodeKey& key) const;
+  };
+
+  // Most recently used first
+  using Lru = std::list<Entry>;
+
+  struct Shard {
+    std::mutex mutex;
+    Lru lru;
+    std::unordered_map<InternalNodeKey, Lru::iterator, KeyHash> index;
+    size_t bytes{0};
+  };
+
+  static constexpr size_t kShards = 16;
+
+  Shard& shardOf(const InternalNodeKey& key) { return shards_[KeyHash{}(key) % kShards]; }
+
+  // Evict the least recently used nodes of the shard while it is too big or they are too old.
+  // Precondition: the shard is locked.
+  void evict(Shard& shard, uint64_t version);
+  void erase(Shard& shard, Lru::iterator it);
+
+  static size_t entryBytes(const InternalNodeKey& key);
+
+  const size_t max_shard_bytes_;
+  const uint64_t max_version_age_;
+  std::array<Shard, kShards> shards_;
+  std::atomic_uint64_t version_{0};
+  std::atomic_size_t size_{0};
+  std::atomic_size_t bytes_{0};
+
+  concordMetrics::Component metrics_component_;
+  concordMetrics::AtomicCounterHandle hits_;
+  concordMetrics::AtomicCounterHandle misses_;
+  concordMetrics::AtomicCounterHandle evictions_;
+  concordMetrics::GaugeHandle num_nodes_;
+  concordMetrics::GaugeHandle size_bytes_;
+};
+
+// Read internal nodes through an InternalNodeCache, and from another reader on a miss.
+class CachedDBReader : public IDBReader {
+ public:
+  CachedDBReader(std::shared_ptr<IDBReader> db_reader, std::shared_ptr<InternalNodeCache> cache)
+      : db_reader_{std::move(db_reader)}, cache_{std::move(cache)} {}
+
+  BatchedInternalNode get_latest_root() const override { return db_reader_->get_latest_root(); }
+  BatchedInternalNode get_internal(const InternalNodeKey& key) const override;
+
+ private:
+  std::shared_ptr<IDBReader> db_reader_;
+  std::shared_ptr<InternalNodeCache> cache_;
+};
+
+}  // namespace sparse_merkle
+}  // namespace kvbc
+}  // namespace concord
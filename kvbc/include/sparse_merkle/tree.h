@@ -17,6 +17,7 @@
 #include <optional>
 #include <array>
 #include <map>
+#include <memory>
 #include <stack>
 #include <utility>
 
@@ -26,8 +27,10 @@
 #include "sparse_merkle/base_types.h"
 #include "sparse_merkle/db_reader.h"
 #include "sparse_merkle/internal_node.h"
+#include "sparse_merkle/internal_node_cache.h"
 #include "sparse_merkle/update_batch.h"
 #include "sparse_merkle/update_cache.h"
+#include "thread_pool.hpp"
 
 namespace concord {
 namespace kvbc {
@@ -40,10 +43,25 @@ namespace sparse_merkle {
 // and making the changes in memory. A batch of DB updates of both internal and
 // leaf nodes, as well as stale nodes are returned to the caller so that they
 // can be written to the DB atomically.
+//
+// If given a thread pool, the keys of large updates are hashed in parallel, and inserted in parallel into the subtrees
+// of the root's children. The resulting tree, root hash and UpdateBatch are the same as without a thread pool. The
+// pool threads read from the IDBReader concurrently.
+//
+// If given an InternalNodeCache, internal nodes are read through it, and the nodes of every update are written to it.
+// The cache must not be shared with another tree.
 class Tree {
  public:
   Tree() = default;
-  explicit Tree(std::shared_ptr<IDBReader> db_reader) : db_reader_(db_reader) { reset(); }
+  explicit Tree(std::shared_ptr<IDBReader> db_reader,
+                std::shared_ptr<util::ThreadPool> thread_pool = nullptr,
+                std::shared_ptr<InternalNodeCache> node_cache = nullptr)
+      : db_reader_(node_cache ? std::make_shared<CachedDBReader>(std::move(db_reader), node_cache)
+                              : std::move(db_reader)),
+        thread_pool_(std::move(thread_pool)),
+        node_cache_(std::move(node_cache)) {
+    reset();
+  }
 
   const Hash& get_root_hash() const { return root_.hash(); }
   Version get_version() const { return root_.version(); }
@@ -74,13 +92,29 @@ class Tree {
   //
   // This is necessary to do before updates, as we only allow updating the
   // latest tree.
-  void reset() { root_ = db_reader_->get_latest_root(); }
+  void reset();
 
   UpdateBatch update_impl(const concord::kvbc::SetOfKeyValuePairs& updates,
                           const concord::kvbc::KeysVector& deleted_keys,
                           detail::UpdateCache& cache);
 
+  // Return the leaf children of `updates`, in order.
+  std::vector<LeafChild> hashLeaves(const concord::kvbc::SetOfKeyValuePairs& updates, Version version) const;
+
+  // Insert the children into the subtrees of the root children in parallel. Children that don't go to an existing
+  // subtree are inserted on the calling thread afterwards.
+  void insertParallel(const std::vector<LeafChild>& children, detail::UpdateCache& cache) const;
+
+  bool parallel(const concord::kvbc::SetOfKeyValuePairs& updates) const {
+    return thread_pool_ && updates.size() >= kMinParallelUpdates;
+  }
+
+  // Smaller updates are not worth the hand-off to the thread pool.
+  static constexpr size_t kMinParallelUpdates = 64;
+
   std::shared_ptr<IDBReader> db_reader_;
+  std::shared_ptr<util::ThreadPool> thread_pool_;
+  std::shared_ptr<InternalNodeCache> node_cache_;
   BatchedInternalNode root_;
 };
 
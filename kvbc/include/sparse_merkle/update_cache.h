@@ -58,7 +58,19 @@ class UpdateCache {
   void put(const NibblePath& path, const BatchedInternalNode& node);
   void remove(const NibblePath& path);
 
+  // Return a cache for inserting keys under the root child `nibble` independently of the other root children, e.g. on
+  // another thread. It starts from the current root and the nodes of that subtree updated so far.
+  //
+  // Precondition: the root child `nibble` is an InternalChild, so that inserts only modify that subtree and its link.
+  UpdateCache fork(Nibble nibble);
+
+  // Take the updated nodes and stale keys of a cache returned by fork(nibble) and link its subtree to the root.
+  void join(Nibble nibble, const UpdateCache& part);
+
  private:
+  UpdateCache(const BatchedInternalNode& root, const std::shared_ptr<IDBReader>& db_reader, Version version)
+      : version_(version), db_reader_(db_reader), original_root_(root) {}
+
   // The version of the tree after this update is complete.
   Version version_;
   std::shared_ptr<IDBReader> db_reader_;
@@ -51,6 +51,15 @@ class IKVBCStateSnapshot {
   // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
   virtual void computeAndPersistPublicStateHash(BlockId checkpoint_block_id, const Converter& value_converter) = 0;
 
+  // Computes and persists the public state hash as computeAndPersistPublicStateHash() does and, in the same iteration,
+  // exports the public key values and the hash to a state snapshot file at `file_path`.
+  //
+  // This method is supposed to be called on DB snapshots only and not on the actual blockchain.
+  // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
+  virtual void exportPublicState(BlockId checkpoint_block_id,
+                                 const Converter& value_converter,
+                                 const std::string& file_path) = 0;
+
   // Returns the public state keys as of the current point in the blockchain's history.
   // Returns std::nullopt if no public keys have been persisted.
   virtual std::optional<concord::kvbc::categorization::PublicStateKeys> getPublicStateKeys() const = 0;
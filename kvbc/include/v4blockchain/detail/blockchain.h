@@ -46,7 +46,10 @@ class Blockchain {
   ///////////////////ADD////////////////////////////////////////
   // construct a new block from the input updates and links it to the previous block by storing the last block digest.
   BlockId addBlock(const concord::kvbc::categorization::Updates&, storage::rocksdb::NativeWriteBatch&);
-  BlockId addBlock(v4blockchain::detail::Block& block, storage::rocksdb::NativeWriteBatch&);
+  // If parent_digest is given, it is used instead of the digest of the last block.
+  BlockId addBlock(v4blockchain::detail::Block& block,
+                   storage::rocksdb::NativeWriteBatch&,
+                   const std::optional<BlockDigest>& parent_digest = std::nullopt);
   //////////////////DELETE//////////////////////////////////////
   // Delete up to until not including until if until is within last reachable block,
   // else delete up to last reachable block and not including last reachable block.
@@ -106,6 +109,7 @@ class Blockchain {
   // stats for tests
   uint64_t from_future{};
   uint64_t from_storage{};
+  uint64_t from_pipeline{};
   static std::atomic<BlockId> global_genesis_block_id;
   void deleteBlock(BlockId id, storage::rocksdb::NativeWriteBatch& wb) {
     ConcordAssertLE(id, last_reachable_block_id_);
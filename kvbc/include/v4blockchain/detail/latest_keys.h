@@ -18,6 +18,7 @@
 #include <unordered_map>
 #include "categorization/updates.h"
 #include "v4blockchain/detail/categories.h"
+#include "v4blockchain/detail/latest_keys_cache.h"
 #include <rocksdb/compaction_filter.h>
 #include "endianness.hpp"
 #include "hex_tools.h"
@@ -39,6 +40,9 @@ the category is represented by a prefix, the following properties of categories
 implementation as well:
 - version category : stale on update i.e. a keys is prunable although it's the latest version when its block is deleted.
 - immutable - updating an immutable key is an error.
+
+If v4LatestKeysCacheMaxBytes is set, the latest values are read through a LatestKeysCache. The keys added by
+addBlockKeys() are written through to the cache by onBlockWritten(), once the write batch is written to storage.
 */
 class LatestKeys {
  public:
@@ -155,13 +159,44 @@ class LatestKeys {
 
   void setDeletedKeysMetric(concordMetrics::CounterHandle* m) { deleted_keys_ = m; }
 
+  // The write batch of the keys of the last call to addBlockKeys() was written to storage.
+  void onBlockWritten() {
+    if (cache_) cache_->commit();
+  }
+  // A write batch of reverted keys (see revertLastBlockKeys()) was written to storage.
+  void onBlockReverted() {
+    if (cache_) cache_->clear();
+  }
+
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+    if (cache_) cache_->setAggregator(aggregator);
+  }
+  void updateCacheMetrics() {
+    if (cache_) cache_->updateAggregator();
+  }
+
  private:
+  // Stage the write of a key for the cache, if enabled.
+  void stageCachedValue(const std::string& prefix,
+                        const std::string& key,
+                        const ::rocksdb::Slice& value,
+                        const ::rocksdb::Slice& flags,
+                        const std::string& block_version);
+  void stageCachedDelete(const std::string& prefix, const std::string& key);
+
+  // Return the stored value of a key, with its flags and version postfix.
+  std::optional<std::string> getStoredValue(const std::string& column_family, const std::string& get_key) const;
+  // Call `f(index, value)` with the stored value of each key, or with nullptr if a key doesn't exist.
+  template <typename F>
+  void multiGetStoredValues(const std::string& column_family, const std::vector<std::string>& get_keys, F f) const;
+
   // This filter is used to delete stale on update keys if their version is smaller than the genesis block
   // It's being called by RocksDB on compaction
 
   std::shared_ptr<concord::storage::rocksdb::NativeClient> native_client_;
   v4blockchain::detail::Categories category_mapping_;
   concordMetrics::CounterHandle* deleted_keys_{nullptr};
+  std::unique_ptr<LatestKeysCache> cache_;
 };
 
 }  // namespace concord::kvbc::v4blockchain::detail
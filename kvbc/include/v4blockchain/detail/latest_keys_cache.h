@@ -0,0 +1,125 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Metrics.hpp"
+
+namespace concord::kvbc::v4blockchain::detail {
+
+// A bounded cache of the latest values of keys, as they are stored in the latest keys column families, i.e. with the
+// flags and version postfix. A key that doesn't exist is cached as std::nullopt.
+//
+// The cache is write-through: the writes of a block are staged while its keys are added to the write batch and are
+// applied by commit() once the batch is written to storage. Values read from storage are only cached if no write to
+// their shard was committed since the read started, so that a read that races with a block never caches a value older
+// than the one in storage.
+//
+// Entries are evicted least recently used first once the estimated size of the cache exceeds `max_bytes`.
+//
+// The cache is thread safe: it is split into shards, each with its own lock. Staging and committing writes is done by
+// the single thread that adds blocks.
+class LatestKeysCache {
+ public:
+  using Value = std::optional<std::string>;
+
+  explicit LatestKeysCache(size_t max_bytes);
+
+  LatestKeysCache(const LatestKeysCache&) = delete;
+  LatestKeysCache& operator=(const LatestKeysCache&) = delete;
+
+  // Return the cached value of `key`, std::nullopt if `key` is not cached.
+  std::optional<Value> get(const std::string& key);
+
+  // The generation of the shard of `key`. Read it before reading `key` from storage and pass it to put().
+  uint64_t generation(const std::string& key);
+  // Cache the value of `key` read from storage, unless a write to its shard was committed since `generation`.
+  void put(const std::string& key, Value value, uint64_t generation);
+
+  // Stage the write of `key` by the block being added. A std::nullopt value drops `key` from the cache.
+  void stage(std::string key, Value value) { staged_.emplace_back(std::move(key), std::move(value)); }
+  // Drop the staged writes of a block that wasn't written.
+  void discardStaged() { staged_.clear(); }
+  // The block that staged the writes was written to storage. Apply them.
+  void commit();
+
+  // Storage was changed without staged writes, e.g. a block was reverted.
+  void clear();
+
+  size_t size() const { return size_.load(); }
+  size_t bytes() const { return bytes_.load(); }
+
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+    metrics_component_.SetAggregator(aggregator);
+  }
+  void updateAggregator();
+
+ private:
+  struct Entry {
+    std::string key;
+    Value value;
+    size_t bytes{0};
+  };
+
+  // Most recently used first
+  using Lru = std::list<Entry>;
+
+  struct Shard {
+    std::mutex mutex;
+    Lru lru;
+    std::unordered_map<std::string, Lru::iterator> index;
+    size_t bytes{0};
+    uint64_t generation{0};
+  };
+
+  static constexpr size_t kShards = 16;
+
+  Shard& shardOf(const std::string& key) { return shards_[std::hash<std::string>{}(key) % kShards]; }
+
+  // Insert or update the entry of `key`, and evict the least recently used entries while the shard is too big.
+  // Precondition: the shard is locked.
+  void set(Shard& shard, const std::string& key, Value&& value);
+  // Precondition: the shard is locked.
+  void erase(Shard& shard, Lru::iterator it);
+
+  static size_t entryBytes(const std::string& key, const Value& value);
+
+  const size_t max_shard_bytes_;
+  std::array<Shard, kShards> shards_;
+  std::vector<std::pair<std::string, Value>> staged_;
+  std::atomic_size_t size_{0};
+  std::atomic_size_t bytes_{0};
+
+  concordMetrics::Component metrics_component_;
+  concordMetrics::AtomicCounterHandle hits_;
+  concordMetrics::AtomicCounterHandle misses_;
+  concordMetrics::AtomicCounterHandle evictions_;
+  concordMetrics::GaugeHandle num_entries_;
+  concordMetrics::GaugeHandle size_bytes_;
+};
+
+}  // namespace concord::kvbc::v4blockchain::detail
@@ -18,7 +18,10 @@
 #include "v4blockchain/detail/st_chain.h"
 #include "v4blockchain/detail/latest_keys.h"
 #include "v4blockchain/detail/blockchain.h"
+#include "block_digest_pipeline.hpp"
+#include "bftengine/ReplicaConfig.hpp"
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace concord::kvbc::v4blockchain {
@@ -37,7 +40,16 @@ class KeyValueBlockchain {
   BlockId add(categorization::Updates &&);
   BlockId add(const categorization::Updates &,
               v4blockchain::detail::Block &block,
-              storage::rocksdb::NativeWriteBatch &);
+              storage::rocksdb::NativeWriteBatch &,
+              const std::optional<concord::util::digest::BlockDigest> &parent_digest = std::nullopt);
+  // Group commit: every block is still written unsynced (and is visible to readers) as soon as it is added, and the WAL
+  // is synced once per group of up to max_blocks consecutive blocks, or once their write batches reach max_bytes. This
+  // bounds the blocks lost on a host crash at the cost of one sync per group, instead of one per block.
+  // max_blocks == 0 disables group commit (the default): the WAL is never synced explicitly.
+  void setGroupCommit(uint32_t max_blocks, uint64_t max_bytes);
+  // Sync the WAL of the blocks that were added since the last group commit.
+  // Must be called before a state that includes these blocks is acknowledged (e.g. a checkpoint).
+  void flushBlocks();
   ////////////////////// DELETE //////////////////////////
   BlockId deleteBlocksUntil(BlockId until);
   void deleteGenesisBlock();
@@ -58,7 +70,10 @@ class KeyValueBlockchain {
   // Adds consecutive blocks from the ST chain to the blockchain until ST chain is empty or a gap is found.
   void linkSTChain();
   // Atomic delete block from the ST chain and add to the blockchain.
-  void writeSTLinkTransaction(const BlockId, const categorization::Updates &);
+  // If parent_digest is given, it is used instead of the digest of the last block in the blockchain.
+  void writeSTLinkTransaction(const BlockId,
+                              const categorization::Updates &,
+                              const std::optional<concord::util::digest::BlockDigest> &parent_digest = std::nullopt);
   // Each block contains the genesis block at the time of that block insertion.
   // On State-transfer, we read this key and prune up to this block.
   void pruneOnSTLink(const categorization::Updates &);
@@ -255,6 +270,17 @@ class KeyValueBlockchain {
   std::optional<categorization::Value> getValueFromUpdate(BlockId block_id,
                                                           const std::string &key,
                                                           const categorization::ImmutableInput &category_input) const;
+  // Called after a block is written, flushes the group commit if it has reached its bounds.
+  void onBlockWritten(size_t batch_size);
+  // Must be called with group_commit_mutex_ held.
+  void flushGroupCommit();
+  // The blocks [from, until] of the state transfer chain, read and hashed ahead by digest_thread_pool_.
+  BlockDigestPipeline<v4blockchain::detail::Block> stChainBlocks(BlockId from, BlockId until) const;
+  // Returns the digest of the previous block in the pipeline if it is the parent digest of `item`.
+  static std::optional<concord::util::digest::BlockDigest> chainedParentDigest(
+      BlockId block_id,
+      const BlockDigestPipeline<v4blockchain::detail::Block>::Item &item,
+      const std::optional<concord::util::digest::BlockDigest> &prev_digest);
 
  private:  // Data members
   std::shared_ptr<concord::storage::rocksdb::NativeClient> native_client_;
@@ -269,6 +295,16 @@ class KeyValueBlockchain {
   std::map<kvbc::BlockId, const ::rocksdb::Snapshot *> chkpnt_snap_shots_;
   // const ::rocksdb::Snapshot *chkpoint_snap_shot_{nullptr};
   util::ThreadPool thread_pool_{1};
+  // Hashes state transfer blocks ahead while they are linked, nullptr if stLinkDigestPipelineDepth is 0.
+  const std::size_t st_link_digest_pipeline_depth_{bftEngine::ReplicaConfig::instance().stLinkDigestPipelineDepth};
+  std::unique_ptr<util::ThreadPool> digest_thread_pool_{makeBlockDigestThreadPool(st_link_digest_pipeline_depth_)};
+
+  // Group commit
+  std::mutex group_commit_mutex_;
+  uint32_t group_commit_max_blocks_{0};
+  uint64_t group_commit_max_bytes_{0};
+  uint64_t group_commit_pending_blocks_{0};
+  uint64_t group_commit_pending_bytes_{0};
 
   // Metrics
   std::shared_ptr<concordMetrics::Aggregator> aggregator_;
@@ -276,11 +312,14 @@ class KeyValueBlockchain {
   concordMetrics::GaugeHandle blocks_deleted_;
   concordMetrics::CounterHandle deleted_keys_;
   mutable concordMetrics::CounterHandle immutables_reads_;
+  concordMetrics::CounterHandle group_commits_;
+  concordMetrics::CounterHandle group_committed_blocks_;
 
  public:
   void setAggregator(std::shared_ptr<concordMetrics::Aggregator> aggregator) {
     aggregator_ = aggregator;
     v4_metrics_comp_.SetAggregator(aggregator_);
+    latest_keys_.setAggregator(aggregator_);
   }
 };
 
@@ -35,6 +35,7 @@
 #include "bftengine/DbCheckpointManager.hpp"
 #include "IntervalMappingResourceManager.hpp"
 #include "kvbc_adapter/v4blockchain/blocks_utils.hpp"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
 
 using bft::communication::ICommunication;
 using bftEngine::bcst::StateTransferDigest;
@@ -356,7 +357,12 @@ void Replica::createReplicaAndSyncState() {
         const auto link_st_chain = false;
         auto kvbc = adapter::ReplicaBlockchain{db, link_st_chain};
         kvbc.trimBlocksFromCheckpoint(block_id_at_checkpoint);
-        kvbc.computeAndPersistPublicStateHash(block_id_at_checkpoint, value_converter);
+        if (bftEngine::ReplicaConfig::instance().stateSnapshotExportEnabled) {
+          kvbc.exportPublicState(
+              block_id_at_checkpoint, value_converter, adapter::common::statesnapshot::StateSnapshotFile::pathIn(path));
+        } else {
+          kvbc.computeAndPersistPublicStateHash(block_id_at_checkpoint, value_converter);
+        }
       },
       [this](bool flag, kvbc::BlockId id) { checkpointInProcess(flag, id); });
 }
@@ -528,10 +534,25 @@ Replica::Replica(ICommunication *comm,
     replicaConfig_.get("concord.bft.st.enableReservedPages", true),
     replicaConfig_.get("concord.bft.st.enableSourceBlocksPreFetch", true),
     replicaConfig_.get("concord.bft.st.enableSourceSelectorPrimaryAwareness", true),
-    replicaConfig_.get("concord.bft.st.enableStoreRvbDataDuringCheckpointing", true)
+    replicaConfig_.get("concord.bft.st.enableStoreRvbDataDuringCheckpointing", true),
+    replicaConfig_.get<uint16_t>("concord.bft.st.maxNumOfStripeSources", 0)
   };
+  stConfig.sourceReadAheadBlocks = replicaConfig_.get<uint32_t>("concord.bft.st.sourceReadAheadBlocks", 0);
+  stConfig.sourceBlockCacheSize =
+      replicaConfig_.get<uint32_t>("concord.bft.st.sourceBlockCacheSize", 256 * 1024 * 1024);
+  stConfig.numOfRvbReconstructionThreads =
+      replicaConfig_.get<uint16_t>("concord.bft.st.numOfRvbReconstructionThreads", 0);
   stConfig.runInSeparateThread = replicaConfig_.isReadOnly ? false : true;
 
+  const auto chunkCompression = replicaConfig_.get<std::string>("concord.bft.st.chunkCompression", "none");
+  if (chunkCompression == "lz4") {
+    stConfig.chunkCompression = bftEngine::bcst::ChunkCompression::LZ4;
+  } else if (chunkCompression == "zstd") {
+    stConfig.chunkCompression = bftEngine::bcst::ChunkCompression::ZSTD;
+  } else if (chunkCompression != "none") {
+    LOG_WARN(logger, "Unknown ST chunk compression, blocks are fetched uncompressed:" << KVLOG(chunkCompression));
+  }
+
 #if !defined USE_COMM_PLAIN_TCP && !defined USE_COMM_TLS_TCP
   // maxChunkSize * maxNumberOfChunksInBatch shouldn't exceed UDP message size which is limited to 64KB
   if (stConfig.maxChunkSize * stConfig.maxNumberOfChunksInBatch > 64 * 1024) {
@@ -707,6 +728,11 @@ size_t Replica::postProcessUntilBlockId(uint64_t max_block_id) {
   return m_kvBlockchain->postProcessUntilBlockId(max_block_id);
 }
 
+void Replica::flushBlocks() {
+  if (replicaConfig_.isReadOnly) return;
+  m_kvBlockchain->flushBlocks();
+}
+
 RawBlock Replica::getBlockInternal(BlockId blockId) const { return m_bcDbAdapter->getRawBlock(blockId); }
 
 /*
@@ -318,7 +318,10 @@ void addStaleKeysToDeleteBatch(const ::rocksdb::PinnableSlice& slice, uint64_t t
   batch.del(BLOCK_MERKLE_STALE_CF, serialize(TreeVersion{tree_version}));
 }
 
-BlockMerkleCategory::BlockMerkleCategory(const std::shared_ptr<storage::rocksdb::NativeClient>& db) : db_{db} {
+BlockMerkleCategory::BlockMerkleCategory(const std::shared_ptr<storage::rocksdb::NativeClient>& db,
+                                         const std::shared_ptr<sparse_merkle::InternalNodeCache>& node_cache,
+                                         const std::shared_ptr<util::ThreadPool>& thread_pool)
+    : db_{db} {
   createColumnFamilyIfNotExisting(BLOCK_MERKLE_INTERNAL_NODES_CF, *db);
   createColumnFamilyIfNotExisting(BLOCK_MERKLE_LEAF_NODES_CF, *db);
   createColumnFamilyIfNotExisting(BLOCK_MERKLE_LATEST_KEY_VERSION_CF, *db);
@@ -326,7 +329,7 @@ BlockMerkleCategory::BlockMerkleCategory(const std::shared_ptr<storage::rocksdb:
   createColumnFamilyIfNotExisting(BLOCK_MERKLE_STALE_CF, *db);
   createColumnFamilyIfNotExisting(BLOCK_MERKLE_ACTIVE_KEYS_FROM_PRUNED_BLOCKS_CF, *db);
   createColumnFamilyIfNotExisting(BLOCK_MERKLE_PRUNED_BLOCKS_CF, *db);
-  tree_ = sparse_merkle::Tree{std::make_shared<Reader>(*db_)};
+  tree_ = sparse_merkle::Tree{std::make_shared<Reader>(*db_), thread_pool, node_cache};
 }
 
 BlockMerkleOutput BlockMerkleCategory::add(BlockId block_id, BlockMerkleInput&& updates, NativeWriteBatch& batch) {
@@ -23,6 +23,7 @@
 #include "categorization/details.h"
 #include "ReplicaConfig.hpp"
 #include "throughput.hpp"
+#include "scope_exit.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -52,9 +53,15 @@ KeyValueBlockchain::KeyValueBlockchain(const std::shared_ptr<concord::storage::r
       merkle_num_of_deleted_keys_{delete_metrics_comp_.RegisterCounter("numOfMerkleKeysDeleted")},
       add_metrics_comp_{
           concordMetrics::Component("kv_blockchain_adds", std::make_shared<concordMetrics::Aggregator>())},
-      versioned_num_of_keys_{add_metrics_comp_.RegisterCounter("numOfVersionedKeys")},
-      immutable_num_of_keys_{add_metrics_comp_.RegisterCounter("numOfImmutableKeys")},
-      merkle_num_of_keys_{add_metrics_comp_.RegisterCounter("numOfMerkleKeys")} {
+      versioned_num_of_keys_{add_metrics_comp_.RegisterAtomicCounter("numOfVersionedKeys")},
+      immutable_num_of_keys_{add_metrics_comp_.RegisterAtomicCounter("numOfImmutableKeys")},
+      merkle_num_of_keys_{add_metrics_comp_.RegisterAtomicCounter("numOfMerkleKeys")} {
+  if (const auto threads = bftEngine::ReplicaConfig::instance().numOfCategoryAddThreads; threads > 0) {
+    category_add_thread_pool_ = std::make_unique<util::ThreadPool>(threads);
+  }
+  if (const auto threads = bftEngine::ReplicaConfig::instance().numOfMerkleUpdateThreads; threads > 0) {
+    merkle_update_thread_pool_ = std::make_shared<util::ThreadPool>(threads);
+  }
   if (detail::createColumnFamilyIfNotExisting(detail::CAT_ID_TYPE_CF, *native_client_.get())) {
     LOG_INFO(CAT_BLOCK_LOG, "Created [" << detail::CAT_ID_TYPE_CF << "] column family for the category types");
   }
@@ -141,7 +148,9 @@ void KeyValueBlockchain::loadCategories() {
     auto cat_type = static_cast<CATEGORY_TYPE>(itr.valueView()[0]);
     switch (cat_type) {
       case CATEGORY_TYPE::block_merkle:
-        categories_.emplace(itr.key(), detail::BlockMerkleCategory{native_client_});
+        categories_.emplace(
+            itr.key(),
+            detail::BlockMerkleCategory{native_client_, makeMerkleNodeCache(itr.key()), merkle_update_thread_pool_});
         category_types_[itr.key()] = CATEGORY_TYPE::block_merkle;
         LOG_INFO(CAT_BLOCK_LOG, "Created category [" << itr.key() << "] as type BlockMerkleCategory");
         break;
@@ -189,33 +198,126 @@ BlockId KeyValueBlockchain::addBlock(Updates&& updates) {
 
 BlockId KeyValueBlockchain::addBlock(CategoryInput&& category_updates,
                                      concord::storage::rocksdb::NativeWriteBatch& write_batch) {
+  return addBlock(std::move(category_updates), write_batch, std::nullopt);
+}
+
+BlockId KeyValueBlockchain::addBlock(CategoryInput&& category_updates,
+                                     concord::storage::rocksdb::NativeWriteBatch& write_batch,
+                                     const std::optional<BlockDigest>& parent_digest) {
   // Use new client batch and column families
   Block new_block{block_chain_.getLastReachableBlockId() + 1};
-  auto parent_digest_future = computeParentBlockDigest(new_block.id(), std::move(last_raw_block_));
+  auto parent_digest_future =
+      parent_digest ? std::future<BlockDigest>{} : computeParentBlockDigest(new_block.id(), std::move(last_raw_block_));
   // initialize the raw block for the next call to computeParentBlockDigest
   auto& last_raw_block = last_raw_block_.second.emplace();
   last_raw_block_.first = new_block.id();
   last_raw_block.updates = category_updates;
   // Per category updates
-  for (auto&& [category_id, update] : category_updates.kv) {
-    std::visit(
-        [&new_block, category_id = category_id, &write_batch, &last_raw_block, this](auto&& update) {
-          auto block_updates =
-              handleCategoryUpdates(new_block.id(), category_id, std::forward<decltype(update)>(update), write_batch);
-          addRootHash(category_id, last_raw_block, block_updates);
-          new_block.add(category_id, std::move(block_updates));
-        },
-        std::move(update));
+  if (category_add_thread_pool_ && category_updates.kv.size() > 1) {
+    addCategoryUpdatesConcurrently(std::move(category_updates), new_block, last_raw_block, write_batch);
+  } else {
+    for (auto&& [category_id, update] : category_updates.kv) {
+      std::visit(
+          [&new_block, category_id = category_id, &write_batch, &last_raw_block, this](auto&& update) {
+            const auto start = std::chrono::steady_clock::now();
+            auto block_updates =
+                handleCategoryUpdates(new_block.id(), category_id, std::forward<decltype(update)>(update), write_batch);
+            recordCategoryAdd(category_id, std::chrono::steady_clock::now() - start);
+            addRootHash(category_id, last_raw_block, block_updates);
+            new_block.add(category_id, std::move(block_updates));
+          },
+          std::move(update));
+    }
   }
-  new_block.data.parent_digest = parent_digest_future.get();
+  new_block.data.parent_digest = parent_digest ? *parent_digest : parent_digest_future.get();
   last_raw_block.parent_digest = new_block.data.parent_digest;
   block_chain_.addBlock(new_block, write_batch);
   LOG_DEBUG(CAT_BLOCK_LOG, "Writing block [" << new_block.id() << "] to the blocks cf");
   write_batch.put(detail::BLOCKS_CF, Block::generateKey(new_block.id()), Block::serialize(new_block));
   add_metrics_comp_.UpdateAggregator();
+  for (auto& metrics : category_add_metrics_) {
+    metrics.second->component.UpdateAggregator();
+  }
+  for (auto& cache : merkle_node_caches_) {
+    cache->updateAggregator();
+  }
   return new_block.id();
 }
 
+void KeyValueBlockchain::addCategoryUpdatesConcurrently(CategoryInput&& category_updates,
+                                                        Block& new_block,
+                                                        RawBlockData& last_raw_block,
+                                                        concord::storage::rocksdb::NativeWriteBatch& write_batch) {
+  using Output = std::variant<BlockMerkleOutput, VersionedOutput, ImmutableOutput>;
+  using Duration = std::chrono::steady_clock::duration;
+  const auto block_id = new_block.id();
+  auto write_batches = std::vector<concord::storage::rocksdb::NativeWriteBatch>{};
+  write_batches.reserve(category_updates.kv.size());
+  auto futures = std::vector<std::future<std::pair<Output, Duration>>>{};
+  futures.reserve(category_updates.kv.size());
+  // The categories write to the batches of this frame, wait for all of them even if one fails.
+  auto wait_for_categories = util::ScopeExit{[&futures]() {
+    for (auto& future : futures) {
+      if (future.valid()) {
+        future.wait();
+      }
+    }
+  }};
+  for (auto& category : category_updates.kv) {
+    auto& category_batch = write_batches.emplace_back(native_client_->getBatch());
+    futures.push_back(category_add_thread_pool_->async([this, block_id, &category, &category_batch]() {
+      const auto start = std::chrono::steady_clock::now();
+      auto output = std::visit(
+          [&](auto&& update) -> Output {
+            return handleCategoryUpdates(
+                block_id, category.first, std::forward<decltype(update)>(update), category_batch);
+          },
+          std::move(category.second));
+      return std::make_pair(std::move(output), std::chrono::steady_clock::now() - start);
+    }));
+  }
+
+  // Append the batches in the order of the categories, so that the result is the same as adding them one by one.
+  auto category_batch = write_batches.begin();
+  auto future = futures.begin();
+  for (const auto& category : category_updates.kv) {
+    auto [output, duration] = future->get();
+    write_batch.append(*category_batch);
+    recordCategoryAdd(category.first, duration);
+    std::visit(
+        [&](auto&& block_updates) {
+          addRootHash(category.first, last_raw_block, block_updates);
+          new_block.add(category.first, std::forward<decltype(block_updates)>(block_updates));
+        },
+        std::move(output));
+    ++category_batch;
+    ++future;
+  }
+}
+
+KeyValueBlockchain::CategoryAddMetrics::CategoryAddMetrics(const std::string& category_id)
+    : component{"kv_blockchain_category_add_" + category_id, std::make_shared<concordMetrics::Aggregator>()},
+      last_add_duration_micros{component.RegisterGauge("lastAddDurationMicros", 0)},
+      total_add_duration_micros{component.RegisterCounter("totalAddDurationMicros")},
+      num_of_adds{component.RegisterCounter("numOfAdds")} {
+  component.Register();
+}
+
+void KeyValueBlockchain::recordCategoryAdd(const std::string& category_id,
+                                           std::chrono::steady_clock::duration duration) {
+  auto& metrics = category_add_metrics_[category_id];
+  if (!metrics) {
+    metrics = std::make_unique<CategoryAddMetrics>(category_id);
+    if (aggregator_) {
+      metrics->component.SetAggregator(aggregator_);
+    }
+  }
+  const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  metrics->last_add_duration_micros.Get().Set(micros);
+  metrics->total_add_duration_micros += micros;
+  metrics->num_of_adds++;
+}
+
 std::future<BlockDigest> KeyValueBlockchain::computeParentBlockDigest(const BlockId block_id,
                                                                       VersionedRawBlock&& cached_raw_block) {
   auto parent_block_id = block_id - 1;
@@ -719,9 +821,12 @@ void KeyValueBlockchain::addNewCategory(const std::string& cat_id, CATEGORY_TYPE
   insertCategoryMapping(cat_id, type);
   auto inserted = false;
   switch (type) {
-    case CATEGORY_TYPE::block_merkle:
-      inserted = categories_.try_emplace(cat_id, detail::BlockMerkleCategory{native_client_}).second;
+    case CATEGORY_TYPE::block_merkle: {
+      auto category =
+          detail::BlockMerkleCategory{native_client_, makeMerkleNodeCache(cat_id), merkle_update_thread_pool_};
+      inserted = categories_.try_emplace(cat_id, std::move(category)).second;
       break;
+    }
     case CATEGORY_TYPE::immutable:
       inserted = categories_.try_emplace(cat_id, detail::ImmutableKeyValueCategory{cat_id, native_client_}).second;
       break;
@@ -737,6 +842,20 @@ void KeyValueBlockchain::addNewCategory(const std::string& cat_id, CATEGORY_TYPE
   }
 }
 
+std::shared_ptr<sparse_merkle::InternalNodeCache> KeyValueBlockchain::makeMerkleNodeCache(const std::string& cat_id) {
+  const auto& config = bftEngine::ReplicaConfig::instance();
+  if (config.merkleNodeCacheMaxBytes == 0) {
+    return nullptr;
+  }
+  auto cache = std::make_shared<sparse_merkle::InternalNodeCache>(
+      cat_id, config.merkleNodeCacheMaxBytes, config.merkleNodeCacheMaxVersionAge);
+  if (aggregator_) {
+    cache->setAggregator(aggregator_);
+  }
+  merkle_node_caches_.push_back(cache);
+  return cache;
+}
+
 BlockMerkleOutput KeyValueBlockchain::handleCategoryUpdates(BlockId block_id,
                                                             const std::string& category_id,
                                                             BlockMerkleInput&& updates,
@@ -853,17 +972,20 @@ size_t KeyValueBlockchain::linkUntilBlockId(BlockId from_block_id, BlockId until
   }
 
   concord::util::DurationTracker<std::chrono::milliseconds> link_duration("link_duration", true);
+  auto blocks = stChainBlocks(from_block_id, until_block_id);
+  auto prev_digest = std::optional<BlockDigest>{};
   for (auto i = from_block_id; i <= until_block_id; ++i) {
-    auto raw_block = state_transfer_block_chain_.getRawBlock(i);
-    if (!raw_block) {
+    auto item = blocks.next();
+    if (!item) {
       // we didn't find the next block
       return i - from_block_id;
     }
 
     // First prune and then link the block to the chain. Rationale is that this will preserve the same order of block
     // deletes relative to block adds on source and destination replicas.
-    pruneOnSTLink(*raw_block);
-    writeSTLinkTransaction(i, *raw_block);
+    pruneOnSTLink(item->block);
+    writeSTLinkTransaction(i, item->block, chainedParentDigest(i, *item, prev_digest));
+    prev_digest = item->digest;
     if ((++report_counter % report_thresh) == 0) {
       auto elapsed_time_ms = link_duration.totalDuration();
       uint64_t blocks_linked_per_sec{};
@@ -892,15 +1014,18 @@ void KeyValueBlockchain::linkSTChainFrom(BlockId block_id) {
   const auto last_block_id = state_transfer_block_chain_.getLastBlockId();
   if (last_block_id == 0) return;
 
+  auto blocks = stChainBlocks(block_id, last_block_id);
+  auto prev_digest = std::optional<BlockDigest>{};
   for (auto i = block_id; i <= last_block_id; ++i) {
-    auto raw_block = state_transfer_block_chain_.getRawBlock(i);
-    if (!raw_block) {
+    auto item = blocks.next();
+    if (!item) {
       return;
     }
     // First prune and then link the block to the chain. Rationale is that this will preserve the same order of block
     // deletes relative to block adds on source and destination replicas.
-    pruneOnSTLink(*raw_block);
-    writeSTLinkTransaction(i, *raw_block);
+    pruneOnSTLink(item->block);
+    writeSTLinkTransaction(i, item->block, chainedParentDigest(i, *item, prev_digest));
+    prev_digest = item->digest;
   }
 
   // Linking has fully completed and we should not have any more ST temporary blocks left. Therefore, make sure we don't
@@ -926,13 +1051,42 @@ void KeyValueBlockchain::pruneOnSTLink(const RawBlock& block) {
 }
 
 // Atomic delete from state transfer and add to blockchain
-void KeyValueBlockchain::writeSTLinkTransaction(const BlockId block_id, RawBlock& block) {
+void KeyValueBlockchain::writeSTLinkTransaction(const BlockId block_id,
+                                                RawBlock& block,
+                                                const std::optional<BlockDigest>& parent_digest) {
   auto write_batch = native_client_->getBatch();
   state_transfer_block_chain_.deleteBlock(block_id, write_batch);
-  auto new_block_id = addBlock(std::move(block.data.updates), write_batch);
+  auto new_block_id = addBlock(std::move(block.data.updates), write_batch, parent_digest);
   native_client_->write(std::move(write_batch));
 
   block_chain_.setAddedBlockId(new_block_id);
 }
 
+BlockDigestPipeline<RawBlock> KeyValueBlockchain::stChainBlocks(BlockId from, BlockId until) const {
+  return BlockDigestPipeline<RawBlock>{
+      digest_thread_pool_.get(),
+      st_link_digest_pipeline_depth_,
+      from,
+      until,
+      [this](BlockId id) { return state_transfer_block_chain_.getRawBlock(id); },
+      [](BlockId id, const RawBlock& block) {
+        const auto& raw_buffer = RawBlock::serialize(block);
+        return computeBlockDigest(id, reinterpret_cast<const char*>(raw_buffer.data()), raw_buffer.size());
+      }};
+}
+
+// State transfer has validated that the digest of each block is the parent digest of the next one. The check
+// protects against linking with a digest that doesn't chain - in which case it is computed as usual.
+std::optional<BlockDigest> KeyValueBlockchain::chainedParentDigest(BlockId block_id,
+                                                                   const BlockDigestPipeline<RawBlock>::Item& item,
+                                                                   const std::optional<BlockDigest>& prev_digest) {
+  if (!prev_digest) return std::nullopt;
+  if (*prev_digest != item.block.data.parent_digest) {
+    LOG_WARN(CAT_BLOCK_LOG,
+             "Parent digest of state transfer block doesn't match the digest of its parent" << KVLOG(block_id));
+    return std::nullopt;
+  }
+  return prev_digest;
+}
+
 }  // namespace concord::kvbc::categorization
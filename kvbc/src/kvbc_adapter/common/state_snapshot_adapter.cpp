@@ -11,30 +11,35 @@
 // terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <utility>
 #include <variant>
 #include "categorization/details.h"
 #include "categorization/db_categories.h"
 #include "kvbc_key_types.hpp"
 #include "kvbc_adapter/common/state_snapshot_adapter.hpp"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
+#include "scope_exit.hpp"
+#include "thread_pool.hpp"
 
 namespace concord::kvbc::adapter::common::statesnapshot {
 ////////////////////////////IKVBCStateSnapshot////////////////////////////////////////////////////////////////////////
 void KVBCStateSnapshot::computeAndPersistPublicStateHash(BlockId checkpoint_block_id,
                                                          const Converter& value_converter) {
-  auto hash = concord::kvbc::categorization::detail::hash(std::string{});
-  iteratePublicStateKeyValues([&](std::string&& key, std::string&& value) {
-    value = value_converter(std::move(value));
-    auto hasher = concord::kvbc::categorization::Hasher{};
-    hasher.init();
-    hasher.update(hash.data(), hash.size());
-    const auto key_hash = concord::kvbc::categorization::detail::hash(key);
-    hasher.update(key_hash.data(), key_hash.size());
-    hasher.update(value.data(), value.size());
-    hash = hasher.finish();
-  });
-  native_client_->put(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey(),
-                      concord::kvbc::categorization::detail::serialize(
-                          concord::kvbc::categorization::StateHash{checkpoint_block_id, hash}));
+  persistPublicStateHash(checkpoint_block_id, hashPublicState(value_converter, nullptr));
+}
+
+void KVBCStateSnapshot::exportPublicState(BlockId checkpoint_block_id,
+                                          const Converter& value_converter,
+                                          const std::string& file_path) {
+  auto writer =
+      StateSnapshotFile::Writer{file_path, bftEngine::ReplicaConfig::instance().stateSnapshotExportBlockSize};
+  const auto hash = hashPublicState(
+      value_converter, [&writer](const std::string& key, const std::string& value) { writer.add(key, value); });
+  writer.finish(checkpoint_block_id, hash);
+  persistPublicStateHash(checkpoint_block_id, hash);
 }
 
 std::optional<concord::kvbc::categorization::PublicStateKeys> KVBCStateSnapshot::getPublicStateKeys() const {
@@ -63,6 +68,126 @@ bool KVBCStateSnapshot::iteratePublicStateKeyValues(const std::function<void(std
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+concord::kvbc::categorization::Hash KVBCStateSnapshot::hashPublicState(
+    const Converter& value_converter,
+    const std::function<void(const std::string&, const std::string&)>& on_key_value) const {
+  const auto public_state = getPublicStateKeys();
+  if (!public_state) {
+    return concord::kvbc::categorization::detail::hash(std::string{});
+  }
+  const auto& config = bftEngine::ReplicaConfig::instance();
+  if (config.stateSnapshotHashRangeSize == 0) {
+    return hashKeyRange(public_state->keys, 0, public_state->keys.size(), value_converter, on_key_value);
+  }
+  return hashKeyRanges(public_state->keys,
+                       config.numOfStateSnapshotHashThreads,
+                       config.stateSnapshotHashRangeSize,
+                       value_converter,
+                       on_key_value);
+}
+
+concord::kvbc::categorization::Hash KVBCStateSnapshot::hashKeyRange(
+    const std::vector<std::string>& keys,
+    std::size_t begin,
+    std::size_t end,
+    const Converter& value_converter,
+    const std::function<void(const std::string&, const std::string&)>& on_key_value) const {
+  auto hash = concord::kvbc::categorization::detail::hash(std::string{});
+  iterateKeyValues(keys, begin, end, [&](std::string&& key, std::string&& value) {
+    if (on_key_value) {
+      on_key_value(key, value);
+    }
+    value = value_converter(std::move(value));
+    auto hasher = concord::kvbc::categorization::Hasher{};
+    hasher.init();
+    hasher.update(hash.data(), hash.size());
+    const auto key_hash = concord::kvbc::categorization::detail::hash(key);
+    hasher.update(key_hash.data(), key_hash.size());
+    hasher.update(value.data(), value.size());
+    hash = hasher.finish();
+  });
+  return hash;
+}
+
+concord::kvbc::categorization::Hash KVBCStateSnapshot::hashKeyRanges(
+    const std::vector<std::string>& keys,
+    std::uint32_t num_threads,
+    std::uint64_t range_size,
+    const Converter& value_converter,
+    const std::function<void(const std::string&, const std::string&)>& on_key_value) const {
+  ConcordAssertGT(range_size, 0);
+  auto hasher = concord::kvbc::categorization::Hasher{};
+  hasher.init();
+  if (num_threads == 0) {
+    for (auto begin = std::size_t{0}; begin < keys.size(); begin += range_size) {
+      const auto end = std::min<std::size_t>(begin + range_size, keys.size());
+      const auto range_hash = hashKeyRange(keys, begin, end, value_converter, on_key_value);
+      hasher.update(range_hash.data(), range_hash.size());
+    }
+    return hasher.finish();
+  }
+
+  struct RangeResult {
+    concord::kvbc::categorization::Hash hash;
+    // The key values of the range, kept only if they are passed to `on_key_value` in key order after the range is
+    // hashed.
+    std::vector<std::pair<std::string, std::string>> key_values;
+  };
+  const auto hash_range = [&](std::size_t begin) {
+    auto result = RangeResult{};
+    const auto end = std::min<std::size_t>(begin + range_size, keys.size());
+    if (on_key_value) {
+      result.key_values.reserve(end - begin);
+      result.hash = hashKeyRange(
+          keys, begin, end, value_converter, [&result](const std::string& key, const std::string& value) {
+            result.key_values.emplace_back(key, value);
+          });
+    } else {
+      result.hash = hashKeyRange(keys, begin, end, value_converter, nullptr);
+    }
+    return result;
+  };
+
+  // Bound the number of ranges in flight so that at most that many ranges of key values are held in memory.
+  const auto max_ranges_in_flight = 2 * static_cast<std::size_t>(num_threads);
+  auto thread_pool = concord::util::ThreadPool{num_threads};
+  auto ranges = std::deque<std::future<RangeResult>>{};
+  // Wait for the ranges in flight before the thread pool is destroyed in case of an exception.
+  auto wait_ranges = concord::util::ScopeExit{[&ranges]() {
+    for (auto& range : ranges) {
+      if (range.valid()) {
+        range.wait();
+      }
+    }
+  }};
+  auto next_range_begin = std::size_t{0};
+  const auto submit_ranges = [&]() {
+    while (next_range_begin < keys.size() && ranges.size() < max_ranges_in_flight) {
+      ranges.push_back(thread_pool.async(hash_range, next_range_begin));
+      next_range_begin += range_size;
+    }
+  };
+
+  submit_ranges();
+  while (!ranges.empty()) {
+    const auto result = ranges.front().get();
+    ranges.pop_front();
+    submit_ranges();
+    hasher.update(result.hash.data(), result.hash.size());
+    for (const auto& [key, value] : result.key_values) {
+      on_key_value(key, value);
+    }
+  }
+  return hasher.finish();
+}
+
+void KVBCStateSnapshot::persistPublicStateHash(BlockId checkpoint_block_id,
+                                               const concord::kvbc::categorization::Hash& hash) {
+  native_client_->put(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey(),
+                      concord::kvbc::categorization::detail::serialize(
+                          concord::kvbc::categorization::StateHash{checkpoint_block_id, hash}));
+}
+
 bool KVBCStateSnapshot::iteratePublicStateKeyValuesImpl(const std::function<void(std::string&&, std::string&&)>& f,
                                                         const std::optional<std::string>& after_key) const {
   const auto public_state = getPublicStateKeys();
@@ -80,19 +205,28 @@ bool KVBCStateSnapshot::iteratePublicStateKeyValuesImpl(const std::function<void
     idx = std::distance(public_state->keys.cbegin(), it) + 1;
   }
 
+  iterateKeyValues(public_state->keys, idx, public_state->keys.size(), f);
+  return true;
+}
+
+void KVBCStateSnapshot::iterateKeyValues(const std::vector<std::string>& keys,
+                                         std::size_t begin,
+                                         std::size_t end,
+                                         const std::function<void(std::string&&, std::string&&)>& f) const {
+  auto idx = begin;
   const auto batch_size = bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize;
   auto keys_batch = std::vector<std::string>{};
   keys_batch.reserve(batch_size);
   auto opt_values = std::vector<std::optional<concord::kvbc::categorization::Value>>{};
   opt_values.reserve(batch_size);
-  while (idx < public_state->keys.size()) {
+  while (idx < end) {
     keys_batch.clear();
     opt_values.clear();
     while (keys_batch.size() < batch_size) {
-      if (idx == public_state->keys.size()) {
+      if (idx == end) {
         break;
       }
-      keys_batch.push_back(public_state->keys[idx]);
+      keys_batch.push_back(keys[idx]);
       ++idx;
     }
     reader_->multiGetLatest(concord::kvbc::categorization::kExecutionProvableCategory, keys_batch, opt_values);
@@ -105,7 +239,6 @@ bool KVBCStateSnapshot::iteratePublicStateKeyValuesImpl(const std::function<void
       f(std::move(keys_batch[i]), std::move(value->data));
     }
   }
-  return true;
 }
 
 }  // namespace concord::kvbc::adapter::common::statesnapshot
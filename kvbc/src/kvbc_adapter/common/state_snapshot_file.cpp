@@ -0,0 +1,328 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the sub-component's license, as noted in the
+// LICENSE file.
+
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
+
+#include <fcntl.h>
+#include <lz4.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "assertUtils.hpp"
+#include "endianness.hpp"
+
+namespace concord::kvbc::adapter::common::statesnapshot {
+
+namespace {
+
+constexpr auto kMagic = std::uint64_t{0x636f6e636f726473};  // "concords"
+constexpr auto kFormatVersion = std::uint32_t{1};
+constexpr auto kHashSize = std::tuple_size_v<categorization::Hash>;
+constexpr auto kFooterSize = sizeof(std::uint64_t) + sizeof(std::uint32_t) + sizeof(BlockId) + kHashSize +
+                             3 * sizeof(std::uint64_t);
+
+template <typename T>
+void append(std::string& out, T v) {
+  const auto buf = concordUtils::toBigEndianArrayBuffer(v);
+  out.append(reinterpret_cast<const char*>(buf.data()), buf.size());
+}
+
+void appendSized(std::string& out, std::string_view data) {
+  append(out, static_cast<std::uint32_t>(data.size()));
+  out.append(data.data(), data.size());
+}
+
+// Reads the integers and sized strings of a buffer, throwing if it ends before them.
+class Reader {
+ public:
+  Reader(const char* data, std::size_t size, const std::string& path) : data_{data}, size_{size}, path_{path} {}
+
+  template <typename T>
+  T read() {
+    check(sizeof(T));
+    const auto v = concordUtils::fromBigEndianBuffer<T>(data_ + pos_);
+    pos_ += sizeof(T);
+    return v;
+  }
+
+  std::string_view readSized() {
+    const auto size = read<std::uint32_t>();
+    return readBytes(size);
+  }
+
+  std::string_view readBytes(std::size_t size) {
+    check(size);
+    const auto bytes = std::string_view{data_ + pos_, size};
+    pos_ += size;
+    return bytes;
+  }
+
+  bool done() const { return pos_ == size_; }
+
+ private:
+  void check(std::size_t size) const {
+    if (size > size_ - pos_) {
+      throw std::runtime_error{"State snapshot file " + path_ + " is truncated"};
+    }
+  }
+
+  const char* data_;
+  const std::size_t size_;
+  const std::string& path_;
+  std::size_t pos_{0};
+};
+
+}  // namespace
+
+StateSnapshotFile::Writer::Writer(const std::string& path, std::size_t block_size)
+    : path_{path},
+      tmp_path_{path + ".tmp"},
+      block_size_{block_size},
+      out_{tmp_path_, std::ios::binary | std::ios::trunc} {
+  ConcordAssertGT(block_size_, 0);
+  if (!out_) {
+    throw std::runtime_error{"Failed to create state snapshot file " + tmp_path_};
+  }
+  block_.reserve(block_size_);
+}
+
+StateSnapshotFile::Writer::~Writer() {
+  if (!finished_) {
+    out_.close();
+    std::remove(tmp_path_.c_str());
+  }
+}
+
+void StateSnapshotFile::Writer::add(const std::string& key, const std::string& value) {
+  ConcordAssert(!finished_);
+  ConcordAssert(num_key_values_ == 0 || last_key_ < key);
+  if (block_.empty()) {
+    first_key_ = key;
+  }
+  appendSized(block_, key);
+  appendSized(block_, value);
+  last_key_ = key;
+  ++num_key_values_;
+  if (block_.size() >= block_size_) {
+    writeBlock();
+  }
+}
+
+void StateSnapshotFile::Writer::writeBlock() {
+  ConcordAssertLE(block_.size(), static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE));
+  compressed_block_.resize(LZ4_compressBound(static_cast<int>(block_.size())));
+  const auto compressed_size = LZ4_compress_default(block_.data(),
+                                                    compressed_block_.data(),
+                                                    static_cast<int>(block_.size()),
+                                                    static_cast<int>(compressed_block_.size()));
+  ConcordAssertGT(compressed_size, 0);
+  write(compressed_block_.data(), compressed_size);
+
+  appendSized(index_, first_key_);
+  append(index_, offset_);
+  append(index_, static_cast<std::uint32_t>(compressed_size));
+  append(index_, static_cast<std::uint32_t>(block_.size()));
+  offset_ += compressed_size;
+  ++num_blocks_;
+  block_.clear();
+}
+
+void StateSnapshotFile::Writer::write(const char* data, std::size_t size) {
+  out_.write(data, size);
+  if (!out_) {
+    throw std::runtime_error{"Failed to write state snapshot file " + tmp_path_};
+  }
+}
+
+void StateSnapshotFile::Writer::finish(BlockId checkpoint_block_id, const categorization::Hash& public_state_hash) {
+  ConcordAssert(!finished_);
+  if (!block_.empty()) {
+    writeBlock();
+  }
+  const auto index_offset = offset_;
+  write(index_.data(), index_.size());
+
+  auto footer = std::string{};
+  footer.reserve(kFooterSize);
+  append(footer, kMagic);
+  append(footer, kFormatVersion);
+  append(footer, checkpoint_block_id);
+  footer.append(reinterpret_cast<const char*>(public_state_hash.data()), public_state_hash.size());
+  append(footer, num_key_values_);
+  append(footer, num_blocks_);
+  append(footer, index_offset);
+  write(footer.data(), footer.size());
+
+  out_.close();
+  if (!out_) {
+    throw std::runtime_error{"Failed to close state snapshot file " + tmp_path_};
+  }
+  if (std::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+    throw std::runtime_error{"Failed to rename state snapshot file " + tmp_path_ + " to " + path_ +
+                             ", error = " + std::strerror(errno)};
+  }
+  finished_ = true;
+}
+
+std::string StateSnapshotFile::pathIn(const std::string& snapshot_dir) {
+  return snapshot_dir + "/public_state.snapshot";
+}
+
+StateSnapshotFile::StateSnapshotFile(const std::string& path) : path_{path} {
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error{"Failed to open state snapshot file " + path + ", error = " + std::strerror(errno)};
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kFooterSize)) {
+    ::close(fd);
+    throw std::runtime_error{"Invalid state snapshot file " + path};
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  auto addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error{"Failed to map state snapshot file " + path + ", error = " + std::strerror(errno)};
+  }
+  data_ = static_cast<const char*>(addr);
+
+  try {
+    auto footer = Reader{data_ + size_ - kFooterSize, kFooterSize, path_};
+    if (footer.read<std::uint64_t>() != kMagic) {
+      throw std::runtime_error{"Invalid state snapshot file " + path_};
+    }
+    const auto version = footer.read<std::uint32_t>();
+    if (version != kFormatVersion) {
+      throw std::runtime_error{"Unsupported state snapshot file " + path_ + " version " + std::to_string(version)};
+    }
+    checkpoint_block_id_ = footer.read<BlockId>();
+    const auto hash = footer.readBytes(kHashSize);
+    std::copy(hash.cbegin(), hash.cend(), public_state_hash_.begin());
+    num_key_values_ = footer.read<std::uint64_t>();
+    const auto num_blocks = footer.read<std::uint64_t>();
+    const auto index_offset = footer.read<std::uint64_t>();
+
+    const auto index_end = size_ - kFooterSize;
+    if (index_offset > index_end) {
+      throw std::runtime_error{"Invalid state snapshot file " + path_ + " index offset"};
+    }
+    auto index = Reader{data_ + index_offset, index_end - index_offset, path_};
+    index_.reserve(num_blocks);
+    for (auto i = std::uint64_t{0}; i < num_blocks; ++i) {
+      auto& block = index_.emplace_back();
+      block.first_key = index.readSized();
+      block.offset = index.read<std::uint64_t>();
+      block.compressed_size = index.read<std::uint32_t>();
+      block.size = index.read<std::uint32_t>();
+      if (block.offset + block.compressed_size > index_offset) {
+        throw std::runtime_error{"Invalid state snapshot file " + path_ + " block " + std::to_string(i)};
+      }
+    }
+    if (!index.done()) {
+      throw std::runtime_error{"Invalid state snapshot file " + path_ + " index"};
+    }
+  } catch (...) {
+    ::munmap(const_cast<char*>(data_), size_);
+    throw;
+  }
+}
+
+StateSnapshotFile::~StateSnapshotFile() { ::munmap(const_cast<char*>(data_), size_); }
+
+std::optional<std::size_t> StateSnapshotFile::blockOf(const std::string& key) const {
+  auto it = std::upper_bound(
+      index_.cbegin(), index_.cend(), key, [](const std::string& k, const BlockHandle& b) { return k < b.first_key; });
+  if (it == index_.cbegin()) {
+    return std::nullopt;
+  }
+  return std::distance(index_.cbegin(), it) - 1;
+}
+
+void StateSnapshotFile::readBlock(std::size_t block, std::string& buffer, std::vector<Entry>& entries) const {
+  const auto& handle = index_[block];
+  buffer.resize(handle.size);
+  const auto size = LZ4_decompress_safe(data_ + handle.offset,
+                                        buffer.data(),
+                                        static_cast<int>(handle.compressed_size),
+                                        static_cast<int>(handle.size));
+  if (size < 0 || static_cast<std::uint32_t>(size) != handle.size) {
+    throw std::runtime_error{"Corrupted state snapshot file " + path_ + " block " + std::to_string(block)};
+  }
+  entries.clear();
+  auto reader = Reader{buffer.data(), buffer.size(), path_};
+  while (!reader.done()) {
+    auto& entry = entries.emplace_back();
+    entry.key = reader.readSized();
+    entry.value = reader.readSized();
+  }
+}
+
+std::optional<std::string> StateSnapshotFile::get(const std::string& key) const {
+  const auto block = blockOf(key);
+  if (!block) {
+    return std::nullopt;
+  }
+  auto buffer = std::string{};
+  auto entries = std::vector<Entry>{};
+  readBlock(*block, buffer, entries);
+  auto it = std::lower_bound(
+      entries.cbegin(), entries.cend(), key, [](const Entry& e, const std::string& k) { return e.key < k; });
+  if (it == entries.cend() || it->key != key) {
+    return std::nullopt;
+  }
+  return std::string{it->value};
+}
+
+void StateSnapshotFile::iterate(const std::function<void(std::string&&, std::string&&)>& f) const {
+  iterateFrom(0, 0, f);
+}
+
+bool StateSnapshotFile::iterate(const std::function<void(std::string&&, std::string&&)>& f,
+                                const std::string& after_key) const {
+  const auto block = blockOf(after_key);
+  if (!block) {
+    return false;
+  }
+  auto buffer = std::string{};
+  auto entries = std::vector<Entry>{};
+  readBlock(*block, buffer, entries);
+  auto it = std::lower_bound(
+      entries.cbegin(), entries.cend(), after_key, [](const Entry& e, const std::string& k) { return e.key < k; });
+  if (it == entries.cend() || it->key != after_key) {
+    return false;
+  }
+  // Start from the key after `after_key`.
+  iterateFrom(*block, std::distance(entries.cbegin(), it) + 1, f);
+  return true;
+}
+
+void StateSnapshotFile::iterateFrom(std::size_t block,
+                                    std::size_t entry,
+                                    const std::function<void(std::string&&, std::string&&)>& f) const {
+  auto buffer = std::string{};
+  auto entries = std::vector<Entry>{};
+  for (; block < index_.size(); ++block, entry = 0) {
+    readBlock(block, buffer, entries);
+    for (; entry < entries.size(); ++entry) {
+      f(std::string{entries[entry].key}, std::string{entries[entry].value});
+    }
+  }
+}
+
+}  // namespace concord::kvbc::adapter::common::statesnapshot
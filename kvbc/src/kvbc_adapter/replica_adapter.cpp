@@ -86,6 +86,8 @@ ReplicaBlockchain::ReplicaBlockchain(
     if (aux_types.has_value()) {
       v4_kvbc_->setAggregator(aux_types->aggregator_);
     }
+    v4_kvbc_->setGroupCommit(bftEngine::ReplicaConfig::instance().v4GroupCommitMaxBlocks,
+                             bftEngine::ReplicaConfig::instance().v4GroupCommitMaxBytes);
     up_deleter_ = std::make_unique<concord::kvbc::adapter::v4blockchain::BlocksDeleterAdapter>(v4_kvbc_);
     up_reader_ = std::make_unique<concord::kvbc::adapter::v4blockchain::BlocksReaderAdapter>(v4_kvbc_);
     up_adder_ = std::make_unique<concord::kvbc::adapter::v4blockchain::BlocksAdderAdapter>(v4_kvbc_);
@@ -17,9 +17,12 @@
 
 #include <boost/detail/endian.hpp>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <exception>
+#include <future>
 #include <optional>
 #include <sstream>
 #include "Logger.hpp"
@@ -28,6 +31,7 @@
 #include "kv_types.hpp"
 #include "kvbc_app_filter/kvbc_key_types.h"
 #include "openssl_crypto.hpp"
+#include "scope_exit.hpp"
 
 using namespace std::chrono_literals;
 
@@ -48,6 +52,100 @@ using concord::util::openssl_utils::kExpectedSHA256HashLengthInBytes;
 namespace concord {
 namespace kvbc {
 
+namespace {
+
+// Call `read(id)` on the pool for the IDs returned by `next_id()` (until it returns std::nullopt), and pass the IDs and
+// the results to `consume(id, result)` in order. Up to `depth` reads are kept in flight: a read is scheduled whenever a
+// result is consumed. Stop early if `consume` returns false. An exception thrown by `read` is rethrown when its result
+// would have been consumed.
+template <typename T, typename IdT, typename NextIdFn, typename ReadFn, typename ConsumeFn>
+void readAheadInOrder(
+    util::ThreadPool &pool, size_t depth, const NextIdFn &next_id, const ReadFn &read, const ConsumeFn &consume) {
+  std::deque<std::pair<IdT, std::future<T>>> pending;
+  // The reads in flight use the caller's state
+  auto wait_pending = util::ScopeExit{[&pending]() {
+    for (auto &[id, result] : pending) {
+      (void)id;  // unused variable hack
+      // The front result is invalid if getting it threw
+      if (result.valid()) result.wait();
+    }
+  }};
+  auto has_next = true;
+  auto schedule = [&]() {
+    while (has_next && pending.size() < depth) {
+      std::optional<IdT> id = next_id();
+      has_next = id.has_value();
+      if (has_next) pending.emplace_back(*id, pool.async(read, *id));
+    }
+  };
+  schedule();
+  while (!pending.empty()) {
+    auto id = pending.front().first;
+    auto result = pending.front().second.get();
+    pending.pop_front();
+    if (!consume(id, std::move(result))) return;
+    schedule();
+  }
+}
+
+// Like readAheadInOrder(), but the reads are started in batches: whenever no more than half of the `depth` reads are in
+// flight, a single `fetch(ids)` is started on the pool for the IDs that fill the window up, and then `read(id, fetched,
+// i)` is called on the pool for the i-th of these IDs once the fetch completed. An exception thrown by `fetch` is
+// rethrown when the result of the first ID of its batch would have been consumed.
+template <typename T, typename IdT, typename NextIdFn, typename FetchFn, typename ReadFn, typename ConsumeFn>
+void readAheadBatchesInOrder(util::ThreadPool &pool,
+                             size_t depth,
+                             const NextIdFn &next_id,
+                             const FetchFn &fetch,
+                             const ReadFn &read,
+                             const ConsumeFn &consume) {
+  std::deque<std::pair<IdT, std::future<T>>> pending;
+  // The reads in flight use the caller's state, and each of them waits for the fetch of its batch
+  auto wait_pending = util::ScopeExit{[&pending]() {
+    for (auto &[id, result] : pending) {
+      (void)id;  // unused variable hack
+      // The front result is invalid if getting it threw
+      if (result.valid()) result.wait();
+    }
+  }};
+  auto has_next = true;
+  auto schedule = [&]() {
+    if (pending.size() > depth / 2) return;
+    auto ids = std::vector<IdT>{};
+    while (has_next && pending.size() + ids.size() < depth) {
+      std::optional<IdT> id = next_id();
+      has_next = id.has_value();
+      if (has_next) ids.push_back(*id);
+    }
+    if (ids.empty()) return;
+    // The pool runs its tasks in FIFO order, so the fetch is running or done when a read waits for it
+    auto fetched = pool.async(fetch, ids).share();
+    for (size_t i = 0; i < ids.size(); ++i) {
+      pending.emplace_back(ids[i],
+                           pool.async([&read, fetched, i, id = ids[i]]() { return read(id, fetched.get(), i); }));
+    }
+  };
+  schedule();
+  while (!pending.empty()) {
+    auto id = pending.front().first;
+    auto result = pending.front().second.get();
+    pending.pop_front();
+    if (!consume(id, std::move(result))) return;
+    schedule();
+  }
+}
+
+}  // namespace
+
+void KvbAppFilter::setReadAhead(size_t depth, std::shared_ptr<util::ThreadPool> pool) {
+  read_ahead_depth_ = pool ? depth : 0;
+  read_ahead_pool_ = std::move(pool);
+}
+
+void KvbAppFilter::setRangeHashCheckpoints(std::shared_ptr<RangeHashCheckpoints> checkpoints) {
+  range_hash_checkpoints_ = std::move(checkpoints);
+}
+
 uint64_t KvbAppFilter::getOldestGlobalEventGroupId() const { return getValueFromLatestTable(kGlobalEgIdKeyOldest); }
 
 uint64_t KvbAppFilter::getNewestPublicEventGroupId() const { return getValueFromLatestTable(kPublicEgIdKeyNewest); }
@@ -270,7 +368,7 @@ void KvbAppFilter::readBlockRange(BlockId block_id_start,
 
   LOG_DEBUG(logger_, "readBlockRange block " << block_id << " to " << block_id_end);
 
-  for (; block_id <= block_id_end; ++block_id) {
+  auto read_block = [this](BlockId block_id) {
     std::string cid;
     auto events = getBlockEvents(block_id, cid);
     if (!events) {
@@ -278,7 +376,9 @@ void KvbAppFilter::readBlockRange(BlockId block_id_start,
       msg << "Couldn't retrieve block events for block id " << block_id;
       throw KvbReadError(msg.str());
     }
-    KvbFilteredUpdate update{block_id, cid, filterKeyValuePairs(*events)};
+    return KvbFilteredUpdate{block_id, cid, filterKeyValuePairs(*events)};
+  };
+  auto push_update = [&](KvbFilteredUpdate &&update) {
     while (!stop_execution) {
       if (queue_out.push(update)) {
         break;
@@ -286,8 +386,26 @@ void KvbAppFilter::readBlockRange(BlockId block_id_start,
     }
     if (stop_execution) {
       LOG_WARN(logger_, "readBlockRange was stopped");
-      break;
+      return false;
     }
+    return true;
+  };
+
+  if (read_ahead_depth_ > 0) {
+    // IReader has no batched read of block updates, and the event keys of a block aren't known before the block is
+    // read, so blocks can't be fetched with a multiGet() - they are read ahead with concurrent getBlockUpdates() calls.
+    auto next_block_id = [&]() -> std::optional<BlockId> {
+      if (block_id > block_id_end) return std::nullopt;
+      return block_id++;
+    };
+    readAheadInOrder<KvbFilteredUpdate, BlockId>(
+        *read_ahead_pool_, read_ahead_depth_, next_block_id, read_block, [&](BlockId, KvbFilteredUpdate &&update) {
+          return push_update(std::move(update));
+        });
+    return;
+  }
+  for (; block_id <= block_id_end; ++block_id) {
+    if (!push_update(read_block(block_id))) break;
   }
 }
 
@@ -458,11 +576,14 @@ void KvbAppFilter::readEventGroups(EventGroupId external_eg_id_start,
     throw InvalidEventGroupRange(external_eg_id_start, oldest_external_eg_id, newest_external_eg_id);
   }
 
-  auto [global_eg_id, is_previous_public, private_eg_id, public_eg_id] = findGlobalEventGroupId(external_eg_id_start);
+  // Not structured bindings, the lambda below captures them
+  const auto start = findGlobalEventGroupId(external_eg_id_start);
+  uint64_t global_eg_id = start.global_id;
+  bool is_previous_public = start.is_public;
   uint64_t ext_eg_id = external_eg_id_start;
 
-  uint64_t next_pvt_eg_id = private_eg_id + 1;
-  uint64_t next_pub_eg_id = public_eg_id + 1;
+  uint64_t next_pvt_eg_id = start.private_id + 1;
+  uint64_t next_pub_eg_id = start.public_id + 1;
 
   // The next public or private event group might not exist or got pruned
   // In this case, set to max so that the comparison will be lost later
@@ -481,19 +602,9 @@ void KvbAppFilter::readEventGroups(EventGroupId external_eg_id_start,
     pub_global_id = std::numeric_limits<uint64_t>::max();
   }
 
-  while (ext_eg_id <= newest_external_eg_id) {
-    // Get events and filter
-    auto event_group = getEventGroup(global_eg_id);
-    if (event_group.events.empty()) {
-      std::stringstream msg;
-      msg << "EventGroup empty/doesn't exist for global event group " << global_eg_id;
-      throw KvbReadError(msg.str());
-    }
-    KvbFilteredEventGroupUpdate update{ext_eg_id, filterEventsInEventGroup(global_eg_id, event_group)};
-
-    // Process update and stop producing more updates if anything goes wrong
-    if (not process_update(std::move(update))) break;
-    if (ext_eg_id == newest_external_eg_id) break;
+  // Move to the event group following {ext_eg_id, global_eg_id}. Return false if there is none.
+  auto next_event_group = [&]() {
+    if (ext_eg_id == newest_external_eg_id) return false;
 
     // Update next public or private ids; Only one needs to be udpated
     if (is_previous_public) {
@@ -512,7 +623,7 @@ void KvbAppFilter::readEventGroups(EventGroupId external_eg_id_start,
 
     // No need to continue if both next counters point into the future
     if (pvt_global_id == std::numeric_limits<uint64_t>::max() && pub_global_id == std::numeric_limits<uint64_t>::max())
-      break;
+      return false;
 
     // The lesser global event group id is the next update for the client
     if (pvt_global_id < pub_global_id) {
@@ -526,8 +637,65 @@ void KvbAppFilter::readEventGroups(EventGroupId external_eg_id_start,
       next_pub_eg_id++;
     }
     ext_eg_id += 1;
+    return true;
+  };
+
+  // Filter the events
+  auto filter = [this](uint64_t ext_eg_id, uint64_t global_eg_id, const kvbc::categorization::EventGroup &event_group) {
+    if (event_group.events.empty()) {
+      std::stringstream msg;
+      msg << "EventGroup empty/doesn't exist for global event group " << global_eg_id;
+      throw KvbReadError(msg.str());
+    }
+    return KvbFilteredEventGroupUpdate{ext_eg_id, filterEventsInEventGroup(global_eg_id, event_group)};
+  };
+
+  if (read_ahead_depth_ == 0) {
+    while (true) {
+      // Get events, filter, process update and stop producing more updates if anything goes wrong
+      if (not process_update(filter(ext_eg_id, global_eg_id, getEventGroup(global_eg_id)))) break;
+      if (not next_event_group()) break;
+    }
+    setLastEgIdsRead(ext_eg_id, global_eg_id);
+    return;
   }
-  setLastEgIdsRead(ext_eg_id, global_eg_id);
+
+  // {external id, global id} of the last event group passed to process_update()
+  auto last_read = std::make_pair(ext_eg_id, global_eg_id);
+  auto is_first = true;
+  auto next_ids = [&]() -> std::optional<std::pair<uint64_t, uint64_t>> {
+    if (not is_first && not next_event_group()) return std::nullopt;
+    is_first = false;
+    return std::make_pair(ext_eg_id, global_eg_id);
+  };
+  // Get the events of a batch of {external id, global id} event groups at once
+  using Values = std::vector<std::optional<kvbc::categorization::Value>>;
+  auto fetch = [this](const std::vector<std::pair<uint64_t, uint64_t>> &batch) {
+    std::vector<std::string> keys;
+    keys.reserve(batch.size());
+    for (const auto &ids : batch) {
+      keys.push_back(concordUtils::toBigEndianStringBuffer(ids.second));
+    }
+    Values values;
+    rostorage_->multiGetLatest(concord::kvbc::categorization::kExecutionEventGroupDataCategory, keys, values);
+    ConcordAssertEQ(values.size(), batch.size());
+    return values;
+  };
+  auto read_event_group = [&](const std::pair<uint64_t, uint64_t> &ids, const Values &values, size_t i) {
+    const auto [ext_eg_id, global_eg_id] = ids;
+    return filter(ext_eg_id, global_eg_id, toEventGroup(global_eg_id, values[i]));
+  };
+  readAheadBatchesInOrder<KvbFilteredEventGroupUpdate, std::pair<uint64_t, uint64_t>>(
+      *read_ahead_pool_,
+      read_ahead_depth_,
+      next_ids,
+      fetch,
+      read_event_group,
+      [&](const std::pair<uint64_t, uint64_t> &ids, KvbFilteredEventGroupUpdate &&update) {
+        last_read = ids;
+        return process_update(std::move(update));
+      });
+  setLastEgIdsRead(last_read.first, last_read.second);
 }
 
 void KvbAppFilter::readEventGroupRange(EventGroupId external_eg_id_start,
@@ -596,11 +764,23 @@ string KvbAppFilter::readBlockRangeHash(BlockId block_id_start, BlockId block_id
     throw InvalidBlockRange(block_id_start, block_id_end);
   }
   BlockId block_id(block_id_start);
+  const auto stream = RangeHashCheckpoints::Stream::kBlocks;
+
+  // A pruned range is not hashed from a checkpoint, it fails to read its first block instead
+  std::optional<std::pair<uint64_t, util::SHA2_256>> checkpoint;
+  if (range_hash_checkpoints_ && block_id_start >= rostorage_->getGenesisBlockId()) {
+    checkpoint = range_hash_checkpoints_->closest(client_id_, stream, block_id_start, block_id_end);
+  }
+  // The SHA-256 of the concatenated update hashes absorbed so far
+  auto running_hash = checkpoint ? std::move(checkpoint->second) : util::SHA2_256{};
+  if (checkpoint) {
+    block_id = checkpoint->first + 1;
+  } else {
+    running_hash.init();
+  }
 
   LOG_DEBUG(logger_, "readBlockRangeHash block " << block_id << " to " << block_id_end);
 
-  string concatenated_update_hashes;
-  concatenated_update_hashes.reserve((1 + block_id_end - block_id) * kExpectedSHA256HashLengthInBytes);
   for (; block_id <= block_id_end; ++block_id) {
     std::string cid;
     auto events = getBlockEvents(block_id, cid);
@@ -610,21 +790,49 @@ string KvbAppFilter::readBlockRangeHash(BlockId block_id_start, BlockId block_id
       throw KvbReadError(msg.str());
     }
     KvbFilteredUpdate filtered_update{block_id, cid, filterKeyValuePairs(*events)};
-    concatenated_update_hashes.append(hashUpdate(filtered_update));
+    const auto update_hash = hashUpdate(filtered_update);
+    running_hash.update(update_hash.data(), update_hash.size());
+    if (range_hash_checkpoints_ &&
+        (block_id == block_id_end || range_hash_checkpoints_->isDue(block_id_start, block_id))) {
+      range_hash_checkpoints_->add(client_id_, stream, block_id_start, block_id, running_hash);
+    }
   }
-  return computeSHA256Hash(concatenated_update_hashes);
+  const auto digest = running_hash.finish();
+  return string(digest.begin(), digest.end());
 }
 
 string KvbAppFilter::readEventGroupRangeHash(EventGroupId external_eg_id_start) {
   auto external_eg_id_end = newestExternalEventGroupId();
-  string concatenated_hashes;
-  concatenated_hashes.reserve((1 + external_eg_id_end - external_eg_id_start) * kExpectedSHA256HashLengthInBytes);
+  const auto stream = RangeHashCheckpoints::Stream::kEventGroups;
+
+  // A pruned range is not hashed from a checkpoint, readEventGroups() rejects it instead
+  std::optional<std::pair<uint64_t, util::SHA2_256>> checkpoint;
+  if (range_hash_checkpoints_) {
+    const auto oldest_external_eg_id = oldestExternalEventGroupId();
+    if (oldest_external_eg_id && external_eg_id_start >= oldest_external_eg_id) {
+      checkpoint = range_hash_checkpoints_->closest(client_id_, stream, external_eg_id_start, external_eg_id_end);
+    }
+  }
+  // The SHA-256 of the concatenated update hashes absorbed so far
+  auto running_hash = checkpoint ? std::move(checkpoint->second) : util::SHA2_256{};
+  if (not checkpoint) running_hash.init();
+
   auto process = [&](KvbFilteredEventGroupUpdate &&update) {
-    concatenated_hashes.append(hashEventGroupUpdate(update));
+    const auto update_hash = hashEventGroupUpdate(update);
+    running_hash.update(update_hash.data(), update_hash.size());
+    if (range_hash_checkpoints_ && (update.event_group_id == external_eg_id_end ||
+                                    range_hash_checkpoints_->isDue(external_eg_id_start, update.event_group_id))) {
+      range_hash_checkpoints_->add(client_id_, stream, external_eg_id_start, update.event_group_id, running_hash);
+    }
     return true;
   };
-  readEventGroups(external_eg_id_start, process);
-  return computeSHA256Hash(concatenated_hashes);
+  if (not checkpoint) {
+    readEventGroups(external_eg_id_start, process);
+  } else if (checkpoint->first < external_eg_id_end) {
+    readEventGroups(checkpoint->first + 1, process);
+  }
+  const auto digest = running_hash.finish();
+  return string(digest.begin(), digest.end());
 }
 
 std::optional<kvbc::categorization::ImmutableInput> KvbAppFilter::getBlockEvents(kvbc::BlockId block_id,
@@ -662,6 +870,11 @@ kvbc::categorization::EventGroup KvbAppFilter::getEventGroup(kvbc::EventGroupId
   // get event group
   const auto opt = rostorage_->getLatest(concord::kvbc::categorization::kExecutionEventGroupDataCategory,
                                          concordUtils::toBigEndianStringBuffer(global_event_group_id));
+  return toEventGroup(global_event_group_id, opt);
+}
+
+kvbc::categorization::EventGroup KvbAppFilter::toEventGroup(
+    kvbc::EventGroupId global_event_group_id, const std::optional<kvbc::categorization::Value> &opt) const {
   if (not opt) {
     stringstream msg;
     msg << "Failed to get global event group " << global_event_group_id;
@@ -0,0 +1,77 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "kvbc_app_filter/range_hash_checkpoints.h"
+
+#include "assertUtils.hpp"
+
+namespace concord {
+namespace kvbc {
+
+RangeHashCheckpoints::RangeHashCheckpoints(uint64_t interval, size_t max_checkpoints, size_t max_ranges)
+    : interval_{interval}, max_checkpoints_{max_checkpoints}, max_ranges_{max_ranges} {
+  ConcordAssertGT(interval, 0);
+  ConcordAssertGT(max_checkpoints, 0);
+  ConcordAssertGT(max_ranges, 0);
+}
+
+std::optional<std::pair<uint64_t, util::SHA2_256>> RangeHashCheckpoints::closest(const std::string& client_id,
+                                                                                  Stream stream,
+                                                                                  uint64_t first,
+                                                                                  uint64_t last) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = checkpoints_.find(Key{client_id, stream, first});
+  if (range == checkpoints_.end()) return std::nullopt;
+  lru_.splice(lru_.begin(), lru_, range->second.lru_position);
+  const auto& checkpoints = range->second.checkpoints;
+  auto it = checkpoints.upper_bound(last);
+  if (it == checkpoints.begin()) return std::nullopt;
+  --it;
+  return std::make_pair(it->first, it->second.clone());
+}
+
+void RangeHashCheckpoints::add(
+    const std::string& client_id, Stream stream, uint64_t first, uint64_t last, const util::SHA2_256& running_hash) {
+  ConcordAssertLE(first, last);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto key = Key{client_id, stream, first};
+  auto range = checkpoints_.find(key);
+  if (range == checkpoints_.end()) {
+    if (checkpoints_.size() == max_ranges_) {
+      checkpoints_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(key);
+    range = checkpoints_.emplace(std::move(key), Range{{}, lru_.begin()}).first;
+  } else {
+    lru_.splice(lru_.begin(), lru_, range->second.lru_position);
+  }
+  auto& checkpoints = range->second.checkpoints;
+  if (checkpoints.find(last) != checkpoints.end()) return;
+  checkpoints.emplace(last, running_hash.clone());
+  if (checkpoints.size() > max_checkpoints_) {
+    checkpoints.erase(checkpoints.begin());
+  }
+}
+
+size_t RangeHashCheckpoints::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto size = size_t{0};
+  for (const auto& range : checkpoints_) {
+    size += range.second.checkpoints.size();
+  }
+  return size;
+}
+
+}  // namespace kvbc
+}  // namespace concord
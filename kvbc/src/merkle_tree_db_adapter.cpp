@@ -135,7 +135,9 @@ std::pair<ContainerT, ContainerT> splitToProvableAndNonProvable(const ContainerT
 DBAdapter::DBAdapter(const std::shared_ptr<IDBClient> &db,
                      bool linkTempSTChain,
                      const NonProvableKeySet &nonProvableKeySet,
-                     const std::shared_ptr<concord::performance::PerformanceManager> &pm)
+                     const std::shared_ptr<concord::performance::PerformanceManager> &pm,
+                     const std::shared_ptr<concord::util::ThreadPool> &merkleUpdateThreadPool,
+                     const std::shared_ptr<sparse_merkle::InternalNodeCache> &merkleNodeCache)
     : logger_{logging::getLogger("concord.kvbc.v2MerkleTree.DBAdapter")},
       // The smTree_ member needs an initialized DB. Therefore, do that in the initializer list before constructing
       // smTree_ .
@@ -143,7 +145,7 @@ DBAdapter::DBAdapter(const std::shared_ptr<IDBClient> &db,
       genesisBlockId_{loadGenesisBlockId()},
       lastReachableBlockId_{loadLastReachableBlockId()},
       latestSTTempBlockId_{loadLatestTempSTBlockId()},
-      smTree_{std::make_shared<Reader>(*this)},
+      smTree_{std::make_shared<Reader>(*this), merkleUpdateThreadPool, merkleNodeCache},
       nonProvableKeySet_{nonProvableKeySet},
       pm_{pm} {
   if (!nonProvableKeySet_.empty()) {
@@ -469,14 +471,14 @@ BatchedInternalNode DBAdapter::Reader::get_internal(const InternalNodeKey &key)
   Sliver res;
   auto status = concordUtils::Status::OK();
   {
-    TimeRecorder scoped_timer(*histograms.dba_get_internal);
+    TimeRecorder<true> scoped_timer(*histograms.dba_get_internal);
     status = adapter_.getDb()->get(DBKeyManipulator::genInternalDbKey(key), res);
   }
   if (!status.isOK()) {
     throw std::runtime_error{"Failed to get the requested merkle tree internal node"};
   }
   {
-    TimeRecorder scoped_timer(*histograms.dba_deserialize_internal);
+    TimeRecorder<true> scoped_timer(*histograms.dba_deserialize_internal);
     return deserialize<BatchedInternalNode>(res);
   }
 }
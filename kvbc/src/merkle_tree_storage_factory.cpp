@@ -13,6 +13,7 @@
 #include "merkle_tree_storage_factory.h"
 
 #include "merkle_tree_db_adapter.h"
+#include "ReplicaConfig.hpp"
 #include "memorydb/client.h"
 #include "storage/merkle_tree_key_manipulator.h"
 #include "rocksdb/client.h"
@@ -27,6 +28,15 @@
 #include <vector>
 
 namespace concord::kvbc::v2MerkleTree {
+
+namespace {
+// Return nullptr if numOfMerkleUpdateThreads is 0
+std::shared_ptr<util::ThreadPool> makeMerkleUpdateThreadPool() {
+  const auto threads = bftEngine::ReplicaConfig::instance().numOfMerkleUpdateThreads;
+  return threads > 0 ? std::make_shared<util::ThreadPool>(threads) : nullptr;
+}
+}  // namespace
+
 #ifdef USE_ROCKSDB
 
 std::shared_ptr<rocksdb::Statistics> completeRocksDBConfiguration(
@@ -85,7 +95,8 @@ IStorageFactory::DatabaseSet RocksDBStorageFactory::newDatabaseSet() const {
     ret.dataDBClient = db->asIDBClient();
   }
   ret.metadataDBClient = ret.dataDBClient;
-  ret.dbAdapter = std::make_unique<DBAdapter>(ret.dataDBClient, true, nonProvableKeySet_, pm_);
+  ret.dbAdapter =
+      std::make_unique<DBAdapter>(ret.dataDBClient, true, nonProvableKeySet_, pm_, makeMerkleUpdateThreadPool());
   return ret;
 }
 
@@ -103,7 +114,11 @@ IStorageFactory::DatabaseSet MemoryDBStorageFactory::newDatabaseSet() const {
   ret.dataDBClient = std::make_shared<storage::memorydb::Client>();
   ret.dataDBClient->init();
   ret.metadataDBClient = ret.dataDBClient;
-  ret.dbAdapter = std::make_unique<DBAdapter>(ret.dataDBClient);
+  ret.dbAdapter = std::make_unique<DBAdapter>(ret.dataDBClient,
+                                              true,
+                                              DBAdapter::NonProvableKeySet{},
+                                              std::make_shared<concord::performance::PerformanceManager>(),
+                                              makeMerkleUpdateThreadPool());
   return ret;
 }
 
@@ -28,6 +28,8 @@
 #include "categorized_kvbc_msgs.cmf.hpp"
 #include "metadata_block_id.h"
 #include "ReplicaResources.h"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
+#include "util/filesystem.hpp"
 #include <chrono>
 #include <algorithm>
 #include <memory>
@@ -38,6 +40,7 @@ using bftEngine::impl::DbCheckpointManager;
 using bftEngine::impl::SigManager;
 using concord::kvbc::KvbAppFilter;
 using concord::kvbc::adapter::IdempotentReader;
+using concord::kvbc::adapter::common::statesnapshot::StateSnapshotFile;
 using concord::messages::SnapshotResponseStatus;
 using concord::storage::rocksdb::NativeClient;
 
@@ -367,34 +370,48 @@ bool StateSnapshotReconfigurationHandler::handle(const concord::messages::StateS
       break;
     case DbCheckpointManager::CheckpointState::kCreated: {
       const auto snapshot_path = DbCheckpointManager::instance().getPathForCheckpoint(req.snapshot_id);
+      const auto export_file_path = StateSnapshotFile::pathIn(snapshot_path);
       const auto read_only = true;
       try {
-        auto db = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
-        const auto link_st_chain = false;
-        const auto kvbc = adapter::ReplicaBlockchain{db, link_st_chain};
-        const auto public_state = kvbc.getPublicStateKeys();
-        auto values = std::vector<std::optional<categorization::Value>>{};
-        kvbc.multiGetLatest(categorization::kExecutionProvableCategory, req.keys, values);
-        ConcordAssertEQ(req.keys.size(), values.size());
-        for (auto i = 0ull; i < req.keys.size(); ++i) {
-          auto& val = values[i];
-          const auto& key = req.keys[i];
-          if (!val) {
-            resp.values.push_back(std::nullopt);
-          } else {
-            auto merkle_val = std::get_if<categorization::MerkleValue>(&val.value());
-            ConcordAssertNE(merkle_val, nullptr);
-            // Make sure no non-public keys are requested.
-            // TODO: This will change when we start streaming non-public keys.
-            if (public_state) {
-              auto it = std::lower_bound(public_state->keys.cbegin(), public_state->keys.cend(), key);
-              if (it == public_state->keys.cend() || *it != key) {
-                resp.values.push_back(std::nullopt);
-              } else {
-                resp.values.push_back(state_value_converter_(std::move(merkle_val->data)));
-              }
+        if (fs::exists(export_file_path)) {
+          // The exported file holds the public keys only.
+          const auto snapshot_file = StateSnapshotFile{export_file_path};
+          for (const auto& key : req.keys) {
+            auto value = snapshot_file.get(key);
+            if (!value) {
+              resp.values.push_back(std::nullopt);
             } else {
+              resp.values.push_back(state_value_converter_(std::move(*value)));
+            }
+          }
+        } else {
+          auto db = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
+          const auto link_st_chain = false;
+          const auto kvbc = adapter::ReplicaBlockchain{db, link_st_chain};
+          const auto public_state = kvbc.getPublicStateKeys();
+          auto values = std::vector<std::optional<categorization::Value>>{};
+          kvbc.multiGetLatest(categorization::kExecutionProvableCategory, req.keys, values);
+          ConcordAssertEQ(req.keys.size(), values.size());
+          for (auto i = 0ull; i < req.keys.size(); ++i) {
+            auto& val = values[i];
+            const auto& key = req.keys[i];
+            if (!val) {
               resp.values.push_back(std::nullopt);
+            } else {
+              auto merkle_val = std::get_if<categorization::MerkleValue>(&val.value());
+              ConcordAssertNE(merkle_val, nullptr);
+              // Make sure no non-public keys are requested.
+              // TODO: This will change when we start streaming non-public keys.
+              if (public_state) {
+                auto it = std::lower_bound(public_state->keys.cbegin(), public_state->keys.cend(), key);
+                if (it == public_state->keys.cend() || *it != key) {
+                  resp.values.push_back(std::nullopt);
+                } else {
+                  resp.values.push_back(state_value_converter_(std::move(merkle_val->data)));
+                }
+              } else {
+                resp.values.push_back(std::nullopt);
+              }
             }
           }
         }
@@ -24,7 +24,7 @@ namespace sparse_merkle {
 using namespace detail;
 
 void BatchedInternalNode::updateHashes(size_t index, Version version) {
-  TimeRecorder scoped_timer(*histograms.internal_node_update_hashes);
+  TimeRecorder<true> scoped_timer(*histograms.internal_node_update_hashes);
   ConcordAssert(index > 0);
   auto hasher = Hasher();
 
@@ -58,7 +58,7 @@ void BatchedInternalNode::updateHashes(size_t index, Version version) {
 BatchedInternalNode::InsertResult BatchedInternalNode::insert(const LeafChild& child,
                                                               size_t depth,
                                                               Version current_version) {
-  TimeRecorder scoped_timer(*histograms.internal_node_insert);
+  TimeRecorder<true> scoped_timer(*histograms.internal_node_insert);
   // The index into the children_ array
   size_t index = 0;
   Nibble child_key = child.key.hash().getNibble(depth);
@@ -193,7 +193,7 @@ BatchedInternalNode::InsertResult BatchedInternalNode::insertTwoLeafChildren(
 }
 
 BatchedInternalNode::RemoveResult BatchedInternalNode::remove(const Hash& key, size_t depth, Version new_version) {
-  TimeRecorder scoped_timer(*histograms.internal_node_remove);
+  TimeRecorder<true> scoped_timer(*histograms.internal_node_remove);
   // The index into the children_ array
   size_t index = 0;
 
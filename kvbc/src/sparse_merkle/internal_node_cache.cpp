@@ -0,0 +1,146 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the sub-component's license, as noted in the
+// LICENSE file.
+
+#include "sparse_merkle/internal_node_cache.h"
+
+#include <functional>
+#include <iterator>
+#include <string_view>
+
+#include "assertUtils.hpp"
+
+namespace concord::kvbc::sparse_merkle {
+
+InternalNodeCache::InternalNodeCache(const std::string& name, size_t max_bytes, uint64_t max_version_age)
+    : max_shard_bytes_{max_bytes / kShards},
+      max_version_age_{max_version_age},
+      metrics_component_{"sparse_merkle_internal_node_cache_" + name, std::make_shared<concordMetrics::Aggregator>()},
+      hits_{metrics_component_.RegisterAtomicCounter("hits")},
+      misses_{metrics_component_.RegisterAtomicCounter("misses")},
+      evictions_{metrics_component_.RegisterAtomicCounter("evictions")},
+      num_nodes_{metrics_component_.RegisterGauge("num_nodes", 0)},
+      size_bytes_{metrics_component_.RegisterGauge("size_bytes", 0)} {
+  ConcordAssertGT(max_shard_bytes_, 0);
+  metrics_component_.Register();
+}
+
+size_t InternalNodeCache::KeyHash::operator()(const InternalNodeKey& key) const {
+  const auto& path = key.path().data();
+  const auto path_hash =
+      std::hash<std::string_view>{}(std::string_view{reinterpret_cast<const char*>(path.data()), path.size()});
+  return path_hash * 31 + std::hash<uint64_t>{}(key.version().value()) * 17 + key.path().length();
+}
+
+size_t InternalNodeCache::entryBytes(const InternalNodeKey& key) {
+  // The entry, its list node and its index node
+  constexpr auto kOverhead = 8 * sizeof(void*);
+  return sizeof(Entry) + kOverhead + key.path().data().size();
+}
+
+std::optional<BatchedInternalNode> InternalNodeCache::get(const InternalNodeKey& key) {
+  auto& shard = shardOf(key);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      it->second->last_used = version_.load();
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      hits_++;
+      return it->second->node;
+    }
+  }
+  misses_++;
+  return std::nullopt;
+}
+
+void InternalNodeCache::put(const InternalNodeKey& key, const BatchedInternalNode& node) {
+  auto& shard = shardOf(key);
+  const auto version = version_.load();
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    it->second->node = node;
+    it->second->last_used = version;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+  const auto bytes = entryBytes(key);
+  shard.lru.push_front(Entry{key, node, version, bytes});
+  shard.index.emplace(key, shard.lru.begin());
+  shard.bytes += bytes;
+  bytes_ += bytes;
+  size_++;
+  evict(shard, version);
+}
+
+void InternalNodeCache::advance(Version version) {
+  version_.store(version.value());
+  if (max_version_age_ == 0) return;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    evict(shard, version.value());
+  }
+}
+
+void InternalNodeCache::reset(Version version) {
+  if (version.value() >= version_.load()) {
+    version_.store(version.value());
+    return;
+  }
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+      auto next = std::next(it);
+      if (version < it->key.version()) {
+        erase(shard, it);
+      }
+      it = next;
+    }
+  }
+  version_.store(version.value());
+}
+
+void InternalNodeCache::evict(Shard& shard, uint64_t version) {
+  while (!shard.lru.empty()) {
+    auto& oldest = shard.lru.back();
+    const auto too_big = shard.bytes > max_shard_bytes_;
+    const auto too_old = max_version_age_ > 0 && oldest.last_used + max_version_age_ < version;
+    if (!too_big && !too_old) break;
+    erase(shard, std::prev(shard.lru.end()));
+    evictions_++;
+  }
+}
+
+void InternalNodeCache::erase(Shard& shard, Lru::iterator it) {
+  shard.bytes -= it->bytes;
+  bytes_ -= it->bytes;
+  size_--;
+  shard.index.erase(it->key);
+  shard.lru.erase(it);
+}
+
+void InternalNodeCache::updateAggregator() {
+  num_nodes_.Get().Set(size());
+  size_bytes_.Get().Set(bytes());
+  metrics_component_.UpdateAggregator();
+}
+
+BatchedInternalNode CachedDBReader::get_internal(const InternalNodeKey& key) const {
+  if (auto node = cache_->get(key)) {
+    return std::move(*node);
+  }
+  auto node = db_reader_->get_internal(key);
+  cache_->put(key, node);
+  return node;
+}
+
+}  // namespace concord::kvbc::sparse_merkle
@@ -13,8 +13,12 @@
 #include "sparse_merkle/histograms.h"
 #include "sparse_merkle/tree.h"
 #include "sparse_merkle/walker.h"
+#include "scope_exit.hpp"
 
+#include <array>
+#include <future>
 #include <iostream>
+#include <iterator>
 using namespace std;
 
 using namespace concordUtils;
@@ -24,7 +28,7 @@ namespace concord::kvbc::sparse_merkle {
 using namespace detail;
 
 void insertComplete(Walker& walker, const BatchedInternalNode::InsertComplete& result) {
-  histograms.insert_depth->record(walker.depth());
+  histograms.insert_depth->recordAtomic(walker.depth());
   walker.ascendToRoot(result.stale_leaf);
 }
 
@@ -48,7 +52,8 @@ void handleCollision(Walker& walker, const LeafChild& stored_child, const LeafCh
 // responses and walk the tree as appropriate to get to the correct node, where
 // the insert will succeed.
 void insert(Walker& walker, const LeafChild& child) {
-  TimeRecorder scoped_timer(*histograms.insert_key);
+  // Atomic, as inserts run on multiple threads in parallel updates
+  TimeRecorder<true> scoped_timer(*histograms.insert_key);
   while (true) {
     ConcordAssert(walker.depth() < Hash::MAX_NIBBLES);
 
@@ -93,14 +98,14 @@ void removeBatchedInternalNode(Walker& walker, const std::optional<LeafChild>& p
 }
 
 void remove(Walker& walker, const Hash& key_hash) {
-  TimeRecorder scoped_timer(*histograms.remove_key);
+  TimeRecorder<true> scoped_timer(*histograms.remove_key);
   while (true) {
     ConcordAssert(walker.depth() < Hash::MAX_NIBBLES);
 
     auto result = walker.currentNode().remove(key_hash, walker.depth(), walker.version());
 
     if (auto rv = std::get_if<BatchedInternalNode::RemoveComplete>(&result)) {
-      histograms.remove_depth->record(walker.depth());
+      histograms.remove_depth->recordAtomic(walker.depth());
       auto stale = LeafKey(key_hash, rv->version);
       return walker.ascendToRoot(stale);
     }
@@ -120,18 +125,26 @@ void remove(Walker& walker, const Hash& key_hash) {
   }
 }
 
+// The trees of different categories are updated on multiple threads in parallel, so all the recorders are atomic
 static void updateBatchHistograms(const UpdateBatch& batch) {
-  histograms.num_batch_internal_nodes->record(batch.internal_nodes.size());
-  histograms.num_batch_leaf_nodes->record(batch.leaf_nodes.size());
-  histograms.num_stale_internal_keys->record(batch.stale.internal_keys.size());
-  histograms.num_stale_leaf_keys->record(batch.stale.leaf_keys.size());
+  histograms.num_batch_internal_nodes->recordAtomic(batch.internal_nodes.size());
+  histograms.num_batch_leaf_nodes->recordAtomic(batch.leaf_nodes.size());
+  histograms.num_stale_internal_keys->recordAtomic(batch.stale.internal_keys.size());
+  histograms.num_stale_leaf_keys->recordAtomic(batch.stale.leaf_keys.size());
+}
+
+void Tree::reset() {
+  root_ = db_reader_->get_latest_root();
+  if (node_cache_) {
+    node_cache_->reset(root_.version());
+  }
 }
 
 UpdateBatch Tree::update(const concord::kvbc::SetOfKeyValuePairs& updates,
                          const concord::kvbc::KeysVector& deleted_keys) {
-  histograms.num_updated_keys->record(updates.size());
-  histograms.num_deleted_keys->record(deleted_keys.size());
-  TimeRecorder scoped_timer(*histograms.update);
+  histograms.num_updated_keys->recordAtomic(updates.size());
+  histograms.num_deleted_keys->recordAtomic(deleted_keys.size());
+  TimeRecorder<true> scoped_timer(*histograms.update);
   reset();
   UpdateCache cache(root_, db_reader_);
   return update_impl(updates, deleted_keys, cache);
@@ -160,20 +173,22 @@ UpdateBatch Tree::update_impl(const concord::kvbc::SetOfKeyValuePairs& updates,
     sparse_merkle::remove(walker, key_hash);
   }
 
+  const auto children = hashLeaves(updates, version);
+  auto child = children.cbegin();
   for (auto&& [key, val] : updates) {
-    histograms.key_size->record(key.length());
-    histograms.val_size->record(val.length());
-    Hash leaf_hash;
-    {
-      TimeRecorder scoped_timer(*histograms.hash_val);
-      leaf_hash = hasher.hash(val.data(), val.length());
+    histograms.key_size->recordAtomic(key.length());
+    histograms.val_size->recordAtomic(val.length());
+    batch.leaf_nodes.emplace_back(child->key, LeafNode{val});
+    ++child;
+  }
+
+  if (parallel(updates)) {
+    insertParallel(children, cache);
+  } else {
+    for (const auto& child : children) {
+      Walker walker(cache);
+      insert(walker, child);
     }
-    LeafNode leaf_node{val};
-    LeafKey leaf_key{hasher.hash(key.data(), key.length()), version};
-    LeafChild child{leaf_hash, leaf_key};
-    Walker walker(cache);
-    insert(walker, child);
-    batch.leaf_nodes.emplace_back(leaf_key, leaf_node);
   }
 
   // Create and return the UpdateBatch
@@ -184,10 +199,104 @@ UpdateBatch Tree::update_impl(const concord::kvbc::SetOfKeyValuePairs& updates,
   }
   updateBatchHistograms(batch);
 
+  // The next update reads the nodes written by this one
+  if (node_cache_) {
+    for (const auto& [key, node] : batch.internal_nodes) {
+      node_cache_->put(key, node);
+    }
+    node_cache_->advance(version);
+  }
+
   // Set the root after updates so that it is reflected to users in get_root_hash() and get_version() .
   root_ = cache.getRoot();
 
   return batch;
 }
 
+std::vector<LeafChild> Tree::hashLeaves(const concord::kvbc::SetOfKeyValuePairs& updates, Version version) const {
+  using Iterator = concord::kvbc::SetOfKeyValuePairs::const_iterator;
+  auto hash_range = [version](Iterator begin, Iterator end) {
+    Hasher hasher;
+    std::vector<LeafChild> children;
+    for (auto it = begin; it != end; ++it) {
+      const auto& [key, val] = *it;
+      Hash leaf_hash;
+      {
+        TimeRecorder<true> scoped_timer(*histograms.hash_val);
+        leaf_hash = hasher.hash(val.data(), val.length());
+      }
+      children.emplace_back(leaf_hash, LeafKey{hasher.hash(key.data(), key.length()), version});
+    }
+    return children;
+  };
+  if (!parallel(updates)) {
+    return hash_range(updates.cbegin(), updates.cend());
+  }
+
+  constexpr auto kChunks = size_t{16};
+  const auto chunk_size = (updates.size() + kChunks - 1) / kChunks;
+  std::vector<std::future<std::vector<LeafChild>>> chunks;
+  // The tasks refer to `updates`, so wait for the ones not collected yet if we throw
+  auto wait_for_chunks = util::ScopeExit{[&chunks]() {
+    for (auto& chunk : chunks) {
+      if (chunk.valid()) chunk.wait();
+    }
+  }};
+  for (auto begin = updates.cbegin(); begin != updates.cend();) {
+    auto end = begin;
+    std::advance(end, std::min<size_t>(chunk_size, std::distance(begin, updates.cend())));
+    chunks.push_back(thread_pool_->async(hash_range, begin, end));
+    begin = end;
+  }
+
+  std::vector<LeafChild> children;
+  children.reserve(updates.size());
+  for (auto& chunk : chunks) {
+    const auto chunk_children = chunk.get();
+    children.insert(children.end(), chunk_children.cbegin(), chunk_children.cend());
+  }
+  return children;
+}
+
+void Tree::insertParallel(const std::vector<LeafChild>& children, UpdateCache& cache) const {
+  // The keys of every root child, in order
+  std::array<std::vector<const LeafChild*>, 16> groups;
+  for (const auto& child : children) {
+    groups[child.key.hash().getNibble(0).data()].push_back(&child);
+  }
+
+  // Inserting under an InternalChild of the root only modifies its subtree and link, so these subtrees are updated in
+  // parallel. The tree doesn't depend on the order of the inserts: the result is the same as inserting serially.
+  const auto& root = cache.getRoot();
+  std::vector<std::pair<Nibble, std::future<UpdateCache>>> parts;
+  auto wait_for_parts = util::ScopeExit{[&parts]() {
+    for (auto& part : parts) {
+      if (part.second.valid()) part.second.wait();
+    }
+  }};
+  for (auto nibble = uint8_t{0}; nibble < groups.size(); ++nibble) {
+    if (groups[nibble].empty() || !root.isInternal(root.nibbleToIndex(nibble))) continue;
+    auto insert_all = [](UpdateCache part, const std::vector<const LeafChild*>* group) {
+      for (const auto child : *group) {
+        Walker walker(part);
+        insert(walker, *child);
+      }
+      return part;
+    };
+    parts.emplace_back(nibble, thread_pool_->async(insert_all, cache.fork(nibble), &groups[nibble]));
+  }
+  for (auto& [nibble, part] : parts) {
+    cache.join(nibble, part.get());
+    groups[nibble.data()].clear();
+  }
+
+  // The keys that go to an empty slot or a LeafChild of the root
+  for (const auto& group : groups) {
+    for (const auto child : group) {
+      Walker walker(cache);
+      insert(walker, *child);
+    }
+  }
+}
+
 }  // namespace concord::kvbc::sparse_merkle
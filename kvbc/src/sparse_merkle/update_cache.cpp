@@ -42,4 +42,38 @@ void UpdateCache::putStale(const InternalNodeKey& key) { stale_.internal_keys.in
 
 void UpdateCache::remove(const NibblePath& path) { internal_nodes_.erase(path); }
 
+UpdateCache UpdateCache::fork(Nibble nibble) {
+  const auto& root = getRoot();
+  ConcordAssert(root.isInternal(root.nibbleToIndex(nibble)));
+  auto part = UpdateCache{root, db_reader_, version_};
+  for (const auto& [path, node] : internal_nodes_) {
+    if (!path.empty() && path.get(0) == nibble) {
+      part.internal_nodes_.emplace(path, node);
+    }
+  }
+  return part;
+}
+
+void UpdateCache::join(Nibble nibble, const UpdateCache& part) {
+  ConcordAssertEQ(part.version_, version_);
+  auto subtree_path = NibblePath{};
+  subtree_path.append(nibble);
+  auto subtree = part.internal_nodes_.find(subtree_path);
+  ConcordAssert(subtree != part.internal_nodes_.end());
+
+  for (const auto& [path, node] : part.internal_nodes_) {
+    // The root of the part differs from ours only in the link to the subtree, which is set below
+    if (!path.empty()) {
+      ConcordAssert(path.get(0) == nibble);
+      internal_nodes_[path] = node;
+    }
+  }
+  stale_.internal_keys.insert(part.stale_.internal_keys.cbegin(), part.stale_.internal_keys.cend());
+  stale_.leaf_keys.insert(part.stale_.leaf_keys.cbegin(), part.stale_.leaf_keys.cend());
+
+  auto root = getRoot();
+  root.linkChild(nibble, InternalChild{subtree->second.hash(), version_});
+  put(NibblePath{}, root);
+}
+
 }  // namespace concord::kvbc::sparse_merkle::detail
@@ -32,7 +32,7 @@ void Walker::appendEmptyNodes(const Hash& key, size_t nodes_to_create) {
 }
 
 void Walker::descend(const Hash& key, Version next_version) {
-  TimeRecorder scoped_timer(*histograms.walker_descend);
+  TimeRecorder<true> scoped_timer(*histograms.walker_descend);
   stack_.push(current_node_);
   Nibble next_nibble = key.getNibble(depth());
   nibble_path_.append(next_nibble);
@@ -55,7 +55,7 @@ void Walker::ascendToRoot(const std::optional<LeafKey>& key) {
 
 void Walker::ascend() {
   ConcordAssert(!stack_.empty());
-  TimeRecorder scoped_timer(*histograms.walker_ascend);
+  TimeRecorder<true> scoped_timer(*histograms.walker_ascend);
 
   markCurrentNodeStale();
   cacheCurrentNode();
@@ -57,11 +57,16 @@ BlockId Blockchain::addBlock(const concord::kvbc::categorization::Updates& categ
   return addBlock(block, wb);
 }
 
-BlockId Blockchain::addBlock(v4blockchain::detail::Block& block, storage::rocksdb::NativeWriteBatch& wb) {
+BlockId Blockchain::addBlock(v4blockchain::detail::Block& block,
+                             storage::rocksdb::NativeWriteBatch& wb,
+                             const std::optional<BlockDigest>& parent_digest) {
   BlockId id = last_reachable_block_id_ + 1;
   // If future from the previous add exist get its value
   concord::util::digest::BlockDigest digest;
-  if (future_digest_) {
+  if (parent_digest) {
+    ++from_pipeline;
+    digest = *parent_digest;
+  } else if (future_digest_) {
     ++from_future;
     digest = future_digest_->get();
   } else {
@@ -71,6 +76,12 @@ BlockId Blockchain::addBlock(v4blockchain::detail::Block& block, storage::rocksd
   auto blockKey = generateKey(id);
   block.addDigest(digest);
   wb.put(v4blockchain::detail::BLOCKS_CF, blockKey, block.getBuffer());
+  if (parent_digest) {
+    // The caller hashes the next blocks as well (see BlockDigestPipeline). If it stops, the digest of this block is
+    // calculated from storage on the next add.
+    future_digest_.reset();
+    return id;
+  }
   future_digest_ = thread_pool_.async(
       [](BlockId id, v4blockchain::detail::Block&& block) { return block.calculateDigest(id); }, id, std::move(block));
   return id;
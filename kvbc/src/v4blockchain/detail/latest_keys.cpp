@@ -17,6 +17,7 @@
 #include "Logger.hpp"
 #include "v4blockchain/detail/blockchain.h"
 #include "rocksdb/details.h"
+#include "ReplicaConfig.hpp"
 
 using namespace concord::kvbc;
 namespace concord::kvbc::v4blockchain::detail {
@@ -39,6 +40,10 @@ LatestKeys::LatestKeys(const std::shared_ptr<concord::storage::rocksdb::NativeCl
     LOG_INFO(V4_BLOCK_LOG,
              "Created [" << v4blockchain::detail::IMMUTABLE_KEYS_CF << "] column family for the immutable keys");
   }
+  const auto cache_max_bytes = bftEngine::ReplicaConfig::instance().v4LatestKeysCacheMaxBytes;
+  if (cache_max_bytes > 0) {
+    cache_ = std::make_unique<LatestKeysCache>(cache_max_bytes);
+  }
 }
 
 void LatestKeys::addBlockKeys(const concord::kvbc::categorization::Updates& updates,
@@ -47,6 +52,7 @@ void LatestKeys::addBlockKeys(const concord::kvbc::categorization::Updates& upda
   LOG_DEBUG(V4_BLOCK_LOG, "Adding keys of block [" << block_id << "] to the latest CF");
   auto block_key = v4blockchain::detail::Blockchain::generateKey(block_id);
   ConcordAssertEQ(block_key.size(), VERSION_SIZE);
+  if (cache_) cache_->discardStaged();
   for (const auto& [category_id, updates] : updates.categoryUpdates().kv) {
     std::visit([cat_id = category_id, &write_batch, &block_key, this](
                    const auto& updates) { handleCategoryUpdates(block_key, cat_id, updates, write_batch); },
@@ -71,6 +77,7 @@ void LatestKeys::handleCategoryUpdates(const std::string& block_version,
                             << " value size " << v.size() << " raw key " << k);
     write_batch.put(
         v4blockchain::detail::LATEST_KEYS_CF, getSliceArray(prefix, k), getSliceArray(v, sl_flags, block_version));
+    stageCachedValue(prefix, k, v, sl_flags, block_version);
   }
   for (const auto& k : updates.deletes) {
     LOG_DEBUG(V4_BLOCK_LOG,
@@ -79,6 +86,7 @@ void LatestKeys::handleCategoryUpdates(const std::string& block_version,
                               << category_id << " prefix " << prefix << " key is hex "
                               << concordUtils::bufferToHex(k.data(), k.size()) << " raw key " << k);
     write_batch.del(v4blockchain::detail::LATEST_KEYS_CF, getSliceArray(prefix, k));
+    stageCachedDelete(prefix, k);
   }
   if (deleted_keys_ && updates.deletes.size() > 0) {
     *deleted_keys_ += updates.deletes.size();
@@ -106,6 +114,7 @@ void LatestKeys::handleCategoryUpdates(const std::string& block_version,
 
     write_batch.put(
         v4blockchain::detail::LATEST_KEYS_CF, getSliceArray(prefix, k), getSliceArray(v.data, sl_flags, block_version));
+    stageCachedValue(prefix, k, v.data, sl_flags, block_version);
   }
   for (const auto& k : updates.deletes) {
     LOG_DEBUG(V4_BLOCK_LOG,
@@ -114,6 +123,7 @@ void LatestKeys::handleCategoryUpdates(const std::string& block_version,
                               << category_id << " prefix " << prefix << " key is hex "
                               << concordUtils::bufferToHex(k.data(), k.size()) << " raw key " << k);
     write_batch.del(v4blockchain::detail::LATEST_KEYS_CF, getSliceArray(prefix, k));
+    stageCachedDelete(prefix, k);
   }
   if (deleted_keys_ && updates.deletes.size() > 0) {
     *deleted_keys_ += updates.deletes.size();
@@ -147,9 +157,33 @@ void LatestKeys::handleCategoryUpdates(const std::string& block_version,
                             << " value size " << v.data.size() << " raw key " << k);
     write_batch.put(
         v4blockchain::detail::IMMUTABLE_KEYS_CF, getSliceArray(prefix, k), getSliceArray(sl_flags, block_version));
+    stageCachedDelete(prefix, k);
   }
 }
 
+void LatestKeys::stageCachedValue(const std::string& prefix,
+                                  const std::string& key,
+                                  const ::rocksdb::Slice& value,
+                                  const ::rocksdb::Slice& flags,
+                                  const std::string& block_version) {
+  if (!cache_) return;
+  // Stale on update keys are removed by the compaction filter once they are pruned, hence they are not cached.
+  if (flags == concord::storage::rocksdb::detail::toSlice(STALE_ON_UPDATE)) {
+    cache_->stage(prefix + key, std::nullopt);
+    return;
+  }
+  auto stored_value = std::string{};
+  stored_value.reserve(value.size() + flags.size() + block_version.size());
+  stored_value.append(value.data(), value.size());
+  stored_value.append(flags.data(), flags.size());
+  stored_value.append(block_version);
+  cache_->stage(prefix + key, std::move(stored_value));
+}
+
+void LatestKeys::stageCachedDelete(const std::string& prefix, const std::string& key) {
+  if (cache_) cache_->stage(prefix + key, std::nullopt);
+}
+
 /*
 Iterate over updates, for each key:
 1 - read its previous version by calling get with version id - 1.
@@ -284,6 +318,79 @@ void LatestKeys::revertDeletedKeysImp(const std::string& category_id,
   }
 }
 
+std::optional<std::string> LatestKeys::getStoredValue(const std::string& column_family,
+                                                      const std::string& get_key) const {
+  if (!cache_) {
+    return native_client_->get(column_family, get_key);
+  }
+  if (auto cached = cache_->get(get_key)) {
+    return std::move(*cached);
+  }
+  const auto generation = cache_->generation(get_key);
+  auto opt_val = native_client_->get(column_family, get_key);
+  if (!opt_val || !isStaleOnUpdate(*opt_val)) {
+    cache_->put(get_key, opt_val, generation);
+  }
+  return opt_val;
+}
+
+template <typename F>
+void LatestKeys::multiGetStoredValues(const std::string& column_family,
+                                      const std::vector<std::string>& get_keys,
+                                      F f) const {
+  // The keys that are not cached, read from storage
+  std::vector<std::string> read_keys;
+  std::vector<size_t> read_indices;
+  std::vector<uint64_t> read_generations;
+  if (cache_) {
+    for (auto i = 0ull; i < get_keys.size(); ++i) {
+      if (auto cached = cache_->get(get_keys[i])) {
+        if (*cached) {
+          const auto value = ::rocksdb::Slice{**cached};
+          f(i, &value);
+        } else {
+          f(i, nullptr);
+        }
+        continue;
+      }
+      read_generations.push_back(cache_->generation(get_keys[i]));
+      read_indices.push_back(i);
+      read_keys.push_back(get_keys[i]);
+    }
+  }
+  const auto& keys = cache_ ? read_keys : get_keys;
+  if (keys.empty()) {
+    return;
+  }
+  std::vector<::rocksdb::Status> statuses;
+  std::vector<::rocksdb::PinnableSlice> sl_values;
+  statuses.reserve(keys.size());
+  sl_values.reserve(keys.size());
+
+  native_client_->multiGet(column_family, keys, sl_values, statuses);
+
+  for (auto j = 0ull; j < keys.size(); ++j) {
+    const auto& status = statuses[j];
+    const auto i = cache_ ? read_indices[j] : j;
+    if (status.ok()) {
+      auto& sl_val = sl_values[j];
+      const auto value =
+          sl_val.IsPinned() ? ::rocksdb::Slice{sl_val.data(), sl_val.size()} : ::rocksdb::Slice{*sl_val.GetSelf()};
+      if (cache_ && !isStaleOnUpdate(value)) {
+        cache_->put(keys[j], value.ToString(), read_generations[j]);
+      }
+      f(i, &value);
+    } else if (status.IsNotFound()) {
+      if (cache_) {
+        cache_->put(keys[j], std::nullopt, read_generations[j]);
+      }
+      f(i, nullptr);
+    } else {
+      throw std::runtime_error{"Revert multiGet() failure: " + status.ToString()};
+    }
+  }
+}
+
 const std::string& LatestKeys::getColumnFamilyFromCategory(const std::string& category_id) const {
   auto category_type = category_mapping_.categoryType(category_id);
   if (category_type == concord::kvbc::categorization::CATEGORY_TYPE::immutable) {
@@ -301,7 +408,7 @@ std::optional<categorization::Value> LatestKeys::getValue(const std::string& cat
   auto category_type = category_mapping_.categoryType(category_id);
   const auto& column_family_str = getColumnFamilyFromCategory(category_id);
 
-  auto opt_val = native_client_->get(column_family_str, get_key);
+  auto opt_val = getStoredValue(column_family_str, get_key);
   if (!opt_val) {
     LOG_DEBUG(V4_BLOCK_LOG,
               "Reading key " << std::hash<std::string>{}(key) << " not found,  category_id " << category_id
@@ -340,31 +447,16 @@ void LatestKeys::multiGetValue(const std::string& category_id,
   values.resize(keys.size());
   std::vector<std::string> get_keys;
   get_keys.reserve(keys.size());
-  std::vector<::rocksdb::Status> statuses;
-  std::vector<::rocksdb::PinnableSlice> sl_values;
-  statuses.reserve(keys.size());
-  sl_values.reserve(keys.size());
 
   for (const auto& k : keys) {
     get_keys.emplace_back(prefix + k);
   }
 
-  native_client_->multiGet(column_family_str, get_keys, sl_values, statuses);
-
-  for (auto i = 0ull; i < get_keys.size(); ++i) {
-    const auto& status = statuses[i];
-    auto& sl_val = sl_values[i];
+  multiGetStoredValues(column_family_str, get_keys, [&](size_t i, const ::rocksdb::Slice* value) {
     const auto& key = get_keys[i];
-    if (status.ok()) {
-      const char* data = nullptr;
-      size_t size{};
-      if (sl_val.IsPinned()) {
-        data = sl_val.data();
-        size = sl_val.size();
-      } else {
-        data = sl_val.GetSelf()->data();
-        size = sl_val.GetSelf()->size();
-      }
+    if (value) {
+      const char* data = value->data();
+      size_t size = value->size();
       auto actual_version = concordUtils::fromBigEndianBuffer<BlockId>(data + (size - VERSION_SIZE));
       LOG_DEBUG(V4_BLOCK_LOG,
                 "Reading key " << std::hash<std::string>{}(key) << " version " << actual_version << " category_id "
@@ -385,16 +477,14 @@ void LatestKeys::multiGetValue(const std::string& category_id,
         default:
           ConcordAssert(false);
       }
-    } else if (status.IsNotFound()) {
+    } else {
       LOG_DEBUG(V4_BLOCK_LOG,
                 "Reading key " << std::hash<std::string>{}(key) << " not found,  category_id " << category_id
                                << " prefix " << prefix << " key is hex "
                                << concordUtils::bufferToHex(key.data(), key.size()) << " raw key " << key);
       values[i] = std::nullopt;
-    } else {
-      throw std::runtime_error{"Revert multiGet() failure: " + status.ToString()};
     }
-  }
+  });
 }
 
 std::optional<categorization::TaggedVersion> LatestKeys::getLatestVersion(const std::string& category_id,
@@ -411,7 +501,7 @@ std::optional<categorization::TaggedVersion> LatestKeys::getLatestVersion(const
   const auto& prefix = category_mapping_.categoryPrefix(category_id);
   get_key.append(prefix);
   get_key.append(key);
-  auto opt_val = native_client_->get(*column_family_ptr, get_key);
+  auto opt_val = getStoredValue(*column_family_ptr, get_key);
   if (!opt_val) {
     LOG_DEBUG(V4_BLOCK_LOG,
               "Reading key version " << std::hash<std::string>{}(key) << " not found, category_id " << category_id
@@ -434,49 +524,30 @@ void LatestKeys::multiGetLatestVersion(const std::string& category_id,
   const auto& column_family_str = getColumnFamilyFromCategory(category_id);
   std::vector<std::string> get_keys;
   get_keys.reserve(keys.size());
-  std::vector<::rocksdb::Status> statuses;
-  std::vector<::rocksdb::PinnableSlice> sl_values;
   versions.clear();
   versions.resize(keys.size());
-  statuses.reserve(keys.size());
-  sl_values.reserve(keys.size());
 
   for (const auto& k : keys) {
     get_keys.emplace_back(prefix + k);
   }
 
-  native_client_->multiGet(column_family_str, get_keys, sl_values, statuses);
-
-  for (auto i = 0ull; i < get_keys.size(); ++i) {
-    const auto& status = statuses[i];
-    auto& sl_val = sl_values[i];
+  multiGetStoredValues(column_family_str, get_keys, [&](size_t i, const ::rocksdb::Slice* value) {
     const auto& key = get_keys[i];
-    if (status.ok()) {
-      const char* data = nullptr;
-      size_t size{};
-      if (sl_val.IsPinned()) {
-        data = sl_val.data();
-        size = sl_val.size();
-      } else {
-        data = sl_val.GetSelf()->data();
-        size = sl_val.GetSelf()->size();
-      }
-      auto actual_version = concordUtils::fromBigEndianBuffer<BlockId>(data + (size - VERSION_SIZE));
+    if (value) {
+      auto actual_version = concordUtils::fromBigEndianBuffer<BlockId>(value->data() + (value->size() - VERSION_SIZE));
       LOG_DEBUG(V4_BLOCK_LOG,
                 "Reading key version " << std::hash<std::string>{}(key) << " version " << actual_version
                                        << " category_id " << category_id << " prefix " << prefix << " key is hex "
                                        << concordUtils::bufferToHex(key.data(), key.size()) << " raw key " << key);
       versions[i] = categorization::TaggedVersion{false, actual_version};
-    } else if (status.IsNotFound()) {
+    } else {
       LOG_DEBUG(V4_BLOCK_LOG,
                 "Reading key version " << std::hash<std::string>{}(key) << " not found, category_id " << category_id
                                        << " prefix " << prefix << " key is hex "
                                        << concordUtils::bufferToHex(key.data(), key.size()) << " raw key " << key);
       versions[i] = std::nullopt;
-    } else {
-      throw std::runtime_error{"Revert multiGet() failure: " + status.ToString()};
     }
-  }
+  });
 }
 
 bool LatestKeys::LKCompactionFilter::Filter(int /*level*/,
@@ -0,0 +1,127 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "v4blockchain/detail/latest_keys_cache.h"
+
+#include <functional>
+#include <iterator>
+
+#include "assertUtils.hpp"
+
+namespace concord::kvbc::v4blockchain::detail {
+
+LatestKeysCache::LatestKeysCache(size_t max_bytes)
+    : max_shard_bytes_{max_bytes / kShards},
+      metrics_component_{"v4_latest_keys_cache", std::make_shared<concordMetrics::Aggregator>()},
+      hits_{metrics_component_.RegisterAtomicCounter("hits")},
+      misses_{metrics_component_.RegisterAtomicCounter("misses")},
+      evictions_{metrics_component_.RegisterAtomicCounter("evictions")},
+      num_entries_{metrics_component_.RegisterGauge("num_entries", 0)},
+      size_bytes_{metrics_component_.RegisterGauge("size_bytes", 0)} {
+  ConcordAssertGT(max_shard_bytes_, 0);
+  metrics_component_.Register();
+}
+
+size_t LatestKeysCache::entryBytes(const std::string& key, const Value& value) {
+  // The entry, its list node and its index node, including the copy of the key in the index
+  constexpr auto kOverhead = 8 * sizeof(void*);
+  return sizeof(Entry) + kOverhead + 2 * key.size() + (value ? value->size() : 0);
+}
+
+std::optional<LatestKeysCache::Value> LatestKeysCache::get(const std::string& key) {
+  auto& shard = shardOf(key);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      hits_++;
+      return it->second->value;
+    }
+  }
+  misses_++;
+  return std::nullopt;
+}
+
+uint64_t LatestKeysCache::generation(const std::string& key) {
+  auto& shard = shardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.generation;
+}
+
+void LatestKeysCache::put(const std::string& key, Value value, uint64_t generation) {
+  auto& shard = shardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (shard.generation != generation) {
+    return;
+  }
+  set(shard, key, std::move(value));
+}
+
+void LatestKeysCache::commit() {
+  for (auto& [key, value] : staged_) {
+    auto& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.generation;
+    if (value) {
+      set(shard, key, std::move(value));
+    } else if (auto it = shard.index.find(key); it != shard.index.end()) {
+      erase(shard, it->second);
+    }
+  }
+  staged_.clear();
+}
+
+void LatestKeysCache::clear() {
+  staged_.clear();
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.generation;
+    while (!shard.lru.empty()) {
+      erase(shard, shard.lru.begin());
+    }
+  }
+}
+
+void LatestKeysCache::set(Shard& shard, const std::string& key, Value&& value) {
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    erase(shard, it->second);
+  }
+  const auto bytes = entryBytes(key, value);
+  shard.lru.push_front(Entry{key, std::move(value), bytes});
+  shard.index.emplace(key, shard.lru.begin());
+  shard.bytes += bytes;
+  bytes_ += bytes;
+  size_++;
+  while (shard.bytes > max_shard_bytes_ && !shard.lru.empty()) {
+    erase(shard, std::prev(shard.lru.end()));
+    evictions_++;
+  }
+}
+
+void LatestKeysCache::erase(Shard& shard, Lru::iterator it) {
+  shard.bytes -= it->bytes;
+  bytes_ -= it->bytes;
+  size_--;
+  shard.index.erase(it->key);
+  shard.lru.erase(it);
+}
+
+void LatestKeysCache::updateAggregator() {
+  num_entries_.Get().Set(size());
+  size_bytes_.Get().Set(bytes());
+  metrics_component_.UpdateAggregator();
+}
+
+}  // namespace concord::kvbc::v4blockchain::detail
@@ -39,7 +39,9 @@ KeyValueBlockchain::KeyValueBlockchain(
       blocks_deleted_{v4_metrics_comp_.RegisterGauge(
           "numOfBlocksDeleted", block_chain_.getGenesisBlockId() > 0 ? (block_chain_.getGenesisBlockId() - 1) : 0)},
       deleted_keys_{v4_metrics_comp_.RegisterCounter("numOfKeysDeleted", 0)},
-      immutables_reads_{v4_metrics_comp_.RegisterCounter("numOfimmutableReads", 0)} {
+      immutables_reads_{v4_metrics_comp_.RegisterCounter("numOfimmutableReads", 0)},
+      group_commits_{v4_metrics_comp_.RegisterCounter("numOfGroupCommits", 0)},
+      group_committed_blocks_{v4_metrics_comp_.RegisterCounter("numOfGroupCommittedBlocks", 0)} {
   if (!link_st_chain) return;
   // Mark version of blockchain
   native_client_->put(v4blockchain::detail::MISC_CF, kvbc::keyTypes::blockchain_version, kvbc::V4Version());
@@ -87,24 +89,64 @@ BlockId KeyValueBlockchain::add(categorization::Updates &&updates) {
                              << " size of final block is " << write_batch.size() << " total bytes written to stroage "
                              << total_size);
   auto sequence_number = future_seq_num_.get();
+  const auto batch_size = write_batch.size();
   native_client_->write(std::move(write_batch));
+  latest_keys_.onBlockWritten();
   block_chain_.setBlockId(block_id);
+  onBlockWritten(batch_size);
   if (sequence_number > 0) setLastBlockSequenceNumber(sequence_number);
   if (block_id % 100 == 0) {
     v4_metrics_comp_.UpdateAggregator();
+    latest_keys_.updateCacheMetrics();
   }
   return block_id;
 }
 
 BlockId KeyValueBlockchain::add(const categorization::Updates &updates,
                                 v4blockchain::detail::Block &block,
-                                storage::rocksdb::NativeWriteBatch &write_batch) {
+                                storage::rocksdb::NativeWriteBatch &write_batch,
+                                const std::optional<concord::util::digest::BlockDigest> &parent_digest) {
   BlockId block_id{};
-  { block_id = block_chain_.addBlock(block, write_batch); }
+  { block_id = block_chain_.addBlock(block, write_batch, parent_digest); }
   { latest_keys_.addBlockKeys(updates, block_id, write_batch); }
   return block_id;
 }
 
+void KeyValueBlockchain::setGroupCommit(uint32_t max_blocks, uint64_t max_bytes) {
+  std::lock_guard<std::mutex> lock(group_commit_mutex_);
+  flushGroupCommit();
+  group_commit_max_blocks_ = max_blocks;
+  group_commit_max_bytes_ = max_bytes;
+  LOG_INFO(V4_BLOCK_LOG, "Group commit of blocks" << KVLOG(max_blocks, max_bytes));
+}
+
+void KeyValueBlockchain::flushBlocks() {
+  std::lock_guard<std::mutex> lock(group_commit_mutex_);
+  flushGroupCommit();
+}
+
+void KeyValueBlockchain::onBlockWritten(size_t batch_size) {
+  std::lock_guard<std::mutex> lock(group_commit_mutex_);
+  if (group_commit_max_blocks_ == 0) return;
+  ++group_commit_pending_blocks_;
+  group_commit_pending_bytes_ += batch_size;
+  if (group_commit_pending_blocks_ >= group_commit_max_blocks_ ||
+      group_commit_pending_bytes_ >= group_commit_max_bytes_) {
+    flushGroupCommit();
+  }
+}
+
+void KeyValueBlockchain::flushGroupCommit() {
+  if (group_commit_pending_blocks_ == 0) return;
+  native_client_->flushWal(true);
+  group_commits_++;
+  group_committed_blocks_ += group_commit_pending_blocks_;
+  v4_metrics_comp_.UpdateAggregator();
+  LOG_DEBUG(V4_BLOCK_LOG, "Group commit flushed" << KVLOG(group_commit_pending_blocks_, group_commit_pending_bytes_));
+  group_commit_pending_blocks_ = 0;
+  group_commit_pending_bytes_ = 0;
+}
+
 //////////////////////////// DELETER////////////////////////////////////////////
 
 BlockId KeyValueBlockchain::deleteBlocksUntil(BlockId until) {
@@ -143,6 +185,7 @@ void KeyValueBlockchain::deleteLastReachableBlock() {
   }
   auto write_batch = native_client_->getBatch(std::move(*batch_data));
   native_client_->write(std::move(write_batch));
+  latest_keys_.onBlockReverted();
   block_chain_.setBlockId(--last_reachable_id);
   LOG_DEBUG(V4_BLOCK_LOG,
             "Wrote revert updates of block " << last_reachable_id + 1 << " last reachable is " << last_reachable_id);
@@ -410,14 +453,17 @@ void KeyValueBlockchain::linkSTChain() {
   const auto last_block_id = state_transfer_chain_.getLastBlockId();
   if (last_block_id == 0) return;
 
+  auto blocks = stChainBlocks(block_id, last_block_id);
+  auto prev_digest = std::optional<concord::util::digest::BlockDigest>{};
   for (auto i = block_id; i <= last_block_id; ++i) {
-    auto block = state_transfer_chain_.getBlock(i);
-    if (!block) {
+    auto item = blocks.next();
+    if (!item) {
       LOG_INFO(V4_BLOCK_LOG, "Block " << i << " wasn't found, started from block " << block_id);
       return;
     }
-    auto updates = block->getUpdates();
-    writeSTLinkTransaction(i, updates);
+    auto updates = item->block.getUpdates();
+    writeSTLinkTransaction(i, updates, chainedParentDigest(i, *item, prev_digest));
+    prev_digest = item->digest;
   }
   // Linking has fully completed and we should not have any more ST temporary blocks left. Therefore, make sure we
   // don't have any value for the latest ST temporary block ID cache.
@@ -442,20 +488,51 @@ void KeyValueBlockchain::pruneOnSTLink(const categorization::Updates &updates) {
 }
 
 // Atomic delete from state transfer and add to blockchain
-void KeyValueBlockchain::writeSTLinkTransaction(const BlockId block_id, const categorization::Updates &updates) {
+void KeyValueBlockchain::writeSTLinkTransaction(
+    const BlockId block_id,
+    const categorization::Updates &updates,
+    const std::optional<concord::util::digest::BlockDigest> &parent_digest) {
   auto sequence_number = onNewBFTSequenceNumber(updates);
   v4blockchain::detail::Block block;
   block.addUpdates(updates);
   auto block_size = block.size();
   auto write_batch = native_client_->getBatch(block_size * updates_to_final_size_ration_);
   state_transfer_chain_.deleteBlock(block_id, write_batch);
-  auto new_block_id = add(updates, block, write_batch);
+  auto new_block_id = add(updates, block, write_batch, parent_digest);
+  const auto batch_size = write_batch.size();
   native_client_->write(std::move(write_batch));
+  latest_keys_.onBlockWritten();
   block_chain_.setBlockId(new_block_id);
+  onBlockWritten(batch_size);
   pruneOnSTLink(updates);
   if (sequence_number > 0) setLastBlockSequenceNumber(sequence_number);
 }
 
+BlockDigestPipeline<v4blockchain::detail::Block> KeyValueBlockchain::stChainBlocks(BlockId from, BlockId until) const {
+  return BlockDigestPipeline<v4blockchain::detail::Block>{
+      digest_thread_pool_.get(),
+      st_link_digest_pipeline_depth_,
+      from,
+      until,
+      [this](BlockId id) { return state_transfer_chain_.getBlock(id); },
+      [](BlockId id, const v4blockchain::detail::Block &block) { return block.calculateDigest(id); }};
+}
+
+// State transfer has validated that the digest of each block is the parent digest of the next one. The check
+// protects against linking with a digest that doesn't chain - in which case it is calculated as usual.
+std::optional<concord::util::digest::BlockDigest> KeyValueBlockchain::chainedParentDigest(
+    BlockId block_id,
+    const BlockDigestPipeline<v4blockchain::detail::Block>::Item &item,
+    const std::optional<concord::util::digest::BlockDigest> &prev_digest) {
+  if (!prev_digest) return std::nullopt;
+  if (*prev_digest != item.block.parentDigest()) {
+    LOG_WARN(V4_BLOCK_LOG,
+             "Parent digest of state transfer block doesn't match the digest of its parent" << KVLOG(block_id));
+    return std::nullopt;
+  }
+  return prev_digest;
+}
+
 size_t KeyValueBlockchain::linkUntilBlockId(BlockId until_block_id) {
   const auto from_block_id = getLastReachableBlockId() + 1;
   ConcordAssertLE(from_block_id, until_block_id);
@@ -465,17 +542,20 @@ size_t KeyValueBlockchain::linkUntilBlockId(BlockId until_block_id) {
 
   concord::util::DurationTracker<std::chrono::milliseconds> link_duration("link_duration", true);
   BlockId last_added = 0;
+  auto blocks = stChainBlocks(from_block_id, until_block_id);
+  auto prev_digest = std::optional<concord::util::digest::BlockDigest>{};
   for (auto i = from_block_id; i <= until_block_id; ++i) {
-    auto block = state_transfer_chain_.getBlock(i);
+    auto item = blocks.next();
 
-    if (!block) {
+    if (!item) {
       break;
     }
     last_added = i;
     // First prune and then link the block to the chain. Rationale is that this will preserve the same order of block
     // deletes relative to block adds on source and destination replicas.
-    auto updates = block->getUpdates();
-    writeSTLinkTransaction(i, updates);
+    auto updates = item->block.getUpdates();
+    writeSTLinkTransaction(i, updates, chainedParentDigest(i, *item, prev_digest));
+    prev_digest = item->digest;
     if ((++report_counter % report_thresh) == 0) {
       auto elapsed_time_ms = link_duration.totalDuration();
       uint64_t blocks_linked_per_sec{};
@@ -662,6 +742,7 @@ void KeyValueBlockchain::trimBlocksFromSnapshot(BlockId block_id_at_checkpoint)
     }
     auto write_batch = native_client_->getBatch(std::move(*batch_data));
     native_client_->write(std::move(write_batch));
+    latest_keys_.onBlockReverted();
     block_chain_.setBlockId(--last_reachable_id);
     LOG_DEBUG(V4_BLOCK_LOG,
               "Wrote revert updates of block " << last_reachable_id + 1 << " last reachable is " << last_reachable_id);
@@ -1077,6 +1077,55 @@ TEST_F(categorized_kvbc, compare_raw_blocks) {
   // ASSERT_EQ(raw_from_api.data, last_raw.second.value().data);
 }
 
+TEST_F(categorized_kvbc, concurrent_category_add_matches_serial) {
+  const auto categories = std::map<std::string, CATEGORY_TYPE>{{"merkle", CATEGORY_TYPE::block_merkle},
+                                                               {"versioned", CATEGORY_TYPE::versioned_kv},
+                                                               {"immutable", CATEGORY_TYPE::immutable},
+                                                               {kConcordInternalCategoryId, CATEGORY_TYPE::versioned_kv}};
+  auto block_updates = [](BlockId block_id) {
+    const auto id = std::to_string(block_id);
+    Updates updates;
+    BlockMerkleUpdates merkle_updates;
+    merkle_updates.addUpdate("merkle_key" + id, "merkle_value" + id);
+    if (block_id > 1) merkle_updates.addDelete("merkle_key" + std::to_string(block_id - 1));
+    updates.add("merkle", std::move(merkle_updates));
+    VersionedUpdates ver_updates;
+    ver_updates.calculateRootHash(true);
+    ver_updates.addUpdate("ver_key", "ver_val" + id);
+    updates.add("versioned", std::move(ver_updates));
+    ImmutableUpdates immutable_updates;
+    immutable_updates.addUpdate("immutable_key" + id, {"immutable_val" + id, {"1"}});
+    updates.add("immutable", std::move(immutable_updates));
+    return updates;
+  };
+
+  const auto concurrent_db_id = 1;
+  cleanup(concurrent_db_id);
+  auto& config = bftEngine::ReplicaConfig::instance();
+  const auto threads = config.numOfCategoryAddThreads;
+  {
+    KeyValueBlockchain serial_chain{db, true, categories};
+    config.numOfCategoryAddThreads = 3;
+    auto concurrent_db = TestRocksDb::createNative(concurrent_db_id);
+    KeyValueBlockchain concurrent_chain{concurrent_db, true, categories};
+    for (BlockId block_id = 1; block_id <= 10; ++block_id) {
+      ASSERT_EQ(serial_chain.addBlock(block_updates(block_id)), block_id);
+      ASSERT_EQ(concurrent_chain.addBlock(block_updates(block_id)), block_id);
+    }
+    for (BlockId block_id = 1; block_id <= 10; ++block_id) {
+      const auto serial_block = db->get(BLOCKS_CF, Block::generateKey(block_id));
+      ASSERT_TRUE(serial_block.has_value());
+      ASSERT_EQ(concurrent_db->get(BLOCKS_CF, Block::generateKey(block_id)), serial_block);
+    }
+    ASSERT_EQ(concurrent_chain.getLatest("versioned", "ver_key"), serial_chain.getLatest("versioned", "ver_key"));
+    ASSERT_EQ(concurrent_chain.getLatest("merkle", "merkle_key10"), serial_chain.getLatest("merkle", "merkle_key10"));
+    ASSERT_FALSE(concurrent_chain.getLatest("merkle", "merkle_key9").has_value());
+    ASSERT_TRUE(concurrent_chain.getLatest("immutable", "immutable_key5").has_value());
+  }
+  config.numOfCategoryAddThreads = threads;
+  cleanup(concurrent_db_id);
+}
+
 TEST_F(categorized_kvbc, single_read_with_version) {
   KeyValueBlockchain block_chain{
       db,
@@ -24,8 +24,11 @@
 #include <vector>
 #include "storage/test/storage_test_common.h"
 #include "kvbc_adapter/common/state_snapshot_adapter.hpp"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
+#include "scope_exit.hpp"
 
 using concord::storage::rocksdb::NativeClient;
+using concord::kvbc::adapter::common::statesnapshot::StateSnapshotFile;
 using namespace ::testing;
 
 namespace {
@@ -204,6 +207,174 @@ TEST_F(common_kvbc, compute_and_persist_hash_batch_size_equals_key_count) {
   }
 }
 
+TEST_F(common_kvbc, export_public_state) {
+  bool version_is_set = false;
+  std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE> cat_map;
+  for (int32_t ver = 0; ver <= static_cast<int32_t>(concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION);
+       ++ver) {
+    auto blockchain_version = getBlockchainVersion(ver);
+    if (!blockchain_version) {
+      continue;
+    }
+    switch (*blockchain_version) {
+      case concord::kvbc::BLOCKCHAIN_VERSION::CATEGORIZED_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace(concord::kvbc::categorization::kExecutionProvableCategory,
+                          concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+      case concord::kvbc::BLOCKCHAIN_VERSION::V4_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace("merkle", concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace("versioned", concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+        {
+          const auto link_st_chain = true;
+          auto kvbc = concord::kvbc::adapter::ReplicaBlockchain{
+              db,
+              link_st_chain,
+              std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE>{
+                  {concord::kvbc::categorization::kExecutionProvableCategory,
+                   concord::kvbc::categorization::CATEGORY_TYPE::block_merkle},
+                  {concord::kvbc::categorization::kConcordInternalCategoryId,
+                   concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv}}};
+          addPublicState(kvbc);
+          bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize = 4;
+          bftEngine::ReplicaConfig::instance().stateSnapshotExportBlockSize = 8;
+          const auto path = StateSnapshotFile::pathIn(rocksDbPath(defaultDbId));
+          kvbc.exportPublicState(1, [](std::string&& s) -> std::string { return std::move(s); }, path);
+          assertPublicStateHash();
+          const auto file = StateSnapshotFile{path};
+          ASSERT_EQ(file.checkpointBlockId(), 1);
+          ASSERT_EQ(file.numKeyValues(), 4);
+          const auto state_hash_val = db->get(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey());
+          auto state_hash = concord::kvbc::categorization::StateHash{};
+          concord::kvbc::categorization::detail::deserialize(*state_hash_val, state_hash);
+          ASSERT_THAT(file.publicStateHash(), ContainerEq(state_hash.hash));
+          auto kvs = std::vector<std::pair<std::string, std::string>>{};
+          file.iterate(
+              [&](std::string&& key, std::string&& value) { kvs.emplace_back(std::move(key), std::move(value)); });
+          ASSERT_THAT(kvs,
+                      ContainerEq(std::vector<std::pair<std::string, std::string>>{
+                          {"a", "va"}, {"b", "vb"}, {"c", "vc"}, {"d", "vd"}}));
+          ASSERT_EQ(file.get("c"), "vc");
+        }
+        version_is_set = false;
+        break;
+      case concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION:
+        version_is_set = false;
+        break;
+    }
+  }
+}
+
+// Public state hash of ranges of 3 keys:
+//
+// r1 = h3 = c6314bdd9c82183d2e4e5cb8869826e1a3ace6a86a7b62ebe5ac77b732d3c792
+// r2 = hash(h0 || hash("d") || "vd") = 372c2e7279683ee1cacd0a661bfd6cede3d1b8a644ea1f421b23ab8cbb287174
+// hash(r1 || r2) = 7ef6973a84e007b9e2be3c3c6e99ce358557ce29d3456348787f29e09f56d37c
+TEST_F(common_kvbc, compute_and_persist_hash_in_key_ranges) {
+  bool version_is_set = false;
+  std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE> cat_map;
+  auto reset_config = concord::util::ScopeExit{[]() {
+    bftEngine::ReplicaConfig::instance().numOfStateSnapshotHashThreads = 0;
+    bftEngine::ReplicaConfig::instance().stateSnapshotHashRangeSize = 0;
+  }};
+  for (int32_t ver = 0; ver <= static_cast<int32_t>(concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION);
+       ++ver) {
+    auto blockchain_version = getBlockchainVersion(ver);
+    if (!blockchain_version) {
+      continue;
+    }
+    switch (*blockchain_version) {
+      case concord::kvbc::BLOCKCHAIN_VERSION::CATEGORIZED_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace(concord::kvbc::categorization::kExecutionProvableCategory,
+                          concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+      case concord::kvbc::BLOCKCHAIN_VERSION::V4_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace("merkle", concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace("versioned", concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+        {
+          const auto link_st_chain = true;
+          auto kvbc = concord::kvbc::adapter::ReplicaBlockchain{
+              db,
+              link_st_chain,
+              std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE>{
+                  {concord::kvbc::categorization::kExecutionProvableCategory,
+                   concord::kvbc::categorization::CATEGORY_TYPE::block_merkle},
+                  {concord::kvbc::categorization::kConcordInternalCategoryId,
+                   concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv}}};
+          addPublicState(kvbc);
+          bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize = 2;
+          bftEngine::ReplicaConfig::instance().stateSnapshotExportBlockSize = 8;
+          const auto expected_hash = concord::kvbc::categorization::Hash{
+              0x7e, 0xf6, 0x97, 0x3a, 0x84, 0xe0, 0x07, 0xb9, 0xe2, 0xbe, 0x3c, 0x3c, 0x6e, 0x99, 0xce, 0x35,
+              0x85, 0x57, 0xce, 0x29, 0xd3, 0x45, 0x63, 0x48, 0x78, 0x7f, 0x29, 0xe0, 0x9f, 0x56, 0xd3, 0x7c};
+          const auto persisted_hash = [&]() {
+            const auto state_hash_val = db->get(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey());
+            auto state_hash = concord::kvbc::categorization::StateHash{};
+            concord::kvbc::categorization::detail::deserialize(*state_hash_val, state_hash);
+            return state_hash.hash;
+          };
+
+          // The hash depends on the range size only, not on the number of threads.
+          bftEngine::ReplicaConfig::instance().stateSnapshotHashRangeSize = 3;
+          for (auto num_threads : {0u, 1u, 4u}) {
+            bftEngine::ReplicaConfig::instance().numOfStateSnapshotHashThreads = num_threads;
+            kvbc.computeAndPersistPublicStateHash(1);
+            ASSERT_THAT(persisted_hash(), ContainerEq(expected_hash)) << num_threads;
+
+            // Exporting passes the key values of the ranges to the file in key order.
+            const auto path = StateSnapshotFile::pathIn(rocksDbPath(defaultDbId));
+            kvbc.exportPublicState(1, [](std::string&& s) -> std::string { return std::move(s); }, path);
+            ASSERT_THAT(persisted_hash(), ContainerEq(expected_hash)) << num_threads;
+            const auto file = StateSnapshotFile{path};
+            ASSERT_THAT(file.publicStateHash(), ContainerEq(expected_hash)) << num_threads;
+            auto kvs = std::vector<std::pair<std::string, std::string>>{};
+            file.iterate(
+                [&](std::string&& key, std::string&& value) { kvs.emplace_back(std::move(key), std::move(value)); });
+            ASSERT_THAT(kvs,
+                        ContainerEq(std::vector<std::pair<std::string, std::string>>{
+                            {"a", "va"}, {"b", "vb"}, {"c", "vc"}, {"d", "vd"}}))
+                << num_threads;
+          }
+
+          // Without ranges, the threads are not used and the hash is the single chain h4.
+          bftEngine::ReplicaConfig::instance().stateSnapshotHashRangeSize = 0;
+          bftEngine::ReplicaConfig::instance().numOfStateSnapshotHashThreads = 4;
+          kvbc.computeAndPersistPublicStateHash(1);
+          const auto h4 = concord::kvbc::categorization::Hash{
+              0xfd, 0x4c, 0x5e, 0xa0, 0x3d, 0xa1, 0x8d, 0xea, 0xf1, 0x03, 0x65, 0xfd, 0xf0, 0x01, 0xc2, 0x16,
+              0x05, 0x5a, 0xaa, 0xa7, 0x96, 0xb0, 0xa9, 0x8e, 0x4d, 0xb7, 0xc7, 0x56, 0xa4, 0x26, 0xae, 0x81};
+          ASSERT_THAT(persisted_hash(), ContainerEq(h4));
+        }
+        version_is_set = false;
+        break;
+      case concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION:
+        version_is_set = false;
+        break;
+    }
+  }
+}
+
 TEST_F(common_kvbc, compute_and_persist_hash_batch_size_bigger_than_key_count_uneven) {
   bool version_is_set = false;
   std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE> cat_map;
@@ -0,0 +1,176 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
+#include "util/filesystem.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using concord::kvbc::adapter::common::statesnapshot::StateSnapshotFile;
+using concord::kvbc::categorization::Hash;
+using namespace ::testing;
+
+namespace {
+
+class state_snapshot_file : public Test {
+ protected:
+  void SetUp() override {
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+  }
+
+  void TearDown() override { fs::remove_all(dir); }
+
+  // Keys "key000", "key002", ..., i.e. the odd keys are missing.
+  static std::vector<std::pair<std::string, std::string>> keyValues(std::size_t count) {
+    auto kvs = std::vector<std::pair<std::string, std::string>>{};
+    for (auto i = 0u; i < count; ++i) {
+      auto id = std::to_string(2 * i);
+      id.insert(0, 3 - id.size(), '0');
+      kvs.emplace_back("key" + id, "value" + id + std::string(i % 7, 'v'));
+    }
+    return kvs;
+  }
+
+  void write(const std::vector<std::pair<std::string, std::string>>& kvs, std::size_t block_size) {
+    auto writer = StateSnapshotFile::Writer{path, block_size};
+    for (const auto& [key, value] : kvs) {
+      writer.add(key, value);
+    }
+    writer.finish(block_id, hash);
+  }
+
+  static std::vector<std::pair<std::string, std::string>> iterate(const StateSnapshotFile& file) {
+    auto kvs = std::vector<std::pair<std::string, std::string>>{};
+    file.iterate([&](std::string&& key, std::string&& value) { kvs.emplace_back(std::move(key), std::move(value)); });
+    return kvs;
+  }
+
+  const std::string dir{(fs::temp_directory_path() / "state_snapshot_file_test").string()};
+  const std::string path{StateSnapshotFile::pathIn(dir)};
+  const concord::kvbc::BlockId block_id{42};
+  const Hash hash{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                  17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+};
+
+TEST_F(state_snapshot_file, footer) {
+  write(keyValues(10), 64);
+  const auto file = StateSnapshotFile{path};
+  ASSERT_EQ(file.checkpointBlockId(), block_id);
+  ASSERT_THAT(file.publicStateHash(), ContainerEq(hash));
+  ASSERT_EQ(file.numKeyValues(), 10);
+}
+
+TEST_F(state_snapshot_file, iterate_all) {
+  const auto kvs = keyValues(100);
+  write(kvs, 64);
+  ASSERT_THAT(iterate(StateSnapshotFile{path}), ContainerEq(kvs));
+}
+
+TEST_F(state_snapshot_file, single_block) {
+  const auto kvs = keyValues(100);
+  write(kvs, 1024 * 1024);
+  const auto file = StateSnapshotFile{path};
+  ASSERT_THAT(iterate(file), ContainerEq(kvs));
+  ASSERT_EQ(file.get(kvs[50].first), kvs[50].second);
+}
+
+TEST_F(state_snapshot_file, get) {
+  const auto kvs = keyValues(100);
+  write(kvs, 64);
+  const auto file = StateSnapshotFile{path};
+  for (const auto& [key, value] : kvs) {
+    ASSERT_EQ(file.get(key), value);
+  }
+  ASSERT_FALSE(file.get("key001").has_value());
+  ASSERT_FALSE(file.get("key099").has_value());
+  ASSERT_FALSE(file.get("a").has_value());
+  ASSERT_FALSE(file.get("key").has_value());
+  ASSERT_FALSE(file.get("z").has_value());
+}
+
+TEST_F(state_snapshot_file, iterate_after_key) {
+  const auto kvs = keyValues(100);
+  write(kvs, 64);
+  const auto file = StateSnapshotFile{path};
+  for (auto i = 0u; i < kvs.size(); ++i) {
+    auto iterated = std::vector<std::pair<std::string, std::string>>{};
+    ASSERT_TRUE(file.iterate(
+        [&](std::string&& key, std::string&& value) { iterated.emplace_back(std::move(key), std::move(value)); },
+        kvs[i].first));
+    const auto expected = std::vector<std::pair<std::string, std::string>>(kvs.cbegin() + i + 1, kvs.cend());
+    ASSERT_THAT(iterated, ContainerEq(expected));
+  }
+}
+
+TEST_F(state_snapshot_file, iterate_after_missing_key) {
+  write(keyValues(100), 64);
+  const auto file = StateSnapshotFile{path};
+  auto calls = 0;
+  const auto f = [&](std::string&&, std::string&&) { ++calls; };
+  ASSERT_FALSE(file.iterate(f, "key001"));
+  ASSERT_FALSE(file.iterate(f, "a"));
+  ASSERT_FALSE(file.iterate(f, "z"));
+  ASSERT_EQ(calls, 0);
+}
+
+TEST_F(state_snapshot_file, empty) {
+  write({}, 64);
+  const auto file = StateSnapshotFile{path};
+  ASSERT_EQ(file.numKeyValues(), 0);
+  ASSERT_TRUE(iterate(file).empty());
+  ASSERT_FALSE(file.get("key").has_value());
+  ASSERT_FALSE(file.iterate([](std::string&&, std::string&&) {}, "key"));
+}
+
+TEST_F(state_snapshot_file, unfinished_file_does_not_exist) {
+  {
+    auto writer = StateSnapshotFile::Writer{path, 64};
+    writer.add("key", "value");
+  }
+  ASSERT_FALSE(fs::exists(path));
+  ASSERT_TRUE(fs::is_empty(dir));
+  ASSERT_THROW(StateSnapshotFile{path}, std::runtime_error);
+}
+
+TEST_F(state_snapshot_file, invalid_files_throw) {
+  write(keyValues(100), 64);
+  const auto size = fs::file_size(path);
+
+  // Not a snapshot file
+  fs::resize_file(path, size - 1);
+  ASSERT_THROW(StateSnapshotFile{path}, std::runtime_error);
+
+  // Too small
+  fs::resize_file(path, 10);
+  ASSERT_THROW(StateSnapshotFile{path}, std::runtime_error);
+}
+
+TEST_F(state_snapshot_file, corrupted_block_throws) {
+  write(keyValues(100), 64);
+  {
+    auto file = std::fstream{path, std::ios::binary | std::ios::in | std::ios::out};
+    file.seekp(0);
+    file.write("\xff\xff\xff\xff", 4);
+  }
+  const auto file = StateSnapshotFile{path};
+  ASSERT_THROW(iterate(file), std::runtime_error);
+}
+
+}  // namespace
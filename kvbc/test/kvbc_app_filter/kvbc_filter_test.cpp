@@ -13,6 +13,7 @@
 
 #include <boost/detail/endian.hpp>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <atomic>
 #include <cassert>
 #include <exception>
 #include <memory>
@@ -90,6 +91,8 @@ class FakeStorage : public concord::kvbc::IReader {
   std::map<std::string, std::string> latest_table;
   // given trid#<event_group_id> as key, the map returns the global_event_group_id
   std::map<std::string, std::string> tag_table;
+  // The number of multiGetLatest() calls
+  mutable std::atomic_size_t num_multi_get_latest_{0};
 
   std::optional<concord::kvbc::categorization::Value> get(const std::string &category_id,
                                                           const std::string &key,
@@ -143,8 +146,15 @@ class FakeStorage : public concord::kvbc::IReader {
   void multiGetLatest(const std::string &category_id,
                       const std::vector<std::string> &keys,
                       std::vector<std::optional<concord::kvbc::categorization::Value>> &values) const override {
-    ADD_FAILURE() << "multiGetLatest() should not be called by this test";
     values = {};
+    if (category_id != concord::kvbc::categorization::kExecutionEventGroupDataCategory) {
+      ADD_FAILURE() << "multiGetLatest() was called with unexpected category id";
+      return;
+    }
+    num_multi_get_latest_++;
+    for (const auto &key : keys) {
+      values.push_back(getLatest(category_id, key));
+    }
   }
 
   std::optional<concord::kvbc::categorization::TaggedVersion> getLatestVersion(const std::string &category_id,
@@ -309,6 +319,12 @@ std::string blockIdToByteStringLittleEndian(const BlockId &block_id) {
 #endif  // BOOST_LITTLE_ENDIAN defined/else
 }
 
+// Range hash checkpoints are only used for ranges that were not pruned
+class NotPrunedStorage : public FakeStorage {
+ public:
+  BlockId getGenesisBlockId() const override { return 0; }
+};
+
 // Prefix the key with the immutable index to make it unique and ordered.
 inline std::string prefixImmutableKey(const std::string &key, uint64_t immutable_index) {
   return concordUtils::toBigEndianStringBuffer(immutable_index) + key;
@@ -739,6 +755,86 @@ TEST(kvbc_filter_test, kvbfilter_success_hash_of_event_groups_in_range_eg) {
   EXPECT_EQ(hash_value, computeSHA256Hash(concatenated_update_hashes));
 }
 
+TEST(kvbc_filter_test, kvbfilter_hash_of_blocks_in_range_from_checkpoints) {
+  NotPrunedStorage storage;
+  storage.fillWithData(kLastBlockId);
+  auto checkpoints = std::make_shared<concord::kvbc::RangeHashCheckpoints>(4, 8, 16);
+
+  auto kvb_filter = KvbAppFilter(&storage, "7");
+  auto expected = [&](BlockId start, BlockId end) { return kvb_filter.readBlockRangeHash(start, end); };
+  // A new filter per call, as the thin replica server creates them
+  auto actual = [&](BlockId start, BlockId end) {
+    auto filter = KvbAppFilter(&storage, "7");
+    filter.setRangeHashCheckpoints(checkpoints);
+    return filter.readBlockRangeHash(start, end);
+  };
+
+  for (auto end : {BlockId{0}, BlockId{2}, BlockId{3}, BlockId{10}, BlockId{11}, BlockId{5}, BlockId{150}}) {
+    ASSERT_EQ(expected(0, end), actual(0, end)) << end;
+    ASSERT_EQ(expected(1, std::max(end, BlockId{1})), actual(1, std::max(end, BlockId{1}))) << end;
+  }
+  // Checkpoints at the ends of the ranges and every 4 blocks, the oldest are evicted
+  ASSERT_EQ(checkpoints->size(), 16);
+  ASSERT_EQ(expected(0, 7), actual(0, 7));
+  ASSERT_EQ(expected(0, 149), actual(0, 149));
+
+  // Other clients have their own running hashes
+  auto other = KvbAppFilter(&storage, "8");
+  other.setRangeHashCheckpoints(checkpoints);
+  ASSERT_EQ(KvbAppFilter(&storage, "8").readBlockRangeHash(0, 150), other.readBlockRangeHash(0, 150));
+  ASSERT_NE(expected(0, 150), other.readBlockRangeHash(0, 150));
+}
+
+TEST(kvbc_filter_test, kvbfilter_hash_of_event_groups_in_range_from_checkpoints) {
+  FakeStorage storage;
+  auto checkpoints = std::make_shared<concord::kvbc::RangeHashCheckpoints>(3, 100, 16);
+  auto hash = [&](const std::string &client_id, EventGroupId start, bool use_checkpoints) {
+    auto filter = KvbAppFilter(&storage, client_id);
+    if (use_checkpoints) filter.setRangeHashCheckpoints(checkpoints);
+    return filter.readEventGroupRangeHash(start);
+  };
+
+  // New event groups are hashed on top of the previous running hash
+  for (auto i = 0; i < 5; i++) {
+    storage.fillWithEventGroupData(2, "A");
+    storage.fillWithEventGroupData(i, kPublicEgIdKey);
+    storage.fillWithEventGroupData(1, "B");
+    for (EventGroupId start = 1; start <= 2; start++) {
+      ASSERT_EQ(hash("A", start, false), hash("A", start, true));
+      // Without new event groups, the running hash is taken as is
+      ASSERT_EQ(hash("A", start, false), hash("A", start, true));
+    }
+    ASSERT_EQ(hash("B", 1, false), hash("B", 1, true));
+  }
+  ASSERT_GT(checkpoints->size(), 0);
+  ASSERT_THROW(hash("A", 100, true), InvalidEventGroupRange);
+}
+
+TEST(kvbc_filter_test, range_hash_checkpoints_evict_least_recently_used_range) {
+  using concord::kvbc::RangeHashCheckpoints;
+  const auto stream = RangeHashCheckpoints::Stream::kBlocks;
+  auto checkpoints = RangeHashCheckpoints(1, 8, 2);
+  auto running_hash = concord::util::SHA2_256{};
+  running_hash.init();
+
+  checkpoints.add("A", stream, 0, 1, running_hash);
+  checkpoints.add("A", stream, 0, 2, running_hash);
+  checkpoints.add("B", stream, 0, 1, running_hash);
+  // Using the range of A makes B the least recently used one
+  ASSERT_TRUE(checkpoints.closest("A", stream, 0, 5).has_value());
+  checkpoints.add("C", stream, 0, 1, running_hash);
+  ASSERT_EQ(checkpoints.size(), 3u);
+  ASSERT_EQ(checkpoints.closest("A", stream, 0, 5)->first, 2u);
+  ASSERT_FALSE(checkpoints.closest("B", stream, 0, 5).has_value());
+  ASSERT_TRUE(checkpoints.closest("C", stream, 0, 5).has_value());
+
+  // Streams and first updates are ranges of their own
+  checkpoints.add("A", RangeHashCheckpoints::Stream::kEventGroups, 0, 1, running_hash);
+  checkpoints.add("A", stream, 1, 1, running_hash);
+  ASSERT_EQ(checkpoints.size(), 2u);
+  ASSERT_FALSE(checkpoints.closest("A", stream, 0, 5).has_value());
+}
+
 TEST(kvbc_filter_test, read_eg_range_external_id_mixed) {
   FakeStorage storage;
   storage.fillWithEventGroupData(1, "A");
@@ -813,6 +909,97 @@ TEST(kvbc_filter_test, read_eg_range_external_id_mixed) {
   ASSERT_EQ(expected_eg_id, 10);
 }
 
+TEST(kvbc_filter_test, kvbfilter_read_ahead_blocks_in_range) {
+  FakeStorage storage;
+  storage.fillWithData(kLastBlockId);
+  auto pool = std::make_shared<concord::util::ThreadPool>(2);
+
+  auto read = [&](KvbAppFilter &kvb_filter, BlockId start, BlockId end) {
+    spsc_queue<KvbFilteredUpdate> queue_out{storage.getLastBlockId()};
+    kvb_filter.readBlockRange(start, end, queue_out, false);
+    std::vector<KvbFilteredUpdate> updates;
+    KvbFilteredUpdate update;
+    while (queue_out.pop(update)) {
+      updates.push_back(update);
+    }
+    return updates;
+  };
+
+  auto sequential = KvbAppFilter(&storage, "42");
+  auto read_ahead = KvbAppFilter(&storage, "42");
+  read_ahead.setReadAhead(4, pool);
+  for (const auto &[start, end] : std::vector<std::pair<BlockId, BlockId>>{{0, 0}, {0, 3}, {5, 50}, {1, 150}}) {
+    auto expected = read(sequential, start, end);
+    auto actual = read(read_ahead, start, end);
+    ASSERT_EQ(expected.size(), end - start + 1);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+      ASSERT_EQ(actual[i].block_id, start + i);
+      ASSERT_EQ(actual[i].kv_pairs, expected[i].kv_pairs);
+    }
+  }
+
+  // Blocks that were read ahead are dropped when stopped
+  spsc_queue<KvbFilteredUpdate> queue_out{3};
+  read_ahead.readBlockRange(0, 10, queue_out, true);
+  ASSERT_EQ(queue_out.read_available(), 0);
+}
+
+TEST(kvbc_filter_test, kvbfilter_read_ahead_event_groups_in_range) {
+  FakeStorage storage;
+  storage.fillWithEventGroupData(1, "A");
+  storage.fillWithEventGroupData(5, kPublicEgIdKey);
+  storage.fillWithEventGroupData(3, "B");
+  storage.fillWithEventGroupData(1, kPublicEgIdKey);
+  storage.fillWithEventGroupData(1, "A");
+  storage.fillWithEventGroupData(3, "C");
+  storage.fillWithEventGroupData(1, "B");
+  storage.fillWithEventGroupData(4, kPublicEgIdKey);
+  auto pool = std::make_shared<concord::util::ThreadPool>(2);
+
+  auto read = [](KvbAppFilter &kvb_filter, EventGroupId start) {
+    spsc_queue<KvbFilteredEventGroupUpdate> queue_out{100};
+    kvb_filter.readEventGroupRange(start, queue_out, false);
+    std::vector<KvbFilteredEventGroupUpdate> updates;
+    KvbFilteredEventGroupUpdate update;
+    while (queue_out.pop(update)) {
+      updates.push_back(update);
+    }
+    return updates;
+  };
+
+  const auto clients = std::vector<std::pair<std::string, EventGroupId>>{{"A", 12}, {"B", 14}};
+  for (const auto &[client_id, newest_eg_id] : clients) {
+    auto sequential = KvbAppFilter(&storage, client_id);
+    // Batches that are smaller than, equal to and larger than the number of event groups
+    for (auto depth : {1, 3, 16}) {
+      auto read_ahead = KvbAppFilter(&storage, client_id);
+      read_ahead.setReadAhead(depth, pool);
+      for (EventGroupId start = 1; start <= newest_eg_id; start++) {
+        auto num_multi_gets = storage.num_multi_get_latest_.load();
+        auto expected = read(sequential, start);
+        ASSERT_EQ(storage.num_multi_get_latest_.load(), num_multi_gets);
+        auto actual = read(read_ahead, start);
+        // The event groups are fetched in batches
+        const auto num_batches = storage.num_multi_get_latest_.load() - num_multi_gets;
+        ASSERT_GT(num_batches, 0u);
+        ASSERT_LE(num_batches, expected.size());
+        if (static_cast<size_t>(depth) >= expected.size()) ASSERT_EQ(num_batches, 1u);
+        ASSERT_EQ(expected.size(), newest_eg_id - start + 1);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+          ASSERT_EQ(actual[i].event_group_id, start + i);
+          ASSERT_EQ(actual[i].event_group.events.size(), expected[i].event_group.events.size());
+          for (size_t j = 0; j < expected[i].event_group.events.size(); j++) {
+            ASSERT_EQ(actual[i].event_group.events[j].data, expected[i].event_group.events[j].data);
+            ASSERT_EQ(actual[i].event_group.events[j].tags, expected[i].event_group.events[j].tags);
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(kvbc_filter_test, kvbfilter_success_hash_of_block) {
   FakeStorage storage;
   int client_id = 1;
@@ -10,6 +10,7 @@
 // terms and conditions of the sub-component's license, as noted in the
 // LICENSE file.
 
+#include <atomic>
 #include <map>
 
 #include "sparse_merkle/keys.h"
@@ -37,9 +38,16 @@ class TestDB : public concord::kvbc::sparse_merkle::IDBReader {
     return internal_nodes_.at(root_key);
   }
 
-  BatchedInternalNode get_internal(const InternalNodeKey& key) const override { return internal_nodes_.at(key); }
+  BatchedInternalNode get_internal(const InternalNodeKey& key) const override {
+    ++num_internal_reads_;
+    return internal_nodes_.at(key);
+  }
+
+  size_t numInternalReads() const { return num_internal_reads_; }
 
  private:
+  // Atomic, as parallel updates read concurrently
+  mutable std::atomic_size_t num_internal_reads_{0};
   Version latest_version_ = 0;
   map<LeafKey, LeafNode> leaf_nodes_;
   map<InternalNodeKey, BatchedInternalNode> internal_nodes_;
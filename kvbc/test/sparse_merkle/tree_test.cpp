@@ -10,12 +10,15 @@
 // terms and conditions of the sub-component's license, as noted in the
 // LICENSE file.
 
+#include <map>
 #include <memory>
+#include <random>
 #include <set>
 
 #include "gtest/gtest.h"
 #include "sparse_merkle/tree.h"
 #include "test_db.h"
+#include "thread_pool.hpp"
 
 #include <iostream>
 using namespace std;
@@ -1156,6 +1159,122 @@ TEST(tree_tests, add_and_remove_of_same_existing_key_in_single_update_add_wins)
   ASSERT_TRUE(leafKeyExists("key1", 1, batch.stale.leaf_keys));
 }
 
+// Updating the subtrees of the root in parallel results in the same tree and the same batch as a serial update.
+TEST(tree_tests, parallel_update_matches_serial) {
+  auto serial_db = std::make_shared<TestDB>();
+  auto parallel_db = std::make_shared<TestDB>();
+  Tree serial_tree(serial_db);
+  // The pool threads read through the node cache concurrently
+  Tree parallel_tree(parallel_db,
+                     std::make_shared<concord::util::ThreadPool>(4),
+                     std::make_shared<InternalNodeCache>("parallel_update", 1024 * 1024, 0));
+
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> dist(0, 2000);
+  std::set<std::string> added;
+  for (auto round = 0; round < 10; round++) {
+    SetOfKeyValuePairs updates;
+    KeysVector deletes;
+    for (auto i = 0; i < 300; i++) {
+      auto key = "key" + std::to_string(dist(gen));
+      updates.emplace(Sliver(std::string(key)), Sliver("val" + std::to_string(round)));
+      added.insert(key);
+    }
+    auto i = 0;
+    for (auto it = added.begin(); it != added.end(); i++) {
+      if (i % 7 == 0) {
+        deletes.emplace_back(Sliver(std::string(*it)));
+        it = added.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    auto serial_batch = serial_tree.update(updates, deletes);
+    auto parallel_batch = parallel_tree.update(updates, deletes);
+    db_put(serial_db, serial_batch);
+    db_put(parallel_db, parallel_batch);
+
+    ASSERT_EQ(serial_tree.get_root_hash(), parallel_tree.get_root_hash());
+    ASSERT_EQ(serial_tree.get_version(), parallel_tree.get_version());
+    auto sorted = [](const auto& nodes) { return std::map(nodes.begin(), nodes.end()); };
+    ASSERT_EQ(sorted(serial_batch.internal_nodes), sorted(parallel_batch.internal_nodes));
+    ASSERT_EQ(sorted(serial_batch.leaf_nodes), sorted(parallel_batch.leaf_nodes));
+    ASSERT_EQ(serial_batch.stale.stale_since_version, parallel_batch.stale.stale_since_version);
+    ASSERT_EQ(serial_batch.stale.internal_keys, parallel_batch.stale.internal_keys);
+    ASSERT_EQ(serial_batch.stale.leaf_keys, parallel_batch.stale.leaf_keys);
+  }
+}
+
+// Reading internal nodes through a cache results in the same tree, and the nodes written by an update are not read
+// from the DB by the next one.
+TEST(tree_tests, cached_update_matches_uncached) {
+  auto db = std::make_shared<TestDB>();
+  auto cached_db = std::make_shared<TestDB>();
+  auto cache = std::make_shared<InternalNodeCache>("cached_update", 64 * 1024 * 1024, 0);
+  Tree tree(db);
+  Tree cached_tree(cached_db, nullptr, cache);
+
+  std::mt19937 gen(2);
+  std::uniform_int_distribution<int> dist(0, 1000);
+  for (auto round = 0; round < 20; round++) {
+    SetOfKeyValuePairs updates;
+    for (auto i = 0; i < 50; i++) {
+      updates.emplace(Sliver("key" + std::to_string(dist(gen))), Sliver("val" + std::to_string(round)));
+    }
+    db_put(db, tree.update(updates));
+    db_put(cached_db, cached_tree.update(updates));
+    ASSERT_EQ(tree.get_root_hash(), cached_tree.get_root_hash());
+  }
+  ASSERT_GT(db->numInternalReads(), 0);
+  ASSERT_EQ(0, cached_db->numInternalReads());
+  ASSERT_GT(cache->size(), 0);
+}
+
+TEST(tree_tests, node_cache_evicts_by_size) {
+  const auto max_bytes = 64 * 1024;
+  InternalNodeCache cache("evicts_by_size", max_bytes, 0);
+  auto path = NibblePath{};
+  path.append(Nibble{1});
+  for (auto version = 1; version <= 1000; version++) {
+    cache.put(InternalNodeKey{Version(version), path}, BatchedInternalNode{});
+  }
+  ASSERT_LE(cache.bytes(), max_bytes);
+  ASSERT_GT(cache.size(), 0);
+  // The most recently used nodes are kept
+  ASSERT_TRUE(cache.get(InternalNodeKey{Version(1000), path}));
+  ASSERT_FALSE(cache.get(InternalNodeKey{Version(1), path}));
+}
+
+TEST(tree_tests, node_cache_evicts_by_version_age) {
+  InternalNodeCache cache("evicts_by_age", 1024 * 1024, 10);
+  cache.put(InternalNodeKey::root(1), BatchedInternalNode{});
+  cache.put(InternalNodeKey::root(2), BatchedInternalNode{});
+  cache.advance(Version(5));
+  // Using a node makes it young again
+  ASSERT_TRUE(cache.get(InternalNodeKey::root(2)));
+  cache.advance(Version(12));
+  ASSERT_FALSE(cache.get(InternalNodeKey::root(1)));
+  ASSERT_TRUE(cache.get(InternalNodeKey::root(2)));
+  cache.advance(Version(30));
+  ASSERT_EQ(0, cache.size());
+  ASSERT_EQ(0, cache.bytes());
+}
+
+TEST(tree_tests, node_cache_reset_drops_newer_versions) {
+  InternalNodeCache cache("reset", 1024 * 1024, 0);
+  cache.put(InternalNodeKey::root(1), BatchedInternalNode{});
+  cache.advance(Version(1));
+  cache.put(InternalNodeKey::root(2), BatchedInternalNode{});
+  cache.advance(Version(2));
+  cache.reset(Version(2));
+  ASSERT_EQ(2, cache.size());
+  cache.reset(Version(1));
+  ASSERT_EQ(1, cache.size());
+  ASSERT_TRUE(cache.get(InternalNodeKey::root(1)));
+  ASSERT_FALSE(cache.get(InternalNodeKey::root(2)));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,114 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+#include "v4blockchain/detail/latest_keys_cache.h"
+
+#include <string>
+
+using concord::kvbc::v4blockchain::detail::LatestKeysCache;
+using namespace ::testing;
+
+namespace {
+
+using Value = LatestKeysCache::Value;
+
+TEST(latest_keys_cache, miss) {
+  auto cache = LatestKeysCache{1024 * 1024};
+  ASSERT_FALSE(cache.get("k").has_value());
+  ASSERT_EQ(cache.size(), 0);
+}
+
+TEST(latest_keys_cache, put_and_get) {
+  auto cache = LatestKeysCache{1024 * 1024};
+  cache.put("k1", Value{"v1"}, cache.generation("k1"));
+  cache.put("k2", std::nullopt, cache.generation("k2"));
+  ASSERT_EQ(cache.get("k1"), Value{"v1"});
+  // A key that doesn't exist is cached as std::nullopt.
+  const auto k2 = cache.get("k2");
+  ASSERT_TRUE(k2.has_value());
+  ASSERT_FALSE(k2->has_value());
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_GT(cache.bytes(), 0);
+}
+
+TEST(latest_keys_cache, staged_writes_are_applied_on_commit) {
+  auto cache = LatestKeysCache{1024 * 1024};
+  cache.put("k1", Value{"v1"}, cache.generation("k1"));
+  cache.put("k2", Value{"v2"}, cache.generation("k2"));
+  cache.stage("k1", Value{"v1'"});
+  cache.stage("k2", std::nullopt);
+  cache.stage("k3", Value{"v3"});
+  ASSERT_EQ(cache.get("k1"), Value{"v1"});
+  ASSERT_EQ(cache.get("k2"), Value{"v2"});
+  ASSERT_FALSE(cache.get("k3").has_value());
+
+  cache.commit();
+  ASSERT_EQ(cache.get("k1"), Value{"v1'"});
+  ASSERT_FALSE(cache.get("k2").has_value());
+  ASSERT_EQ(cache.get("k3"), Value{"v3"});
+}
+
+TEST(latest_keys_cache, discarded_writes_are_not_applied) {
+  auto cache = LatestKeysCache{1024 * 1024};
+  cache.stage("k", Value{"v"});
+  cache.discardStaged();
+  cache.commit();
+  ASSERT_FALSE(cache.get("k").has_value());
+}
+
+TEST(latest_keys_cache, read_older_than_commit_is_not_cached) {
+  auto cache = LatestKeysCache{1024 * 1024};
+  // A reader reads the old value from storage while a block with a new value is written and committed.
+  const auto generation = cache.generation("k");
+  cache.stage("k", Value{"new"});
+  cache.commit();
+  cache.put("k", Value{"old"}, generation);
+  ASSERT_EQ(cache.get("k"), Value{"new"});
+}
+
+TEST(latest_keys_cache, clear) {
+  auto cache = LatestKeysCache{1024 * 1024};
+  cache.put("k1", Value{"v1"}, cache.generation("k1"));
+  const auto generation = cache.generation("k2");
+  cache.stage("k3", Value{"v3"});
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_EQ(cache.bytes(), 0);
+  ASSERT_FALSE(cache.get("k1").has_value());
+  // Reads that started before the clear are not cached.
+  cache.put("k2", Value{"v2"}, generation);
+  ASSERT_FALSE(cache.get("k2").has_value());
+  // Staged writes are dropped.
+  cache.commit();
+  ASSERT_FALSE(cache.get("k3").has_value());
+}
+
+TEST(latest_keys_cache, evicts_least_recently_used) {
+  // A small cache, such that a shard holds a few entries only.
+  auto cache = LatestKeysCache{16 * 1024};
+  const auto value = std::string(100, 'v');
+  for (auto i = 0; i < 1000; ++i) {
+    const auto key = "k" + std::to_string(i);
+    cache.put(key, value, cache.generation(key));
+    // Keep k0 hot.
+    ASSERT_TRUE(cache.get("k0").has_value());
+  }
+  ASSERT_LE(cache.bytes(), 16 * 1024);
+  ASSERT_LT(cache.size(), 1000);
+  ASSERT_TRUE(cache.get("k0").has_value());
+  ASSERT_FALSE(cache.get("k1").has_value());
+  ASSERT_TRUE(cache.get("k999").has_value());
+}
+
+}  // namespace
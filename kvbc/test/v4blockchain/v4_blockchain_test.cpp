@@ -453,6 +453,44 @@ TEST_F(v4_kvbc, add_and_read_blocks) {
   }
 }
 
+TEST_F(v4_kvbc, group_commit) {
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  blockchain->setAggregator(aggregator);
+  auto group_commits = [&]() { return aggregator->GetCounter("v4_blockchain", "numOfGroupCommits").Get(); };
+  auto committed_blocks = [&]() { return aggregator->GetCounter("v4_blockchain", "numOfGroupCommittedBlocks").Get(); };
+  blockchain->setGroupCommit(3, 1024 * 1024 * 1024);
+  uint32_t num_merkle_each = 0;
+  uint32_t num_versioned_each = 0;
+  uint32_t num_immutable_each = 0;
+  create_blocks(7, num_merkle_each, num_versioned_each, num_immutable_each);
+  // Blocks are visible before their group is committed
+  ASSERT_EQ(blockchain->getLastReachableBlockId(), 7);
+  auto val = blockchain->getLatest("merkle", "merkle_key_7_1");
+  ASSERT_TRUE(val.has_value());
+  ASSERT_EQ(std::get<kvbc::categorization::MerkleValue>(*val).data, "merkle_value_7_1");
+  ASSERT_EQ(group_commits(), 2);
+  ASSERT_EQ(committed_blocks(), 6);
+
+  // A checkpoint flushes the partial group
+  blockchain->flushBlocks();
+  ASSERT_EQ(group_commits(), 3);
+  ASSERT_EQ(committed_blocks(), 7);
+  blockchain->flushBlocks();
+  ASSERT_EQ(group_commits(), 3);
+
+  // The bytes bound flushes every block
+  blockchain->setGroupCommit(100, 1);
+  create_blocks(9, num_merkle_each, num_versioned_each, num_immutable_each, 8);
+  ASSERT_EQ(group_commits(), 5);
+  ASSERT_EQ(committed_blocks(), 9);
+
+  // Disabled
+  blockchain->setGroupCommit(0, 0);
+  create_blocks(10, num_merkle_each, num_versioned_each, num_immutable_each, 10);
+  blockchain->flushBlocks();
+  ASSERT_EQ(group_commits(), 5);
+}
+
 TEST_F(v4_kvbc, trim_history_get_block_sequence_number) {
   {
     categorization::Updates updates;
@@ -1681,6 +1719,51 @@ TEST_F(v4_kvbc, parent_digest) {
   }
 }
 
+TEST_F(v4_kvbc, st_link_digest_pipeline) {
+  uint32_t num_merkle_each = 0;
+  uint32_t num_versioned_each = 0;
+  uint32_t num_immutable_each = 0;
+  create_blocks(50, num_merkle_each, num_versioned_each, num_immutable_each);
+
+  const auto st_db_id = 1;
+  cleanup(st_db_id);
+  auto& config = bftEngine::ReplicaConfig::instance();
+  const auto depth = config.stLinkDigestPipelineDepth;
+  config.stLinkDigestPipelineDepth = 8;
+  {
+    auto st_db = TestRocksDb::createNative(st_db_id);
+    v4blockchain::KeyValueBlockchain blockchain2{
+        st_db,
+        true,
+        std::map<std::string, categorization::CATEGORY_TYPE>{
+            {"merkle", categorization::CATEGORY_TYPE::block_merkle},
+            {"versioned", categorization::CATEGORY_TYPE::versioned_kv},
+            {"versioned_2", categorization::CATEGORY_TYPE::versioned_kv},
+            {"immutable", categorization::CATEGORY_TYPE::immutable},
+            {categorization::kConcordInternalCategoryId, categorization::CATEGORY_TYPE::versioned_kv}}};
+    for (BlockId i = 1; i <= 50; ++i) {
+      auto block_data = *(blockchain->getBlockData(i));
+      blockchain2.addBlockToSTChain(i, block_data.c_str(), block_data.size(), false);
+    }
+    ASSERT_EQ(blockchain2.linkUntilBlockId(20), 20);
+    blockchain2.linkSTChain();
+    ASSERT_EQ(blockchain2.getLastReachableBlockId(), 50);
+    // The first block of each range is linked with the digest of the last block in the blockchain
+    ASSERT_EQ(blockchain2.getBlockchain().from_pipeline, 48);
+    for (BlockId i = 1; i <= 50; ++i) {
+      ASSERT_EQ(*(blockchain2.getBlockData(i)), *(blockchain->getBlockData(i)));
+    }
+
+    // Continues from the last linked block
+    create_blocks(51, num_merkle_each, num_versioned_each, num_immutable_each, 51);
+    auto block_data = *(blockchain->getBlockData(51));
+    blockchain2.addBlockToSTChain(51, block_data.c_str(), block_data.size(), true);
+    ASSERT_EQ(*(blockchain2.getBlockData(51)), block_data);
+  }
+  config.stLinkDigestPipelineDepth = depth;
+  cleanup(st_db_id);
+}
+
 TEST_F(v4_kvbc, prun_on_st) {
   v4blockchain::KeyValueBlockchain blockchain2{
       db,
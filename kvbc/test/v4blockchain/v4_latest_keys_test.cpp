@@ -318,6 +318,80 @@ TEST_F(v4_kvbc, add_and_get_keys) {
   }
 }
 
+TEST_F(v4_kvbc, cached_latest_keys) {
+  bftEngine::ReplicaConfig::instance().v4LatestKeysCacheMaxBytes = 1024 * 1024;
+  v4blockchain::detail::LatestKeys latest_keys{db, categories};
+  bftEngine::ReplicaConfig::instance().v4LatestKeysCacheMaxBytes = 0;
+  const auto add_block = [&](categorization::Updates&& updates, BlockId block_id) {
+    auto wb = db->getBatch();
+    latest_keys.addBlockKeys(updates, block_id, wb);
+    db->write(std::move(wb));
+    latest_keys.onBlockWritten();
+  };
+  const auto merkle_value = [&](const std::string& key) -> std::optional<std::string> {
+    auto value = latest_keys.getValue("merkle", key);
+    if (!value) return std::nullopt;
+    return std::get<categorization::MerkleValue>(*value).data;
+  };
+
+  {
+    categorization::Updates updates;
+    categorization::BlockMerkleUpdates merkle_updates;
+    merkle_updates.addUpdate("k1", "v1");
+    merkle_updates.addUpdate("k2", "v2");
+    updates.add("merkle", std::move(merkle_updates));
+    categorization::VersionedUpdates ver_updates;
+    ver_updates.addUpdate("stale", categorization::VersionedUpdates::Value{"v", true});
+    updates.add("versioned", std::move(ver_updates));
+    add_block(std::move(updates), 1);
+  }
+  // Cache the values, and the key that doesn't exist.
+  ASSERT_EQ(merkle_value("k1"), "v1");
+  ASSERT_EQ(merkle_value("k2"), "v2");
+  ASSERT_EQ(merkle_value("k3"), std::nullopt);
+  ASSERT_TRUE(latest_keys.getValue("versioned", "stale").has_value());
+
+  {
+    categorization::Updates updates;
+    categorization::BlockMerkleUpdates merkle_updates;
+    merkle_updates.addUpdate("k1", "v1'");
+    merkle_updates.addUpdate("k3", "v3");
+    merkle_updates.addDelete("k2");
+    updates.add("merkle", std::move(merkle_updates));
+    categorization::VersionedUpdates ver_updates;
+    ver_updates.addUpdate("stale", categorization::VersionedUpdates::Value{"v'", true});
+    updates.add("versioned", std::move(ver_updates));
+    add_block(std::move(updates), 2);
+  }
+  // The writes of the block are written through to the cache.
+  ASSERT_EQ(merkle_value("k1"), "v1'");
+  ASSERT_EQ(merkle_value("k2"), std::nullopt);
+  ASSERT_EQ(merkle_value("k3"), "v3");
+  ASSERT_EQ(latest_keys.getLatestVersion("merkle", "k1")->version, 2);
+  ASSERT_EQ(std::get<categorization::VersionedValue>(*latest_keys.getValue("versioned", "stale")).data, "v'");
+
+  std::vector<std::optional<categorization::Value>> values;
+  latest_keys.multiGetValue("merkle", {"k1", "k2", "k3", "k4"}, values);
+  ASSERT_EQ(values.size(), 4);
+  ASSERT_EQ(std::get<categorization::MerkleValue>(*values[0]).data, "v1'");
+  ASSERT_FALSE(values[1].has_value());
+  ASSERT_EQ(std::get<categorization::MerkleValue>(*values[2]).data, "v3");
+  ASSERT_FALSE(values[3].has_value());
+  std::vector<std::optional<categorization::TaggedVersion>> versions;
+  latest_keys.multiGetLatestVersion("merkle", {"k1", "k4"}, versions);
+  ASSERT_EQ(versions.size(), 2);
+  ASSERT_EQ(versions[0]->version, 2);
+  ASSERT_FALSE(versions[1].has_value());
+
+  // Storage changes that are not written through are seen once the cache is cleared.
+  const auto stored_value = std::string{"v4"} + std::string(v4blockchain::detail::LatestKeys::FLAGS_SIZE, '\0') +
+                            v4blockchain::detail::Blockchain::generateKey(3);
+  db->put(v4blockchain::detail::LATEST_KEYS_CF, latest_keys.getCategoryPrefix("merkle") + "k4", stored_value);
+  ASSERT_EQ(merkle_value("k4"), std::nullopt);
+  latest_keys.onBlockReverted();
+  ASSERT_EQ(merkle_value("k4"), "v4");
+}
+
 }  // end namespace
 
 int main(int argc, char** argv) {
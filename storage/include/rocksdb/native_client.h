@@ -109,6 +109,9 @@ class NativeClient : public std::enable_shared_from_this<NativeClient> {
   NativeWriteBatch getBatch(size_t reserved_bytes = 0) const;
   NativeWriteBatch getBatch(std::string &&data) const;
   void write(NativeWriteBatch &&);
+  // Write the WAL buffered by RocksDB (if any) to the log file and, if sync is true, sync the log file to disk. Used to
+  // sync several unsynced writes at once.
+  void flushWal(bool sync);
 
   // MultiGet interface
   //
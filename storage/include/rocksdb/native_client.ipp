@@ -218,6 +218,11 @@ inline void NativeClient::write(NativeWriteBatch &&b) {
   detail::throwOnError("write(batch) failed"sv, std::move(s));
 }
 
+inline void NativeClient::flushWal(bool sync) {
+  auto s = client_->dbInstance_->FlushWAL(sync);
+  detail::throwOnError("flushWal failed"sv, std::move(s));
+}
+
 inline std::unordered_set<std::string> NativeClient::columnFamilies(const std::string &path) {
   auto families = std::vector<std::string>{};
   auto status = ::rocksdb::DB::ListColumnFamilies(::rocksdb::DBOptions{}, path, &families);
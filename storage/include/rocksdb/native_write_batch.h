@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace concord::storage::rocksdb {
 
@@ -63,6 +64,9 @@ class NativeWriteBatch {
   template <typename BeginSpan, typename EndSpan>
   void delRange(const BeginSpan &beginKey, const EndSpan &endKey);
 
+  // Add the updates of another batch of the same client after the updates of this one.
+  void append(const NativeWriteBatch &other);
+
   std::size_t size() const;
   std::uint32_t count() const;
   const std::string &data() const { return batch_.Data(); }
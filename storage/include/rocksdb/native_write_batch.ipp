@@ -101,6 +101,53 @@ void NativeWriteBatch::delRange(const BeginSpan &beginKey, const EndSpan &endKey
   delRange(client_->defaultColumnFamily(), beginKey, endKey);
 }
 
+inline void NativeWriteBatch::append(const NativeWriteBatch &other) {
+  // Replay the updates of the other batch through the public WriteBatch API instead of relying on its representation.
+  class Appender : public ::rocksdb::WriteBatch::Handler {
+   public:
+    Appender(const NativeClient &client, ::rocksdb::WriteBatch &batch) : client_{client}, batch_{batch} {}
+
+    ::rocksdb::Status PutCF(std::uint32_t cf_id, const ::rocksdb::Slice &key, const ::rocksdb::Slice &value) override {
+      auto handle = columnFamilyHandle(cf_id);
+      return handle ? batch_.Put(handle, key, value) : unknownColumnFamily(cf_id);
+    }
+    ::rocksdb::Status DeleteCF(std::uint32_t cf_id, const ::rocksdb::Slice &key) override {
+      auto handle = columnFamilyHandle(cf_id);
+      return handle ? batch_.Delete(handle, key) : unknownColumnFamily(cf_id);
+    }
+    ::rocksdb::Status DeleteRangeCF(std::uint32_t cf_id,
+                                    const ::rocksdb::Slice &begin_key,
+                                    const ::rocksdb::Slice &end_key) override {
+      auto handle = columnFamilyHandle(cf_id);
+      return handle ? batch_.DeleteRange(handle, begin_key, end_key) : unknownColumnFamily(cf_id);
+    }
+
+   private:
+    ::rocksdb::ColumnFamilyHandle *columnFamilyHandle(std::uint32_t cf_id) {
+      if (handles_.empty()) {
+        for (const auto &cf : client_.columnFamilies()) {
+          auto handle = client_.columnFamilyHandle(cf);
+          handles_.emplace(handle->GetID(), handle);
+        }
+      }
+      auto it = handles_.find(cf_id);
+      return it != handles_.cend() ? it->second : nullptr;
+    }
+    static ::rocksdb::Status unknownColumnFamily(std::uint32_t cf_id) {
+      return ::rocksdb::Status::InvalidArgument("unknown column family id " + std::to_string(cf_id));
+    }
+
+    const NativeClient &client_;
+    ::rocksdb::WriteBatch &batch_;
+    std::unordered_map<std::uint32_t, ::rocksdb::ColumnFamilyHandle *> handles_;
+  };
+
+  if (other.count() == 0) return;
+  auto appender = Appender{*client_, batch_};
+  auto s = other.batch_.Iterate(&appender);
+  detail::throwOnError("batch append failed"sv, std::move(s));
+}
+
 inline std::size_t NativeWriteBatch::size() const { return batch_.GetDataSize(); }
 
 inline std::uint32_t NativeWriteBatch::count() const { return batch_.Count(); }
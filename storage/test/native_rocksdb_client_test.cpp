@@ -364,6 +364,38 @@ TEST_F(native_rocksdb_test, batch_operations_honor_order) {
   }
 }
 
+TEST_F(native_rocksdb_test, append_batch) {
+  const auto cf = "cf"s;
+  db->createColumnFamily(cf);
+  db->put(key3, value3);
+  db->put(cf, key2, value2);
+  auto batch = db->getBatch();
+  batch.put(key1, value1);
+  batch.put(key2, value);
+  auto other = db->getBatch();
+  other.put(cf, key1, value2);
+  other.put(key2, value2);
+  other.del(key3);
+  other.delRange(cf, key2, key3);
+  batch.append(other);
+  batch.append(db->getBatch());
+  ASSERT_EQ(batch.count(), 6u);
+  db->write(std::move(batch));
+
+  const auto dbValue1 = db->get(key1);
+  ASSERT_TRUE(dbValue1.has_value());
+  ASSERT_EQ(*dbValue1, value1);
+  const auto cfValue1 = db->get(cf, key1);
+  ASSERT_TRUE(cfValue1.has_value());
+  ASSERT_EQ(*cfValue1, value2);
+  // The updates of the appended batch come after the updates of the batch.
+  const auto dbValue2 = db->get(key2);
+  ASSERT_TRUE(dbValue2.has_value());
+  ASSERT_EQ(*dbValue2, value2);
+  ASSERT_FALSE(db->get(key3).has_value());
+  ASSERT_FALSE(db->get(cf, key2).has_value());
+}
+
 TEST_F(native_rocksdb_test, put_container_in_batch_in_default_family) {
   const auto kvSet = SetOfKeyValuePairs{std::make_pair(toSliver(key1), toSliver(value1)),
                                         std::make_pair(toSliver(key2), toSliver(value2))};
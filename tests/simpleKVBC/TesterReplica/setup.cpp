@@ -388,6 +388,10 @@ std::unique_ptr<TestSetup> TestSetup::ParseArgs(int argc, char** argv) {
                                                                            commConfigFile,
                                                                            replicaConfig.useUnifiedCertificates,
                                                                            certRootPath);
+    conf.maxCoalescedWriteMsgs_ = replicaConfig.tlsMaxCoalescedWriteMsgs;
+    conf.maxCoalescedWriteBytes_ = replicaConfig.tlsMaxCoalescedWriteBytes;
+    conf.numOfIoShards_ = replicaConfig.tlsNumOfIoShards;
+    conf.pinIoShardsToCores_ = replicaConfig.tlsPinIoShardsToCores;
     if (conf.secretData_.has_value()) {
       sm_ = std::make_shared<concord::secretsmanager::SecretsManagerEnc>(conf.secretData_.value());
     } else {
@@ -0,0 +1,128 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#ifndef CONCORD_THIN_REPLICA_BROADCAST_RING_HPP_
+#define CONCORD_THIN_REPLICA_BROADCAST_RING_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "assertUtils.hpp"
+
+namespace concord {
+namespace thin_replica {
+
+// A ring of the last `capacity` immutable updates, written by a producer and read by any number of readers.
+//
+// Every update gets a sequence number (0, 1, ...) and is stored once, no matter how many readers there are. Each
+// reader keeps its own cursor - the sequence number of the next update it reads - so the producer never waits for
+// the readers: a reader that falls more than `capacity` updates behind finds its update overwritten.
+//
+// Producers are serialized between themselves, readers never take the producer lock. Readers that wait for updates
+// wait on a single wake-up shared by the whole ring, so publishing is O(1) no matter how many readers there are.
+template <typename T>
+class BroadcastRing {
+ public:
+  using Value = std::shared_ptr<const T>;
+  using Clock = std::chrono::steady_clock;
+
+  explicit BroadcastRing(size_t capacity) : slots_(capacity), published_at_(capacity) { ConcordAssertGT(capacity, 0); }
+
+  BroadcastRing(const BroadcastRing&) = delete;
+  BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+  void publish(Value value) {
+    ConcordAssertNE(value, nullptr);
+    std::lock_guard<std::mutex> lock(producer_mutex_);
+    const auto seq = published_.load(std::memory_order_relaxed);
+    // Readers of the update being overwritten check claimed_ after they read the slot
+    claimed_.store(seq + 1);
+    std::atomic_store(&slots_[seq % slots_.size()], std::move(value));
+    published_at_[seq % slots_.size()].store(Clock::now().time_since_epoch().count());
+    published_.store(seq + 1);
+    notify();
+  }
+
+  // The number of updates published so far, i.e. the sequence number of the next update.
+  uint64_t published() const { return published_.load(); }
+
+  // Return the update with the given sequence number (which must be published already), or nullptr if it was
+  // overwritten. If `published_at` isn't nullptr, it is set to the time the update was published.
+  Value read(uint64_t seq, Clock::time_point* published_at = nullptr) const {
+    ConcordAssertLT(seq, published());
+    auto value = std::atomic_load(&slots_[seq % slots_.size()]);
+    const auto published_at_count = published_at_[seq % slots_.size()].load();
+    if (claimed_.load() > seq + slots_.size()) {
+      return nullptr;
+    }
+    if (published_at) *published_at = Clock::time_point{Clock::duration{published_at_count}};
+    return value;
+  }
+
+  size_t capacity() const { return slots_.size(); }
+
+  // Wait until `pred` returns true, or until `deadline` if given. Return false if the deadline passed. `pred` is
+  // evaluated under the wake-up lock, and again whenever an update is published or notifyReaders() is called.
+  template <typename PredT>
+  bool wait(const std::optional<Clock::time_point>& deadline, PredT pred) {
+    std::unique_lock<std::mutex> lock(wakeup_mutex_);
+    ++waiters_;
+    auto ready = true;
+    if (deadline) {
+      ready = wakeup_.wait_until(lock, *deadline, pred);
+    } else {
+      wakeup_.wait(lock, pred);
+    }
+    --waiters_;
+    return ready;
+  }
+
+  // Wake the waiting readers up after a change to their predicates that isn't a publication. The caller must not
+  // hold a lock that the predicates take.
+  void notifyReaders() {
+    {
+      std::lock_guard<std::mutex> lock(wakeup_mutex_);
+    }
+    wakeup_.notify_all();
+  }
+
+ private:
+  void notify() {
+    if (waiters_.load() > 0) {
+      // Make sure the waiting readers either evaluate their predicates after the update or are already waiting
+      std::lock_guard<std::mutex> lock(wakeup_mutex_);
+    }
+    wakeup_.notify_all();
+  }
+
+  std::vector<Value> slots_;
+  // The publication time of the update in the slot with the same index
+  std::vector<std::atomic<Clock::rep>> published_at_;
+  std::mutex producer_mutex_;
+  // The number of updates whose slot may have been written
+  std::atomic_uint64_t claimed_{0};
+  std::atomic_uint64_t published_{0};
+  std::mutex wakeup_mutex_;
+  std::condition_variable wakeup_;
+  std::atomic_uint32_t waiters_{0};
+};
+
+}  // namespace thin_replica
+}  // namespace concord
+
+#endif  // CONCORD_THIN_REPLICA_BROADCAST_RING_HPP_
@@ -0,0 +1,214 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "Metrics.hpp"
+#include "diagnostics.h"
+#include "performance_handler.h"
+
+namespace concord {
+namespace thin_replica {
+
+// Every live update is pushed to all the subscribers, and the subscribers of the same client id filter it in the same
+// way. LiveUpdateFanout makes sure that a live update is filtered and turned into a response only once per client id,
+// and hands out the same refcounted response to all the streams of that client id.
+//
+// The first stream that asks for the response of an update computes it. Streams that ask for it concurrently wait for
+// that computation instead of repeating it. Responses are kept for the last `capacity` updates - a stream that lags
+// further behind computes its own response.
+//
+// The response is handed out in a Delivery. The streams report their writes of the response to it, and once all of
+// them released it, the time from the publication of the update until the last write is recorded as the fan-out
+// latency.
+template <typename ResponseT>
+class LiveUpdateFanout {
+ public:
+  // nullptr if the update has nothing for the client.
+  using Response = std::shared_ptr<const ResponseT>;
+  using Clock = std::chrono::steady_clock;
+
+  class Delivery {
+   public:
+    Delivery(Response response,
+             Clock::time_point published_at,
+             std::shared_ptr<concord::diagnostics::Recorder> recorder)
+        : response_{std::move(response)}, published_at_{published_at}, recorder_{std::move(recorder)} {}
+    Delivery(const Delivery&) = delete;
+    Delivery& operator=(const Delivery&) = delete;
+    ~Delivery() {
+      const auto last_written = last_written_.load();
+      if (last_written == kNotWritten) return;
+      recorder_->recordAtomic(std::chrono::duration_cast<std::chrono::microseconds>(
+                                  Clock::time_point{Clock::duration{last_written}} - published_at_)
+                                  .count());
+    }
+
+    const Response& response() const { return response_; }
+
+    // Called by every stream after it wrote the response
+    void written() {
+      const auto now = Clock::now().time_since_epoch().count();
+      auto last_written = last_written_.load();
+      while (last_written < now && !last_written_.compare_exchange_weak(last_written, now)) {
+      }
+    }
+
+   private:
+    static constexpr Clock::rep kNotWritten = std::numeric_limits<Clock::rep>::min();
+    const Response response_;
+    const Clock::time_point published_at_;
+    const std::shared_ptr<concord::diagnostics::Recorder> recorder_;
+    std::atomic<Clock::rep> last_written_{kNotWritten};
+  };
+  using DeliveryPtr = std::shared_ptr<Delivery>;
+
+  LiveUpdateFanout(size_t capacity, const std::string& stream_type)
+      : capacity_{capacity},
+        metrics_component_{"ThinReplicaServerFanout_" + stream_type, std::make_shared<concordMetrics::Aggregator>()},
+        num_filtered_updates_{metrics_component_.RegisterAtomicCounter("num_filtered_updates")},
+        num_shared_updates_{metrics_component_.RegisterAtomicCounter("num_shared_updates")},
+        histograms_{"trs_fanout_" + stream_type} {
+    metrics_component_.Register();
+  }
+
+  LiveUpdateFanout(const LiveUpdateFanout&) = delete;
+  LiveUpdateFanout& operator=(const LiveUpdateFanout&) = delete;
+
+  // Returns the response of `client_id` to the live update `update_id` (a block ID or a global event group ID),
+  // calling `make_response()` if it isn't available. `external_id` is the event group ID exposed to the client, it is
+  // part of the response (0 for blocks). `published_at` is the time the update was published to the subscribers.
+  template <typename MakeResponse>
+  DeliveryPtr get(const std::string& client_id,
+                  bool event_group,
+                  uint64_t update_id,
+                  uint64_t external_id,
+                  Clock::time_point published_at,
+                  MakeResponse&& make_response) {
+    if (capacity_ == 0) return getUnshared(published_at, std::forward<MakeResponse>(make_response));
+    auto key = Key{client_id, event_group, update_id, external_id};
+    auto promise = std::promise<DeliveryPtr>{};
+    auto entry = std::shared_future<DeliveryPtr>{};
+    auto is_owner = false;
+    auto seq = uint64_t{0};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        entry = it->second.response;
+      } else {
+        is_owner = true;
+        seq = next_seq_++;
+        entry = promise.get_future().share();
+        order_.push_back(key);
+        entries_.emplace(key, Entry{entry, seq, std::prev(order_.end())});
+        while (order_.size() > capacity_) {
+          entries_.erase(order_.front());
+          order_.pop_front();
+        }
+      }
+    }
+
+    if (!is_owner) {
+      // Waits if the response is still being computed, and rethrows if its computation failed
+      auto delivery = entry.get();
+      num_shared_updates_++;
+      return delivery;
+    }
+
+    try {
+      auto delivery = std::make_shared<Delivery>(make_response(), published_at, histograms_.fanout_latency);
+      promise.set_value(delivery);
+      num_filtered_updates_++;
+      return delivery;
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+      std::lock_guard<std::mutex> lock(mutex_);
+      // The entry might have been evicted, and the key added again by another stream, in the meantime
+      auto it = entries_.find(key);
+      if (it != entries_.end() && it->second.seq == seq) {
+        order_.erase(it->second.order_it);
+        entries_.erase(it);
+      }
+      throw;
+    }
+  }
+
+  // Returns a response that isn't shared with other streams
+  template <typename MakeResponse>
+  DeliveryPtr getUnshared(Clock::time_point published_at, MakeResponse&& make_response) {
+    num_filtered_updates_++;
+    return std::make_shared<Delivery>(make_response(), published_at, histograms_.fanout_latency);
+  }
+
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+    metrics_component_.SetAggregator(aggregator);
+  }
+
+  void updateAggregator() { metrics_component_.UpdateAggregator(); }
+
+ private:
+  // client id, event group, update id, external id
+  using Key = std::tuple<std::string, bool, uint64_t, uint64_t>;
+
+  struct Entry {
+    std::shared_future<DeliveryPtr> response;
+    // Distinguishes the entry from later entries of the same key
+    uint64_t seq;
+    // Position of the key in order_
+    typename std::list<Key>::iterator order_it;
+  };
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::map<Key, Entry> entries_;
+  // Keys of entries_ in insertion order, for eviction
+  std::list<Key> order_;
+  uint64_t next_seq_{0};
+
+  concordMetrics::Component metrics_component_;
+  // Number of responses computed (once per client id)
+  concordMetrics::AtomicCounterHandle num_filtered_updates_;
+  // Number of responses shared with other streams of the same client id
+  concordMetrics::AtomicCounterHandle num_shared_updates_;
+
+  // 60 seconds
+  static constexpr int64_t MAX_VALUE_MICROSECONDS = 1000 * 1000 * 60l;
+  struct Recorders {
+    Recorders(const std::string& component) {
+      auto& registrar = concord::diagnostics::RegistrarSingleton::getInstance();
+      if (!registrar.perf.isRegisteredComponent(component)) {
+        registrar.perf.registerComponent(component, {fanout_latency});
+      }
+    }
+    // Time from the publication of a live update until the last stream of the same client id wrote its response
+    DEFINE_SHARED_RECORDER(fanout_latency, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+  };
+  Recorders histograms_;
+};
+
+}  // namespace thin_replica
+}  // namespace concord
@@ -15,14 +15,20 @@
 #define CONCORD_THIN_REPLICA_SUBSCRIPTION_BUFFER_HPP_
 
 #include <categorization/updates.h>
-#include <boost/lockfree/spsc_queue.hpp>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <tuple>
 #include <unordered_set>
 #include "Logger.hpp"
 #include "assertUtils.hpp"
+#include "broadcast_ring.hpp"
 #include "block_update/block_update.hpp"
 #include "block_update/event_group_update.hpp"
 #include "kv_types.hpp"
@@ -38,275 +44,355 @@ class ConsumerTooSlow : public std::runtime_error {
 typedef kvbc::BlockUpdate SubUpdate;
 typedef kvbc::EventGroupUpdate SubEventGroupUpdate;
 
-// Each subscriber creates its own spsc queue and puts it into the shared list
-// of subscriber buffers. This is a thread-safe implementation around boost's
-// spsc queue in order to use an additional wake-up mechanism. We expect a
-// single producer (the commands handler) and a single consumer (the subscriber
-// thread in the thin replica gRPC service).
+// A subscriber's view of the live updates. The updates are kept, once for all subscribers, in the broadcast rings
+// of the SubBufferList the buffer is added to, and the buffer only holds the subscriber's position in them. Updates
+// can also be pushed to the buffer itself (e.g. before it is added to a list); these are kept by the buffer and read
+// in the order they were pushed/published. We expect a single producer (the commands handler) and a single consumer
+// (the subscriber thread in the thin replica gRPC service).
+//
+// A consumer that falls more than `size` updates behind the producer is too slow: the updates it missed may have
+// been overwritten, so it can't continue and gets a ConsumerTooSlow exception.
 class SubUpdateBuffer {
  public:
   explicit SubUpdateBuffer(size_t size)
       : logger_(logging::getLogger("concord.thin_replica.sub_buffer")),
-        queue_(size),
-        eg_queue_(size),
-        too_slow_(false),
-        eg_too_slow_(false),
-        newest_block_id_(0),
-        newest_event_group_id_(0) {}
+        blocks_(size, logger_),
+        event_groups_(size, logger_) {}
 
   // Let's help ourselves and make sure we don't copy this buffer
   SubUpdateBuffer(const SubUpdateBuffer&) = delete;
   SubUpdateBuffer& operator=(const SubUpdateBuffer&) = delete;
 
-  // Add an update to the queue and notify waiting subscribers
-  void Push(const SubUpdate& update) {
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-      if (!too_slow_ && !queue_.push(update)) {
-        // If we fail to push a new update (because the queue is full) we
-        // indicate that this queue is unusable and the reader should clean-up.
-        // Not stopping the subscription will lead to a failure on the consumer
-        // end (TRC) eventually. Therefore, let's stop it right here.
-        too_slow_ = true;
-        LOG_WARN(logger_, "Failed to add update. Consumer too slow.");
-      } else {
-        newest_block_id_ = update.block_id;
-      }
-    }
-    cv_.notify_one();
-  }
+  // Add an update to this buffer only and notify the waiting subscriber
+  void Push(const SubUpdate& update) { blocks_.push(std::make_shared<const SubUpdate>(update)); }
 
-  // Add an update to the queue and notify waiting subscribers
+  // Add an update to this buffer only and notify the waiting subscriber
   void PushEventGroup(const SubEventGroupUpdate& update) {
-    {
-      std::unique_lock<std::mutex> lock(eg_mutex_);
-      if (!eg_too_slow_ && !eg_queue_.push(update)) {
-        // If we fail to push a new update (because the queue is full) we
-        // indicate that this queue is unusable and the reader should clean-up.
-        // Not stopping the subscription will lead to a failure on the consumer
-        // end (TRC) eventually. Therefore, let's stop it right here.
-        eg_too_slow_ = true;
-        LOG_WARN(logger_, "Failed to add update. Consumer too slow.");
-      } else {
-        newest_event_group_id_ = update.event_group_id;
-      }
-    }
-    eg_cv_.notify_one();
+    event_groups_.push(std::make_shared<const SubEventGroupUpdate>(update));
   }
 
-  // Return the oldest update (block if queue is empty)
-  void Pop(SubUpdate& out) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    cv_.wait(lock, [this] { return too_slow_ || queue_.read_available(); });
-
-    if (too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
-
-    ConcordAssert(queue_.pop(out));
-  }
+  // Return the oldest update (block if there is none)
+  void Pop(SubUpdate& out) { out = *blocks_.pop(std::nullopt); }
 
   template <typename RepT, typename PeriodT>
   bool TryPop(SubUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    cv_.wait_for(lock, timeout, [this] { return too_slow_ || queue_.read_available(); });
-
-    if (too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
-
-    if (queue_.read_available()) {
-      ConcordAssert(queue_.pop(out));
-      return true;
-    }
-    return false;
+    auto update = blocks_.pop(toTimeout(timeout));
+    if (!update) return false;
+    out = *update;
+    return true;
   }
 
-  // Return the oldest update (event group if queue is empty)
-  void PopEventGroup(SubEventGroupUpdate& out) {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    eg_cv_.wait(lock, [this] { return eg_too_slow_ || eg_queue_.read_available(); });
-
-    if (eg_too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
-
-    ConcordAssert(eg_queue_.pop(out));
+  // Return the oldest update without copying it - the update is shared with the other subscribers. If `published_at`
+  // isn't nullptr, it is set to the time the update was published.
+  template <typename RepT, typename PeriodT>
+  bool TryPop(std::shared_ptr<const SubUpdate>& out,
+              const std::chrono::duration<RepT, PeriodT>& timeout,
+              std::chrono::steady_clock::time_point* published_at = nullptr) {
+    out = blocks_.pop(toTimeout(timeout), published_at);
+    return out != nullptr;
   }
 
+  // Return the oldest update (event group if there is none)
+  void PopEventGroup(SubEventGroupUpdate& out) { out = *event_groups_.pop(std::nullopt); }
+
   template <typename RepT, typename PeriodT>
   bool TryPopEventGroup(SubEventGroupUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    eg_cv_.wait_for(lock, timeout, [this] { return eg_too_slow_ || eg_queue_.read_available(); });
-
-    if (eg_too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
-
-    if (eg_queue_.read_available()) {
-      ConcordAssert(eg_queue_.pop(out));
-      return true;
-    }
-    return false;
+    auto update = event_groups_.pop(toTimeout(timeout));
+    if (!update) return false;
+    out = *update;
+    return true;
   }
 
-  void waitUntilNonEmpty() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [this] { return queue_.read_available(); });
+  // Return the oldest update without copying it - the update is shared with the other subscribers. If `published_at`
+  // isn't nullptr, it is set to the time the update was published.
+  template <typename RepT, typename PeriodT>
+  bool TryPopEventGroup(std::shared_ptr<const SubEventGroupUpdate>& out,
+                        const std::chrono::duration<RepT, PeriodT>& timeout,
+                        std::chrono::steady_clock::time_point* published_at = nullptr) {
+    out = event_groups_.pop(toTimeout(timeout), published_at);
+    return out != nullptr;
   }
 
+  void waitUntilNonEmpty() { blocks_.waitUntilNonEmpty(std::nullopt); }
+
   template <typename RepT, typename PeriodT>
   [[nodiscard]] bool waitUntilNonEmpty(const std::chrono::duration<RepT, PeriodT>& duration) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return cv_.wait_for(lock, duration, [this] { return queue_.read_available(); });
+    return blocks_.waitUntilNonEmpty(toTimeout(duration));
   }
 
-  void waitForEventGroupUntilNonEmpty() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    eg_cv_.wait(lock, [this] { return eg_queue_.read_available(); });
-  }
+  void waitForEventGroupUntilNonEmpty() { event_groups_.waitUntilNonEmpty(std::nullopt); }
 
   template <typename RepT, typename PeriodT>
   [[nodiscard]] bool waitForEventGroupUntilNonEmpty(const std::chrono::duration<RepT, PeriodT>& duration) {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return eg_cv_.wait_for(lock, duration, [this] { return eg_queue_.read_available(); });
+    return event_groups_.waitUntilNonEmpty(toTimeout(duration));
   }
 
-  // This is not thread-safe and the caller has to make sure that there is no
-  // writer or reader active. This is a trade-off in order to stay lock-free.
-  void removeAllUpdates() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    queue_.reset();
-  }
+  // Skip all the updates that weren't read yet
+  void removeAllUpdates() { blocks_.skipAll(); }
 
-  // This is not thread-safe and the caller has to make sure that there is no
-  // writer or reader active. This is a trade-off in order to stay lock-free.
-  void removeAllEventGroupUpdates() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    eg_queue_.reset();
-  }
+  // Skip all the updates that weren't read yet
+  void removeAllEventGroupUpdates() { event_groups_.skipAll(); }
 
   // The caller needs to make sure that the queue is not empty when calling
-  kvbc::BlockId newestBlockId() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // We cannot reach the newest element without consuming the others. Hence,
-    // the counter is a workaround but it requires that there is at least one
-    // element in the queue.
-    ConcordAssertGT(queue_.read_available(), 0);
-    return newest_block_id_;
-  }
+  kvbc::BlockId newestBlockId() { return blocks_.newest()->block_id; }
 
   // The caller needs to make sure that the queue is not empty when calling
-  kvbc::EventGroupId newestEventGroupId() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // We cannot reach the newest element without consuming the others. Hence,
-    // the counter is a workaround but it requires that there is at least one
-    // element in the queue.
-    ConcordAssertGT(eg_queue_.read_available(), 0);
-    return newest_event_group_id_;
-  }
+  kvbc::EventGroupId newestEventGroupId() { return event_groups_.newest()->event_group_id; }
 
   // The caller needs to make sure that the queue is not empty when calling
-  kvbc::BlockId oldestBlockId() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // Undefined behavior if the queue is empty
-    ConcordAssertGT(queue_.read_available(), 0);
-    return queue_.front().block_id;
-  }
+  kvbc::BlockId oldestBlockId() { return blocks_.oldest()->block_id; }
 
   // The caller needs to make sure that the queue is not empty when calling
-  kvbc::EventGroupId oldestEventGroupId() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Undefined behavior if the queue is empty
-    ConcordAssertGT(eg_queue_.read_available(), 0);
-    return eg_queue_.front().event_group_id;
-  }
+  kvbc::EventGroupId oldestEventGroupId() { return event_groups_.oldest()->event_group_id; }
 
   // The caller needs to make sure that the queue is not empty when calling
-  SubEventGroupUpdate oldestEventGroup() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Undefined behavior if the queue is empty
-    ConcordAssertGT(eg_queue_.read_available(), 0);
-    return eg_queue_.front();
-  }
+  SubEventGroupUpdate oldestEventGroup() { return *event_groups_.oldest(); }
 
-  bool Empty() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return !queue_.read_available();
-  }
+  bool Empty() { return blocks_.size() == 0; }
 
-  bool EmptyEventGroupQueue() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return !eg_queue_.read_available();
-  }
+  bool EmptyEventGroupQueue() { return event_groups_.size() == 0; }
 
-  bool Full() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return !queue_.write_available();
-  }
+  bool Full() { return blocks_.full(); }
 
-  bool FullEventGroupQueue() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return !eg_queue_.write_available();
-  }
+  bool FullEventGroupQueue() { return event_groups_.full(); }
 
   // Return the number of elements in the queue
-  size_t Size() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return queue_.read_available();
-  }
+  size_t Size() { return blocks_.size(); }
 
   // Return the number of elements in the queue
-  size_t SizeEventGroupQueue() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return eg_queue_.read_available();
-  }
+  size_t SizeEventGroupQueue() { return event_groups_.size(); }
 
  private:
+  friend class SubBufferList;
+
+  // Wait forever if std::nullopt
+  using Timeout = std::optional<std::chrono::nanoseconds>;
+
+  template <typename RepT, typename PeriodT>
+  static Timeout toTimeout(const std::chrono::duration<RepT, PeriodT>& duration) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+  }
+
+  // The subscriber's cursor in a broadcast ring and the updates pushed to the buffer itself. Once the buffer is added
+  // to a list, a waiting subscriber waits on the ring's shared wake-up, so the producer never touches the reader.
+  //
+  // The updates pushed to the buffer are read in order with the updates of the ring: each of them is read once the
+  // updates that were published to the ring before it was pushed are read.
+  template <typename T>
+  class Reader {
+   public:
+    using Ring = BroadcastRing<T>;
+    using Clock = typename Ring::Clock;
+
+    Reader(size_t size, logging::Logger& logger) : logger_(logger), size_(size), limit_(size) {}
+
+    // Read the updates published to `ring` from now on, after the updates pushed so far
+    void attach(std::shared_ptr<Ring> ring) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ring_ = std::move(ring);
+        limit_ = std::min(size_, ring_->capacity());
+        cursor_ = ring_->published();
+        for (auto& pushed : pushed_) pushed.ring_position = cursor_;
+      }
+      cv_.notify_all();
+    }
+
+    void push(typename Ring::Value update) {
+      std::shared_ptr<Ring> ring;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (too_slow_) return;
+        if (count() >= size_) {
+          setTooSlow();
+        } else {
+          pushed_.push_back(Pushed{std::move(update), ring_ ? ring_->published() : 0, Clock::now()});
+        }
+        ring = ring_;
+      }
+      if (ring) {
+        ring->notifyReaders();
+      } else {
+        cv_.notify_all();
+      }
+    }
+
+    // Return the oldest update, waiting up to `timeout` for one. Return nullptr if the timeout expired.
+    typename Ring::Value pop(const Timeout& timeout, typename Clock::time_point* published_at = nullptr) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wait(lock, timeout, [this] { return too_slow_ || count() > 0; });
+      if (count() == 0 && !too_slow_) return nullptr;
+      auto update = oldestLocked(published_at);
+      if (nextIsPushed()) {
+        pushed_.pop_front();
+      } else {
+        ++cursor_;
+      }
+      return update;
+    }
+
+    bool waitUntilNonEmpty(const Timeout& timeout) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      return wait(lock, timeout, [this] { return count() > 0; });
+    }
+
+    typename Ring::Value oldest() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return oldestLocked();
+    }
+
+    typename Ring::Value newest() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ConcordAssertGT(count(), 0);
+      if (!pushed_.empty() && (lag() == 0 || pushed_.back().ring_position >= ring_->published())) {
+        return pushed_.back().update;
+      }
+      while (true) {
+        // Only a concurrent producer may overwrite the newest update
+        auto update = ring_->read(ring_->published() - 1);
+        if (update) return update;
+      }
+    }
+
+    void skipAll() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pushed_.clear();
+      if (ring_) cursor_ = ring_->published();
+    }
+
+    size_t size() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return std::min<uint64_t>(count(), limit_);
+    }
+
+    bool full() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return count() >= limit_;
+    }
+
+   private:
+    struct Pushed {
+      typename Ring::Value update;
+      // The number of updates published to the ring when the update was pushed, i.e. the cursor position it is read at
+      uint64_t ring_position;
+      typename Clock::time_point pushed_at;
+    };
+
+    uint64_t lag() const { return ring_ ? ring_->published() - cursor_ : 0; }
+    uint64_t count() const { return pushed_.size() + lag(); }
+    bool nextIsPushed() const { return !pushed_.empty() && pushed_.front().ring_position <= cursor_; }
+
+    // Called with `lock` held, returns with it held
+    template <typename PredT>
+    bool wait(std::unique_lock<std::mutex>& lock, const Timeout& timeout, PredT pred) {
+      std::optional<typename Clock::time_point> deadline;
+      if (timeout) deadline = Clock::now() + std::chrono::duration_cast<typename Clock::duration>(*timeout);
+      while (!pred()) {
+        if (!ring_) {
+          // Not added to a list yet - push() and attach() notify cv_
+          auto woken = [&] { return pred() || ring_ != nullptr; };
+          if (!deadline) {
+            cv_.wait(lock, woken);
+          } else if (!cv_.wait_until(lock, *deadline, woken)) {
+            return false;
+          }
+          continue;
+        }
+        // The ring's wake-up lock is taken before ours, so ours is released while waiting
+        auto ring = ring_;
+        lock.unlock();
+        const auto ready = ring->wait(deadline, [&] {
+          std::lock_guard<std::mutex> reader_lock(mutex_);
+          return pred();
+        });
+        lock.lock();
+        if (!ready) return pred();
+      }
+      return true;
+    }
+
+    typename Ring::Value oldestLocked(typename Clock::time_point* published_at = nullptr) {
+      if (!too_slow_) {
+        ConcordAssertGT(count(), 0);
+        if (nextIsPushed()) {
+          if (published_at) *published_at = pushed_.front().pushed_at;
+          return pushed_.front().update;
+        }
+        if (lag() > limit_) {
+          setTooSlow();
+        } else if (auto update = ring_->read(cursor_, published_at)) {
+          return update;
+        } else {
+          setTooSlow();
+        }
+      }
+      // We throw an exception because we cannot handle the clean-up ourselves
+      // and it doesn't make sense to continue popping updates.
+      throw ConsumerTooSlow();
+    }
+
+    void setTooSlow() {
+      // Updates were missed. Not stopping the subscription will lead to a failure on the consumer end (TRC)
+      // eventually. Therefore, let's stop it right here.
+      too_slow_ = true;
+      LOG_WARN(logger_, "Updates were missed. Consumer too slow.");
+    }
+
+    logging::Logger& logger_;
+    const size_t size_;
+    // The maximum number of updates the subscriber may fall behind
+    size_t limit_;
+    // nullptr until the buffer is added to a list
+    std::shared_ptr<Ring> ring_;
+    // The sequence number of the next update to read from the ring
+    uint64_t cursor_{0};
+    // The updates pushed to the buffer itself and not read yet
+    std::deque<Pushed> pushed_;
+    // Indicate whether the consumer doesn't read fast enough
+    bool too_slow_{false};
+    // lock used for updating the variables above and for waiting
+    std::mutex mutex_;
+    // Used for waiting until the buffer is added to a list
+    std::condition_variable cv_;
+  };
+
   logging::Logger logger_;
-  boost::lockfree::spsc_queue<SubUpdate> queue_;
-  boost::lockfree::spsc_queue<SubEventGroupUpdate> eg_queue_;
-  // lock used for updating the queue as well as the variables below
-  std::mutex mutex_;
-  std::condition_variable cv_;
-  std::mutex eg_mutex_;
-  std::condition_variable eg_cv_;
-
-  // Indidcate whether the consumer doesn't read fast enough
-  bool too_slow_;
-  bool eg_too_slow_;
-  uint64_t newest_block_id_;
-  uint64_t newest_event_group_id_;
+  Reader<SubUpdate> blocks_;
+  Reader<SubEventGroupUpdate> event_groups_;
 };
 
-// Thread-safe list implementation which manages subscriber queues. You can
+// Thread-safe list implementation which manages subscriber buffers. You can
 // think of this list as the list of subscribers whereby each subscriber is
-// represented by its spsc queue. The presence or absence of a buffer determines
+// represented by its buffer. The presence or absence of a buffer determines
 // whether a subscriber is subscribed or unsubscribed respectively.
+//
+// Every update is published once to a broadcast ring, shared by all the
+// subscribers, and the producer doesn't wait for any of them. Publishing
+// doesn't take the subscriber list lock and is O(1) in the number of
+// subscribers - waiting subscribers share the ring's wake-up.
 class SubBufferList {
  public:
-  SubBufferList() {}
+  // The number of most recent updates kept for the subscribers
+  static constexpr size_t kDefaultCapacity{1000u};
+
+  explicit SubBufferList(size_t capacity = kDefaultCapacity)
+      : blocks_(std::make_shared<BroadcastRing<SubUpdate>>(capacity)),
+        event_groups_(std::make_shared<BroadcastRing<SubEventGroupUpdate>>(capacity)) {}
 
   // Let's help ourselves and make sure we don't copy this list
   SubBufferList(const SubBufferList&) = delete;
   SubBufferList& operator=(const SubBufferList&) = delete;
 
-  // Add a subscriber
+  // Add a subscriber. It gets the updates published from now on, after the updates pushed to its buffer so far.
   virtual bool addBuffer(std::shared_ptr<SubUpdateBuffer> elem) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto success = subscriber_.insert(elem).second;
+    if (success) {
+      // Counted before attaching, so that every update published after the buffer's cursor is set is published
+      num_subscribers_++;
+      elem->blocks_.attach(blocks_);
+      elem->event_groups_.attach(event_groups_);
+    }
     return success;
   }
 
@@ -315,24 +401,19 @@ class SubBufferList {
     std::lock_guard<std::mutex> lock(mutex_);
     // If the assert fires then there is a logic error somewhere
     ConcordAssertEQ(subscriber_.erase(elem), 1);
+    num_subscribers_--;
   }
 
   // Populate updates to all subscribers
-  // Note: This is potentially expensive depending on the update size and the
-  // number of subscribers. If TRC/TRS stays then we might want to think about
-  // an optimization.
+  // Note: The update is copied once and shared by all the subscribers.
   virtual void updateSubBuffers(SubUpdate& update) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& it : subscriber_) {
-      it->Push(update);
-    }
+    if (num_subscribers_.load() == 0) return;
+    blocks_->publish(std::make_shared<const SubUpdate>(update));
   }
 
   virtual void updateEventGroupSubBuffers(SubEventGroupUpdate& update) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& it : subscriber_) {
-      it->PushEventGroup(update);
-    }
+    if (num_subscribers_.load() == 0) return;
+    event_groups_->publish(std::make_shared<const SubEventGroupUpdate>(update));
   }
 
   // Current number of subscribers
@@ -345,6 +426,12 @@ class SubBufferList {
  protected:
   std::unordered_set<std::shared_ptr<SubUpdateBuffer>> subscriber_;
   std::mutex mutex_;
+
+ private:
+  // The size of subscriber_, read by the producer without taking mutex_
+  std::atomic_size_t num_subscribers_{0};
+  std::shared_ptr<BroadcastRing<SubUpdate>> blocks_;
+  std::shared_ptr<BroadcastRing<SubEventGroupUpdate>> event_groups_;
 };
 
 }  // namespace thin_replica
@@ -23,12 +23,14 @@
 #ifdef USE_OPENTRACING
 #include <opentracing/tracer.h>
 #endif
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <fstream>
+#include <thread>
 
 #include "Logger.hpp"
 #include "Metrics.hpp"
@@ -38,6 +40,7 @@
 #include "kvbc_app_filter/kvbc_key_types.h"
 #include "thin_replica.grpc.pb.h"
 #include "subscription_buffer.hpp"
+#include "live_update_fanout.hpp"
 #include "trs_metrics.hpp"
 #include "util/filesystem.hpp"
 #include "hex_tools.h"
@@ -73,6 +76,12 @@ struct ThinReplicaServerConfig {
   // the time duration the TRS waits before printing warning logs when
   // subscription status for live updates is not ok
   std::chrono::seconds no_live_subscription_warn_duration;
+  // the number of most recent live updates for which the filtered response is kept and shared between the
+  // subscriptions of the same client id (0, the default, disables sharing)
+  const size_t live_update_fanout_capacity;
+  // the number of blocks or event groups that are read from storage and filtered ahead, in parallel, when a client
+  // catches up on historical updates (0 reads and filters them one by one)
+  const size_t read_ahead_depth;
 
   ThinReplicaServerConfig(const bool is_insecure_trs_,
                           const std::string& tls_trs_cert_path_,
@@ -81,7 +90,9 @@ struct ThinReplicaServerConfig {
                           std::unordered_set<std::string>& client_id_set_,
                           const uint16_t update_metrics_aggregator_thresh_ = 100,
                           bool use_unified_certs_ = false,
-                          std::chrono::seconds no_live_subscription_warn_duration_ = kNoLiveSubscriptionWarnDuration)
+                          std::chrono::seconds no_live_subscription_warn_duration_ = kNoLiveSubscriptionWarnDuration,
+                          const size_t live_update_fanout_capacity_ = kLiveUpdateFanoutCapacity,
+                          const size_t read_ahead_depth_ = 0)
       : is_insecure_trs(is_insecure_trs_),
         tls_trs_cert_path(tls_trs_cert_path_),
         rostorage(rostorage_),
@@ -89,10 +100,13 @@ struct ThinReplicaServerConfig {
         client_id_set(client_id_set_),
         update_metrics_aggregator_thresh(update_metrics_aggregator_thresh_),
         use_unified_certs(use_unified_certs_),
-        no_live_subscription_warn_duration(no_live_subscription_warn_duration_) {}
+        no_live_subscription_warn_duration(no_live_subscription_warn_duration_),
+        live_update_fanout_capacity(live_update_fanout_capacity_),
+        read_ahead_depth(read_ahead_depth_) {}
 
  private:
   static constexpr std::chrono::seconds kNoLiveSubscriptionWarnDuration = 60s;
+  static constexpr size_t kLiveUpdateFanoutCapacity = 0;
 };
 
 class ThinReplicaImpl {
@@ -113,6 +127,11 @@ class ThinReplicaImpl {
 
   using KvbAppFilterPtr = std::shared_ptr<kvbc::KvbAppFilter>;
   static constexpr size_t kSubUpdateBufferSize{1000u};
+  // State hash checkpoints of every client and stream, kept every kRangeHashCheckpointInterval updates
+  static constexpr uint64_t kRangeHashCheckpointInterval{1000u};
+  static constexpr size_t kMaxRangeHashCheckpoints{64u};
+  // Number of (client, stream, first update) ranges with checkpoints; the least recently used range is evicted
+  static constexpr size_t kMaxRangeHashCheckpointRanges{1024u};
   const std::chrono::milliseconds kWaitForUpdateTimeout{100};
   const std::string kCorrelationIdTag = "cid";
   // last timestamp when subscription status for live updates was not ok
@@ -124,7 +143,21 @@ class ThinReplicaImpl {
  public:
   ThinReplicaImpl(std::unique_ptr<ThinReplicaServerConfig> config,
                   std::shared_ptr<concordMetrics::Aggregator> aggregator)
-      : logger_(logging::getLogger("concord.thin_replica")), config_(std::move(config)), aggregator_(aggregator) {}
+      : logger_(logging::getLogger("concord.thin_replica")),
+        config_(std::move(config)),
+        aggregator_(aggregator),
+        data_fanout_(config_->live_update_fanout_capacity, "data"),
+        hash_fanout_(config_->live_update_fanout_capacity, "hash"),
+        range_hash_checkpoints_(std::make_shared<kvbc::RangeHashCheckpoints>(
+            kRangeHashCheckpointInterval, kMaxRangeHashCheckpoints, kMaxRangeHashCheckpointRanges)) {
+    data_fanout_.setAggregator(aggregator_);
+    hash_fanout_.setAggregator(aggregator_);
+    if (config_->read_ahead_depth > 0) {
+      const auto hw_threads = std::max(std::thread::hardware_concurrency(), 1u);
+      read_ahead_pool_ = std::make_shared<util::ThreadPool>(
+          static_cast<unsigned int>(std::min<size_t>(config_->read_ahead_depth, hw_threads)));
+    }
+  }
 
   ThinReplicaImpl(const ThinReplicaImpl&) = delete;
   ThinReplicaImpl(ThinReplicaImpl&&) = delete;
@@ -178,6 +211,8 @@ class ThinReplicaImpl {
     if (isUpdatePruned(request, msg, kvb_filter)) return grpc::Status(grpc::StatusCode::NOT_FOUND, msg.str());
 
     LOG_DEBUG(logger_, "ReadStateHash");
+    // Clients verify the state hash from the first update on every reconnect - continue from where the last one ended
+    kvb_filter->setRangeHashCheckpoints(range_hash_checkpoints_);
 
     if (request->has_events()) {
       kvbc::BlockId block_id_start = 1;
@@ -403,45 +438,58 @@ class ThinReplicaImpl {
         return grpc::Status(grpc::StatusCode::UNKNOWN, msg.str());
       }
       // Read, filter, and send live updates
-      SubUpdate update;
+      // The update is shared with the other subscribers and must not be modified
+      std::shared_ptr<const SubUpdate> update;
+      std::chrono::steady_clock::time_point published_at;
       try {
         while (!context->IsCancelled() && !is_event_group_transition) {
           metrics.queue_size.Get().Set(live_updates->Size());
           bool is_update_available = false;
-          is_update_available = live_updates->TryPop(update, kWaitForUpdateTimeout);
+          is_update_available = live_updates->TryPop(update, kWaitForUpdateTimeout, &published_at);
           if (not is_update_available) {
             continue;
           }
-          auto kvb_update =
-              kvbc::KvbUpdate{update.block_id, update.correlation_id, std::move(update.immutable_kv_pairs)};
-          const auto& filtered_update = kvb_filter->filterUpdate(kvb_update);
-          const auto num_events = filtered_update.kv_pairs.size();
-          const auto block_id = filtered_update.block_id;
+          const auto block_id = update->block_id;
           const auto client_id = getClientId(context);
+          auto filter_update = [&]() { return kvb_filter->filterUpdate(*update); };
           if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
-            LOG_DEBUG(logger_, "Sending updates (live, data)" << KVLOG(client_id, block_id, num_events));
-            auto correlation_id = filtered_update.correlation_id;
-            if (update.parent_span) {
-              sendData(stream, filtered_update, {*update.parent_span});
+            auto make_data = [&](const std::string& span) {
+              return std::make_shared<const DataT>(makeData(filter_update(), {span}));
+            };
+            typename LiveUpdateFanout<DataT>::DeliveryPtr data;
+            if (update->parent_span) {
+              data = data_fanout_.get(
+                  client_id, false, block_id, 0, published_at, [&]() { return make_data(*update->parent_span); });
             } else {
-              std::string propagated_span_context;
 #ifdef USE_OPENTRACING
+              // Every stream gets its own span, so the response can't be shared
               auto span = opentracing::Tracer::Global()->StartSpan(
-                  "trs_stream_update", {opentracing::SetTag{kCorrelationIdTag, correlation_id}});
+                  "trs_stream_update", {opentracing::SetTag{kCorrelationIdTag, update->correlation_id}});
               std::ostringstream context;
               const opentracing::Span& span_to_serialize = *span;
               span_to_serialize.tracer().Inject(span_to_serialize.context(), context);
-              propagated_span_context = context.str();
+              data = data_fanout_.getUnshared(published_at, [&]() { return make_data(context.str()); });
+#else
+              data = data_fanout_.get(
+                  client_id, false, block_id, 0, published_at, [&]() { return make_data(std::string{}); });
 #endif
-              sendData(stream, filtered_update, {propagated_span_context});
             }
+            const auto num_events = data->response()->events().data_size();
+            LOG_DEBUG(logger_, "Sending updates (live, data)" << KVLOG(client_id, block_id, num_events));
+            writeData(stream, *data->response());
+            data->written();
           } else if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>()) {
-            LOG_DEBUG(logger_, "Sending updates (live, hash)" << KVLOG(client_id, block_id, num_events));
-            sendHash(stream, update.block_id, kvb_filter->hashUpdate(filtered_update));
+            auto hash = hash_fanout_.get(client_id, false, block_id, 0, published_at, [&]() {
+              return std::make_shared<const DataT>(makeHash(block_id, kvb_filter->hashUpdate(filter_update())));
+            });
+            LOG_DEBUG(logger_, "Sending updates (live, hash)" << KVLOG(client_id, block_id));
+            writeHash(stream, *hash->response());
+            hash->written();
           }
-          metrics.last_sent_block_id.Get().Set(update.block_id);
+          metrics.last_sent_block_id.Get().Set(block_id);
           if (++update_aggregator_counter == config_->update_metrics_aggregator_thresh) {
             metrics.updateAggregator();
+            liveUpdateFanout<DataT>().updateAggregator();
             update_aggregator_counter = 0;
           }
         }
@@ -501,48 +549,67 @@ class ThinReplicaImpl {
     }
 
     // Read, filter, and send live updates
-    SubEventGroupUpdate sub_eg_update;
+    // The update is shared with the other subscribers and must not be modified
+    std::shared_ptr<const SubEventGroupUpdate> sub_eg_update;
+    std::chrono::steady_clock::time_point published_at;
     try {
       while (not context->IsCancelled()) {
         metrics.queue_size.Get().Set(live_updates->SizeEventGroupQueue());
         bool is_update_available = false;
-        is_update_available = live_updates->TryPopEventGroup(sub_eg_update, kWaitForUpdateTimeout);
+        is_update_available = live_updates->TryPopEventGroup(sub_eg_update, kWaitForUpdateTimeout, &published_at);
         if (not is_update_available) {
           continue;
         }
         const auto& [last_ext_eg_id_read, last_global_eg_id_read] = kvb_filter->getLastEgIdsRead();
         // Event group read from live update queue should always be greater than last global event group ID read and
         // sent
-        ConcordAssertGT(sub_eg_update.event_group_id, last_global_eg_id_read);
-
-        auto eg_update = kvbc::EgUpdate{sub_eg_update.event_group_id, std::move(sub_eg_update.event_group)};
+        ConcordAssertGT(sub_eg_update->event_group_id, last_global_eg_id_read);
 
         auto next_ext_eg_id = last_ext_eg_id_read + 1;
         // TODO (Shruti):
         // We read and filter the first event group for the client from the live update queue twice.
         // Once in syncAndSendEventGroups() and once here. Do this only once.
-        auto filtered_eg_update = kvb_filter->filterEventGroupUpdate(eg_update);
-        if (!filtered_eg_update) {
+        // The response is computed once for all the streams of the client. It is nullptr if the event group has
+        // nothing for the client.
+        const auto client_id = getClientId(context);
+        auto response = liveUpdateFanout<DataT>().get(
+            client_id,
+            true,
+            sub_eg_update->event_group_id,
+            next_ext_eg_id,
+            published_at,
+            [&]() -> std::shared_ptr<const DataT> {
+              auto filtered_eg_update = kvb_filter->filterEventGroupUpdate(*sub_eg_update);
+              if (!filtered_eg_update) return nullptr;
+              // Overwrite event group ID in the filtered update to external event group ID
+              // We don't want to expose the global event group ID to the client
+              filtered_eg_update.value().event_group_id = next_ext_eg_id;
+              if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
+                return std::make_shared<const DataT>(
+                    makeEventGroupData(filtered_eg_update.value(), sub_eg_update->parent_span));
+              } else {
+                return std::make_shared<const DataT>(
+                    makeEventGroupHash(next_ext_eg_id, kvb_filter->hashEventGroupUpdate(filtered_eg_update.value())));
+              }
+            });
+        if (!response->response()) {
           metrics.num_skipped_event_groups++;
           continue;
         }
-        // Overwrite event group ID in the filtered update to external event group ID
-        // We don't want to expose the global event group ID to the client
-        filtered_eg_update.value().event_group_id = next_ext_eg_id;
 
         if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
-          sendEventGroupData(stream, filtered_eg_update.value(), sub_eg_update.parent_span);
+          writeData(stream, *response->response(), "Data event group stream closed");
         } else if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>()) {
-          sendEventGroupHash(stream,
-                             filtered_eg_update.value().event_group_id,
-                             kvb_filter->hashEventGroupUpdate(filtered_eg_update.value()));
+          writeHash(stream, *response->response(), "Hash event group stream closed");
         }
+        response->written();
 
-        kvb_filter->setLastEgIdsRead(next_ext_eg_id, sub_eg_update.event_group_id);
+        kvb_filter->setLastEgIdsRead(next_ext_eg_id, sub_eg_update->event_group_id);
 
-        metrics.last_sent_event_group_id.Get().Set(filtered_eg_update.value().event_group_id);
+        metrics.last_sent_event_group_id.Get().Set(next_ext_eg_id);
         if (++update_aggregator_counter == config_->update_metrics_aggregator_thresh) {
           metrics.updateAggregator();
+          liveUpdateFanout<DataT>().updateAggregator();
           update_aggregator_counter = 0;
         }
       }
@@ -1120,6 +1187,30 @@ class ThinReplicaImpl {
   void sendData(ServerWriterT* stream,
                 const kvbc::KvbFilteredUpdate& update,
                 const std::optional<std::string>& span = std::nullopt) {
+    writeData(stream, makeData(update, span));
+  }
+
+  // Send* prepares the response object and puts it on the stream
+  template <typename ServerWriterT>
+  void sendEventGroupData(ServerWriterT* stream,
+                          const kvbc::KvbFilteredEventGroupUpdate& eg_update,
+                          const std::optional<std::string>& span = std::nullopt) {
+    writeData(stream, makeEventGroupData(eg_update, span), "Data event group stream closed");
+  }
+
+  template <typename ServerWriterT>
+  void sendHash(ServerWriterT* stream, kvbc::BlockId block_id, const std::string& update_hash) {
+    writeHash(stream, makeHash(block_id, update_hash));
+  }
+
+  template <typename ServerWriterT>
+  void sendEventGroupHash(ServerWriterT* stream, kvbc::EventGroupId event_group_id, const std::string& update_hash) {
+    writeHash(stream, makeEventGroupHash(event_group_id, update_hash), "Hash event group stream closed");
+  }
+
+  // Make* prepares the response object only, so that it can be written to several streams
+  com::vmware::concord::thin_replica::Data makeData(const kvbc::KvbFilteredUpdate& update,
+                                                    const std::optional<std::string>& span = std::nullopt) {
     com::vmware::concord::thin_replica::Data data;
     LOG_DEBUG(logger_, "sendData for block " << update.block_id);
     data.mutable_events()->set_block_id(update.block_id);
@@ -1134,16 +1225,11 @@ class ThinReplicaImpl {
     if (span) {
       data.mutable_events()->set_span_context(*span);
     }
-    if (!stream->Write(data)) {
-      throw StreamClosed("Data stream closed");
-    }
+    return data;
   }
 
-  // Send* prepares the response object and puts it on the stream
-  template <typename ServerWriterT>
-  void sendEventGroupData(ServerWriterT* stream,
-                          const kvbc::KvbFilteredEventGroupUpdate& eg_update,
-                          const std::optional<std::string>& span = std::nullopt) {
+  com::vmware::concord::thin_replica::Data makeEventGroupData(const kvbc::KvbFilteredEventGroupUpdate& eg_update,
+                                                              const std::optional<std::string>& span = std::nullopt) {
     com::vmware::concord::thin_replica::Data data;
     LOG_DEBUG(logger_, "sendEventGroupData for id " << eg_update.event_group_id);
     data.mutable_event_group()->set_id(eg_update.event_group_id);
@@ -1158,31 +1244,51 @@ class ThinReplicaImpl {
     if (span) {
       data.mutable_event_group()->set_trace_context(*span);
     }
-    if (!stream->Write(data)) {
-      throw StreamClosed("Data event group stream closed");
-    }
+    return data;
   }
 
-  template <typename ServerWriterT>
-  void sendHash(ServerWriterT* stream, kvbc::BlockId block_id, const std::string& update_hash) {
+  com::vmware::concord::thin_replica::Hash makeHash(kvbc::BlockId block_id, const std::string& update_hash) {
     com::vmware::concord::thin_replica::Hash hash;
     hash.mutable_events()->set_block_id(block_id);
     hash.mutable_events()->set_hash(update_hash);
     concordUtils::HexPrintBuffer update_hash_buff{update_hash.data(), update_hash.size()};
     LOG_DEBUG(logger_, "COMPARE SendHash block_id " << block_id << " update_hash " << update_hash_buff);
-    if (!stream->Write(hash)) {
-      throw StreamClosed("Hash stream closed");
-    }
+    return hash;
   }
 
-  template <typename ServerWriterT>
-  void sendEventGroupHash(ServerWriterT* stream, kvbc::EventGroupId event_group_id, const std::string& update_hash) {
+  com::vmware::concord::thin_replica::Hash makeEventGroupHash(kvbc::EventGroupId event_group_id,
+                                                              const std::string& update_hash) {
     com::vmware::concord::thin_replica::Hash hash;
     hash.mutable_event_group()->set_event_group_id(event_group_id);
     hash.mutable_event_group()->set_hash(update_hash);
     LOG_DEBUG(logger_, "COMPARE SendHash event group id " << event_group_id << " update_hash " << update_hash);
+    return hash;
+  }
+
+  template <typename ServerWriterT>
+  void writeData(ServerWriterT* stream,
+                 const com::vmware::concord::thin_replica::Data& data,
+                 const std::string& closed_msg = "Data stream closed") {
+    if (!stream->Write(data)) {
+      throw StreamClosed(closed_msg);
+    }
+  }
+
+  template <typename ServerWriterT>
+  void writeHash(ServerWriterT* stream,
+                 const com::vmware::concord::thin_replica::Hash& hash,
+                 const std::string& closed_msg = "Hash stream closed") {
     if (!stream->Write(hash)) {
-      throw StreamClosed("Hash event group stream closed");
+      throw StreamClosed(closed_msg);
+    }
+  }
+
+  template <typename DataT>
+  LiveUpdateFanout<DataT>& liveUpdateFanout() {
+    if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
+      return data_fanout_;
+    } else {
+      return hash_fanout_;
     }
   }
 
@@ -1228,6 +1334,7 @@ class ThinReplicaImpl {
     KvbAppFilterPtr kvb_filter;
     try {
       kvb_filter = std::make_shared<kvbc::KvbAppFilter>(config_->rostorage, getClientId(context));
+      kvb_filter->setReadAhead(config_->read_ahead_depth, read_ahead_pool_);
     } catch (std::exception& error) {
       std::stringstream msg;
       msg << "Failed to set up filter: " << error.what();
@@ -1255,6 +1362,13 @@ class ThinReplicaImpl {
   logging::Logger logger_;
   std::unique_ptr<ThinReplicaServerConfig> config_;
   std::shared_ptr<concordMetrics::Aggregator> aggregator_;
+  // Filtered live updates, shared between the subscriptions of the same client id
+  LiveUpdateFanout<com::vmware::concord::thin_replica::Data> data_fanout_;
+  LiveUpdateFanout<com::vmware::concord::thin_replica::Hash> hash_fanout_;
+  // Running state hashes, shared by the ReadStateHash calls of all the clients
+  std::shared_ptr<kvbc::RangeHashCheckpoints> range_hash_checkpoints_;
+  // Shared by the filters of all the subscriptions for reading historical updates ahead (nullptr if disabled)
+  std::shared_ptr<util::ThreadPool> read_ahead_pool_;
 };
 }  // namespace thin_replica
 }  // namespace concord
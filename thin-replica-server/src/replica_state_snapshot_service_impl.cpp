@@ -15,6 +15,8 @@
 
 #include "Logger.hpp"
 #include "kvbc_adapter/replica_adapter.hpp"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
+#include "util/filesystem.hpp"
 
 #include <stdexcept>
 #include <string>
@@ -27,6 +29,7 @@ using vmware::concord::replicastatesnapshot::StreamSnapshotResponse;
 using bftEngine::impl::DbCheckpointManager;
 using storage::rocksdb::NativeClient;
 using concord::kvbc::adapter::ReplicaBlockchain;
+using concord::kvbc::adapter::common::statesnapshot::StateSnapshotFile;
 
 grpc::Status ReplicaStateSnapshotServiceImpl::StreamSnapshot(grpc::ServerContext* context,
                                                              const StreamSnapshotRequest* request,
@@ -61,10 +64,18 @@ grpc::Status ReplicaStateSnapshotServiceImpl::StreamSnapshot(grpc::ServerContext
     const auto snapshot_path = overriden_path_for_test_.has_value()
                                    ? *overriden_path_for_test_
                                    : DbCheckpointManager::instance().getPathForCheckpoint(request->snapshot_id());
-    const auto read_only = true;
-    const auto link_st_chain = false;
-    auto db_client = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
-    auto kvbc_state_snapshot_ = std::make_unique<ReplicaBlockchain>(db_client, link_st_chain);
+    // Serve the snapshot from its exported file if there is one, else iterate its RocksDB checkpoint.
+    const auto export_file_path = StateSnapshotFile::pathIn(snapshot_path);
+    auto snapshot_file = std::unique_ptr<StateSnapshotFile>{};
+    auto kvbc_state_snapshot_ = std::unique_ptr<ReplicaBlockchain>{};
+    if (fs::exists(export_file_path)) {
+      snapshot_file = std::make_unique<StateSnapshotFile>(export_file_path);
+    } else {
+      const auto read_only = true;
+      const auto link_st_chain = false;
+      auto db_client = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
+      kvbc_state_snapshot_ = std::make_unique<ReplicaBlockchain>(db_client, link_st_chain);
+    }
 
     const auto iterate = [&](std::string&& key, std::string&& value) {
       auto resp = StreamSnapshotResponse{};
@@ -82,12 +93,17 @@ grpc::Status ReplicaStateSnapshotServiceImpl::StreamSnapshot(grpc::ServerContext
     };
 
     if (request->has_last_received_key()) {
-      if (!kvbc_state_snapshot_->iteratePublicStateKeyValues(iterate, request->last_received_key())) {
+      const auto found =
+          snapshot_file ? snapshot_file->iterate(iterate, request->last_received_key())
+                        : kvbc_state_snapshot_->iteratePublicStateKeyValues(iterate, request->last_received_key());
+      if (!found) {
         const auto msg =
             "Streaming of State Snapshot ID = " + snapshot_id_str + " failed, reason = last_received_key not found";
         LOG_INFO(STATE_SNAPSHOT, msg);
         return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, msg};
       }
+    } else if (snapshot_file) {
+      snapshot_file->iterate(iterate);
     } else {
       kvbc_state_snapshot_->iteratePublicStateKeyValues(iterate);
     }
@@ -16,6 +16,7 @@
 
 #include "categorization/db_categories.h"
 #include "kvbc_adapter/replica_adapter.hpp"
+#include "kvbc_adapter/common/state_snapshot_file.hpp"
 #include "kvbc_key_types.hpp"
 #include "storage/test/storage_test_common.h"
 #include "thin-replica-server/replica_state_snapshot_service_impl.hpp"
@@ -27,6 +28,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,6 +41,7 @@ using namespace concord::kvbc::categorization;
 using namespace concord::thin_replica;
 using bftEngine::impl::DbCheckpointManager;
 using concord::kvbc::adapter::ReplicaBlockchain;
+using concord::kvbc::adapter::common::statesnapshot::StateSnapshotFile;
 using concord::storage::rocksdb::NativeClient;
 using grpc::Channel;
 using grpc::ClientContext;
@@ -208,6 +211,44 @@ TEST_F(replica_state_snapshot_service_test, invalid_last_received_key) {
   ASSERT_TRUE(kvs.empty());
 }
 
+TEST_F(replica_state_snapshot_service_test, exported_snapshot_file) {
+  addPublicState();
+  // Export the file to a directory without a DB, so that the snapshot is served from the file only.
+  const auto export_db_id = 1;
+  const auto export_dir = rocksDbPath(export_db_id);
+  cleanup(export_db_id);
+  fs::create_directories(export_dir);
+  kvbc_->exportPublicState(
+      1, [](std::string &&v) -> std::string { return std::move(v); }, StateSnapshotFile::pathIn(export_dir));
+  service_.overrideCheckpointPathForTest(export_dir);
+  startServer();
+  const auto stream = [&](const std::optional<std::string> &last_received_key) {
+    auto context = ClientContext{};
+    auto request = StreamSnapshotRequest{};
+    request.set_snapshot_id(42);  // ignored, because we override the DB path and, hence, the DbCheckpointManager
+    if (last_received_key) {
+      request.set_last_received_key(*last_received_key);
+    }
+    auto response = StreamSnapshotResponse{};
+    auto reader = std::unique_ptr<ClientReader<StreamSnapshotResponse>>{stub_->StreamSnapshot(&context, request)};
+    auto kvs = std::vector<std::pair<std::string, std::string>>{};
+    while (reader->Read(&response)) {
+      kvs.push_back(std::make_pair(response.key_value().key(), response.key_value().value()));
+    }
+    return std::make_pair(reader->Finish().error_code(), kvs);
+  };
+
+  ASSERT_THAT(stream(std::nullopt),
+              Pair(StatusCode::OK,
+                   ContainerEq(std::vector<std::pair<std::string, std::string>>{
+                       {"a", "va"}, {"b", "vb"}, {"c", "vc"}, {"d", "vd"}})));
+  ASSERT_THAT(stream("b"),
+              Pair(StatusCode::OK,
+                   ContainerEq(std::vector<std::pair<std::string, std::string>>{{"c", "vc"}, {"d", "vd"}})));
+  ASSERT_THAT(stream("e"), Pair(StatusCode::INVALID_ARGUMENT, IsEmpty()));
+  cleanup(export_db_id);
+}
+
 TEST_F(replica_state_snapshot_service_test, pending_checkpoint_creation) {
   addPublicState();
   service_.overrideCheckpointStateForTest(DbCheckpointManager::CheckpointState::kPending);
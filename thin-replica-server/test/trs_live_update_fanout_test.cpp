@@ -0,0 +1,176 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "thin-replica-server/live_update_fanout.hpp"
+
+namespace {
+
+using concord::thin_replica::LiveUpdateFanout;
+
+const auto published_at = std::chrono::steady_clock::now();
+
+// Every client id gets its own response, computed once.
+TEST(trs_live_update_fanout_test, shared_per_client_id) {
+  LiveUpdateFanout<std::string> fanout{10, "test_shared"};
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  fanout.setAggregator(aggregator);
+  auto num_calls = 0;
+  auto make = [&](const std::string& value) {
+    return [&num_calls, value]() {
+      num_calls++;
+      return std::make_shared<const std::string>(value);
+    };
+  };
+
+  auto a1 = fanout.get("A", false, 1, 0, published_at, make("A1"));
+  auto a2 = fanout.get("A", false, 1, 0, published_at, make("other"));
+  auto b1 = fanout.get("B", false, 1, 0, published_at, make("B1"));
+  ASSERT_EQ(2, num_calls);
+  ASSERT_EQ("A1", *a1->response());
+  ASSERT_EQ(a1.get(), a2.get());
+  ASSERT_EQ("B1", *b1->response());
+  a1->written();
+  a2->written();
+
+  // Blocks and event groups with the same ID are different updates, as are different external IDs
+  fanout.get("A", true, 1, 0, published_at, make("A1 eg"));
+  fanout.get("A", true, 1, 1, published_at, make("A1 eg 1"));
+  ASSERT_EQ(4, num_calls);
+
+  // Filtered out updates are shared as well
+  auto filtered_out = [] { return std::shared_ptr<const std::string>{}; };
+  ASSERT_EQ(nullptr, fanout.get("A", false, 2, 0, published_at, filtered_out)->response());
+  ASSERT_EQ(nullptr, fanout.get("A", false, 2, 0, published_at, make("A2"))->response());
+  ASSERT_EQ(4, num_calls);
+
+  fanout.updateAggregator();
+  ASSERT_EQ(5, aggregator->GetCounter("ThinReplicaServerFanout_test_shared", "num_filtered_updates").Get());
+  ASSERT_EQ(2, aggregator->GetCounter("ThinReplicaServerFanout_test_shared", "num_shared_updates").Get());
+}
+
+// Only the last `capacity` updates are kept.
+TEST(trs_live_update_fanout_test, evicts_oldest) {
+  LiveUpdateFanout<int> fanout{2, "test_evict"};
+  auto num_calls = 0;
+  auto make = [&]() {
+    num_calls++;
+    return std::make_shared<const int>(num_calls);
+  };
+  for (uint64_t id = 1; id <= 3; id++) fanout.get("A", false, id, 0, published_at, make);
+  ASSERT_EQ(3, num_calls);
+  ASSERT_EQ(3, *fanout.get("A", false, 3, 0, published_at, make)->response());
+  ASSERT_EQ(4, *fanout.get("A", false, 1, 0, published_at, make)->response());
+}
+
+// No sharing without capacity.
+TEST(trs_live_update_fanout_test, disabled) {
+  LiveUpdateFanout<int> fanout{0, "test_disabled"};
+  auto num_calls = 0;
+  auto make = [&]() { return std::make_shared<const int>(++num_calls); };
+  auto first = fanout.get("A", false, 1, 0, published_at, make);
+  auto second = fanout.get("A", false, 1, 0, published_at, make);
+  ASSERT_EQ(2, num_calls);
+  ASSERT_NE(first.get(), second.get());
+  ASSERT_NE(first.get(), fanout.getUnshared(published_at, make).get());
+  ASSERT_EQ(3, num_calls);
+}
+
+// The delivery of a response is held by the fanout, until it is evicted, and by the streams that got it.
+TEST(trs_live_update_fanout_test, delivery_is_released_by_all_streams) {
+  LiveUpdateFanout<int> fanout{1, "test_release"};
+  auto make = []() { return std::make_shared<const int>(1); };
+  auto first = fanout.get("A", false, 1, 0, published_at, make);
+  auto second = fanout.get("A", false, 1, 0, published_at, make);
+  std::weak_ptr<LiveUpdateFanout<int>::Delivery> delivery = first;
+  first->written();
+  first.reset();
+  // Evicts the first update
+  fanout.get("A", false, 2, 0, published_at, make);
+  ASSERT_FALSE(delivery.expired());
+  second->written();
+  second.reset();
+  ASSERT_TRUE(delivery.expired());
+}
+
+// A failed computation is not shared - the next caller computes the response again.
+TEST(trs_live_update_fanout_test, failure_is_not_kept) {
+  LiveUpdateFanout<int> fanout{10, "test_failure"};
+  auto fail = []() -> std::shared_ptr<const int> { throw std::runtime_error("fail"); };
+  ASSERT_THROW(fanout.get("A", false, 1, 0, published_at, fail), std::runtime_error);
+  auto make = []() { return std::make_shared<const int>(1); };
+  ASSERT_EQ(1, *fanout.get("A", false, 1, 0, published_at, make)->response());
+}
+
+// A failed computation doesn't take a slot, or evict the response computed by the retry.
+TEST(trs_live_update_fanout_test, failure_does_not_evict_retry) {
+  LiveUpdateFanout<int> fanout{2, "test_failure_retry"};
+  auto fail = []() -> std::shared_ptr<const int> { throw std::runtime_error("fail"); };
+  auto num_calls = 0;
+  auto make = [&]() { return std::make_shared<const int>(++num_calls); };
+  ASSERT_THROW(fanout.get("A", false, 1, 0, published_at, fail), std::runtime_error);
+  ASSERT_EQ(1, *fanout.get("A", false, 1, 0, published_at, make)->response());
+  ASSERT_EQ(2, *fanout.get("A", false, 2, 0, published_at, make)->response());
+  ASSERT_EQ(1, *fanout.get("A", false, 1, 0, published_at, make)->response());
+  ASSERT_EQ(2, *fanout.get("A", false, 2, 0, published_at, make)->response());
+  ASSERT_EQ(2, num_calls);
+}
+
+// Concurrent streams of the same client id wait for the one that computes the response.
+TEST(trs_live_update_fanout_test, concurrent_streams) {
+  LiveUpdateFanout<int> fanout{10, "test_concurrent"};
+  std::atomic_int num_calls{0};
+  std::promise<void> computing;
+  std::promise<void> release;
+  auto release_future = release.get_future().share();
+
+  auto owner = std::async(std::launch::async, [&]() {
+    return fanout.get("A", false, 1, 0, published_at, [&]() {
+      num_calls++;
+      computing.set_value();
+      release_future.wait();
+      return std::make_shared<const int>(42);
+    });
+  });
+  computing.get_future().wait();
+
+  std::vector<std::future<LiveUpdateFanout<int>::DeliveryPtr>> waiters;
+  for (auto i = 0; i < 4; i++) {
+    waiters.push_back(std::async(std::launch::async, [&]() {
+      return fanout.get("A", false, 1, 0, published_at, [&]() {
+        num_calls++;
+        return std::make_shared<const int>(0);
+      });
+    }));
+  }
+  release.set_value();
+
+  auto response = owner.get();
+  for (auto& waiter : waiters) ASSERT_EQ(response->response().get(), waiter.get()->response().get());
+  ASSERT_EQ(1, num_calls);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
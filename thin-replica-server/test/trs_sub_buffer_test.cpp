@@ -17,6 +17,7 @@
 #include <chrono>
 #include <future>
 #include <list>
+#include <vector>
 #include "Logger.hpp"
 #include "thin-replica-server/subscription_buffer.hpp"
 
@@ -122,6 +123,108 @@ TEST(trs_sub_buffer_test, throw_exception_if_consumer_too_slow_eg) {
   EXPECT_THROW(updates->PopEventGroup(consumer_update), ConsumerTooSlow);
 }
 
+// The updates are stored once and shared by the subscribers.
+TEST(trs_sub_buffer_test, updates_are_shared) {
+  SubBufferList sub_list;
+  auto updates1 = std::make_shared<SubUpdateBuffer>(10);
+  auto updates2 = std::make_shared<SubUpdateBuffer>(10);
+  sub_list.addBuffer(updates1);
+  sub_list.addBuffer(updates2);
+
+  SubUpdate update{1337, "CID", {}};
+  sub_list.updateSubBuffers(update);
+
+  std::shared_ptr<const SubUpdate> out1;
+  std::shared_ptr<const SubUpdate> out2;
+  ASSERT_TRUE(updates1->TryPop(out1, 10ms));
+  ASSERT_TRUE(updates2->TryPop(out2, 10ms));
+  ASSERT_EQ(out1.get(), out2.get());
+  ASSERT_EQ(out1->block_id, 1337);
+}
+
+// A slow consumer doesn't affect the producer or the other consumers. It finds out that it was overrun when it reads
+// next, even if the list keeps fewer updates than the consumer may fall behind.
+TEST(trs_sub_buffer_test, overrun_consumer_too_slow) {
+  SubBufferList sub_list{4};
+  auto slow = std::make_shared<SubUpdateBuffer>(10);
+  auto fast = std::make_shared<SubUpdateBuffer>(10);
+  sub_list.addBuffer(slow);
+  sub_list.addBuffer(fast);
+
+  SubUpdate update{0, "CID", {}};
+  SubUpdate out;
+  for (unsigned i = 1; i <= 6; ++i) {
+    update.block_id = i;
+    sub_list.updateSubBuffers(update);
+    ASSERT_TRUE(fast->TryPop(out, 10ms));
+    ASSERT_EQ(out.block_id, i);
+  }
+  ASSERT_EQ(slow->newestBlockId(), 6);
+  EXPECT_THROW(slow->Pop(out), ConsumerTooSlow);
+  EXPECT_THROW(slow->TryPop(out, 10ms), ConsumerTooSlow);
+  ASSERT_TRUE(fast->Empty());
+}
+
+// A subscriber only gets the updates published after it was added.
+TEST(trs_sub_buffer_test, late_subscriber) {
+  SubBufferList sub_list;
+  auto early = std::make_shared<SubUpdateBuffer>(10);
+  sub_list.addBuffer(early);
+  SubEventGroupUpdate update{1, {}};
+  sub_list.updateEventGroupSubBuffers(update);
+
+  auto late = std::make_shared<SubUpdateBuffer>(10);
+  sub_list.addBuffer(late);
+  ASSERT_TRUE(late->EmptyEventGroupQueue());
+  update.event_group_id = 2;
+  sub_list.updateEventGroupSubBuffers(update);
+
+  ASSERT_EQ(early->SizeEventGroupQueue(), 2);
+  ASSERT_EQ(early->oldestEventGroupId(), 1);
+  ASSERT_EQ(late->SizeEventGroupQueue(), 1);
+  ASSERT_EQ(late->oldestEventGroupId(), 2);
+}
+
+// Updates pushed to a buffer are not seen by the other buffers, and are read in the order they were pushed/published,
+// including the ones pushed before the buffer was added.
+TEST(trs_sub_buffer_test, pushed_updates_are_local_and_ordered) {
+  SubBufferList sub_list;
+  auto updates = std::make_shared<SubUpdateBuffer>(10);
+  auto other = std::make_shared<SubUpdateBuffer>(10);
+  updates->Push({1, "cid", {}});
+  updates->Push({2, "cid", {}});
+  sub_list.addBuffer(updates);
+  sub_list.addBuffer(other);
+  ASSERT_EQ(updates->Size(), 2);
+  ASSERT_EQ(updates->oldestBlockId(), 1);
+  ASSERT_EQ(updates->newestBlockId(), 2);
+
+  SubUpdate update{3, "cid", {}};
+  sub_list.updateSubBuffers(update);
+  updates->Push({4, "cid", {}});
+  update.block_id = 5;
+  sub_list.updateSubBuffers(update);
+  ASSERT_EQ(updates->Size(), 5);
+  ASSERT_EQ(updates->newestBlockId(), 5);
+  ASSERT_EQ(other->Size(), 2);
+  ASSERT_EQ(other->oldestBlockId(), 3);
+
+  SubUpdate out;
+  for (uint64_t block_id = 1; block_id <= 5; block_id++) {
+    ASSERT_TRUE(updates->TryPop(out, 10ms));
+    ASSERT_EQ(out.block_id, block_id);
+  }
+  ASSERT_TRUE(updates->Empty());
+
+  // A buffer that isn't added to a list
+  auto standalone = std::make_shared<SubUpdateBuffer>(2);
+  standalone->Push({1, "cid", {}});
+  standalone->Push({2, "cid", {}});
+  ASSERT_TRUE(standalone->Full());
+  standalone->Push({3, "cid", {}});
+  EXPECT_THROW(standalone->Pop(out), ConsumerTooSlow);
+}
+
 TEST(trs_sub_buffer_test, block_consumer_if_no_updates_available) {
   SubBufferList sub_list;
   std::atomic_bool reader_started;
@@ -284,6 +387,45 @@ TEST(trs_sub_buffer_test, waiting_for_updates) {
   sub_list.updateEventGroupSubBuffers(update_eg);
 }
 
+// All the waiting consumers share the wake-up of the list, which is triggered by every update, while an update
+// pushed to a single buffer wakes its consumer up as well.
+TEST(trs_sub_buffer_test, waiting_consumers_share_wakeup) {
+  SubBufferList sub_list;
+  const auto num_consumers = 16;
+  std::vector<std::shared_ptr<SubUpdateBuffer>> buffers;
+  std::vector<std::future<uint64_t>> readers;
+  for (auto i = 0; i < num_consumers; ++i) {
+    buffers.push_back(std::make_shared<SubUpdateBuffer>(10));
+    sub_list.addBuffer(buffers.back());
+    readers.push_back(std::async(std::launch::async, [buffer = buffers.back()] {
+      SubUpdate out;
+      buffer->Pop(out);
+      return out.block_id;
+    }));
+  }
+
+  SubUpdate update{};
+  update.block_id = 42;
+  sub_list.updateSubBuffers(update);
+  for (auto& reader : readers) {
+    ASSERT_EQ(reader.get(), 42);
+  }
+
+  std::atomic_bool reader_started{false};
+  auto reader = std::async(std::launch::async, [&] {
+    reader_started = true;
+    SubUpdate out;
+    buffers.front()->Pop(out);
+    return out.block_id;
+  });
+  while (!reader_started)
+    ;
+  update.block_id = 7;
+  buffers.front()->Push(update);
+  ASSERT_EQ(reader.get(), 7);
+  ASSERT_TRUE(buffers.back()->Empty());
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
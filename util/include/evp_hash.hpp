@@ -98,6 +98,16 @@ class EVPHash {
     updating_ = false;
     return digest;
   }
+
+  // Return a copy of a digest in progress, to which data can be appended independently of this one.
+  EVPHash clone() const noexcept {
+    ConcordAssert(updating_);
+    EVPHash copy;
+    ConcordAssert(EVP_MD_CTX_copy_ex(copy.ctx_, ctx_) == 1);
+    copy.updating_ = true;
+    return copy;
+  }
+
   static std::string toHexString(const Digest& digest) {
     std::ostringstream oss;
     for (size_t i = 0; i < SIZE_IN_BYTES; ++i)
@@ -0,0 +1,202 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace concord::util {
+
+// Size of a cache line, used to keep the producer and consumer indices from sharing a line.
+static constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * class MpscRingQueue
+ *
+ * A bounded, lock-free, multi-producer/single-consumer FIFO queue. Every cell carries a sequence number that tells
+ * producers and the consumer whether the cell is free or holds a value for the current lap (D. Vyukov's bounded queue).
+ * Producers reserve a cell with a CAS on the tail index; the single consumer never needs a CAS.
+ *
+ * tryPush() returns false when the queue is full - it never blocks and never allocates.
+ * tryPop() returns std::nullopt when the queue is empty, or when the next producer in line has reserved its cell but
+ * has not yet published the element. Callers are expected to retry.
+ *
+ * Capacity is rounded up to the next power of two.
+ */
+template <typename T>
+class MpscRingQueue {
+ public:
+  explicit MpscRingQueue(std::size_t capacity) : capacity_{roundUpToPowerOfTwo(capacity)}, mask_{capacity_ - 1} {
+    if (capacity == 0) throw std::invalid_argument("MpscRingQueue capacity must be positive");
+    cells_ = std::make_unique<Cell[]>(capacity_);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~MpscRingQueue() {
+    while (tryPop()) {
+    }
+  }
+
+  MpscRingQueue(const MpscRingQueue&) = delete;
+  MpscRingQueue& operator=(const MpscRingQueue&) = delete;
+
+  // Can be called by any thread.
+  template <typename U>
+  bool tryPush(U&& element) {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      const auto seq = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        // The consumer hasn't freed this cell yet - the queue is full.
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    new (&cell->storage) T(std::forward<U>(element));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Must only be called by the single consumer thread.
+  std::optional<T> tryPop() {
+    auto& cell = cells_[head_ & mask_];
+    const auto seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(head_ + 1) < 0) return std::nullopt;
+    auto* element = std::launder(reinterpret_cast<T*>(&cell.storage));
+    std::optional<T> ret{std::move(*element)};
+    element->~T();
+    cell.sequence.store(head_ + capacity_, std::memory_order_release);
+    ++head_;
+    head_published_.store(head_, std::memory_order_relaxed);
+    return ret;
+  }
+
+  // An approximation of the number of elements in the queue. Can be called by any thread.
+  std::size_t size() const {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    const auto head = head_published_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  static std::size_t roundUpToPowerOfTwo(std::size_t v) {
+    std::size_t ret = 1;
+    while (ret < v) ret <<= 1;
+    return ret;
+  }
+
+  struct Cell {
+    std::atomic<std::size_t> sequence{0};
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+  };
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+  // Consumer only.
+  alignas(kCacheLineSize) std::size_t head_{0};
+  // A copy of head_ that other threads may read for size().
+  std::atomic<std::size_t> head_published_{0};
+};
+
+/**
+ * class MpscLinkedQueue
+ *
+ * An unbounded, lock-free, multi-producer/single-consumer FIFO queue based on an intrusive singly linked list with a
+ * stub node (D. Vyukov's non-intrusive MPSC queue). A push is a single atomic exchange plus a node allocation.
+ *
+ * Use it where elements must never be dropped and producers must never block. Similarly to MpscRingQueue, tryPop()
+ * may transiently return std::nullopt while a producer is between the exchange and linking its node.
+ */
+template <typename T>
+class MpscLinkedQueue {
+ public:
+  MpscLinkedQueue() : head_{new Node{}}, tail_{head_.load(std::memory_order_relaxed)} {}
+
+  ~MpscLinkedQueue() {
+    while (tryPop()) {
+    }
+    delete tail_;
+  }
+
+  MpscLinkedQueue(const MpscLinkedQueue&) = delete;
+  MpscLinkedQueue& operator=(const MpscLinkedQueue&) = delete;
+
+  // Can be called by any thread.
+  template <typename U>
+  void push(U&& element) {
+    auto node = new Node{std::forward<U>(element)};
+    auto prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Must only be called by the single consumer thread.
+  std::optional<T> tryPop() {
+    auto next = tail_->next.load(std::memory_order_acquire);
+    if (!next) return std::nullopt;
+    std::optional<T> ret{std::move(*next->element)};
+    next->element.reset();
+    delete tail_;
+    tail_ = next;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return ret;
+  }
+
+  // An approximation of the number of elements in the queue. Can be called by any thread.
+  std::size_t size() const {
+    const auto size = size_.load(std::memory_order_relaxed);
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+ private:
+  struct Node {
+    Node() = default;
+    template <typename U>
+    explicit Node(U&& e) : element{std::forward<U>(e)} {}
+    std::atomic<Node*> next{nullptr};
+    std::optional<T> element;
+  };
+
+  // Producers push at head_.
+  alignas(kCacheLineSize) std::atomic<Node*> head_;
+  // The consumer pops from tail_, which always points to a stub node.
+  alignas(kCacheLineSize) Node* tail_;
+  std::atomic<std::int64_t> size_{0};
+};
+
+}  // namespace concord::util
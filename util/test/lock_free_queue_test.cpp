@@ -0,0 +1,125 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+#include "lock_free_queue.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace concord::util;
+
+namespace {
+
+constexpr std::uint64_t kProducers = 4;
+constexpr std::uint64_t kElementsPerProducer = 50000;
+
+// Elements encode the producer id in the high bits and a per-producer counter in the low bits, so the consumer can
+// check that elements from the same producer come out in order.
+constexpr std::uint64_t encode(std::uint64_t producer, std::uint64_t i) { return (producer << 32) | i; }
+
+template <typename PushFunc, typename PopFunc>
+void checkMultipleProducers(PushFunc&& push, PopFunc&& pop) {
+  auto producers = std::vector<std::thread>{};
+  for (auto p = 0u; p < kProducers; ++p) {
+    producers.emplace_back([&push, p]() {
+      for (auto i = 0u; i < kElementsPerProducer; ++i) {
+        while (!push(encode(p, i))) std::this_thread::yield();
+      }
+    });
+  }
+
+  // Keep popping until all elements are consumed, even after a failure, so that the producers can finish and be joined.
+  auto next_expected = std::vector<std::uint64_t>(kProducers, 0);
+  auto out_of_order = 0u;
+  auto popped = 0u;
+  while (popped < kProducers * kElementsPerProducer) {
+    auto e = pop();
+    if (!e) continue;
+    ++popped;
+    const auto producer = *e >> 32;
+    const auto i = *e & 0xFFFFFFFF;
+    EXPECT_LT(producer, kProducers);
+    if (producer >= kProducers) continue;
+    if (next_expected[producer] != i) ++out_of_order;
+    next_expected[producer] = i + 1;
+  }
+  for (auto& t : producers) t.join();
+  ASSERT_EQ(0u, out_of_order);
+  for (auto n : next_expected) ASSERT_EQ(kElementsPerProducer, n);
+}
+
+TEST(mpsc_ring_queue, capacity_is_rounded_to_power_of_two) {
+  auto q = MpscRingQueue<int>{5};
+  ASSERT_EQ(8u, q.capacity());
+  ASSERT_THROW(MpscRingQueue<int>{0}, std::invalid_argument);
+}
+
+TEST(mpsc_ring_queue, push_fails_when_full) {
+  auto q = MpscRingQueue<int>{4};
+  for (auto i = 0; i < 4; ++i) ASSERT_TRUE(q.tryPush(i));
+  ASSERT_EQ(4u, q.size());
+  ASSERT_FALSE(q.tryPush(4));
+  ASSERT_EQ(0, *q.tryPop());
+  ASSERT_TRUE(q.tryPush(4));
+  for (auto i = 1; i <= 4; ++i) ASSERT_EQ(i, *q.tryPop());
+  ASSERT_FALSE(q.tryPop());
+  ASSERT_TRUE(q.empty());
+}
+
+TEST(mpsc_ring_queue, move_only_elements) {
+  auto q = MpscRingQueue<std::unique_ptr<int>>{2};
+  ASSERT_TRUE(q.tryPush(std::make_unique<int>(42)));
+  auto e = q.tryPop();
+  ASSERT_TRUE(e);
+  ASSERT_EQ(42, **e);
+}
+
+TEST(mpsc_ring_queue, elements_destroyed_with_queue) {
+  auto shared = std::make_shared<int>(0);
+  {
+    auto q = MpscRingQueue<std::shared_ptr<int>>{4};
+    ASSERT_TRUE(q.tryPush(shared));
+    ASSERT_TRUE(q.tryPush(shared));
+    ASSERT_EQ(3, shared.use_count());
+  }
+  ASSERT_EQ(1, shared.use_count());
+}
+
+TEST(mpsc_ring_queue, multiple_producers_keep_per_producer_order) {
+  auto q = MpscRingQueue<std::uint64_t>{1024};
+  checkMultipleProducers([&q](std::uint64_t e) { return q.tryPush(e); }, [&q]() { return q.tryPop(); });
+}
+
+TEST(mpsc_linked_queue, fifo) {
+  auto q = MpscLinkedQueue<int>{};
+  ASSERT_FALSE(q.tryPop());
+  for (auto i = 0; i < 100; ++i) q.push(i);
+  ASSERT_EQ(100u, q.size());
+  for (auto i = 0; i < 100; ++i) ASSERT_EQ(i, *q.tryPop());
+  ASSERT_FALSE(q.tryPop());
+  ASSERT_TRUE(q.empty());
+}
+
+TEST(mpsc_linked_queue, multiple_producers_keep_per_producer_order) {
+  auto q = MpscLinkedQueue<std::uint64_t>{};
+  checkMultipleProducers(
+      [&q](std::uint64_t e) {
+        q.push(e);
+        return true;
+      },
+      [&q]() { return q.tryPop(); });
+}
+
+}  // namespace